@@ -236,6 +236,30 @@ namespace SPH {
 		multi_ploygen_.findBounds(lower_bound, upper_bound);
 	}
 	//=================================================================================================//
+	uint64_t ComplexShape::ContentHash()
+	{
+		uint64_t hash = initial_content_hash;
+		for (const boost_poly& polygon : multi_ploygen_.getBoostMultiPoly())
+		{
+			hash = updateContentHash(hash, polygon.outer().size());
+			for (const model::d2::point_xy<Real>& point : polygon.outer())
+			{
+				hash = updateContentHash(hash, point.x());
+				hash = updateContentHash(hash, point.y());
+			}
+			for (const auto& inner_ring : polygon.inners())
+			{
+				hash = updateContentHash(hash, inner_ring.size());
+				for (const model::d2::point_xy<Real>& point : inner_ring)
+				{
+					hash = updateContentHash(hash, point.x());
+					hash = updateContentHash(hash, point.y());
+				}
+			}
+		}
+		return hash;
+	}
+	//=================================================================================================//
 	void ComplexShape::addAMultiPolygon(MultiPolygon& multi_polygon, ShapeBooleanOps op)
 	{
 		multi_ploygen_.addAMultiPolygon(multi_polygon, op);
@@ -92,6 +92,8 @@ namespace SPH {
 		virtual Real findSignedDistance(Vec2d input_pnt);
 		virtual Vec2d findNormalDirection(Vec2d input_pnt);
 		virtual Vecd computeKernelIntegral(Vecd input_pnt, Kernel* kernel);
+		/** hash of the points of the rings of the resulted multi-polygon */
+		uint64_t ContentHash();
 	protected:
 		MultiPolygon multi_ploygen_;
 	};
@@ -50,5 +50,20 @@ namespace SPH {
 		return grid_index[0] * number_of_grid_points[1] + grid_index[1];
 	}
 	//=============================================================================================//
+	size_t BaseMesh::transferMeshIndexToMortonOrder(Vecu grid_index)
+	{
+		/** spread the lower 32 bits of an index to the even bits */
+		auto separate_bits = [](size_t i)->size_t {
+			i &= 0xffffffff;
+			i = (i | (i << 16)) & 0x0000ffff0000ffff;
+			i = (i | (i << 8)) & 0x00ff00ff00ff00ff;
+			i = (i | (i << 4)) & 0x0f0f0f0f0f0f0f0f;
+			i = (i | (i << 2)) & 0x3333333333333333;
+			i = (i | (i << 1)) & 0x5555555555555555;
+			return i;
+		};
+		return separate_bits(grid_index[0]) | (separate_bits(grid_index[1]) << 1);
+	}
+	//=============================================================================================//
 }
 //=============================================================================================//
@@ -48,7 +48,7 @@ namespace SPH
 		//check lower bound
 		for (size_t i = 0; i != lower_bound_cells_.size(); ++i) {
 			CellListDataVector& list_data
-				= cell_linked_lists_[lower_bound_cells_[i][0]][lower_bound_cells_[i][1]].cell_list_data_;
+				= mesh_cell_linked_list_->CellListDataFromIndex(lower_bound_cells_[i]);
 			for (size_t num = 0; num < list_data.size(); ++num)
 				CheckLowerBound(list_data[num].first, list_data[num].second, dt);
 		}
@@ -56,7 +56,7 @@ namespace SPH
 		//check upper bound
 		for (size_t i = 0; i != upper_bound_cells_.size(); ++i) {
 			CellListDataVector& list_data
-				= cell_linked_lists_[upper_bound_cells_[i][0]][upper_bound_cells_[i][1]].cell_list_data_;
+				= mesh_cell_linked_list_->CellListDataFromIndex(upper_bound_cells_[i]);
 			for (size_t num = 0; num < list_data.size(); ++num)
 				CheckUpperBound(list_data[num].first, list_data[num].second, dt);
 		}
@@ -71,7 +71,7 @@ namespace SPH
 			[&](const blocked_range<size_t>& r) {
 				for (size_t i = r.begin(); i < r.end(); ++i) {
 					CellListDataVector& list_data
-						= cell_linked_lists_[lower_bound_cells_[i][0]][lower_bound_cells_[i][1]].cell_list_data_;
+						= mesh_cell_linked_list_->CellListDataFromIndex(lower_bound_cells_[i]);
 					for (size_t num = 0; num < list_data.size(); ++num)
 						CheckLowerBound(list_data[num].first, list_data[num].second, dt);
 				}
@@ -82,7 +82,7 @@ namespace SPH
 			[&](const blocked_range<size_t>& r) {
 				for (size_t i = r.begin(); i < r.end(); ++i) {
 					CellListDataVector& list_data
-						= cell_linked_lists_[upper_bound_cells_[i][0]][upper_bound_cells_[i][1]].cell_list_data_;
+						= mesh_cell_linked_list_->CellListDataFromIndex(upper_bound_cells_[i]);
 					for (size_t num = 0; num < list_data.size(); ++num)
 						CheckUpperBound(list_data[num].first, list_data[num].second, dt);
 				}
@@ -128,7 +128,7 @@ namespace SPH
 		setupDynamics(dt);
 		for (size_t i = 0; i != bound_cells_.size(); ++i) {
 			CellListDataVector& list_data
-				= cell_linked_lists_[bound_cells_[i][0]][bound_cells_[i][1]].cell_list_data_;
+				= mesh_cell_linked_list_->CellListDataFromIndex(bound_cells_[i]);
 			for (size_t num = 0; num < list_data.size(); ++num)
 				checking_bound_(list_data[num].first, dt);
 		}
@@ -142,7 +142,7 @@ namespace SPH
 			[&](const blocked_range<size_t>& r) {
 				for (size_t i = r.begin(); i < r.end(); ++i) {
 					CellListDataVector& list_data
-						= cell_linked_lists_[bound_cells_[i][0]][bound_cells_[i][1]].cell_list_data_;
+						= mesh_cell_linked_list_->CellListDataFromIndex(bound_cells_[i]);
 					for (size_t num = 0; num < list_data.size(); ++num)
 						checking_bound_(list_data[num].first, dt);
 				}
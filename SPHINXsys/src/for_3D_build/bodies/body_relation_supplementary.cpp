@@ -11,114 +11,347 @@
 #include "base_particles.h"
 #include "base_kernel.h"
 #include "mesh_cell_linked_list.h"
+#include "dynamics_profiler.h"
 namespace SPH
 {
 	//=================================================================================================//
-	void SPHBodyInnerRelation::updateConfiguration()
+	template<typename NeighborOperation>
+	void SPHBodyInnerRelation::searchNeighbors(size_t particle_index, int search_range, 
+		Real search_radius_sqr, NeighborOperation& neighbor_operation)
 	{
-		BaseParticles* base_particles = sph_body_->base_particles_;
 		Vecu number_of_cells = mesh_cell_linked_list_->NumberOfCells();
-		matrix_cell cell_linked_lists = mesh_cell_linked_list_->CellLinkedLists();
-		Kernel* current_kernel = sph_body_->kernel_;
-		Real cutoff_radius_sqr = powern(current_kernel->GetCutOffRadius(), 2);
+		Vecd particle_position = base_particles_->pos_n_[particle_index];
+		Vecu cell_location = mesh_cell_linked_list_->GridIndexFromPosition(particle_position);
+		int i = (int)cell_location[0];
+		int j = (int)cell_location[1];
+		int k = (int)cell_location[2];
 
-		parallel_for(blocked_range<size_t>(0, sph_body_->number_of_particles_),
-			[&](const blocked_range<size_t>& r) {
-				for (size_t num = r.begin(); num != r.end(); ++num)
+		for (int l = SMAX(i - search_range, 0); l <= SMIN(i + search_range, int(number_of_cells[0]) - 1); ++l)
+			for (int m = SMAX(j - search_range, 0); m <= SMIN(j + search_range, int(number_of_cells[1]) - 1); ++m)
+				for (int q = SMAX(k - search_range, 0); q <= SMIN(k + search_range, int(number_of_cells[2]) - 1); ++q)
 				{
-					Vecd particle_position = base_particles->pos_n_[num];
-					Vecu cell_location = 
-						mesh_cell_linked_list_->GridIndexFromPosition(particle_position);
-					int i = (int)cell_location[0];
-					int j = (int)cell_location[1];
-					int k = (int)cell_location[2];
-
-					Neighborhood& neighborhood = inner_configuration_[num];
-					size_t current_count_of_neighbors = 0;
-					for (int l = SMAX(i - 1, 0); l <= SMIN(i + 1, int(number_of_cells[0]) - 1); ++l)
+					CellListDataVector& target_particles = mesh_cell_linked_list_->CellListDataFromIndex(Vecu(l, m, q));
+					for (size_t n = 0; n != target_particles.size(); ++n)
 					{
-						for (int m = SMAX(j - 1, 0); m <= SMIN(j + 1, int(number_of_cells[1]) - 1); ++m)
+						//displacement pointing from neighboring particle to origin particle
+						Vecd displacement = particle_position - target_particles[n].second;
+						if (displacement.normSqr() <= search_radius_sqr && particle_index != target_particles[n].first)
+							neighbor_operation(displacement, target_particles[n].first);
+					}
+				}
+	}
+	//=================================================================================================//
+	template<typename NeighborOperation>
+	void SPHBodyBaseRelation::searchNeighborsWithVariableSmoothingLength(size_t particle_index,
+		SearchLevels& search_levels, Kernel& kernel, StdLargeVec<Real>& target_smoothing_length,
+		NeighborOperation& neighbor_operation)
+	{
+		Vecd particle_position = base_particles_->pos_n_[particle_index];
+		Real smoothing_length = base_particles_->smoothing_length_[particle_index];
+		Real cutoff_radius = kernel.GetCutOffRadius(smoothing_length);
+		for (size_t level = 0; level != search_levels.size(); ++level)
+		{
+			BaseMeshCellLinkedList& target_mesh_cell_linked_list = *search_levels[level].first;
+			Vecu target_number_of_cells = target_mesh_cell_linked_list.NumberOfCells();
+			int search_range = (int)ceil((SMAX(cutoff_radius, search_levels[level].second) + skin_radius_)
+				/ target_mesh_cell_linked_list.CellSpacing());
+			Vecu target_cell_index = target_mesh_cell_linked_list.GridIndexFromPosition(particle_position);
+			int i = (int)target_cell_index[0];
+			int j = (int)target_cell_index[1];
+			int k = (int)target_cell_index[2];
+
+			for (int l = SMAX(i - search_range, 0); l <= SMIN(i + search_range, int(target_number_of_cells[0]) - 1); ++l)
+				for (int m = SMAX(j - search_range, 0); m <= SMIN(j + search_range, int(target_number_of_cells[1]) - 1); ++m)
+					for (int q = SMAX(k - search_range, 0); q <= SMIN(k + search_range, int(target_number_of_cells[2]) - 1); ++q)
+					{
+						CellListDataVector& target_particles = target_mesh_cell_linked_list.CellListDataFromIndex(Vecu(l, m, q));
+						for (size_t n = 0; n != target_particles.size(); ++n)
 						{
-							for (int q = SMAX(k - 1, 0); q <= SMIN(k + 1, int(number_of_cells[2]) - 1); ++q)
-							{
-								CellListDataVector& target_particles = cell_linked_lists[l][m][q].cell_list_data_;
-								for (size_t n = 0; n != target_particles.size(); ++n)
-								{
-									//displacement pointing from neighboring particle to origin particle
-									Vecd displacement = particle_position - target_particles[n].second;
-									if (displacement.normSqr() <= cutoff_radius_sqr && num != target_particles[n].first)
-									{
-										current_count_of_neighbors >= neighborhood.memory_size_ ?
-											createNeighborRelation(neighborhood,
-												*current_kernel, displacement, num, target_particles[n].first)
-											: initializeNeighborRelation(neighborhood, current_count_of_neighbors,
-												*current_kernel, displacement, num, target_particles[n].first);
-										current_count_of_neighbors++;
-									}
-								}
-							}
+							size_t j_index = target_particles[n].first;
+							Real smoothing_length_ij = SMAX(smoothing_length, target_smoothing_length[j_index]);
+							Real search_radius = kernel.GetCutOffRadius(smoothing_length_ij) + skin_radius_;
+							//displacement pointing from neighboring particle to origin particle
+							Vecd displacement = particle_position - target_particles[n].second;
+							if (displacement.normSqr() <= search_radius * search_radius)
+								neighbor_operation(displacement, j_index, smoothing_length_ij);
 						}
 					}
-					neighborhood.current_size_ = current_count_of_neighbors;
+		}
+	}
+	//=================================================================================================//
+	void SPHBodyInnerRelation::updateConfigurationWithVariableSmoothingLength(Kernel& kernel)
+	{
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		if (isVerletListValid())
+		{
+			refreshConfigurationWithVariableSmoothingLength(inner_configuration_, kernel, base_particles_);
+			if (is_pair_configuration_requested_) updateInnerPairConfiguration();
+			/** the split cell lists have changed with the cell linked list */
+			updateCellListCosts();
+			return;
+		}
+
+		SearchLevels search_levels = getSearchLevels(mesh_cell_linked_list_, kernel.GetCutOffRadius());
+		StdLargeVec<Real>& smoothing_length = base_particles_->smoothing_length_;
+		StdLargeVec<size_t>& offsets = inner_configuration_.offsets_;
+
+		/** count the neighbors first so that the neighbors are saved contiguously. */
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t current_count_of_neighbors = 0;
+					auto count_a_neighbor = [&](Vecd& displacement, size_t j_index, Real smoothing_length_ij) {
+						if (j_index != num) current_count_of_neighbors++;
+					};
+					searchNeighborsWithVariableSmoothingLength(num, search_levels, kernel, smoothing_length, count_a_neighbor);
+					offsets[num + 1] = current_count_of_neighbors;
+				}
+			}, configuration_affinity_);
+
+		inner_configuration_.allocateNeighbors(number_of_particles);
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t entry_index = offsets[num];
+					auto set_a_neighbor = [&](Vecd& displacement, size_t j_index, Real smoothing_length_ij) {
+						if (j_index == num) return;
+						inner_configuration_.setAVerletListNeighbor(entry_index, kernel, 1.0 / smoothing_length_ij,
+							displacement, j_index, powern(kernel.GetCutOffRadius(smoothing_length_ij), 2));
+						entry_index++;
+					};
+					searchNeighborsWithVariableSmoothingLength(num, search_levels, kernel, smoothing_length, set_a_neighbor);
 				}
-			}, ap);
+			}, configuration_affinity_);
+
+		number_of_rebuilds_++;
+		number_of_particles_at_rebuild_ = number_of_particles;
+		if (skin_radius_ > 0.0) recordPositions(base_particles_, number_of_particles, pos_at_rebuild_);
+		if (is_pair_configuration_requested_) updateInnerPairConfiguration();
+		updateCellListCosts();
+	}
+	//=================================================================================================//
+	void SPHBodyInnerRelation::updateConfiguration()
+	{
+		recordUpdateStamp();
+
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		DynamicsTiming dynamics_timing(sph_body_->GetBodyName(), "inner configuration", number_of_particles);
+		Kernel* current_kernel = sph_body_->kernel_;
+		Real cutoff_radius = current_kernel->GetCutOffRadius();
+		Real cutoff_radius_sqr = powern(cutoff_radius, 2);
+		number_of_updates_++;
+		if (hasVariableSmoothingLength(mesh_cell_linked_list_))
+		{
+			updateConfigurationWithVariableSmoothingLength(*current_kernel);
+			return;
+		}
+		if (isVerletListValid())
+		{
+			refreshConfiguration(inner_configuration_, *current_kernel, cutoff_radius_sqr, base_particles_->pos_n_);
+			if (is_pair_configuration_requested_) updateInnerPairConfiguration();
+			/** the split cell lists have changed with the cell linked list */
+			updateCellListCosts();
+			return;
+		}
+
+		int search_range = computeVerletSearchRange(mesh_cell_linked_list_, cutoff_radius, 1);
+		Real search_radius_sqr = powern(cutoff_radius + skin_radius_, 2);
+		StdLargeVec<size_t>& offsets = inner_configuration_.offsets_;
+
+		/** count the neighbors first so that the neighbors are saved contiguously. */
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t current_count_of_neighbors = 0;
+					auto count_a_neighbor = [&](Vecd& displacement, size_t j_index) {
+						current_count_of_neighbors++;
+					};
+					searchNeighbors(num, search_range, search_radius_sqr, count_a_neighbor);
+					offsets[num + 1] = current_count_of_neighbors;
+				}
+			}, configuration_affinity_);
+
+		inner_configuration_.allocateNeighbors(number_of_particles);
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t entry_index = offsets[num];
+					auto set_a_neighbor = [&](Vecd& displacement, size_t j_index) {
+						inner_configuration_.setAVerletListNeighbor(entry_index, 
+							*current_kernel, displacement, j_index, cutoff_radius_sqr);
+						entry_index++;
+					};
+					searchNeighbors(num, search_range, search_radius_sqr, set_a_neighbor);
+				}
+			}, configuration_affinity_);
+
+		number_of_rebuilds_++;
+		number_of_particles_at_rebuild_ = number_of_particles;
+		if (skin_radius_ > 0.0) recordPositions(base_particles_, number_of_particles, pos_at_rebuild_);
+		if (is_pair_configuration_requested_) updateInnerPairConfiguration();
+		updateCellListCosts();
+	}
+	//=================================================================================================//
+	template<typename NeighborOperation>
+	void SPHBodyContactRelation::searchNeighbors(size_t particle_index, 
+		BaseMeshCellLinkedList& target_mesh_cell_linked_list, int search_range, 
+		Real search_radius_sqr, NeighborOperation& neighbor_operation)
+	{
+		Vecu target_number_of_cells = target_mesh_cell_linked_list.NumberOfCells();
+		Vecd particle_position = base_particles_->pos_n_[particle_index];
+		Vecu target_cell_index = target_mesh_cell_linked_list.GridIndexFromPosition(particle_position);
+		int i = (int)target_cell_index[0];
+		int j = (int)target_cell_index[1];
+		int k = (int)target_cell_index[2];
+
+		for (int l = SMAX(i - search_range, 0); l <= SMIN(i + search_range, int(target_number_of_cells[0]) - 1); ++l)
+			for (int m = SMAX(j - search_range, 0); m <= SMIN(j + search_range, int(target_number_of_cells[1]) - 1); ++m)
+				for (int q = SMAX(k - search_range, 0); q <= SMIN(k + search_range, int(target_number_of_cells[2]) - 1); ++q)
+				{
+					CellListDataVector& target_particles = target_mesh_cell_linked_list.CellListDataFromIndex(Vecu(l, m, q));
+					for (size_t n = 0; n < target_particles.size(); n++)
+					{
+						//displacement pointing from neighboring particle to origin particle
+						Vecd displacement = particle_position - target_particles[n].second;
+						if (displacement.normSqr() <= search_radius_sqr)
+							neighbor_operation(displacement, target_particles[n].first);
+					}
+				}
+	}
+	//=================================================================================================//
+	void SPHBodyContactRelation::updateContactConfigurationWithVariableSmoothingLength(size_t relation_body_num,
+		Kernel& kernel, bool is_verlet_list_valid)
+	{
+		ParticleConfiguration& configuration = contact_configuration_[relation_body_num];
+		BaseParticles* contact_particles = contact_sph_bodies_[relation_body_num]->base_particles_;
+		if (is_verlet_list_valid)
+		{
+			refreshConfigurationWithVariableSmoothingLength(configuration, kernel, contact_particles);
+			return;
+		}
+
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		SearchLevels search_levels = getSearchLevels(target_mesh_cell_linked_lists_[relation_body_num],
+			kernel.GetCutOffRadius(contact_sph_bodies_[relation_body_num]->kernel_->GetSmoothingLength()));
+		StdLargeVec<Real>& target_smoothing_length = contact_particles->smoothing_length_;
+		StdLargeVec<size_t>& offsets = configuration.offsets_;
+
+		/** count the neighbors first so that the neighbors are saved contiguously. */
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t current_count_of_neighbors = 0;
+					auto count_a_neighbor = [&](Vecd& displacement, size_t j_index, Real smoothing_length_ij) {
+						current_count_of_neighbors++;
+					};
+					searchNeighborsWithVariableSmoothingLength(num, search_levels, kernel,
+						target_smoothing_length, count_a_neighbor);
+					offsets[num + 1] = current_count_of_neighbors;
+				}
+			}, configuration_affinity_);
+
+		configuration.allocateNeighbors(number_of_particles);
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t num = r.begin(); num != r.end(); ++num) {
+					size_t entry_index = offsets[num];
+					auto set_a_neighbor = [&](Vecd& displacement, size_t j_index, Real smoothing_length_ij) {
+						configuration.setAVerletListNeighbor(entry_index, kernel, 1.0 / smoothing_length_ij,
+							displacement, j_index, powern(kernel.GetCutOffRadius(smoothing_length_ij), 2));
+						entry_index++;
+					};
+					searchNeighborsWithVariableSmoothingLength(num, search_levels, kernel,
+						target_smoothing_length, set_a_neighbor);
+				}
+			}, configuration_affinity_);
+
+		size_t target_number_of_particles = contact_sph_bodies_[relation_body_num]->number_of_particles_;
+		target_number_of_particles_at_rebuild_[relation_body_num] = target_number_of_particles;
+		if (skin_radius_ > 0.0) recordPositions(contact_particles,
+			target_number_of_particles, target_pos_at_rebuild_[relation_body_num]);
 	}
 	//=================================================================================================//
 	void SPHBodyContactRelation::updateConfiguration()
 	{
-		BaseParticles* base_particles = sph_body_->base_particles_;
+		recordUpdateStamp();
 
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		DynamicsTiming dynamics_timing(sph_body_->GetBodyName(), "contact configuration", number_of_particles);
+		number_of_updates_++;
+		bool is_verlet_list_valid = isVerletListValid();
 		for (size_t relation_body_num = 0; relation_body_num < contact_sph_bodies_.size(); ++relation_body_num)
 		{
 			BaseMeshCellLinkedList& target_mesh_cell_linked_list
-				= *(contact_sph_bodies_[relation_body_num]->mesh_cell_linked_list_);
-			Vecu target_number_of_cells = target_mesh_cell_linked_list.NumberOfCells();
-			int search_range =
+				= *(target_mesh_cell_linked_lists_[relation_body_num]);
+			int search_range = 
 				mesh_cell_linked_list_->ComputingSearchRage(sph_body_->refinement_level_,
 					contact_sph_bodies_[relation_body_num]->refinement_level_);
 			Kernel& current_kernel = mesh_cell_linked_list_->ChoosingKernel(sph_body_->kernel_,
 				contact_sph_bodies_[relation_body_num]->kernel_);
-			Real cutoff_radius_sqr = powern(current_kernel.GetCutOffRadius(), 2);
+			Real cutoff_radius = current_kernel.GetCutOffRadius();
+			Real cutoff_radius_sqr = powern(cutoff_radius, 2);
+			ParticleConfiguration& configuration = contact_configuration_[relation_body_num];
+			BaseParticles* contact_particles = contact_sph_bodies_[relation_body_num]->base_particles_;
+			if (hasVariableSmoothingLength(mesh_cell_linked_list_)
+				|| hasVariableSmoothingLength(&target_mesh_cell_linked_list))
+			{
+				updateContactConfigurationWithVariableSmoothingLength(relation_body_num, current_kernel, is_verlet_list_valid);
+				continue;
+			}
+			if (is_verlet_list_valid)
+			{
+				refreshConfiguration(configuration, current_kernel, cutoff_radius_sqr, contact_particles->pos_n_);
+				continue;
+			}
+
+			search_range = computeVerletSearchRange(&target_mesh_cell_linked_list, cutoff_radius, search_range);
+			Real search_radius_sqr = powern(cutoff_radius + skin_radius_, 2);
+			StdLargeVec<size_t>& offsets = configuration.offsets_;
 
-			parallel_for(blocked_range<size_t>(0, sph_body_->number_of_particles_),
+			/** count the neighbors first so that the neighbors are saved contiguously. */
+			parallel_for(blocked_range<size_t>(0, number_of_particles),
 				[&](const blocked_range<size_t>& r) {
 					for (size_t num = r.begin(); num != r.end(); ++num) {
+						size_t current_count_of_neighbors = 0;
+						auto count_a_neighbor = [&](Vecd& displacement, size_t j_index) {
+							current_count_of_neighbors++;
+						};
+						searchNeighbors(num, target_mesh_cell_linked_list, search_range,
+							search_radius_sqr, count_a_neighbor);
+						offsets[num + 1] = current_count_of_neighbors;
+					}
+				}, configuration_affinity_);
 
-						Vecd particle_position = base_particles->pos_n_[num];
-						Vecu target_cell_index = target_mesh_cell_linked_list
-							.GridIndexFromPosition(particle_position);
-						int i = (int)target_cell_index[0];
-						int j = (int)target_cell_index[1];
-						int k = (int)target_cell_index[2];
-
-						matrix_cell target_cell_linked_lists
-							= target_mesh_cell_linked_list.CellLinkedLists();
+			configuration.allocateNeighbors(number_of_particles);
 
-						Neighborhood& neighborhood = contact_configuration_[relation_body_num][num];
-						size_t current_count_of_neighbors = 0;
-						for (int l = SMAX(i - search_range, 0); l <= SMIN(i + search_range, int(target_number_of_cells[0]) - 1); ++l)
-							for (int m = SMAX(j - search_range, 0); m <= SMIN(j + search_range, int(target_number_of_cells[1]) - 1); ++m)
-								for (int q = SMAX(k - search_range, 0); q <= SMIN(k + search_range, int(target_number_of_cells[2]) - 1); ++q)
-								{
-									CellListDataVector& target_particles = target_cell_linked_lists[l][m][q].cell_list_data_;
-									for (size_t n = 0; n < target_particles.size(); n++)
-									{
-										//displacement pointing from neighboring particle to origin particle
-										Vecd displacement = particle_position - target_particles[n].second;
-										if (displacement.normSqr() <= cutoff_radius_sqr)
-										{
-											current_count_of_neighbors >= neighborhood.memory_size_ ?
-												createNeighborRelation(neighborhood,
-													current_kernel, displacement, num, target_particles[n].first)
-												: initializeNeighborRelation(neighborhood, current_count_of_neighbors,
-													current_kernel, displacement, num, target_particles[n].first);
-											current_count_of_neighbors++;
-										}
-									}
-								}
-						neighborhood.current_size_ = current_count_of_neighbors;
+			parallel_for(blocked_range<size_t>(0, number_of_particles),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t num = r.begin(); num != r.end(); ++num) {
+						size_t entry_index = offsets[num];
+						auto set_a_neighbor = [&](Vecd& displacement, size_t j_index) {
+							configuration.setAVerletListNeighbor(entry_index, 
+								current_kernel, displacement, j_index, cutoff_radius_sqr);
+							entry_index++;
+						};
+						searchNeighbors(num, target_mesh_cell_linked_list, search_range,
+							search_radius_sqr, set_a_neighbor);
 					}
-				}, ap);
+				}, configuration_affinity_);
+
+			size_t target_number_of_particles = contact_sph_bodies_[relation_body_num]->number_of_particles_;
+			target_number_of_particles_at_rebuild_[relation_body_num] = target_number_of_particles;
+			if (skin_radius_ > 0.0) recordPositions(contact_particles, 
+				target_number_of_particles, target_pos_at_rebuild_[relation_body_num]);
+		}
+
+		if (!is_verlet_list_valid)
+		{
+			number_of_rebuilds_++;
+			number_of_particles_at_rebuild_ = number_of_particles;
+			if (skin_radius_ > 0.0) recordPositions(base_particles_, number_of_particles, pos_at_rebuild_);
 		}
 	}
 	//=================================================================================================//
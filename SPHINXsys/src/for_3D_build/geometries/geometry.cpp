@@ -53,61 +53,21 @@ namespace SPH
 			std::cout << "\n Error the triangle mesh is not valid" << std::endl;
 		}
 		std::cout << "num of faces:" << triangle_mesh->getNumFaces() << std::endl;
+		bvh_ = new TriangleMeshBVH(*triangle_mesh);
 
 		return triangle_mesh;
 	}
 	//=================================================================================================//
 	bool TriangleMeshShape::checkContain(Vec3d pnt, bool BOUNDARY_INCLUDED)
 	{
-
-		SimTK::Vec2 uv_coordinate;
-		bool inside = false;
-		int face_id;
-		Vec3d closest_pnt = triangle_mesh_->findNearestPoint(pnt, inside, face_id, uv_coordinate);
-
-		vector<int> neighbor_face(4);
-		neighbor_face[0] = face_id;
-		/** go throught the neighbor faces. */
-		for (int i = 1; i < 4; i++) {
-			int edge = triangle_mesh_->getFaceEdge(face_id, i - 1);
-			int face = triangle_mesh_->getEdgeFace(edge, 0);
-			neighbor_face[i] = face != face_id ? face : triangle_mesh_->getEdgeFace(edge, 1);
-		}
-
-		Vec3d from_face_to_pnt = pnt - closest_pnt;
-		Real sum_weights = 0.0;
-		Real weighted_dot_product = 0.0;
-		for (int i = 0; i < 4; i++) {
-			SimTK::UnitVec3 normal_direction = triangle_mesh_->getFaceNormal(neighbor_face[i]);
-			Real dot_product = dot(normal_direction, from_face_to_pnt);
-			Real weight = dot_product * dot_product;
-			weighted_dot_product += weight * dot_product;
-			sum_weights += weight;
-		}
-
-		weighted_dot_product /= sum_weights;
-
-		bool weighted_inside = false;
-		if (weighted_dot_product < 0.0) weighted_inside = true;
-
-		if (face_id < 0 && face_id > triangle_mesh_->getNumFaces())
-		{
-			std::cout << "\n Error the nearest point is not valid" << std::endl;
-			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
-			exit(1);
-		}
-
-		return weighted_inside;
+		return bvh_->checkContain(pnt);
 	}
 	//=================================================================================================//
 	Vec3d TriangleMeshShape::findClosestPoint(Vec3d input_pnt)
 	{
-		bool inside = false;
 		int face_id;
-		SimTK::Vec2 normal;
-		Vec3d closest_pnt;
-		closest_pnt = triangle_mesh_->findNearestPoint(input_pnt, inside,face_id, normal);
-		if (face_id < 0 && face_id > triangle_mesh_->getNumFaces()) 
+		Vec3d closest_pnt = bvh_->findClosestPoint(input_pnt, face_id);
+		if (face_id < 0 || face_id >= triangle_mesh_->getNumFaces())
 		{
 			std::cout << "\n Error the nearest point is not valid" << std::endl;
 			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
@@ -291,6 +251,56 @@ namespace SPH
 		}
 	}
 	//=================================================================================================//
+	uint64_t ComplexShape::ContentHash()
+	{
+		uint64_t hash = initial_content_hash;
+		for (size_t i = 0; i < triangle_mesh_shapes_.size(); i++)
+		{
+			SimTK::ContactGeometry::TriangleMesh* triangle_mesh = triangle_mesh_shapes_[i].first->getTriangleMesh();
+			hash = updateContentHash(hash, int(triangle_mesh_shapes_[i].second));
+			hash = updateContentHash(hash, triangle_mesh->getNumVertices());
+			for (int n = 0; n != triangle_mesh->getNumVertices(); ++n)
+			{
+				Vec3d vertex = triangle_mesh->getVertexPosition(n);
+				for (int j = 0; j != 3; ++j) hash = updateContentHash(hash, vertex[j]);
+			}
+			hash = updateContentHash(hash, triangle_mesh->getNumFaces());
+			for (int n = 0; n != triangle_mesh->getNumFaces(); ++n)
+				for (int k = 0; k != 3; ++k) hash = updateContentHash(hash, triangle_mesh->getFaceVertex(n, k));
+		}
+		return hash;
+	}
+	//=================================================================================================//
+	void ComplexShape::findClosestPoints(StdVec<Vec3d>& input_pnts, StdVec<Vec3d>& closest_pnts)
+	{
+		closest_pnts.resize(input_pnts.size());
+		parallel_for(blocked_range<size_t>(0, input_pnts.size()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					closest_pnts[i] = findClosestPoint(input_pnts[i]);
+			});
+	}
+	//=================================================================================================//
+	void ComplexShape::checkContainPoints(StdVec<Vec3d>& input_pnts, StdVec<int>& is_contained)
+	{
+		is_contained.resize(input_pnts.size());
+		parallel_for(blocked_range<size_t>(0, input_pnts.size()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					is_contained[i] = checkContain(input_pnts[i]) ? 1 : 0;
+			});
+	}
+	//=================================================================================================//
+	void ComplexShape::findSignedDistances(StdVec<Vec3d>& input_pnts, StdVec<Real>& signed_distances)
+	{
+		signed_distances.resize(input_pnts.size());
+		parallel_for(blocked_range<size_t>(0, input_pnts.size()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					signed_distances[i] = findSignedDistance(input_pnts[i]);
+			});
+	}
+	//=================================================================================================//
 	Vecd ComplexShape::computeKernelIntegral(Vecd input_pnt, Kernel* kernel)
 	{
 		std::cout << "\n ComplexShape::computeKernelIntegral is not implemented!" << std::endl;
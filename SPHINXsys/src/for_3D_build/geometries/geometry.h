@@ -32,6 +32,7 @@
 #define _SILENCE_EXPERIMENTAL_FILESYSTEM_DEPRECATION_WARNING
 
 #include "base_geometry.h"
+#include "triangle_mesh_bvh.h"
 #include "SimTKcommon.h"
 #include "SimTKmath.h"
 #include "Simbody.h"
@@ -71,12 +72,15 @@ namespace SPH {
 		TriangleMeshShape(SimTK::UnitVec3 axis, Real radius, Real halflength, int resolution, Vec3d translation);
 
 		SimTK::ContactGeometry::TriangleMesh* getTriangleMesh() { return triangle_mesh_; };
+		TriangleMeshBVH* getBVH() { return bvh_; };
 		bool checkContain(Vec3d pnt, bool BOUNDARY_INCLUDED = true);
 		virtual Vec3d findClosestPoint(Vec3d input_pnt) override;
 		virtual void findBounds(Vec3d &lower_bound, Vec3d &upper_bound) override;
 
 	protected:
 		SimTK::ContactGeometry::TriangleMesh* triangle_mesh_;
+		/** the hierarchy for the closest point and the inside/outside queries, built with the triangle mesh */
+		TriangleMeshBVH* bvh_;
 
 		//generate triangle mesh from polymesh
 		SimTK::ContactGeometry::TriangleMesh* generateTriangleMesh(SimTK::PolygonalMesh& ploy_mesh);
@@ -104,6 +108,12 @@ namespace SPH {
 		virtual Vec3d findNormalDirection(Vec3d input_pnt);
 		virtual Vecd weightedIntegral(Vecd input_pnt, Kernel * kernel, Real smoothing_length) { return Vecd(1.0); };
 		virtual Vecd computeKernelIntegral(Vecd input_pnt, Kernel* kernel);
+		/** batched queries of many points evaluated in parallel, the results are resized to the points */
+		void findClosestPoints(StdVec<Vec3d>& input_pnts, StdVec<Vec3d>& closest_pnts);
+		void checkContainPoints(StdVec<Vec3d>& input_pnts, StdVec<int>& is_contained);
+		void findSignedDistances(StdVec<Vec3d>& input_pnts, StdVec<Real>& signed_distances);
+		/** hash of the boolean operations, the vertices and the faces of the triangle meshes */
+		uint64_t ContentHash();
 	protected:
 		/** shape container<pointer to geomtry, operation> */
 		std::vector<std::pair<TriangleMeshShape*, ShapeBooleanOps>> triangle_mesh_shapes_;
@@ -24,14 +24,25 @@ namespace SPH {
 	//=================================================================================================//
 	void  LevelSetDataPackage::initializeDataPackage(ComplexShape& complex_shape)
 	{
+		/** the signed distances of all the grid points in the package are queried as a batch */
+		StdVec<Vec3d> positions;
 		for (int i = 0; i != PackageSize(); ++i)
 			for (int j = 0; j != PackageSize(); ++j)
 				for (int k = 0; k != PackageSize(); ++k)
 				{
-					Vec3d position = data_lower_bound_ 
-								   + Vec3d((Real)i * grid_spacing_, (Real)j * grid_spacing_, (Real)k * grid_spacing_);
-					Real phi_from_surface = (complex_shape.findClosestPoint(position) - position).norm();
-					phi_[i][j][k] = complex_shape.checkContain(position) ? - phi_from_surface : phi_from_surface;
+					positions.push_back(data_lower_bound_
+						+ Vec3d((Real)i * grid_spacing_, (Real)j * grid_spacing_, (Real)k * grid_spacing_));
+				}
+		StdVec<Real> signed_distances;
+		complex_shape.findSignedDistances(positions, signed_distances);
+
+		size_t position_index = 0;
+		for (int i = 0; i != PackageSize(); ++i)
+			for (int j = 0; j != PackageSize(); ++j)
+				for (int k = 0; k != PackageSize(); ++k)
+				{
+					phi_[i][j][k] = signed_distances[position_index];
+					position_index++;
 				}
 	}
 	//=================================================================================================//
@@ -0,0 +1,236 @@
+#include "triangle_mesh_bvh.h"
+
+#include <algorithm>
+
+namespace SPH
+{
+	//=================================================================================================//
+	TriangleMeshBVH::TriangleMeshBVH(SimTK::ContactGeometry::TriangleMesh& triangle_mesh)
+		: max_faces_in_leaf_(4)
+	{
+		for (int i = 0; i != triangle_mesh.getNumVertices(); ++i)
+			vertices_.push_back(triangle_mesh.getVertexPosition(i));
+
+		StdVec<Vec3d> face_centroids;
+		for (int i = 0; i != triangle_mesh.getNumFaces(); ++i)
+		{
+			Vec3u face((size_t)triangle_mesh.getFaceVertex(i, 0),
+				(size_t)triangle_mesh.getFaceVertex(i, 1), (size_t)triangle_mesh.getFaceVertex(i, 2));
+			faces_.push_back(face);
+			face_centroids.push_back((vertices_[face[0]] + vertices_[face[1]] + vertices_[face[2]]) / 3.0);
+			face_indexes_.push_back(i);
+		}
+		nodes_.reserve(2 * faces_.size() / max_faces_in_leaf_ + 1);
+		buildNode(0, faces_.size(), face_centroids);
+	}
+	//=================================================================================================//
+	size_t TriangleMeshBVH::buildNode(size_t first_face, size_t number_of_faces, StdVec<Vec3d>& face_centroids)
+	{
+		BVHNode node;
+		node.lower_bound_ = Vec3d(Infinity);
+		node.upper_bound_ = Vec3d(-Infinity);
+		Vec3d centroid_lower_bound(Infinity), centroid_upper_bound(-Infinity);
+		for (size_t n = first_face; n != first_face + number_of_faces; ++n)
+		{
+			size_t face_index = face_indexes_[n];
+			for (int k = 0; k != 3; ++k)
+			{
+				Vec3d& vertex = vertices_[faces_[face_index][k]];
+				for (int j = 0; j != 3; ++j)
+				{
+					node.lower_bound_[j] = SMIN(node.lower_bound_[j], vertex[j]);
+					node.upper_bound_[j] = SMAX(node.upper_bound_[j], vertex[j]);
+				}
+			}
+			for (int j = 0; j != 3; ++j)
+			{
+				centroid_lower_bound[j] = SMIN(centroid_lower_bound[j], face_centroids[face_index][j]);
+				centroid_upper_bound[j] = SMAX(centroid_upper_bound[j], face_centroids[face_index][j]);
+			}
+		}
+		node.left_child_ = MaxSize_t;
+		node.right_child_ = MaxSize_t;
+		node.first_face_ = first_face;
+		node.number_of_faces_ = number_of_faces;
+
+		size_t node_index = nodes_.size();
+		nodes_.push_back(node);
+		if (number_of_faces <= max_faces_in_leaf_) return node_index;
+
+		Vec3d centroid_extent = centroid_upper_bound - centroid_lower_bound;
+		int axis = 0;
+		if (centroid_extent[1] > centroid_extent[axis]) axis = 1;
+		if (centroid_extent[2] > centroid_extent[axis]) axis = 2;
+		size_t number_of_left_faces = number_of_faces / 2;
+		std::nth_element(face_indexes_.begin() + first_face, face_indexes_.begin() + first_face + number_of_left_faces,
+			face_indexes_.begin() + first_face + number_of_faces,
+			[&](size_t a, size_t b) { return face_centroids[a][axis] < face_centroids[b][axis]; });
+
+		/** the node is accessed by its index as the nodes may be reallocated by the children */
+		size_t left_child = buildNode(first_face, number_of_left_faces, face_centroids);
+		size_t right_child = buildNode(first_face + number_of_left_faces,
+			number_of_faces - number_of_left_faces, face_centroids);
+		nodes_[node_index].left_child_ = left_child;
+		nodes_[node_index].right_child_ = right_child;
+		nodes_[node_index].number_of_faces_ = 0;
+		return node_index;
+	}
+	//=================================================================================================//
+	Real TriangleMeshBVH::distanceSqrToNode(const Vec3d& input_pnt, const BVHNode& node)
+	{
+		Real distance_sqr = 0.0;
+		for (int j = 0; j != 3; ++j)
+		{
+			Real outside = SMAX(node.lower_bound_[j] - input_pnt[j], input_pnt[j] - node.upper_bound_[j]);
+			if (outside > 0.0) distance_sqr += outside * outside;
+		}
+		return distance_sqr;
+	}
+	//=================================================================================================//
+	Vec3d TriangleMeshBVH::findClosestPointOnFace(const Vec3d& input_pnt, size_t face_index)
+	{
+		/** the regions of the vertices, the edges and the face are checked in turn */
+		const Vec3d& a = vertices_[faces_[face_index][0]];
+		const Vec3d& b = vertices_[faces_[face_index][1]];
+		const Vec3d& c = vertices_[faces_[face_index][2]];
+		Vec3d ab = b - a;
+		Vec3d ac = c - a;
+		Vec3d ap = input_pnt - a;
+		Real d1 = dot(ab, ap);
+		Real d2 = dot(ac, ap);
+		if (d1 <= 0.0 && d2 <= 0.0) return a;
+
+		Vec3d bp = input_pnt - b;
+		Real d3 = dot(ab, bp);
+		Real d4 = dot(ac, bp);
+		if (d3 >= 0.0 && d4 <= d3) return b;
+
+		Real vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0) return a + ab * (d1 / (d1 - d3));
+
+		Vec3d cp = input_pnt - c;
+		Real d5 = dot(ab, cp);
+		Real d6 = dot(ac, cp);
+		if (d6 >= 0.0 && d5 <= d6) return c;
+
+		Real vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0) return a + ac * (d2 / (d2 - d6));
+
+		Real va = d3 * d6 - d5 * d4;
+		if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+			return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		Real denominator = 1.0 / (va + vb + vc);
+		return a + ab * (vb * denominator) + ac * (vc * denominator);
+	}
+	//=================================================================================================//
+	Vec3d TriangleMeshBVH::findClosestPoint(const Vec3d& input_pnt, int& face_id)
+	{
+		Real min_distance_sqr = Infinity;
+		Vec3d closest_pnt = input_pnt;
+		face_id = -1;
+
+		StdVec<size_t> node_stack;
+		node_stack.reserve(64);
+		node_stack.push_back(0);
+		while (!node_stack.empty())
+		{
+			const BVHNode& node = nodes_[node_stack.back()];
+			node_stack.pop_back();
+			if (distanceSqrToNode(input_pnt, node) >= min_distance_sqr) continue;
+
+			if (node.left_child_ == MaxSize_t)
+			{
+				for (size_t n = node.first_face_; n != node.first_face_ + node.number_of_faces_; ++n)
+				{
+					Vec3d pnt_on_face = findClosestPointOnFace(input_pnt, face_indexes_[n]);
+					Real distance_sqr = (pnt_on_face - input_pnt).normSqr();
+					if (distance_sqr < min_distance_sqr)
+					{
+						min_distance_sqr = distance_sqr;
+						closest_pnt = pnt_on_face;
+						face_id = (int)face_indexes_[n];
+					}
+				}
+				continue;
+			}
+
+			/** the nearer child is visited first to shrink the search early */
+			size_t near_child = node.left_child_;
+			size_t far_child = node.right_child_;
+			if (distanceSqrToNode(input_pnt, nodes_[far_child]) < distanceSqrToNode(input_pnt, nodes_[near_child]))
+				std::swap(near_child, far_child);
+			node_stack.push_back(far_child);
+			node_stack.push_back(near_child);
+		}
+		return closest_pnt;
+	}
+	//=================================================================================================//
+	bool TriangleMeshBVH::isOnPositiveSideOfEdge(Real w, const Vec3d& p, const Vec3d& q, int u, int v)
+	{
+		if (w != 0.0) return w > 0.0;
+		/** the sign after shifting the point, given by the derivatives of w with respect to its u and v coordinates */
+		if (p[v] != q[v]) return p[v] > q[v];
+		return q[u] > p[u];
+	}
+	//=================================================================================================//
+	bool TriangleMeshBVH::checkRayCrossFace(const Vec3d& input_pnt, int axis, size_t face_index)
+	{
+		int u = (axis + 1) % 3;
+		int v = (axis + 2) % 3;
+		const Vec3d& a = vertices_[faces_[face_index][0]];
+		const Vec3d& b = vertices_[faces_[face_index][1]];
+		const Vec3d& c = vertices_[faces_[face_index][2]];
+		/** the signed areas of the sub-triangles in the plane normal to the ray */
+		Real w_a = (b[u] - input_pnt[u]) * (c[v] - input_pnt[v]) - (b[v] - input_pnt[v]) * (c[u] - input_pnt[u]);
+		Real w_b = (c[u] - input_pnt[u]) * (a[v] - input_pnt[v]) - (c[v] - input_pnt[v]) * (a[u] - input_pnt[u]);
+		Real w_c = (a[u] - input_pnt[u]) * (b[v] - input_pnt[v]) - (a[v] - input_pnt[v]) * (b[u] - input_pnt[u]);
+		Real area = w_a + w_b + w_c;
+		if (area == 0.0) return false;
+		bool side_a = isOnPositiveSideOfEdge(w_a, b, c, u, v);
+		bool side_b = isOnPositiveSideOfEdge(w_b, c, a, u, v);
+		bool side_c = isOnPositiveSideOfEdge(w_c, a, b, u, v);
+		if (side_a != side_b || side_b != side_c) return false;
+
+		Real crossing_position = (w_a * a[axis] + w_b * b[axis] + w_c * c[axis]) / area;
+		return crossing_position > input_pnt[axis];
+	}
+	//=================================================================================================//
+	size_t TriangleMeshBVH::countRayCrossings(const Vec3d& input_pnt, int axis)
+	{
+		int u = (axis + 1) % 3;
+		int v = (axis + 2) % 3;
+		size_t number_of_crossings = 0;
+
+		StdVec<size_t> node_stack;
+		node_stack.reserve(64);
+		node_stack.push_back(0);
+		while (!node_stack.empty())
+		{
+			const BVHNode& node = nodes_[node_stack.back()];
+			node_stack.pop_back();
+			if (input_pnt[u] < node.lower_bound_[u] || input_pnt[u] > node.upper_bound_[u]
+				|| input_pnt[v] < node.lower_bound_[v] || input_pnt[v] > node.upper_bound_[v]
+				|| input_pnt[axis] > node.upper_bound_[axis]) continue;
+
+			if (node.left_child_ == MaxSize_t)
+			{
+				for (size_t n = node.first_face_; n != node.first_face_ + node.number_of_faces_; ++n)
+					if (checkRayCrossFace(input_pnt, axis, face_indexes_[n])) number_of_crossings++;
+				continue;
+			}
+			node_stack.push_back(node.left_child_);
+			node_stack.push_back(node.right_child_);
+		}
+		return number_of_crossings;
+	}
+	//=================================================================================================//
+	bool TriangleMeshBVH::checkContain(const Vec3d& input_pnt)
+	{
+		int number_of_inside_votes = 0;
+		for (int axis = 0; axis != 3; ++axis)
+			if (countRayCrossings(input_pnt, axis) % 2 == 1) number_of_inside_votes++;
+		return number_of_inside_votes >= 2;
+	}
+	//=================================================================================================//
+}
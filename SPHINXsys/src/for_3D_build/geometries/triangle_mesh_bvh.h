@@ -0,0 +1,85 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+* @file triangle_mesh_bvh.h
+* @brief A bounding volume hierarchy of axis-aligned boxes over the faces of a triangle mesh
+* for the closest point and the inside/outside queries of a geometry.
+* @author	Chi ZHang and Xiangyu Hu
+* @version	0.1
+*/
+#pragma once
+
+#include "base_data_package.h"
+#include "SimTKcommon.h"
+#include "SimTKmath.h"
+#include "Simbody.h"
+
+namespace SPH {
+
+	/**
+	 * @class TriangleMeshBVH
+	 * @brief The hierarchy is built once from a copy of the vertices and the faces of the mesh
+	 * by splitting the faces at the median of their centroids along the longest axis.
+	 * The queries only read the hierarchy, so that they can be called concurrently.
+	 * A point is inside a closed mesh if the rays from it in the positive axis directions
+	 * cross the faces an odd number of times, taking the majority of the three rays
+	 * to be robust for the rays through edges or vertices.
+	 */
+	class TriangleMeshBVH
+	{
+	public:
+		explicit TriangleMeshBVH(SimTK::ContactGeometry::TriangleMesh& triangle_mesh);
+		virtual ~TriangleMeshBVH() {};
+
+		/** the closest point on the mesh and the face where it is */
+		Vec3d findClosestPoint(const Vec3d& input_pnt, int& face_id);
+		bool checkContain(const Vec3d& input_pnt);
+		size_t NumberOfNodes() { return nodes_.size(); };
+	protected:
+		/** a leaf has no children and the faces from first_face_ in face_indexes_ */
+		struct BVHNode
+		{
+			Vec3d lower_bound_, upper_bound_;
+			size_t left_child_, right_child_;
+			size_t first_face_, number_of_faces_;
+		};
+
+		size_t max_faces_in_leaf_;
+		StdVec<Vec3d> vertices_;
+		StdVec<Vec3u> faces_;
+		StdVec<size_t> face_indexes_;
+		StdVec<BVHNode> nodes_;
+
+		size_t buildNode(size_t first_face, size_t number_of_faces, StdVec<Vec3d>& face_centroids);
+		Real distanceSqrToNode(const Vec3d& input_pnt, const BVHNode& node);
+		Vec3d findClosestPointOnFace(const Vec3d& input_pnt, size_t face_index);
+		/** whether a point is on the positive side of the edge from p to q in the plane normal to the ray,
+		  * given the signed area w of the point and the edge. A point on the edge line is taken
+		  * as shifted infinitesimally in the u and then the v direction, so that the edges are half-open. */
+		bool isOnPositiveSideOfEdge(Real w, const Vec3d& p, const Vec3d& q, int u, int v);
+		/** whether the ray from a point in the positive axis direction crosses a face,
+		  * a ray through a shared edge or vertex crosses exactly one of the faces sharing it */
+		bool checkRayCrossFace(const Vec3d& input_pnt, int axis, size_t face_index);
+		size_t countRayCrossings(const Vec3d& input_pnt, int axis);
+	};
+}
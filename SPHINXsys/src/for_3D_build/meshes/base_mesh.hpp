@@ -151,6 +151,19 @@ namespace SPH {
 	}
 	//=================================================================================================//
 	template<class BaseMeshType, class DataPackageType>
+	DataPackageType* MeshWithDataPackages<BaseMeshType, DataPackageType>::DataPackageInACell(Vecu cell_index)
+	{
+		return data_pkg_addrs_[cell_index[0]][cell_index[1]][cell_index[2]];
+	}
+	//=================================================================================================//
+	template<class BaseMeshType, class DataPackageType>
+	void MeshWithDataPackages<BaseMeshType, DataPackageType>::
+		assignDataPackageToACell(Vecu cell_index, DataPackageType* data_pkg)
+	{
+		data_pkg_addrs_[cell_index[0]][cell_index[1]][cell_index[2]] = data_pkg;
+	}
+	//=================================================================================================//
+	template<class BaseMeshType, class DataPackageType>
 	void MeshWithDataPackages<BaseMeshType, DataPackageType>::allocateMeshDataMatrix()
 	{
 		Allocate3dArray(data_pkg_addrs_, BaseMeshType::number_of_cells_);
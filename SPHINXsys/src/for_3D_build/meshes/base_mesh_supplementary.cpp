@@ -56,4 +56,20 @@ namespace SPH {
 			 + grid_index[2];
 	}
 	//=================================================================================================//
+	size_t BaseMesh::transferMeshIndexToMortonOrder(Vecu grid_index)
+	{
+		/** spread the lower 21 bits of an index to every third bit */
+		auto separate_bits = [](size_t i)->size_t {
+			i &= 0x1fffff;
+			i = (i | (i << 32)) & 0x001f00000000ffff;
+			i = (i | (i << 16)) & 0x001f0000ff0000ff;
+			i = (i | (i << 8)) & 0x100f00f00f00f00f;
+			i = (i | (i << 4)) & 0x10c30c30c30c30c3;
+			i = (i | (i << 2)) & 0x1249249249249249;
+			return i;
+		};
+		return separate_bits(grid_index[0]) | (separate_bits(grid_index[1]) << 1)
+			| (separate_bits(grid_index[2]) << 2);
+	}
+	//=================================================================================================//
 }
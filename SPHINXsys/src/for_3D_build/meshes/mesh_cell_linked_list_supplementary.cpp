@@ -6,7 +6,7 @@
 
 namespace SPH {
 	//=================================================================================================//
-	CellList::CellList()
+	CellList::CellList() : cost_(0)
 	{
 		concurrent_particle_indexes_.reserve(36);
 	}
@@ -24,7 +24,7 @@ namespace SPH {
 							cell_linked_lists[i][j][k].real_particle_indexes_.clear();
 
 						}
-			}, ap);
+			}, update_affinity_);
 	}
 	//=================================================================================================//
 	void BaseMeshCellLinkedList::UpdateSplitCellLists(SplitCellLists& split_cell_lists,
@@ -48,13 +48,13 @@ namespace SPH {
 									.push_back(&cell_linked_lists[i][j][k]);
 							}
 						}
-			}, ap);
+			}, update_affinity_);
 	}
 	//=================================================================================================//
-	void BaseMeshCellLinkedList::UpdateCellListData(matrix_cell cell_linked_lists)
+	void BaseMeshCellLinkedList::UpdateCellListData(Vecu& number_of_cells, matrix_cell cell_linked_lists)
 	{
 		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
-		parallel_for(blocked_range3d<size_t>(0, number_of_cells_[0], 0, number_of_cells_[1], 0, number_of_cells_[2]),
+		parallel_for(blocked_range3d<size_t>(0, number_of_cells[0], 0, number_of_cells[1], 0, number_of_cells[2]),
 			[&](const blocked_range3d<size_t>& r) {
 				for (size_t i = r.pages().begin(); i != r.pages().end(); ++i)
 					for (size_t j = r.rows().begin(); j != r.rows().end(); ++j)
@@ -67,7 +67,7 @@ namespace SPH {
 								cell_list.cell_list_data_.emplace_back(make_pair(particle_index, pos_n[particle_index]));
 							}
 						}
-			}, ap);
+			}, update_affinity_);
 	}
 	//=================================================================================================//
 	CellList* MeshCellLinkedList::CellListFormIndex(Vecu cell_index)
@@ -75,29 +75,56 @@ namespace SPH {
 		return &cell_linked_lists_[cell_index[0]][cell_index[1]][cell_index[2]];
 	}
 	//=================================================================================================//
+	CellListDataVector& MeshCellLinkedList::CellListDataFromIndex(const Vecu& cell_index)
+	{
+		return cell_linked_lists_[cell_index[0]][cell_index[1]][cell_index[2]].cell_list_data_;
+	}
+	//=================================================================================================//
 	void MeshCellLinkedList
 		::allocateMeshDataMatrix()
 	{
 		Allocate3dArray(cell_linked_lists_, number_of_cells_);
+		size_t total_number_of_cells = TotalNumberOfCells();
+		cell_counts_ = new std::atomic<size_t>[total_number_of_cells];
+		for (size_t l = 0; l != total_number_of_cells; ++l) cell_counts_[l] = 0;
 	}
 	//=================================================================================================//
 	void MeshCellLinkedList
 		::deleteMeshDataMatrix()
 	{
+		if (cell_linked_lists_ == nullptr) return;
+
 		Delete3dArray(cell_linked_lists_, number_of_cells_);
+		cell_linked_lists_ = nullptr;
+		delete[] cell_counts_;
+		cell_counts_ = nullptr;
 	}
 	//=================================================================================================//
-	void MultilevelMeshCellLinkedList
-		::InsertACellLinkedListEntryAtALevel(size_t particle_index, 
-			Vecd& position, Vecu& cell_index, size_t level)
+	void MultilevelMeshCellLinkedList::allocateMeshDataMatrix()
 	{
-		cell_linked_lists_levels_[level][cell_index[0]][cell_index[1]][cell_index[2]]
-			.concurrent_particle_indexes_.push_back(particle_index);
+		Allocate3dArray(cell_linked_lists_, number_of_cells_);
+		for (size_t level = 0; level != total_levels_; ++level)
+			mesh_cell_linked_list_levels_[level]->allocateMeshDataMatrix();
+	}
+	//=================================================================================================//
+	void MultilevelMeshCellLinkedList::deleteMeshDataMatrix()
+	{
+		for (size_t level = 0; level != total_levels_; ++level)
+			mesh_cell_linked_list_levels_[level]->deleteMeshDataMatrix();
+		if (cell_linked_lists_ == nullptr) return;
+
+		Delete3dArray(cell_linked_lists_, number_of_cells_);
+		cell_linked_lists_ = nullptr;
 	}
 	//=================================================================================================//
 	CellList* MultilevelMeshCellLinkedList::CellListFormIndex(Vecu cell_index)
 	{
-		return &cell_linked_lists_levels_[0][cell_index[0]][cell_index[1]][cell_index[2]];
+		return &cell_linked_lists_[cell_index[0]][cell_index[1]][cell_index[2]];
+	}
+	//=================================================================================================//
+	CellListDataVector& MultilevelMeshCellLinkedList::CellListDataFromIndex(const Vecu& cell_index)
+	{
+		return cell_linked_lists_[cell_index[0]][cell_index[1]][cell_index[2]].cell_list_data_;
 	}
 	//=================================================================================================//
 	void MeshCellLinkedList
@@ -111,6 +138,7 @@ namespace SPH {
 		::InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position)
 	{
 		Vecu cellpos = GridIndexFromPosition(particle_position);
+		cells_with_extra_data_.push_back(transferMeshIndexTo1D(number_of_cells_, cellpos));
 		cell_linked_lists_[cellpos[0]][cellpos[1]][cellpos[2]].cell_list_data_
 			.emplace_back(make_pair(particle_index, particle_position));
 	}
@@ -147,4 +175,68 @@ namespace SPH {
 		return nearest_entry;
 	}
 	//=================================================================================================//
+	ListData SparseMeshCellLinkedList::findNearestListDataEntry(Vecd& position)
+	{
+		Real min_distance = Infinity;
+		ListData nearest_entry = std::make_pair(MaxSize_t, Vecd(Infinity));
+
+		Vecu cell_location = GridIndexFromPosition(position);
+		int i = (int)cell_location[0];
+		int j = (int)cell_location[1];
+		int k = (int)cell_location[2];
+
+		for (int l = SMAX(i - 1, 0); l <= SMIN(i + 1, int(number_of_cells_[0]) - 1); ++l)
+		{
+			for (int m = SMAX(j - 1, 0); m <= SMIN(j + 1, int(number_of_cells_[1]) - 1); ++m)
+			{
+				for (int q = SMAX(k - 1, 0); q <= SMIN(k + 1, int(number_of_cells_[2]) - 1); ++q)
+				{
+					CellListDataVector& target_particles = CellListDataFromIndex(Vecu(l, m, q));
+					for (size_t n = 0; n != target_particles.size(); ++n)
+					{
+						Real distance = (position - target_particles[n].second).norm();
+						if(distance < min_distance)
+						{
+							min_distance = distance;
+							nearest_entry =  target_particles[n];
+						}
+					}
+				}
+			}
+		}
+		return nearest_entry;
+	}
+	//=================================================================================================//
+	ListData MultilevelMeshCellLinkedList::findNearestListDataEntry(Vecd& position)
+	{
+		Real min_distance = Infinity;
+		ListData nearest_entry = std::make_pair(MaxSize_t, Vecd(Infinity));
+
+		Vecu cell_location = GridIndexFromPosition(position);
+		int i = (int)cell_location[0];
+		int j = (int)cell_location[1];
+		int k = (int)cell_location[2];
+
+		for (int l = SMAX(i - 1, 0); l <= SMIN(i + 1, int(number_of_cells_[0]) - 1); ++l)
+		{
+			for (int m = SMAX(j - 1, 0); m <= SMIN(j + 1, int(number_of_cells_[1]) - 1); ++m)
+			{
+				for (int q = SMAX(k - 1, 0); q <= SMIN(k + 1, int(number_of_cells_[2]) - 1); ++q)
+				{
+					CellListDataVector& target_particles = CellListDataFromIndex(Vecu(l, m, q));
+					for (size_t n = 0; n != target_particles.size(); ++n)
+					{
+						Real distance = (position - target_particles[n].second).norm();
+						if(distance < min_distance)
+						{
+							min_distance = distance;
+							nearest_entry =  target_particles[n];
+						}
+					}
+				}
+			}
+		}
+		return nearest_entry;
+	}
+	//=================================================================================================//
 }
@@ -13,21 +13,29 @@ namespace SPH {
 		size_t number_of_particles = 0;
 		Real vol = lattice_spacing_ * lattice_spacing_*lattice_spacing_;
 		Real sigma = ComputeReferenceNumberDensity();
+		/** the lattice points are queried as a batch for each slab in the first direction,
+		  * and the particles are created in the same order as the lattice. */
+		StdVec<Vec3d> slab_locations;
+		StdVec<int> is_contained;
 		for (size_t i = 0; i < number_of_lattices_[0]; ++i)
+		{
+			slab_locations.clear();
 			for (size_t j = 0; j < number_of_lattices_[1]; ++j) 
 				for (size_t k = 0; k < number_of_lattices_[2]; ++k) {
 					Point particle_location(lower_bound_[0] + (i + 0.5) * lattice_spacing_,
 						lower_bound_[1] + (j + 0.5) * lattice_spacing_,
 						lower_bound_[2] + (k + 0.5) * lattice_spacing_);
-					if (body_shape_->checkNotFar(particle_location, lattice_spacing_))
-					{
-						if (body_shape_->checkContain(particle_location))
-						{
-							base_particles->initializeABaseParticle(particle_location, vol, sigma);
-							number_of_particles++;
-						}
-					}
+					slab_locations.push_back(particle_location);
 				}
+			body_shape_->checkContainPoints(slab_locations, is_contained);
+
+			for (size_t n = 0; n != slab_locations.size(); ++n)
+				if (is_contained[n])
+				{
+					base_particles->initializeABaseParticle(slab_locations[n], vol, sigma);
+					number_of_particles++;
+				}
+		}
 
 		sph_body_->number_of_particles_ = number_of_particles;
 	}
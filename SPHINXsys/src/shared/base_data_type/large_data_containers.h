@@ -46,11 +46,88 @@ namespace SPH {
 	template <typename T>
 	using LargeVec = tbb::concurrent_vector<T>;
 
+	/** whether the value-initialization of new elements of large vectors
+	  * is deferred in the present thread, see FirstTouch. */
+	inline bool& isConstructionDeferred()
+	{
+		static thread_local bool is_deferred = false;
+		return is_deferred;
+	}
+
+	/**
+	 * @class LargeVecAllocator
+	 * @brief The cache aligned allocator of the large vectors.
+	 * The value-initialization of new elements can be deferred,
+	 * so that the memory pages are touched first by the threads which work on them later.
+	 */
 	template <typename T>
-	using StdLargeVec = std::vector<T, cache_aligned_allocator<T>>;
+	class LargeVecAllocator : public cache_aligned_allocator<T>
+	{
+	public:
+		template <typename U> struct rebind { typedef LargeVecAllocator<U> other; };
+
+		LargeVecAllocator() throw() {};
+		LargeVecAllocator(const LargeVecAllocator&) throw() {};
+		template <typename U> LargeVecAllocator(const LargeVecAllocator<U>&) throw() {};
+
+		template <typename U>
+		void construct(U* p) { if (!isConstructionDeferred()) ::new((void*)p) U(); };
+		template <typename U, typename... Args>
+		void construct(U* p, Args&&... args) { ::new((void*)p) U(std::forward<Args>(args)...); };
+	};
+
+	template <typename T>
+	using StdLargeVec = std::vector<T, LargeVecAllocator<T>>;
 
 	template <typename T>
 	using StdVec = std::vector<T>;
+
+	/**
+	 * @class FirstTouch
+	 * @brief On NUMA systems, a memory page is placed on the node of the thread which touches it first.
+	 * When enabled, the particle data and the neighbor configurations are allocated without being touched
+	 * and then written first in the static partition of the particle range,
+	 * which is also the initial partition of the parallel loops of the particle dynamics.
+	 * Together with thread pinning, most of the memory accesses of a thread are then local.
+	 * Note that it is not for vectors of bool, whose elements share bytes.
+	 */
+	class FirstTouch
+	{
+	public:
+		static void enable(bool is_enabled = true) { isEnabledFlag() = is_enabled; };
+		static bool isEnabled() { return isEnabledFlag(); };
+
+		/** reallocate a vector and copy its data by the threads of the static partition */
+		template <typename T>
+		static void relocate(StdLargeVec<T>& variable)
+		{
+			StdLargeVec<T> relocated_variable;
+			allocateUntouched(relocated_variable, variable.size());
+			parallel_for(blocked_range<size_t>(0, variable.size()),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t i = r.begin(); i != r.end(); ++i)
+						relocated_variable[i] = variable[i];
+				}, static_partitioner());
+			variable.swap(relocated_variable);
+		};
+		/** allocate a vector of the given size without touching its elements, which are written first afterwards.
+		  * The present data are discarded. */
+		template <typename T>
+		static void allocateUntouched(StdLargeVec<T>& variable, size_t size)
+		{
+			StdLargeVec<T> untouched_variable;
+			isConstructionDeferred() = true;
+			untouched_variable.resize(size);
+			isConstructionDeferred() = false;
+			variable.swap(untouched_variable);
+		};
+	protected:
+		static bool& isEnabledFlag()
+		{
+			static bool is_enabled = false;
+			return is_enabled;
+		};
+	};
 }
 
 #endif // SPHINXSYS_BASE_CONTAINER_H
\ No newline at end of file
@@ -9,20 +9,23 @@
  */
 #include "base_body.h"
 #include "sph_system.h"
+#include "body_relation.h"
 #include "in_output.h"
 #include "base_particles.h"
 #include "all_kernels.h"
 #include "mesh_cell_linked_list.h"
+#include "dynamics_profiler.h"
+#include "geometry_level_set.h"
 //=================================================================================================//
 namespace SPH
 {
 	//=================================================================================================//
 	SPHBody::SPHBody(SPHSystem &sph_system, string body_name,
 		int refinement_level, Real smoothing_length_ratio, ParticleGenerator* particle_generator) : 
-		sph_system_(sph_system), body_name_(body_name), newly_updated_(true),
+		sph_system_(sph_system), body_name_(body_name), newly_updated_(true), number_of_updates_(0),
 		body_lower_bound_(0), body_upper_bound_(0), prescribed_body_bounds_(false),
-		refinement_level_(refinement_level), particle_generator_(particle_generator),
-		body_shape_(NULL)
+		level_set_shape_(NULL), refinement_level_(refinement_level), base_particles_(NULL), particle_generator_(particle_generator),
+		body_shape_(NULL), domain_decomposition_(NULL)
 	{	
 		sph_system_.addABody(this);
 		particle_spacing_ 	= RefinementLevelToParticleSpacing();
@@ -34,6 +37,7 @@ namespace SPH
 		size_t number_of_split_cell_lists = powern(3, Vecd(0).size());
 		/** I will use concurrent vector here later after tests. */
 		split_cell_lists_.resize(number_of_split_cell_lists);
+		split_cell_list_chunks_.resize(number_of_split_cell_lists);
 	}
 	//=================================================================================================//
 	void  SPHBody::getSPHSystemBound(Vecd& system_lower_bound, Vecd& system_uppwer_bound) 
@@ -70,6 +74,22 @@ namespace SPH
 		return sph_system_;
 	}
 	//=================================================================================================//
+	ComplexShape* SPHBody::getLevelSetShape()
+	{
+		if (level_set_shape_ == NULL)
+		{
+			if (body_shape_ == NULL)
+			{
+				std::cout << "\n Error: the level set shape of " << body_name_ << " requires a body shape!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				exit(1);
+			}
+			level_set_shape_ = dynamic_cast<LevelSetComplexShape*>(body_shape_);
+			if (level_set_shape_ == NULL) level_set_shape_ = new LevelSetComplexShape(this, *body_shape_);
+		}
+		return level_set_shape_;
+	}
+	//=================================================================================================//
 	void SPHBody::assignBaseParticle(BaseParticles* base_particles)
 	{
 		base_particles_ = base_particles;
@@ -103,6 +123,12 @@ namespace SPH
 		newly_updated_ = false;
 	}
 	//=================================================================================================//
+	void SPHBody::writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays)
+	{
+		base_particles_->writeParticlesToVtuDataArrays(data_arrays);
+		newly_updated_ = false;
+	}
+	//=================================================================================================//
 	void SPHBody::writeParticlesToPltFile(ofstream &output_file)
 	{
 		if (newly_updated_) base_particles_->writeParticlesToPltFile(output_file);
@@ -119,6 +145,16 @@ namespace SPH
 		base_particles_->readParticleFromXmlForRestart(filefullpath);
 	}
 	//=================================================================================================//
+	void SPHBody::writeParticlesToBinaryCheckpoint(BinaryCheckpointWriter& checkpoint)
+	{
+		base_particles_->writeParticlesToBinaryCheckpoint(checkpoint);
+	}
+	//=================================================================================================//
+	void SPHBody::readParticlesFromBinaryCheckpoint(BinaryCheckpointReader& checkpoint)
+	{
+		base_particles_->readParticlesFromBinaryCheckpoint(checkpoint);
+	}
+	//=================================================================================================//
 	void SPHBody::writeToXmlForReloadParticle(std::string &filefullpath)
 	{
 		base_particles_->writeToXmlForReloadParticle(filefullpath);
@@ -136,7 +172,8 @@ namespace SPH
 	//=================================================================================================//
 	RealBody::RealBody(SPHSystem &sph_system, string body_name,
 		int refinement_level, Real smoothing_length_ratio, ParticleGenerator* particle_generator)
-	: SPHBody(sph_system, body_name, refinement_level, smoothing_length_ratio, particle_generator)
+	: SPHBody(sph_system, body_name, refinement_level, smoothing_length_ratio, particle_generator),
+		particle_sorting_period_(0)
 	{
 		sph_system.addARealBody(this);
 
@@ -150,9 +187,74 @@ namespace SPH
 	//=================================================================================================//
 	void RealBody::updateCellLinkedList()
 	{
+		DynamicsTiming dynamics_timing(body_name_, "cell linked list", number_of_particles_);
+		if (particle_sorting_period_ != 0 && number_of_updates_ % particle_sorting_period_ == 0)
+			sortParticlesWithMeshCellLinkedList();
+		number_of_updates_++;
+
 		mesh_cell_linked_list_->UpdateCellLists();
 	}
 	//=================================================================================================//
+	void RealBody::replaceMeshCellLinkedList(BaseMeshCellLinkedList* mesh_cell_linked_list)
+	{
+		/** the relations keep the cell linked list they are created with */
+		if (!body_relations_.empty())
+		{
+			std::cout << "\n Error: the cell linked list of " << body_name_
+				<< " is replaced after creating its relations!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+		delete mesh_cell_linked_list_;
+		mesh_cell_linked_list_ = mesh_cell_linked_list;
+		mesh_cell_linked_list_->allocateMeshDataMatrix();
+		if (base_particles_ != NULL) mesh_cell_linked_list_->assignBaseParticles(base_particles_);
+	}
+	//=================================================================================================//
+	void RealBody::useSparseMeshCellLinkedList(size_t block_width)
+	{
+		replaceMeshCellLinkedList(new SparseMeshCellLinkedList(this, sph_system_.lower_bound_,
+			sph_system_.upper_bound_, kernel_->GetCutOffRadius(), 2, block_width));
+	}
+	//=================================================================================================//
+	void RealBody::useMultilevelMeshCellLinkedList(size_t total_levels)
+	{
+		replaceMeshCellLinkedList(new MultilevelMeshCellLinkedList(this, sph_system_.lower_bound_,
+			sph_system_.upper_bound_, kernel_->GetCutOffRadius(), total_levels));
+	}
+	//=================================================================================================//
+	void RealBody::sortParticlesWithMeshCellLinkedList()
+	{
+		/** body part particles are kept by their particle ids during sorting. */
+		StdLargeVec<size_t>& particle_id = base_particles_->particle_id_;
+		for (size_t k = 0; k != body_parts_by_particle_.size(); ++k)
+		{
+			IndexVector& body_part_particles = body_parts_by_particle_[k]->body_part_particles_;
+			for (size_t i = 0; i != body_part_particles.size(); ++i)
+				body_part_particles[i] = particle_id[body_part_particles[i]];
+		}
+
+		mesh_cell_linked_list_->computingSequence(base_particles_->sequence_);
+		base_particles_->sortRealParticles();
+
+		StdLargeVec<size_t>& sorted_id = base_particles_->sorted_id_;
+		for (size_t k = 0; k != body_parts_by_particle_.size(); ++k)
+		{
+			IndexVector& body_part_particles = body_parts_by_particle_[k]->body_part_particles_;
+			for (size_t i = 0; i != body_part_particles.size(); ++i)
+				body_part_particles[i] = sorted_id[body_part_particles[i]];
+		}
+
+		/** the Verlet lists from and to this body refer to the particle indexes before sorting,
+		  * so that they are rebuilt even if the particles have hardly moved. */
+		for (size_t k = 0; k != sph_system_.bodies_.size(); ++k)
+		{
+			StdVec<SPHBodyBaseRelation*>& body_relations = sph_system_.bodies_[k]->body_relations_;
+			for (size_t l = 0; l != body_relations.size(); ++l)
+				body_relations[l]->invalidateVerletList(this);
+		}
+	}
+	//=================================================================================================//
 	RealBody* RealBody::pointToThisObject()
 	{
 		return this;
@@ -172,7 +274,8 @@ namespace SPH
 	//=================================================================================================//
 	void FictitiousBody::updateCellLinkedList()
 	{
-		/** do nothing here. */;
+		/** only counted, as the fictitious particles are not binned. */
+		number_of_updates_++;
 	}
 	//=================================================================================================//
 	FictitiousBody* FictitiousBody::pointToThisObject()
@@ -183,7 +286,6 @@ namespace SPH
 	void BodyPartByParticle::tagAParticle(size_t particle_index)
 	{
 		body_part_particles_.push_back(particle_index);
-		body_->base_particles_->is_sortable_[particle_index] = false;
 	}
 	//=================================================================================================//
 	void BodyPartByParticle::tagBodyPart()
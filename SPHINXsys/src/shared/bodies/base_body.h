@@ -55,6 +55,11 @@ namespace SPH
 	class Kernel;
 	class BaseMeshCellLinkedList;
 	class SPHBodyBaseRelation;
+	class BodyPartByParticle;
+	class VtuDataArrays;
+	class BinaryCheckpointWriter;
+	class BinaryCheckpointReader;
+	class DomainDecompositionInAxisDirection;
 
 	/**
 	 * @class SPHBody
@@ -69,12 +74,15 @@ namespace SPH
 		SPHSystem &sph_system_; 	/**< SPHSystem. */
 		string body_name_; 		/**< name of this body */
 		bool newly_updated_;		/**< whether this body is in a newly updated state */
+		size_t number_of_updates_;	/**< Number of cell linked list updates since the beginning of the simulation. */
 		/** Computational domain bounds of the body for boundary conditions. */
 		Vecd body_lower_bound_, body_upper_bound_;
 		/** Whether the computational domain bound for this body is prescribed. */
 		bool prescribed_body_bounds_;
 		/** smoothing length. */
 		Real smoothing_length_;
+		/** the body shape described by a level set, generated when it is required first. */
+		ComplexShape* level_set_shape_;
 		/** Computing particle spacing from refinement level. */
 		Real RefinementLevelToParticleSpacing();
 
@@ -99,9 +107,16 @@ namespace SPH
 		 * they have no interaction because they are too far.
 		 */
 		SplitCellLists split_cell_lists_;
+		/** the split cell lists in chunks of about equal estimated costs for the parallel sweeps,
+		  * which are partitioned together with the cost estimation by the inner configuration. */
+		SplitCellListChunks split_cell_list_chunks_;
 
 		/** all contact relations centered from this body **/
 		StdVec<SPHBodyBaseRelation*> body_relations_;
+		/** all body parts by particle, whose particle indexes are remapped after particle sorting. */
+		StdVec<BodyPartByParticle*> body_parts_by_particle_;
+		/** The decomposition distributing the particles among the ranks, NULL if the body is not decomposed. */
+		DomainDecompositionInAxisDirection* domain_decomposition_;
 
 		/**
 		 * @brief Constructor of SPHBody.
@@ -121,6 +136,12 @@ namespace SPH
 		bool checkNewlyUpdated() { return newly_updated_; };
 		void setNotNewlyUpdated() { newly_updated_ = false; };
 		SPHSystem& getSPHSystem();
+		/**
+		 * @brief The body shape probed by a level set, which is the body shape itself
+		 * if it is a level set shape already, see LevelSetComplexShape.
+		 * The queries by interpolation are much cheaper than those to the exact shape.
+		 */
+		ComplexShape* getLevelSetShape();
 
 		/** Get the name of this body for out file name. */
 		void setBodyLowerBound(Vecd lower_bound) { body_lower_bound_ = lower_bound; };
@@ -135,6 +156,7 @@ namespace SPH
 		virtual void allocateMemoryCellLinkedList() = 0;
 		/** Update cell linked list. */
 		virtual void updateCellLinkedList() = 0;
+		size_t NumberOfCellLinkedListUpdates() { return number_of_updates_; };
 		/** Allocate extra configuration memories for body buffer particles. */
 		void allocateConfigurationMemoriesForBodyBuffer();
 
@@ -147,6 +169,8 @@ namespace SPH
 
 		/** Output particle data in VTU file for visualization in Paraview. */
 		virtual void writeParticlesToVtuFile(ofstream &output_file);
+		/** Output particle data to the data arrays of a binary VTU file. */
+		virtual void writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays);
 		/** Output particle data in PLT file for visualization in Tecplot. */
 		virtual void writeParticlesToPltFile(ofstream &output_file);
 
@@ -154,6 +178,10 @@ namespace SPH
 		virtual void writeParticlesToXmlForRestart(std::string &filefullpath);
 		/** Read particle data in XML file for restart simulation. */
 		virtual void readParticlesFromXmlForRestart(std::string &filefullpath);
+		/** Output particle data to a binary checkpoint for restart simulation. */
+		virtual void writeParticlesToBinaryCheckpoint(BinaryCheckpointWriter& checkpoint);
+		/** Read particle data from a binary checkpoint for restart simulation. */
+		virtual void readParticlesFromBinaryCheckpoint(BinaryCheckpointReader& checkpoint);
 
 		/** Output particle position and volume in XML file for reloading particles. */
 		virtual void writeToXmlForReloadParticle(std::string &filefullpath);
@@ -171,7 +199,11 @@ namespace SPH
 	class RealBody : public SPHBody
 	{
 	protected:
+		/** Number of cell linked list updates between two particle sortings, 0 for no sorting. */
+		size_t particle_sorting_period_;
 
+		/** Replace the cell linked list, which is only possible before creating the relations of the body. */
+		void replaceMeshCellLinkedList(BaseMeshCellLinkedList* mesh_cell_linked_list);
 	public:
 		/** Constructor of RealBody. */
 		RealBody(SPHSystem &sph_system, string body_name, int refinement_level, Real smoothing_length_ratio, 
@@ -182,6 +214,17 @@ namespace SPH
 		virtual void allocateMemoryCellLinkedList() override;
 		/** Update cell linked list. */
 		virtual void updateCellLinkedList() override;
+		/** Set the period of particle sorting in terms of cell linked list updates. */
+		void setParticleSortingPeriod(size_t particle_sorting_period) { particle_sorting_period_ = particle_sorting_period; };
+		/** Sort the particles along the Morton curve of the cell linked list for memory locality. */
+		void sortParticlesWithMeshCellLinkedList();
+		/** Replace the dense cell linked list by a block-sparse one for large and mostly empty domains.
+		  * It should be called right after the body is constructed, before creating relations. */
+		void useSparseMeshCellLinkedList(size_t block_width = 4);
+		/** Replace the cell linked list by a multilevel one for particles with variable smoothing lengths,
+		  * the cell spacing of the middle level is the cutoff radius of the body kernel.
+		  * It should be called right after the body is constructed, before creating relations. */
+		void useMultilevelMeshCellLinkedList(size_t total_levels = 3);
 		/** The pointer to derived class object. */
 		virtual RealBody* pointToThisObject() override;
 	};
@@ -252,7 +295,10 @@ namespace SPH
 		IndexVector body_part_particles_;
 
 		BodyPartByParticle(SPHBody* body, string body_part_name)
-			: BodyPart(body, body_part_name) {};
+			: BodyPart(body, body_part_name)
+		{
+			body->body_parts_by_particle_.push_back(this);
+		};
 	virtual ~BodyPartByParticle() {};
 
 	protected:
@@ -10,45 +10,245 @@
 #include "base_kernel.h"
 #include "body_relation.h"
 #include "base_particles.h"
+#include "mesh_cell_linked_list.h"
+#include "sph_system.h"
+#include "loop_partitioner.h"
 
 namespace SPH
 {
 	//=================================================================================================//
 	SPHBodyBaseRelation::SPHBodyBaseRelation(SPHBody* sph_body)
-		: sph_body_(sph_body), split_cell_lists_(sph_body->split_cell_lists_), base_particles_(sph_body->base_particles_),
+		: skin_radius_(0.0), number_of_updates_(0), number_of_rebuilds_(0), number_of_particles_at_rebuild_(0), update_stamp_(0),
+		sph_body_(sph_body), split_cell_lists_(sph_body->split_cell_lists_), base_particles_(sph_body->base_particles_),
 		mesh_cell_linked_list_(sph_body->mesh_cell_linked_list_)
 	{
 	}
 	//=================================================================================================//
-	void SPHBodyBaseRelation::createNeighborRelation(Neighborhood& neighborhood,
-		Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index)
+	void SPHBodyBaseRelation::invalidateVerletList(SPHBody* reordered_body)
 	{
-		neighborhood.addANeighbor(kernel, vec_r_ij, i_index, j_index);
-		neighborhood.memory_size_++;
+		if (reordered_body == sph_body_)
+		{
+			number_of_particles_at_rebuild_ = 0;
+			update_stamp_ = 0;
+		}
+	}
+	//=================================================================================================//
+	size_t SPHBodyBaseRelation::computeUpdateStamp()
+	{
+		return sph_body_->NumberOfCellLinkedListUpdates() + 1;
+	}
+	//=================================================================================================//
+	void SPHBodyBaseRelation::checkVerletListOfBody(SPHBody* body)
+	{
+		if (body->domain_decomposition_ != NULL)
+		{
+			std::cout << "\n Error: the Verlet list is not available for the decomposed body "
+				<< body->GetBodyName() << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
 	}
 	//=================================================================================================//
-	void SPHBodyBaseRelation::initializeNeighborRelation(Neighborhood& neighborhood, 
-		size_t current_count_of_neighbors, Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index)
+	void SPHBodyBaseRelation::recordPositions(BaseParticles* particles, 
+		size_t number_of_particles, StdLargeVec<Vecd>& pos_at_rebuild)
 	{
-		neighborhood.j_[current_count_of_neighbors] = j_index;
-		neighborhood.W_ij_[current_count_of_neighbors] = kernel.W(vec_r_ij);
-		neighborhood.dW_ij_[current_count_of_neighbors] = kernel.dW(vec_r_ij);
-		Real r_ij = vec_r_ij.norm();
-		neighborhood.r_ij_[current_count_of_neighbors] = r_ij;
-		neighborhood.e_ij_[current_count_of_neighbors] = vec_r_ij / (r_ij + TinyReal);
+		StdLargeVec<Vecd>& pos_n = particles->pos_n_;
+		pos_at_rebuild.resize(number_of_particles);
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					pos_at_rebuild[i] = pos_n[i];
+			}, configuration_affinity_);
+	}
+	//=================================================================================================//
+	Real SPHBodyBaseRelation::computeMaximumDisplacement(BaseParticles* particles,
+		size_t number_of_particles, StdLargeVec<Vecd>& pos_at_rebuild)
+	{
+		StdLargeVec<Vecd>& pos_n = particles->pos_n_;
+		Real maximum_displacement_sqr = parallel_reduce(blocked_range<size_t>(0, number_of_particles),
+			Real(0),
+			[&](const blocked_range<size_t>& r, Real temp) -> Real {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					temp = SMAX(temp, (pos_n[i] - pos_at_rebuild[i]).normSqr());
+				return temp;
+			},
+			[](Real x, Real y) -> Real {
+				return SMAX(x, y);
+			}
+			);
+		return sqrt(maximum_displacement_sqr);
+	}
+	//=================================================================================================//
+	int SPHBodyBaseRelation::computeVerletSearchRange(BaseMeshCellLinkedList* target_mesh_cell_linked_list,
+		Real cutoff_radius, int search_range)
+	{
+		if (skin_radius_ <= 0.0) return search_range;
+		int verlet_search_range = (int)ceil((cutoff_radius + skin_radius_) 
+			/ target_mesh_cell_linked_list->CellSpacing());
+		return SMAX(search_range, verlet_search_range);
+	}
+	//=================================================================================================//
+	void SPHBodyBaseRelation::refreshConfiguration(ParticleConfiguration& configuration,
+		Kernel& kernel, Real cutoff_radius_sqr, StdLargeVec<Vecd>& target_pos_n)
+	{
+		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		StdLargeVec<size_t>& offsets = configuration.offsets_;
+		parallel_for(blocked_range<size_t>(0, number_of_particles_at_rebuild_),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					for (size_t n = offsets[i]; n != offsets[i + 1]; ++n)
+					{
+						size_t index_j = configuration.j_[n];
+						//displacement pointing from neighboring particle to origin particle
+						Vecd displacement = pos_n[i] - target_pos_n[index_j];
+						configuration.setAVerletListNeighbor(n, kernel, displacement, index_j, cutoff_radius_sqr);
+					}
+			}, configuration_affinity_);
+	}
+	//=================================================================================================//
+	bool SPHBodyBaseRelation::hasVariableSmoothingLength(BaseMeshCellLinkedList* mesh_cell_linked_list)
+	{
+		return dynamic_cast<MultilevelMeshCellLinkedList*>(mesh_cell_linked_list) != nullptr;
+	}
+	//=================================================================================================//
+	SearchLevels SPHBodyBaseRelation::getSearchLevels(BaseMeshCellLinkedList* target_mesh_cell_linked_list,
+		Real target_cutoff_radius)
+	{
+		SearchLevels search_levels;
+		MultilevelMeshCellLinkedList* multilevel_mesh_cell_linked_list
+			= dynamic_cast<MultilevelMeshCellLinkedList*>(target_mesh_cell_linked_list);
+		if (multilevel_mesh_cell_linked_list == nullptr)
+		{
+			search_levels.push_back(std::make_pair(target_mesh_cell_linked_list, target_cutoff_radius));
+			return search_levels;
+		}
+
+		for (size_t level = 0; level != multilevel_mesh_cell_linked_list->TotalLevels(); ++level)
+			search_levels.push_back(std::make_pair(multilevel_mesh_cell_linked_list->MeshCellLinkedListAtLevel(level),
+				multilevel_mesh_cell_linked_list->CutOffRadiusAtLevel(level)));
+		return search_levels;
+	}
+	//=================================================================================================//
+	void SPHBodyBaseRelation::refreshConfigurationWithVariableSmoothingLength(ParticleConfiguration& configuration,
+		Kernel& kernel, BaseParticles* target_particles)
+	{
+		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		StdLargeVec<Real>& smoothing_length = base_particles_->smoothing_length_;
+		StdLargeVec<Vecd>& target_pos_n = target_particles->pos_n_;
+		StdLargeVec<Real>& target_smoothing_length = target_particles->smoothing_length_;
+		StdLargeVec<size_t>& offsets = configuration.offsets_;
+		parallel_for(blocked_range<size_t>(0, number_of_particles_at_rebuild_),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					for (size_t n = offsets[i]; n != offsets[i + 1]; ++n)
+					{
+						size_t index_j = configuration.j_[n];
+						Real smoothing_length_ij = SMAX(smoothing_length[i], target_smoothing_length[index_j]);
+						//displacement pointing from neighboring particle to origin particle
+						Vecd displacement = pos_n[i] - target_pos_n[index_j];
+						configuration.setAVerletListNeighbor(n, kernel, 1.0 / smoothing_length_ij, displacement,
+							index_j, powern(kernel.GetCutOffRadius(smoothing_length_ij), 2));
+					}
+			}, configuration_affinity_);
 	}
 	//=================================================================================================//
 	SPHBodyInnerRelation::SPHBodyInnerRelation(SPHBody* sph_body)
-		: SPHBodyBaseRelation(sph_body)
+		: SPHBodyBaseRelation(sph_body), is_pair_configuration_requested_(false)
 	{
 		subscribe_to_body();
+		sph_body->getSPHSystem().registerARelation(this);
 		updateConfigurationMemories();
 	};
 	//=================================================================================================//
 	void SPHBodyInnerRelation::updateConfigurationMemories()
 	{
 		size_t updated_size = sph_body_->base_particles_->real_particles_bound_;
-		inner_configuration_.resize(updated_size, Neighborhood());
+		inner_configuration_.resize(updated_size);
+		if (is_pair_configuration_requested_) inner_pair_configuration_.resize(updated_size);
+	}
+	//=================================================================================================//
+	void SPHBodyInnerRelation::requestInnerPairConfiguration()
+	{
+		if (is_pair_configuration_requested_) return;
+
+		is_pair_configuration_requested_ = true;
+		inner_pair_configuration_.resize(inner_configuration_.size());
+		updateInnerPairConfiguration();
+	}
+	//=================================================================================================//
+	void SPHBodyInnerRelation::updateInnerPairConfiguration()
+	{
+		if (skin_radius_ > 0.0)
+		{
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			std::cout << "\n Inner pair configuration failure: not available for Verlet list!" << std::endl;
+			exit(1);
+		}
+
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		StdLargeVec<size_t>& offsets = inner_configuration_.offsets_;
+		StdLargeVec<size_t>& pair_offsets = inner_pair_configuration_.offsets_;
+		StdLargeVec<size_t>& j = inner_configuration_.j_;
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i) {
+					size_t number_of_pairs = 0;
+					for (size_t n = offsets[i]; n != offsets[i + 1]; ++n)
+						if (j[n] > i) number_of_pairs++;
+					pair_offsets[i + 1] = number_of_pairs;
+				}
+			}, configuration_affinity_);
+
+		inner_pair_configuration_.allocateNeighbors(number_of_particles);
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i) {
+					size_t entry_index = pair_offsets[i];
+					for (size_t n = offsets[i]; n != offsets[i + 1]; ++n)
+						if (j[n] > i)
+						{
+							inner_pair_configuration_.j_[entry_index] = j[n];
+							inner_pair_configuration_.W_ij_[entry_index] = inner_configuration_.W_ij_[n];
+							inner_pair_configuration_.dW_ij_[entry_index] = inner_configuration_.dW_ij_[n];
+							inner_pair_configuration_.r_ij_[entry_index] = inner_configuration_.r_ij_[n];
+							inner_pair_configuration_.e_ij_[entry_index] = inner_configuration_.e_ij_[n];
+							entry_index++;
+						}
+				}
+			}, configuration_affinity_);
+	}
+	//=================================================================================================//
+	bool SPHBodyInnerRelation::isVerletListValid()
+	{
+		if (skin_radius_ <= 0.0) return false;
+		checkVerletListOfBody(sph_body_);
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		if (number_of_particles != number_of_particles_at_rebuild_) return false;
+
+		return 2.0 * computeMaximumDisplacement(base_particles_, number_of_particles, pos_at_rebuild_) 
+			< skin_radius_;
+	}
+	//=================================================================================================//
+	void SPHBodyInnerRelation::updateCellListCosts()
+	{
+		StdLargeVec<size_t>& offsets = inner_configuration_.offsets_;
+		SplitCellListChunks& split_cell_list_chunks = sph_body_->split_cell_list_chunks_;
+		for (size_t k = 0; k != split_cell_lists_.size(); ++k)
+		{
+			ConcurrentCellLists& cell_lists = split_cell_lists_[k];
+			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t l = r.begin(); l != r.end(); ++l) {
+						IndexVector& particle_indexes = cell_lists[l]->real_particle_indexes_;
+						size_t cost = particle_indexes.size();
+						for (size_t i = 0; i != particle_indexes.size(); ++i)
+							cost += offsets[particle_indexes[i] + 1] - offsets[particle_indexes[i]];
+						cell_lists[l]->cost_ = cost;
+					}
+				}, configuration_affinity_);
+			LoopPartitioner::partitionCellLists(cell_lists, split_cell_list_chunks[k]);
+		}
 	}
 	//=================================================================================================//
 	SPHBodyContactRelation::SPHBodyContactRelation(SPHBody* sph_body, SPHBodyVector contact_sph_bodies)
@@ -56,7 +256,10 @@ namespace SPH
 		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k) {
 			target_mesh_cell_linked_lists_.push_back(contact_sph_bodies_[k]->mesh_cell_linked_list_);
 		}
+		target_number_of_particles_at_rebuild_.resize(contact_sph_bodies_.size(), 0);
+		target_pos_at_rebuild_.resize(contact_sph_bodies_.size());
 		subscribe_to_body();
+		sph_body->getSPHSystem().registerARelation(this);
 		updateConfigurationMemories();
 	}
 	//=================================================================================================//
@@ -65,16 +268,59 @@ namespace SPH
 		size_t updated_size = sph_body_->base_particles_->real_particles_bound_;
 		contact_configuration_.resize(contact_sph_bodies_.size());
 		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k) {
-			contact_configuration_[k].resize(updated_size, Neighborhood());
+			contact_configuration_[k].resize(updated_size);
 		}
 	}
 	//=================================================================================================//
+	bool SPHBodyContactRelation::isVerletListValid()
+	{
+		if (skin_radius_ <= 0.0) return false;
+		checkVerletListOfBody(sph_body_);
+		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k)
+			checkVerletListOfBody(contact_sph_bodies_[k]);
+		size_t number_of_particles = sph_body_->number_of_particles_;
+		if (number_of_particles != number_of_particles_at_rebuild_) return false;
+
+		Real maximum_displacement 
+			= computeMaximumDisplacement(base_particles_, number_of_particles, pos_at_rebuild_);
+		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k)
+		{
+			SPHBody* contact_body = contact_sph_bodies_[k];
+			if (contact_body->number_of_particles_ != target_number_of_particles_at_rebuild_[k]) return false;
+			Real target_maximum_displacement = computeMaximumDisplacement(contact_body->base_particles_, 
+				contact_body->number_of_particles_, target_pos_at_rebuild_[k]);
+			if (maximum_displacement + target_maximum_displacement >= skin_radius_) return false;
+		}
+		return true;
+	}
+	//=================================================================================================//
+	void SPHBodyContactRelation::invalidateVerletList(SPHBody* reordered_body)
+	{
+		SPHBodyBaseRelation::invalidateVerletList(reordered_body);
+		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k)
+			if (reordered_body == contact_sph_bodies_[k])
+			{
+				number_of_particles_at_rebuild_ = 0;
+				update_stamp_ = 0;
+			}
+	}
+	//=================================================================================================//
+	size_t SPHBodyContactRelation::computeUpdateStamp()
+	{
+		/** the sum increases as soon as any of the cell linked lists is updated */
+		size_t update_stamp = SPHBodyBaseRelation::computeUpdateStamp();
+		for (size_t k = 0; k != contact_sph_bodies_.size(); ++k)
+			update_stamp += contact_sph_bodies_[k]->NumberOfCellLinkedListUpdates();
+		return update_stamp;
+	}
+	//=================================================================================================//
 	SPHBodyComplexRelation::SPHBodyComplexRelation(SPHBody* body, SPHBodyVector contact_sph_bodies)
 		: SPHBodyBaseRelation(body),
-		inner_relation_(new SPHBodyInnerRelation(body)),
-		contact_relation_(new SPHBodyContactRelation(body, contact_sph_bodies)),
+		inner_relation_(body->getSPHSystem().getInnerRelation(body)),
+		contact_relation_(body->getSPHSystem().getContactRelation(body, contact_sph_bodies)),
 		contact_sph_bodies_(contact_sph_bodies),
 		inner_configuration_(inner_relation_->inner_configuration_),
+		inner_pair_configuration_(inner_relation_->inner_pair_configuration_),
 		contact_configuration_(contact_relation_->contact_configuration_) 
 	{
 		updateConfigurationMemories();
@@ -83,9 +329,10 @@ namespace SPH
 	SPHBodyComplexRelation::SPHBodyComplexRelation(SPHBodyInnerRelation* body_inner_relation, 
 		SPHBodyVector contact_sph_bodies) : SPHBodyBaseRelation(body_inner_relation->sph_body_),
 		inner_relation_(body_inner_relation),
-		contact_relation_(new SPHBodyContactRelation(sph_body_, contact_sph_bodies)),
+		contact_relation_(sph_body_->getSPHSystem().getContactRelation(sph_body_, contact_sph_bodies)),
 		contact_sph_bodies_(contact_sph_bodies),
 		inner_configuration_(inner_relation_->inner_configuration_),
+		inner_pair_configuration_(inner_relation_->inner_pair_configuration_),
 		contact_configuration_(contact_relation_->contact_configuration_)
 	{
 		updateConfigurationMemories();
@@ -99,8 +346,21 @@ namespace SPH
 	//=================================================================================================//
 	void SPHBodyComplexRelation::updateConfiguration()
 	{
-		inner_relation_->updateConfiguration();
-		contact_relation_->updateConfiguration();
+		size_t number_of_rebuilds 
+			= inner_relation_->NumberOfRebuilds() + contact_relation_->NumberOfRebuilds();
+		inner_relation_->updateSharedConfiguration();
+		contact_relation_->updateSharedConfiguration();
+
+		number_of_updates_++;
+		if (inner_relation_->NumberOfRebuilds() + contact_relation_->NumberOfRebuilds() 
+			!= number_of_rebuilds) number_of_rebuilds_++;
+	}
+	//=================================================================================================//
+	void SPHBodyComplexRelation::setSkinRadius(Real skin_radius)
+	{
+		skin_radius_ = skin_radius;
+		inner_relation_->setSkinRadius(skin_radius);
+		contact_relation_->setSkinRadius(skin_radius);
 	}
 	//=================================================================================================//
 }
\ No newline at end of file
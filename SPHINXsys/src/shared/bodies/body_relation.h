@@ -32,12 +32,63 @@
 
 namespace SPH
 {
+	/** the cell linked lists to be searched, each with the upper bound of the cutoff radii of its particles */
+	using SearchLevels = StdVec<std::pair<BaseMeshCellLinkedList*, Real>>;
+
 	/**
 	 * @class SPHBodyBaseRelation
-	 * @brief The relation within a SPH body or with its contact SPH bodies
+	 * @brief The relation within a SPH body or with its contact SPH bodies.
+	 * Optionally, the configuration is built as a Verlet list with the cutoff radius plus a skin radius.
+	 * It is then reused, with only the kernel values refreshed, until the particles have moved
+	 * so far that a neighbor within the cutoff radius may be missing from the list.
+	 * Note that the Verlet list is not suitable for the boundary conditions 
+	 * which insert ghost entries into the cell linked lists,
+	 * and it is rejected for decomposed bodies, whose halo particles are recreated at each step.
 	 */
 	class SPHBodyBaseRelation
 	{
+	protected:
+		Real skin_radius_;				/**< skin radius of the Verlet list, zero for rebuilding every update */
+		size_t number_of_updates_;		/**< number of configuration updates */
+		size_t number_of_rebuilds_;		/**< number of configuration updates with neighbor search */
+		size_t number_of_particles_at_rebuild_;
+		StdLargeVec<Vecd> pos_at_rebuild_;	/**< particle positions at the last neighbor search */
+		size_t update_stamp_;			/**< update stamp at the last configuration update, zero for none */
+		/** partitioner of the parallel loops updating this configuration, which is not shared
+		  * with other relations so that several configurations can be updated concurrently. */
+		affinity_partitioner configuration_affinity_;
+
+		/** the stamp of the present cell linked lists, which increases with each update of them. */
+		virtual size_t computeUpdateStamp();
+		/** record the stamp of the present cell linked lists at an update of the configuration. */
+		void recordUpdateStamp() { update_stamp_ = computeUpdateStamp(); };
+		/** exit with an error if a Verlet list is used with a decomposed body. */
+		void checkVerletListOfBody(SPHBody* body);
+		/** record the particle positions at a neighbor search. */
+		void recordPositions(BaseParticles* particles, size_t number_of_particles, 
+			StdLargeVec<Vecd>& pos_at_rebuild);
+		/** the maximum particle displacement since the last neighbor search. */
+		Real computeMaximumDisplacement(BaseParticles* particles, size_t number_of_particles,
+			StdLargeVec<Vecd>& pos_at_rebuild);
+		/** the number of cells to be searched for the cutoff radius plus the skin radius. */
+		int computeVerletSearchRange(BaseMeshCellLinkedList* target_mesh_cell_linked_list, 
+			Real cutoff_radius, int search_range);
+		/** refresh the kernel values of a Verlet list with the present particle positions. */
+		void refreshConfiguration(ParticleConfiguration& configuration, Kernel& kernel, 
+			Real cutoff_radius_sqr, StdLargeVec<Vecd>& target_pos_n);
+		/** whether the particles binned in a cell linked list have variable smoothing lengths,
+		  * i.e. the cell linked list is a multilevel one. */
+		bool hasVariableSmoothingLength(BaseMeshCellLinkedList* mesh_cell_linked_list);
+		/** all levels of a multilevel cell linked list, or the cell linked list itself otherwise. */
+		SearchLevels getSearchLevels(BaseMeshCellLinkedList* target_mesh_cell_linked_list, Real target_cutoff_radius);
+		/** refresh the kernel values of a Verlet list with the smoothing length of each pair. */
+		void refreshConfigurationWithVariableSmoothingLength(ParticleConfiguration& configuration,
+			Kernel& kernel, BaseParticles* target_particles);
+		/** apply an operation to all the neighbors of a particle with variable smoothing lengths,
+		  * for which the smoothing length of a pair is the larger one of the two particles. */
+		template<typename NeighborOperation>
+		void searchNeighborsWithVariableSmoothingLength(size_t particle_index, SearchLevels& search_levels,
+			Kernel& kernel, StdLargeVec<Real>& target_smoothing_length, NeighborOperation& neighbor_operation);
 	public:
 		SPHBody* sph_body_;
 		SplitCellLists& split_cell_lists_;
@@ -50,12 +101,19 @@ namespace SPH
 		void subscribe_to_body() { sph_body_->body_relations_.push_back(this); };
 		virtual void updateConfigurationMemories() = 0;
 		virtual void updateConfiguration() = 0;
-	protected:
-		virtual void createNeighborRelation(Neighborhood& neighborhood,
-			Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index);
-		virtual void initializeNeighborRelation(Neighborhood& neighborhood, size_t current_count_of_neighbors, 
-			Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index);
-
+		/** whether the configuration has been updated already with the present cell linked lists. */
+		bool isUpdatedAlready() { return update_stamp_ == computeUpdateStamp(); };
+		/** update the configuration unless it has been updated already with the present cell linked lists,
+		  * which is used by the complex relations for the inner and contact relations they share. */
+		void updateSharedConfiguration() { if (!isUpdatedAlready()) updateConfiguration(); };
+
+		/** set the skin radius to build the configuration as a Verlet list. */
+		virtual void setSkinRadius(Real skin_radius) { skin_radius_ = skin_radius; };
+		size_t NumberOfUpdates() { return number_of_updates_; };
+		size_t NumberOfRebuilds() { return number_of_rebuilds_; };
+		/** force a neighbor search at the next update if the particles of a body,
+		  * which is the body of the relation or a target of it, have been reordered. */
+		virtual void invalidateVerletList(SPHBody* reordered_body);
 	};
 
 	/**
@@ -67,12 +125,33 @@ namespace SPH
 	public:
 		/** inner configuration for the neighbor relations. */
 		ParticleConfiguration inner_configuration_;
+		/** inner configuration with only the neighbors j > i, for computing each particle pair once.
+		  * It is built from the inner configuration only after requested. */
+		ParticleConfiguration inner_pair_configuration_;
 
 		SPHBodyInnerRelation(SPHBody* sph_body);
 		virtual ~SPHBodyInnerRelation() {};
 
 		virtual void updateConfigurationMemories() override;
 		virtual void updateConfiguration() override;
+		/** request the inner pair configuration, which is then updated with the inner configuration. */
+		void requestInnerPairConfiguration();
+	protected:
+		bool is_pair_configuration_requested_;
+
+		/** collect the neighbors j > i from the inner configuration. */
+		void updateInnerPairConfiguration();
+		/** check whether the Verlet list is still valid for the present particle positions. */
+		bool isVerletListValid();
+		/** estimate the costs of the split cell lists from the numbers of neighbors,
+		  * and partition them into chunks of about equal costs for the parallel sweeps. */
+		void updateCellListCosts();
+		/** neighbor search across the levels of a multilevel cell linked list. */
+		void updateConfigurationWithVariableSmoothingLength(Kernel& kernel);
+		/** apply an operation to all the neighbors of a particle found from the cell linked list */
+		template<typename NeighborOperation>
+		void searchNeighbors(size_t particle_index, int search_range, Real search_radius_sqr, 
+			NeighborOperation& neighbor_operation);
 	};
 
 	/**
@@ -83,6 +162,12 @@ namespace SPH
 	{
 	protected:
 		StdVec<BaseMeshCellLinkedList*> target_mesh_cell_linked_lists_;
+		StdVec<size_t> target_number_of_particles_at_rebuild_;
+		StdVec<StdLargeVec<Vecd>> target_pos_at_rebuild_;
+
+		virtual size_t computeUpdateStamp() override;
+		/** check whether the Verlet list is still valid for the present particle positions. */
+		bool isVerletListValid();
 	public:
 		SPHBodyVector contact_sph_bodies_;
 
@@ -94,6 +179,15 @@ namespace SPH
 
 		virtual void updateConfigurationMemories() override;
 		virtual void updateConfiguration() override;
+		virtual void invalidateVerletList(SPHBody* reordered_body) override;
+	protected:
+		/** apply an operation to all the neighbors of a particle found from a target cell linked list */
+		template<typename NeighborOperation>
+		void searchNeighbors(size_t particle_index, BaseMeshCellLinkedList& target_mesh_cell_linked_list,
+			int search_range, Real search_radius_sqr, NeighborOperation& neighbor_operation);
+		/** neighbor search of a contact body across the levels of multilevel cell linked lists. */
+		void updateContactConfigurationWithVariableSmoothingLength(size_t relation_body_num,
+			Kernel& kernel, bool is_verlet_list_valid);
 	};
 
 	/**
@@ -101,6 +195,11 @@ namespace SPH
 	 * @brief The relation within a SPH body and with its contact SPH bodies.
 	 * The interaction is in a inner-boundary-condition fashion. Here inner interaction is
 	 * different from conact interaction
+	 * The inner and contact relations are shared through the registry of the SPH system,
+	 * so that a body has only one inner configuration even with several complex relations.
+	 * Note that a complex relation skips the update of a shared relation
+	 * which has been updated already after the cell linked lists are updated,
+	 * while an explicit update of a relation is always carried out.
 	 */
 	class SPHBodyComplexRelation : public SPHBodyBaseRelation
 	{
@@ -112,17 +211,20 @@ namespace SPH
 
 		/** inner configuration for the neighbor relations. */
 		ParticleConfiguration& inner_configuration_;
+		/** inner configuration with only the neighbors j > i. */
+		ParticleConfiguration& inner_pair_configuration_;
 		/** Configurations for updated Lagrangian formulation. **/
 		ContatcParticleConfiguration& contact_configuration_;
 
 		SPHBodyComplexRelation(SPHBody* body, SPHBodyVector contact_sph_bodies);
 		SPHBodyComplexRelation(SPHBodyInnerRelation* body_inner_relation, SPHBodyVector contact_sph_bodies);
-		virtual ~SPHBodyComplexRelation() {
-			delete inner_relation_;
-			delete contact_relation_;
-		};
+		/** the shared inner and contact relations are not owned by the complex relation. */
+		virtual ~SPHBodyComplexRelation() {};
 
 		virtual void updateConfigurationMemories() override;
 		virtual void updateConfiguration()  override;
+		virtual void setSkinRadius(Real skin_radius) override;
+		/** request the inner pair configuration. */
+		void requestInnerPairConfiguration() { inner_relation_->requestInnerPairConfiguration(); };
 	};
 }
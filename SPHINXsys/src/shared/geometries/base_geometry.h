@@ -36,6 +36,7 @@
 #include "sph_data_conainers.h"
 
 #include <string>
+#include <cstdint>
 using namespace std;
 
 namespace SPH
@@ -50,6 +51,26 @@ namespace SPH
 	 */
 	enum class ShapeBooleanOps { add, sub, sym_diff, intersect };
 
+	/** The initial value of a content hash, i.e. the FNV-1a offset basis. */
+	const uint64_t initial_content_hash = 14695981039346656037ULL;
+	/** FNV-1a hash updated with the given bytes, used to identify the content of shapes and files. */
+	inline uint64_t updateContentHash(uint64_t hash, const char* data, size_t data_size)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+		for (size_t i = 0; i != data_size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+	/** FNV-1a hash updated with the bytes of a value. */
+	template<typename Type>
+	uint64_t updateContentHash(uint64_t hash, const Type& value)
+	{
+		return updateContentHash(hash, reinterpret_cast<const char*>(&value), sizeof(Type));
+	}
+
 	/**
 	 * @class Shape
 	 * @brief Base class for all geometries
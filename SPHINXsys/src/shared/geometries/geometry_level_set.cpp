@@ -19,10 +19,47 @@ namespace SPH {
 		Vecd lower_bound, upper_bound;
 		findBounds(lower_bound, upper_bound);
 		Real mesh_spacing = 4.0 * sph_body->particle_spacing_;
-		level_set_ = new LevelSet(complex_shape, lower_bound, upper_bound,	mesh_spacing, 4	);
-		if (isCleaned) level_set_->cleanInterface();
+		size_t buffer_width = 4;
+		LevelSet* level_set = new LevelSet(complex_shape, lower_bound, upper_bound, mesh_spacing, buffer_width, false);
+		level_set_ = level_set;
 
-		In_Output in_output(sph_body->getSPHSystem());
+		/** the key identifies the shape and all parameters of the level set */
+		SPHSystem& sph_system = sph_body->getSPHSystem();
+		uint64_t cache_key = complex_shape.ContentHash();
+		cache_key = updateContentHash(cache_key, lower_bound);
+		cache_key = updateContentHash(cache_key, upper_bound);
+		cache_key = updateContentHash(cache_key, mesh_spacing);
+		cache_key = updateContentHash(cache_key, uint64_t(buffer_width));
+		cache_key = updateContentHash(cache_key, isCleaned);
+		string cache_filefullpath = sph_system.level_set_cache_folder_ + "/" + name_ + "_levelset.cache";
+		if (sph_system.use_level_set_cache_ && level_set->readFromCacheFile(cache_filefullpath, cache_key))
+		{
+			std::cout << "\n The level set of " << name_ << " is reloaded from " << cache_filefullpath << std::endl;
+		}
+		else
+		{
+			level_set->initializeDataPackages();
+			if (isCleaned) level_set->cleanInterface();
+			if (sph_system.use_level_set_cache_)
+			{
+				fs_error_code error_code;
+				if (!fs::exists(sph_system.level_set_cache_folder_, error_code))
+				{
+					fs::create_directory(sph_system.level_set_cache_folder_, error_code);
+				}
+				if (error_code)
+				{
+					std::cout << "\n Warning: the level set cache folder " << sph_system.level_set_cache_folder_
+						<< " cannot be created: " << error_code.message() << ", the level set is not cached." << std::endl;
+				}
+				else
+				{
+					level_set->writeToCacheFile(cache_filefullpath, cache_key);
+				}
+			}
+		}
+
+		In_Output in_output(sph_system);
 		WriteLevelSetToPlt 	write_level_set(in_output, { sph_body }, level_set_);
 		write_level_set.WriteToFile(0.0);
 	}
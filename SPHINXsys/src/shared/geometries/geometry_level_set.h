@@ -18,7 +18,9 @@ namespace SPH {
 	/**
 	 * @class LevelSetComplexShape
 	 * @brief the final geomtrical definition of the SPHBody based on a narrow band level set function
-	 * generated from the original ComplexShape
+	 * generated from the original ComplexShape.
+	 * The level set is saved to the level set cache folder of the system and reloaded by later runs
+	 * with the same shape, particle spacing and cleaning, see SPHSystem::use_level_set_cache_.
 	 */
 	class LevelSetComplexShape : public ComplexShape
 	{
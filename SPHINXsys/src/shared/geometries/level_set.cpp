@@ -6,6 +6,7 @@
 
 #include "level_set.h"
 #include "base_body.h"
+#include "sph_system.h"
 
 namespace SPH {
 	//=================================================================================================//
@@ -55,7 +56,7 @@ namespace SPH {
 	//=================================================================================================//
 	LevelSet
 		::LevelSet(ComplexShape& complex_shape, 
-			Vecd lower_bound, Vecd upper_bound, Real grid_spacing, size_t buffer_width)
+			Vecd lower_bound, Vecd upper_bound, Real grid_spacing, size_t buffer_width, bool is_data_initialized)
 		: MeshWithDataPackages<BaseLevelSet, LevelSetDataPackage>(lower_bound,
 			upper_bound, grid_spacing, buffer_width), complex_shape_(complex_shape)
 	{
@@ -66,7 +67,7 @@ namespace SPH {
 		LevelSetDataPackage* positive_far_field = new LevelSetDataPackage();
 		positive_far_field->initializeWithUniformData(far_field_distance, Vecd(0));
 		singular_data_pkgs_addrs.push_back(positive_far_field);
-		initializeDataPackages();
+		if (is_data_initialized) initializeDataPackages();
 	}
 	//=================================================================================================//
 	void LevelSet::initializeDataPackages()
@@ -150,5 +151,167 @@ namespace SPH {
 		updateNormalDirection();
 	}
 	//=============================================================================================//
+	const char LevelSet::cache_magic_[8] = { 'S', 'P', 'H', 'L', 'S', 'E', 'T', '\0' };
+	//=============================================================================================//
+	void LevelSet::writeToCacheFile(string filefullpath, uint64_t cache_key)
+	{
+		/** the cache is written to a temporary file first so that an interrupted writing
+		 *  does not leave a corrupted cache behind */
+		string temporary_filefullpath = filefullpath + ".tmp";
+		std::ofstream out_file(temporary_filefullpath.c_str(), ios::trunc | ios::binary);
+		uint64_t checksum = initial_content_hash;
+		writeACacheValue(out_file, checksum, cache_magic_);
+		writeACacheValue(out_file, checksum, uint32_t(cache_version_));
+		writeACacheValue(out_file, checksum, uint32_t(Vecd(0).size()));
+		writeACacheValue(out_file, checksum, uint32_t(sizeof(Real)));
+		writeACacheValue(out_file, checksum, cache_key);
+		writeACacheValue(out_file, checksum, mesh_lower_bound_);
+		writeACacheValue(out_file, checksum, number_of_cells_);
+		writeACacheValue(out_file, checksum, cell_spacing_);
+		writeACacheValue(out_file, checksum, uint64_t(buffer_width_));
+
+		MeshFunctor write_a_cell = [&](Vecu cell_index, Real dt)
+		{
+			LevelSetDataPackage* data_pkg = DataPackageInACell(cell_index);
+			if (data_pkg == singular_data_pkgs_addrs[0])
+			{
+				writeACacheValue(out_file, checksum, uint32_t(negative_far_field));
+			}
+			else if (data_pkg == singular_data_pkgs_addrs[1])
+			{
+				writeACacheValue(out_file, checksum, uint32_t(positive_far_field));
+			}
+			else
+			{
+				writeACacheValue(out_file, checksum, uint32_t(data_package));
+				writeACacheValue(out_file, checksum, uint32_t(data_pkg->is_core_pkg_));
+				writeACacheValue(out_file, checksum, uint32_t(data_pkg->is_inner_pkg_));
+				writeACacheValue(out_file, checksum, data_pkg->phi_);
+				writeACacheValue(out_file, checksum, data_pkg->n_);
+				writeACacheValue(out_file, checksum, data_pkg->kappa_);
+				writeACacheValue(out_file, checksum, data_pkg->near_interface_id_);
+			}
+		};
+		MeshIterator(Vecu(0), number_of_cells_, write_a_cell);
+		out_file.write(reinterpret_cast<const char*>(&checksum), sizeof(uint64_t));
+		out_file.close();
+
+		/** the cache is optional, so that a failed writing only leaves the level set uncached */
+		fs_error_code error_code;
+		if (!out_file.good())
+		{
+			std::cout << "\n Warning: writing the level set cache " << temporary_filefullpath
+				<< " failed, the level set is not cached." << std::endl;
+			fs::remove(temporary_filefullpath, error_code);
+			return;
+		}
+		/** the previous cache is replaced by the rename, so that it is never missing in between */
+		fs::rename(temporary_filefullpath, filefullpath, error_code);
+		if (error_code)
+		{
+			std::cout << "\n Warning: the level set cache " << filefullpath << " cannot be replaced: "
+				<< error_code.message() << ", the level set is not cached." << std::endl;
+			fs::remove(temporary_filefullpath, error_code);
+		}
+	}
+	//=============================================================================================//
+	bool LevelSet::readFromCacheFile(string filefullpath, uint64_t cache_key)
+	{
+		std::ifstream in_file(filefullpath.c_str(), ios::binary | ios::ate);
+		if (!in_file.is_open()) return false;
+		size_t file_size = size_t(in_file.tellg());
+		if (file_size < sizeof(uint64_t)) return false;
+		StdVec<char> data(file_size);
+		in_file.seekg(0, ios::beg);
+		in_file.read(data.data(), file_size);
+		in_file.close();
+
+		uint64_t checksum;
+		size_t data_size = file_size - sizeof(uint64_t);
+		memcpy(reinterpret_cast<char*>(&checksum), data.data() + data_size, sizeof(uint64_t));
+		data.resize(data_size);
+		if (checksum != updateContentHash(initial_content_hash, data.data(), data_size)) return false;
+
+		size_t position = 0;
+		char magic[8];
+		uint32_t version, dimension, real_size;
+		uint64_t key, buffer_width;
+		Vecd mesh_lower_bound;
+		Vecu number_of_cells;
+		Real cell_spacing;
+		if (!readACacheValue(data, position, magic) || memcmp(magic, cache_magic_, 8) != 0) return false;
+		if (!readACacheValue(data, position, version) || version != cache_version_) return false;
+		if (!readACacheValue(data, position, dimension) || dimension != uint32_t(Vecd(0).size())) return false;
+		if (!readACacheValue(data, position, real_size) || real_size != uint32_t(sizeof(Real))) return false;
+		if (!readACacheValue(data, position, key) || key != cache_key) return false;
+		if (!readACacheValue(data, position, mesh_lower_bound) || !readACacheValue(data, position, number_of_cells)
+			|| !readACacheValue(data, position, cell_spacing) || !readACacheValue(data, position, buffer_width))
+			return false;
+		for (int n = 0; n != Vecd(0).size(); ++n)
+			if (mesh_lower_bound[n] != mesh_lower_bound_[n] || number_of_cells[n] != number_of_cells_[n]) return false;
+		if (cell_spacing != cell_spacing_ || buffer_width != uint64_t(buffer_width_)) return false;
+
+		/** the records of all cells are checked before any package is allocated */
+		StdVec<uint32_t> cell_tags;
+		StdVec<size_t> cell_positions;
+		bool is_valid = true;
+		MeshFunctor check_a_cell = [&](Vecu cell_index, Real dt)
+		{
+			uint32_t tag = negative_far_field;
+			if (!is_valid || !readACacheValue(data, position, tag) || tag > data_package)
+			{
+				is_valid = false;
+				return;
+			}
+			cell_tags.push_back(tag);
+			cell_positions.push_back(position);
+			if (tag == data_package)
+			{
+				position += 2 * sizeof(uint32_t) + sizeof(LevelSetDataPackage::PackageData<Real>)
+					+ sizeof(LevelSetDataPackage::PackageData<Vecd>) + sizeof(LevelSetDataPackage::PackageData<Real>)
+					+ sizeof(LevelSetDataPackage::PackageData<int>);
+				if (position > data.size()) is_valid = false;
+			}
+		};
+		MeshIterator(Vecu(0), number_of_cells_, check_a_cell);
+		if (!is_valid || position != data.size()) return false;
+
+		size_t cell_number = 0;
+		MeshFunctor read_a_cell = [&](Vecu cell_index, Real dt)
+		{
+			uint32_t tag = cell_tags[cell_number];
+			size_t record_position = cell_positions[cell_number];
+			cell_number++;
+			if (tag != data_package)
+			{
+				assignDataPackageToACell(cell_index, singular_data_pkgs_addrs[tag]);
+				return;
+			}
+
+			LevelSetDataPackage* new_data_pkg = data_pkg_pool_.malloc();
+			Vecd cell_position = CellPositionFromIndexes(cell_index);
+			Vecd pkg_lower_bound = GridPositionFromCellPosition(cell_position);
+			new_data_pkg->initializePackageGeometry(pkg_lower_bound, data_spacing_);
+			new_data_pkg->pkg_index_ = cell_index;
+			uint32_t is_core_pkg, is_inner_pkg;
+			readACacheValue(data, record_position, is_core_pkg);
+			readACacheValue(data, record_position, is_inner_pkg);
+			readACacheValue(data, record_position, new_data_pkg->phi_);
+			readACacheValue(data, record_position, new_data_pkg->n_);
+			readACacheValue(data, record_position, new_data_pkg->kappa_);
+			readACacheValue(data, record_position, new_data_pkg->near_interface_id_);
+			new_data_pkg->is_core_pkg_ = is_core_pkg != 0;
+			new_data_pkg->is_inner_pkg_ = is_inner_pkg != 0;
+			if (new_data_pkg->is_core_pkg_) core_data_pkgs_.push_back(new_data_pkg);
+			if (new_data_pkg->is_inner_pkg_) inner_data_pkgs_.push_back(new_data_pkg);
+			assignDataPackageToACell(cell_index, new_data_pkg);
+		};
+		MeshIterator(Vecu(0), number_of_cells_, read_a_cell);
+
+		MeshFunctor initial_address_in_a_cell = std::bind(&LevelSet::initializeAddressesInACell, this, _1, _2);
+		MeshIterator_parallel(Vecu(0), number_of_cells_, initial_address_in_a_cell);
+		return true;
+	}
+	//=============================================================================================//
 	
 }
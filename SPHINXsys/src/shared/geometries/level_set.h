@@ -40,6 +40,9 @@
 #include "geometry.h"
 #include "base_mesh.hpp"
 
+#include <fstream>
+#include <cstring>
+
 namespace SPH
 {
 	/**
@@ -167,7 +170,8 @@ namespace SPH
 			Vecd lower_bound,      /**< Lower bound. */
 			Vecd upper_bound, 		/**< Upper bound. */
 			Real grid_spacing, 	/**< Grid spcaing. */
-			size_t buffer_width = 0 /**< Buffer size. */
+			size_t buffer_width = 0, /**< Buffer size. */
+			bool is_data_initialized = true /**< If false, the packages are given later by initializeDataPackages or a cache file. */
 		);
 		virtual ~LevelSet() {};
 
@@ -175,6 +179,20 @@ namespace SPH
 		 *@brief This function initialize the Levelset data package.
 		 */
 		virtual void initializeDataPackages() override;
+		/**
+		 *@brief This function writes the data packages and their layout on the mesh to a binary cache file.
+		 *@param[in] filefullpath(string) The cache file.
+		 *@param[in] cache_key(uint64_t) The key identifying the geometry and the parameters of the level set.
+		 */
+		void writeToCacheFile(string filefullpath, uint64_t cache_key);
+		/**
+		 *@brief This function reads the data packages from a cache file into a level set without data packages.
+		 * It returns false, and nothing is changed, if the file is missing, corrupted,
+		 * or written for another key or another mesh.
+		 *@param[in] filefullpath(string) The cache file.
+		 *@param[in] cache_key(uint64_t) The key identifying the geometry and the parameters of the level set.
+		 */
+		bool readFromCacheFile(string filefullpath, uint64_t cache_key);
 		/**
 		 *@brief This function probe the level set at a off-grid position.
 		 *@param[in] position(Vecd) The enquiry postion
@@ -247,6 +265,26 @@ namespace SPH
 		void markNearInterfaceForAPackage(LevelSetDataPackage* core_data_pkg, Real dt = 0.0);
 		void redistanceInterfaceForAPackage(LevelSetDataPackage* core_data_pkg, Real dt = 0.0);
 
+		/** write a value to a cache file and update the checksum with it */
+		template<typename Type>
+		void writeACacheValue(std::ofstream& out_file, uint64_t& checksum, const Type& value)
+		{
+			out_file.write(reinterpret_cast<const char*>(&value), sizeof(Type));
+			checksum = updateContentHash(checksum, value);
+		};
+		/** read a value from the data of a cache file, return false at the end of the data */
+		template<typename Type>
+		bool readACacheValue(StdVec<char>& data, size_t& position, Type& value)
+		{
+			if (position + sizeof(Type) > data.size()) return false;
+			memcpy(reinterpret_cast<char*>(&value), data.data() + position, sizeof(Type));
+			position += sizeof(Type);
+			return true;
+		};
+		/** Tags of the cells in a cache file. */
+		enum CacheCellTag : uint32_t { negative_far_field = 0, positive_far_field = 1, data_package = 2 };
+		static const char cache_magic_[8];
+		static const uint32_t cache_version_ = 1;
 	};
 }
 
@@ -33,6 +33,10 @@ capabilities. **/
 #include "all_meshes.h"
 #include "all_types_of_bodies.h"
 #include "sph_system.h"
+#include "dynamics_task_graph.h"
+#include "multi_rate_integrator.h"
+#include "mpi_environment.h"
+#include "thread_pinning.h"
 #include "all_materials.h"
 #include "all_physical_dynamics.h"
 #include "all_simbody.h"
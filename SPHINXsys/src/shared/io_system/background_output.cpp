@@ -0,0 +1,98 @@
+/**
+ * @file 	background_output.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "background_output.h"
+
+namespace SPH
+{
+	//=================================================================================================//
+	BackgroundOutput::BackgroundOutput(size_t number_of_buffers)
+		: number_of_buffers_(number_of_buffers), is_terminated_(false), is_busy_(false)
+	{
+		if (isAsynchronous()) writer_ = std::thread(&BackgroundOutput::writeInBackground, this);
+	}
+	//=================================================================================================//
+	BackgroundOutput::~BackgroundOutput()
+	{
+		if (isAsynchronous())
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				is_terminated_ = true;
+			}
+			task_condition_.notify_one();
+			writer_.join();
+		}
+
+		for (size_t l = 0; l != files_.size(); ++l)
+		{
+			files_[l]->close();
+			delete files_[l];
+		}
+	}
+	//=================================================================================================//
+	void BackgroundOutput::writeInBackground()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				task_condition_.wait(lock, [&]() { return is_terminated_ || !tasks_.empty(); });
+				/** the queue is always emptied before termination */
+				if (tasks_.empty()) return;
+				task = tasks_.front();
+				tasks_.pop_front();
+				is_busy_ = true;
+			}
+			buffer_condition_.notify_all();
+
+			task();
+
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				is_busy_ = false;
+			}
+			buffer_condition_.notify_all();
+		}
+	}
+	//=================================================================================================//
+	ofstream* BackgroundOutput::openAFile(string filefullpath, ios_base::openmode mode)
+	{
+		ofstream* out_file = new ofstream(filefullpath.c_str(), mode);
+		std::unique_lock<std::mutex> lock(mutex_);
+		files_.push_back(out_file);
+		return out_file;
+	}
+	//=================================================================================================//
+	void BackgroundOutput::addATask(const std::function<void()>& task)
+	{
+		if (!isAsynchronous())
+		{
+			task();
+			return;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			buffer_condition_.wait(lock, [&]() { return tasks_.size() < number_of_buffers_; });
+			tasks_.push_back(task);
+		}
+		task_condition_.notify_one();
+	}
+	//=================================================================================================//
+	void BackgroundOutput::flush()
+	{
+		if (isAsynchronous())
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			buffer_condition_.wait(lock, [&]() { return tasks_.empty() && !is_busy_; });
+		}
+
+		for (size_t l = 0; l != files_.size(); ++l) files_[l]->flush();
+	}
+	//=================================================================================================//
+}
@@ -0,0 +1,82 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	background_output.h
+ * @brief 	A background thread which writes output files,
+ * so that the simulation continues while the previous output is formatted and flushed.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "sph_data_conainers.h"
+
+#include <fstream>
+#include <string>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+namespace SPH {
+
+	/**
+	 * @class BackgroundOutput
+	 * @brief Output tasks are queued and carried out in order by a background thread.
+	 * A task only works on the snapshot of data it owns and on the files opened by this class.
+	 * The number of buffers bounds the number of queued snapshots,
+	 * i.e. the simulation waits when all buffers are occupied.
+	 * With zero buffers, the tasks are carried out immediately in the calling thread.
+	 * All queued tasks are finished and the files are closed at destruction.
+	 */
+	class BackgroundOutput
+	{
+	protected:
+		size_t number_of_buffers_;
+		bool is_terminated_;
+		bool is_busy_;
+		std::deque<std::function<void()>> tasks_;
+		std::mutex mutex_;
+		std::condition_variable task_condition_;
+		std::condition_variable buffer_condition_;
+		std::thread writer_;
+		StdVec<ofstream*> files_;
+
+		/** The loop of the background thread. */
+		void writeInBackground();
+	public:
+		explicit BackgroundOutput(size_t number_of_buffers = 0);
+		virtual ~BackgroundOutput();
+
+		bool isAsynchronous() { return number_of_buffers_ != 0; };
+		/** Open a file which is kept open and closed after all tasks are finished. */
+		ofstream* openAFile(string filefullpath, ios_base::openmode mode = ios::app);
+		/** Queue a task, waiting for a free buffer if necessary. */
+		void addATask(const std::function<void()>& task);
+		/** Wait until all queued tasks are finished and flush the files. */
+		void flush();
+	};
+}
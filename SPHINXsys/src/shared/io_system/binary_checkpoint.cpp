@@ -0,0 +1,163 @@
+/**
+ * @file 	binary_checkpoint.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "binary_checkpoint.h"
+
+namespace SPH
+{
+	//=================================================================================================//
+	const char BinaryCheckpoint::magic_[8] = { 'S', 'P', 'H', 'C', 'K', 'P', 'T', '\0' };
+	//=================================================================================================//
+	uint64_t BinaryCheckpoint::updateChecksum(uint64_t checksum, const char* data, size_t data_size)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+		for (size_t i = 0; i != data_size; ++i)
+		{
+			checksum ^= bytes[i];
+			checksum *= 1099511628211ULL;
+		}
+		return checksum;
+	}
+	//=================================================================================================//
+	BinaryCheckpointWriter::BinaryCheckpointWriter(string filefullpath, Real physical_time)
+		: out_file_(filefullpath.c_str(), ios::trunc | ios::binary), checksum_(initialChecksum())
+	{
+		Vecd zero(0);
+		writeBytes(magic_, 8);
+		writeAValue<uint32_t>(version_);
+		writeAValue<uint32_t>(uint32_t(zero.size()));
+		writeAValue<uint32_t>(uint32_t(sizeof(Real)));
+		writeAValue<uint32_t>(0);
+		writeAValue<double>(double(physical_time));
+	}
+	//=================================================================================================//
+	void BinaryCheckpointWriter::writeBytes(const char* data, size_t data_size)
+	{
+		out_file_.write(data, data_size);
+		checksum_ = updateChecksum(checksum_, data, data_size);
+	}
+	//=================================================================================================//
+	void BinaryCheckpointWriter::writeAString(string name)
+	{
+		writeAValue<uint64_t>(name.size());
+		writeBytes(name.data(), name.size());
+	}
+	//=================================================================================================//
+	void BinaryCheckpointWriter::writeABodyHead(string body_name, size_t number_of_particles)
+	{
+		writeAValue<uint32_t>(body_record);
+		writeAString(body_name);
+		writeAValue<uint64_t>(number_of_particles);
+	}
+	//=================================================================================================//
+	bool BinaryCheckpointWriter::finish()
+	{
+		writeAValue<uint32_t>(end_record);
+		uint64_t checksum = checksum_;
+		out_file_.write(reinterpret_cast<const char*>(&checksum), sizeof(uint64_t));
+		out_file_.close();
+		return !out_file_.fail();
+	}
+	//=================================================================================================//
+	BinaryCheckpointReader::BinaryCheckpointReader(string filefullpath)
+		: filefullpath_(filefullpath), position_(0), physical_time_(0.0)
+	{
+		std::ifstream in_file(filefullpath.c_str(), ios::binary | ios::ate);
+		if (!in_file.is_open()) readError("the file cannot be opened");
+		size_t file_size = size_t(in_file.tellg());
+		if (file_size < header_size_ + sizeof(uint32_t) + sizeof(uint64_t)) readError("the file is too short");
+
+		/** the whole file is read at once and the arrays are copied from it afterwards */
+		data_.resize(file_size);
+		in_file.seekg(0, ios::beg);
+		in_file.read(data_.data(), file_size);
+		in_file.close();
+
+		size_t data_size = file_size - sizeof(uint64_t);
+		uint64_t checksum;
+		memcpy(&checksum, data_.data() + data_size, sizeof(uint64_t));
+		if (checksum != updateChecksum(initialChecksum(), data_.data(), data_size)) 
+			readError("the checksum does not match, the file is corrupted");
+
+		char magic[8];
+		readBytes(magic, 8);
+		if (memcmp(magic, magic_, 8) != 0) readError("the file is not a binary checkpoint");
+		if (readAValue<uint32_t>() != version_) readError("the version of the checkpoint is not supported");
+		Vecd zero(0);
+		if (readAValue<uint32_t>() != uint32_t(zero.size())) readError("the dimension does not match");
+		if (readAValue<uint32_t>() != uint32_t(sizeof(Real))) readError("the size of Real does not match");
+		readAValue<uint32_t>();
+		physical_time_ = Real(readAValue<double>());
+
+		BodyEntry* body_entry = nullptr;
+		while (true)
+		{
+			uint32_t tag = readAValue<uint32_t>();
+			if (tag == end_record) break;
+			if (tag == body_record)
+			{
+				string body_name = readAString();
+				body_entry = &bodies_[body_name];
+				body_entry->number_of_particles_ = size_t(readAValue<uint64_t>());
+			}
+			else if (tag == array_record && body_entry != nullptr)
+			{
+				string array_name = readAString();
+				ArrayEntry& array_entry = body_entry->arrays_[array_name];
+				array_entry.element_size_ = size_t(readAValue<uint64_t>());
+				array_entry.number_of_elements_ = size_t(readAValue<uint64_t>());
+				array_entry.offset_ = position_;
+				size_t array_size = array_entry.element_size_ * array_entry.number_of_elements_;
+				if (position_ + array_size > data_size) readError("an array exceeds the file");
+				position_ += array_size;
+			}
+			else readError("the record is not recognized");
+		}
+	}
+	//=================================================================================================//
+	void BinaryCheckpointReader::readError(string message)
+	{
+		std::cout << "\n Error: reading the checkpoint " << filefullpath_ << " failed, " << message << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		exit(1);
+	}
+	//=================================================================================================//
+	void BinaryCheckpointReader::readBytes(char* data, size_t data_size)
+	{
+		if (position_ + data_size > data_.size() - sizeof(uint64_t)) readError("unexpected end of the data");
+		memcpy(data, data_.data() + position_, data_size);
+		position_ += data_size;
+	}
+	//=================================================================================================//
+	string BinaryCheckpointReader::readAString()
+	{
+		size_t string_size = size_t(readAValue<uint64_t>());
+		if (position_ + string_size > data_.size() - sizeof(uint64_t)) readError("unexpected end of the data");
+		string name(data_.data() + position_, string_size);
+		position_ += string_size;
+		return name;
+	}
+	//=================================================================================================//
+	BinaryCheckpointReader::ArrayEntry* BinaryCheckpointReader
+		::findAnArray(string body_name, string array_name, size_t element_size)
+	{
+		map<string, BodyEntry>::iterator body_entry = bodies_.find(body_name);
+		if (body_entry == bodies_.end()) readError("the body " + body_name + " is not found");
+		map<string, ArrayEntry>::iterator array_entry = body_entry->second.arrays_.find(array_name);
+		if (array_entry == body_entry->second.arrays_.end()) return nullptr;
+		if (array_entry->second.element_size_ != element_size) 
+			readError("the element size of " + array_name + " does not match");
+		return &array_entry->second;
+	}
+	//=================================================================================================//
+	size_t BinaryCheckpointReader::NumberOfParticles(string body_name)
+	{
+		map<string, BodyEntry>::iterator body_entry = bodies_.find(body_name);
+		if (body_entry == bodies_.end()) readError("the body " + body_name + " is not found");
+		return body_entry->second.number_of_particles_;
+	}
+	//=================================================================================================//
+}
@@ -0,0 +1,170 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	binary_checkpoint.h
+ * @brief 	The binary checkpoint format for restart.
+ * A checkpoint file has a header with the schema version, the dimension 
+ * and the size of Real and the physical time, then, for each body, 
+ * the body name, the number of particles and the raw contiguous arrays of 
+ * the registered particle variables. It ends with a checksum of all the data before. 
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+#include "sph_data_conainers.h"
+
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+namespace SPH {
+
+	/** The formats of restart files, i.e. the XML files of each body and one binary checkpoint for all bodies. */
+	enum class RestartFormat { xml, binary };
+
+	/**
+	 * @class BinaryCheckpoint
+	 * @brief The definitions shared by the writer and the reader of binary checkpoints.
+	 */
+	class BinaryCheckpoint
+	{
+	protected:
+		/** Tags of the records after the header. */
+		enum RecordTag : uint32_t { body_record = 1, array_record = 2, end_record = 3 };
+		static const char magic_[8];
+		static const uint32_t version_ = 1;
+		/** Header: magic, version, dimension, size of Real, reserved and physical time. */
+		static const size_t header_size_ = 8 + 4 * sizeof(uint32_t) + sizeof(double);
+
+		/** FNV-1a hash, which is updated with the given bytes. */
+		static uint64_t updateChecksum(uint64_t checksum, const char* data, size_t data_size);
+		static uint64_t initialChecksum() { return 14695981039346656037ULL; };
+	public:
+		BinaryCheckpoint() {};
+		virtual ~BinaryCheckpoint() {};
+	};
+
+	/**
+	 * @class BinaryCheckpointWriter
+	 * @brief Write bodies and their particle arrays into a binary checkpoint file.
+	 */
+	class BinaryCheckpointWriter : public BinaryCheckpoint
+	{
+	protected:
+		std::ofstream out_file_;
+		uint64_t checksum_;
+
+		void writeBytes(const char* data, size_t data_size);
+		void writeAString(string name);
+		template<typename Type>
+		void writeAValue(Type value)
+		{
+			writeBytes(reinterpret_cast<const char*>(&value), sizeof(Type));
+		};
+	public:
+		BinaryCheckpointWriter(string filefullpath, Real physical_time);
+		virtual ~BinaryCheckpointWriter() {};
+
+		/** Start the records of a body. */
+		void writeABodyHead(string body_name, size_t number_of_particles);
+		/** Write the first number_of_elements elements of an array. */
+		template<typename VariableType>
+		void writeAnArray(string array_name, StdLargeVec<VariableType>& variable, size_t number_of_elements)
+		{
+			writeAValue<uint32_t>(array_record);
+			writeAString(array_name);
+			writeAValue<uint64_t>(sizeof(VariableType));
+			writeAValue<uint64_t>(number_of_elements);
+			writeBytes(reinterpret_cast<const char*>(variable.data()), number_of_elements * sizeof(VariableType));
+		};
+		/** Write the end record and the checksum and close the file.
+		  * Return false if any writing to the file has failed, e.g. when the disk is full. */
+		bool finish();
+	};
+
+	/**
+	 * @class BinaryCheckpointReader
+	 * @brief Read a binary checkpoint file as a whole, 
+	 * verify it and copy the arrays to particle variables.
+	 */
+	class BinaryCheckpointReader : public BinaryCheckpoint
+	{
+	protected:
+		/** Location of an array in the data. */
+		struct ArrayEntry
+		{
+			size_t offset_;
+			size_t element_size_;
+			size_t number_of_elements_;
+		};
+		/** The number of particles and the arrays of a body. */
+		struct BodyEntry
+		{
+			size_t number_of_particles_;
+			map<string, ArrayEntry> arrays_;
+		};
+
+		string filefullpath_;
+		StdVec<char> data_;
+		size_t position_;
+		Real physical_time_;
+		map<string, BodyEntry> bodies_;
+
+		void readError(string message);
+		void readBytes(char* data, size_t data_size);
+		string readAString();
+		template<typename Type>
+		Type readAValue()
+		{
+			Type value;
+			readBytes(reinterpret_cast<char*>(&value), sizeof(Type));
+			return value;
+		};
+		/** Find the array of a body, checking the element size. */
+		ArrayEntry* findAnArray(string body_name, string array_name, size_t element_size);
+	public:
+		explicit BinaryCheckpointReader(string filefullpath);
+		virtual ~BinaryCheckpointReader() {};
+
+		Real PhysicalTime() { return physical_time_; };
+		/** The number of particles of a body in the checkpoint. */
+		size_t NumberOfParticles(string body_name);
+		/** Copy an array to a variable, return false if the array is not in the checkpoint. */
+		template<typename VariableType>
+		bool readAnArray(string body_name, string array_name, StdLargeVec<VariableType>& variable)
+		{
+			ArrayEntry* array_entry = findAnArray(body_name, array_name, sizeof(VariableType));
+			if (array_entry == nullptr) return false;
+
+			size_t number_of_elements = SMIN(array_entry->number_of_elements_, variable.size());
+			memcpy(reinterpret_cast<char*>(variable.data()), 
+				data_.data() + array_entry->offset_, number_of_elements * sizeof(VariableType));
+			return true;
+		};
+	};
+}
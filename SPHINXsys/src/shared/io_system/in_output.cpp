@@ -12,8 +12,8 @@
 namespace SPH 
 {
 	//=============================================================================================//
-	In_Output::In_Output(SPHSystem &sph_system)
-		: sph_system_(sph_system)
+	In_Output::In_Output(SPHSystem &sph_system, size_t number_of_output_buffers)
+		: sph_system_(sph_system), background_output_(number_of_output_buffers)
 	{
 		output_folder_ = sph_system.output_folder_;
 		restart_folder_ = sph_system.restart_folder_;
@@ -34,6 +34,11 @@ namespace SPH
 				{
 					fs::remove(filefullpath);
 				}
+				if (vtu_format_ != VtuFormat::ascii)
+				{
+					writeBinaryVtuFile(body, filefullpath);
+					continue;
+				}
 				std::ofstream out_file(filefullpath.c_str(), ios::trunc);
 				//begin of the XML file
 				out_file << "<?xml version=\"1.0\"?>\n";
@@ -68,6 +73,44 @@ namespace SPH
 		}
 	}
 	//=============================================================================================//
+	void WriteBodyStatesToVtu::writeBinaryVtuFile(SPHBody* body, std::string& filefullpath)
+	{
+		size_t number_of_particles = body->number_of_particles_;
+		std::string body_name = body->GetBodyName();
+		/** the snapshot of the particle data, which is encoded and written in the background */
+		std::shared_ptr<VtuDataArrays> data_arrays 
+			= std::make_shared<VtuDataArrays>(number_of_particles, vtu_format_ == VtuFormat::compressed);
+		body->writeParticlesToVtuDataArrays(*data_arrays);
+
+		in_output_.background_output_.addATask([=]() {
+			std::ofstream out_file(filefullpath.c_str(), ios::trunc | ios::binary);
+			out_file << "<?xml version=\"1.0\"?>\n";
+			out_file << "<VTKFile " << data_arrays->VtkFileAttributes() << ">\n";
+			out_file << " <UnstructuredGrid>\n";
+			out_file << "  <Piece Name =\"" << body_name << "\" NumberOfPoints=\"" << number_of_particles << "\" NumberOfCells=\"0\">\n";
+
+			data_arrays->writeDataArrayHeaders(out_file);
+
+			//write empty cells
+			out_file << "   <Cells>\n";
+			out_file << "    <DataArray type=\"Int32\"  Name=\"connectivity\"  Format=\"ascii\">\n";
+			out_file << "    </DataArray>\n";
+			out_file << "    <DataArray type=\"Int32\"  Name=\"offsets\"  Format=\"ascii\">\n";
+			out_file << "    </DataArray>\n";
+			out_file << "    <DataArray type=\"UInt8\"  Name=\"types\"  Format=\"ascii\">\n";
+			out_file << "    </DataArray>\n";
+			out_file << "   </Cells>\n";
+
+			out_file << "  </Piece>\n";
+			out_file << " </UnstructuredGrid>\n";
+
+			data_arrays->writeAppendedData(out_file);
+			out_file << "</VTKFile>\n";
+
+			out_file.close();
+		});
+	}
+	//=============================================================================================//
 	void WriteBodyStatesToPlt::WriteToFile(Real time)
 	{
 		int Itime = int(time*1.0e4);
@@ -138,20 +181,24 @@ namespace SPH
 	{
 		filefullpath_ = in_output_.output_folder_ + "/" + water_block->GetBodyName() 
 					  + "_water_mechanical_energy_" + in_output_.restart_step_ + ".dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << "\"run_time\""<<"   ";
-		out_file << water_block->GetBodyName()<<"   ";
-		out_file <<"\n";
-		out_file.close();
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+		*out_file_ << "\"run_time\""<<"   ";
+		*out_file_ << water_block->GetBodyName()<<"   ";
+		*out_file_ <<"\n";
 	};
 	//=============================================================================================//
 	void WriteTotalMechanicalEnergy::WriteToFile(Real time)
 	{
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time<<"   ";
-		out_file << parallel_exec()<<"   ";
-		out_file << "\n";
-		out_file.close();
+		Real total_mechanical_energy = parallel_exec();
+		if (WriteBodyStates::body_->domain_decomposition_ != NULL)
+			total_mechanical_energy = MPIEnvironment::reduceSum(total_mechanical_energy);
+
+		std::ofstream* out_file = out_file_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time<<"   ";
+			*out_file << total_mechanical_energy<<"   ";
+			*out_file << "\n";
+		});
 	};
 	//=================================================================================================//
 	WriteMaximumSpeed
@@ -160,20 +207,24 @@ namespace SPH
 	{
 		filefullpath_ = in_output_.output_folder_ + "/" + sph_body->GetBodyName()
 			+ "_maximum_speed_" + in_output_.restart_step_ + ".dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << "\"run_time\"" << "   ";
-		out_file << sph_body->GetBodyName() << "   ";
-		out_file << "\n";
-		out_file.close();
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+		*out_file_ << "\"run_time\"" << "   ";
+		*out_file_ << sph_body->GetBodyName() << "   ";
+		*out_file_ << "\n";
 	};
 	//=============================================================================================//
 	void WriteMaximumSpeed::WriteToFile(Real time)
 	{
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time << "   ";
-		out_file << parallel_exec() << "   ";
-		out_file << "\n";
-		out_file.close();
+		Real maximum_speed = parallel_exec();
+		if (WriteBodyStates::body_->domain_decomposition_ != NULL)
+			maximum_speed = MPIEnvironment::reduceMax(maximum_speed);
+
+		std::ofstream* out_file = out_file_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time << "   ";
+			*out_file << maximum_speed << "   ";
+			*out_file << "\n";
+		});
 	};
 	//=============================================================================================//
 	WriteTotalViscousForceOnSolid
@@ -184,24 +235,25 @@ namespace SPH
 		dimension_ = zero.size();
 
 		filefullpath_ = in_output_.output_folder_ + "/total_viscous_force_on_" + solid_body->GetBodyName() + ".dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << "\"run_time\"" << "   ";
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+		*out_file_ << "\"run_time\"" << "   ";
 		for(int i=0; i!= dimension_; ++i)
-		 out_file << "\"total_force["<<i<<"]\"" << "   ";
-		out_file << "\n";
-		out_file.close();
+		 *out_file_ << "\"total_force["<<i<<"]\"" << "   ";
+		*out_file_ << "\n";
 	}
 	//=============================================================================================//
 	void WriteTotalViscousForceOnSolid::WriteToFile(Real time)
 	{
 		Vecd total_force = parallel_exec();
 
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time << "   ";
-		for (int i = 0; i < dimension_; ++i)
-			out_file << total_force[i] << "   ";
-		out_file << "\n";
-		out_file.close();
+		std::ofstream* out_file = out_file_;
+		int dimension = dimension_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time << "   ";
+			for (int i = 0; i < dimension; ++i)
+				*out_file << total_force[i] << "   ";
+			*out_file << "\n";
+		});
 	};
 	//=============================================================================================//
 	WriteTotalForceOnSolid
@@ -213,24 +265,25 @@ namespace SPH
 
 		filefullpath_ = in_output_.output_folder_ + "/total_force_on_" + solid_body->GetBodyName() 
 			+ "_"+ in_output_.restart_step_ + ".dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << "\"run_time\"" << "   ";
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+		*out_file_ << "\"run_time\"" << "   ";
 		for(int i = 0; i < dimension_; ++i)
-		 out_file << "\"total_force["<<i<<"]\"" << "   ";
-		out_file << "\n";
-		out_file.close();
+		 *out_file_ << "\"total_force["<<i<<"]\"" << "   ";
+		*out_file_ << "\n";
 	}
 	//=============================================================================================//
 	void WriteTotalForceOnSolid::WriteToFile(Real time)
 	{
 		Vecd total_force = parallel_exec();
 
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time << "   ";
-		for (int i = 0; i < dimension_; ++i)
-			out_file << total_force[i] << "   ";
-		out_file << "\n";
-		out_file.close();
+		std::ofstream* out_file = out_file_;
+		int dimension = dimension_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time << "   ";
+			for (int i = 0; i < dimension; ++i)
+				*out_file << total_force[i] << "   ";
+			*out_file << "\n";
+		});
 	};
 	//=============================================================================================//
 	WriteUpperFrontInXDirection
@@ -239,20 +292,22 @@ namespace SPH
 	{
 		filefullpath_ = in_output_.output_folder_ + "/" + body->GetBodyName() 
 			+ "_upper_bound_in_x_direction_" + in_output_.restart_step_ + ".dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << "\"run_time\"" << "   ";
-		out_file << body->GetBodyName() << "   ";
-		out_file << "\n";
-		out_file.close();
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+		*out_file_ << "\"run_time\"" << "   ";
+		*out_file_ << body->GetBodyName() << "   ";
+		*out_file_ << "\n";
 	};
 	//=============================================================================================//
 	void WriteUpperFrontInXDirection::WriteToFile(Real time)
 	{
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time << "   ";
-		out_file << parallel_exec() << "   ";
-		out_file << "\n";
-		out_file.close();
+		Real upper_front = parallel_exec();
+
+		std::ofstream* out_file = out_file_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time << "   ";
+			*out_file << upper_front << "   ";
+			*out_file << "\n";
+		});
 	};
 	//=============================================================================================//
 	ReloadParticleIO::ReloadParticleIO(In_Output& in_output, SPHBodyVector bodies)
@@ -336,9 +391,11 @@ namespace SPH
 		}
 	}
 	//=============================================================================================//
-	RestartIO::RestartIO(In_Output& in_output, SPHBodyVector bodies)
+	RestartIO::RestartIO(In_Output& in_output, SPHBodyVector bodies, RestartFormat restart_format)
+		: restart_format_(restart_format)
 	{
 		overall_file_path_ = in_output.restart_folder_ + "/Restart_time_";
+		checkpoint_file_path_ = in_output.restart_folder_ + "/Restart_";
 		for (SPHBody* body : bodies)
 		{
 			file_paths_.push_back(in_output.restart_folder_ + "/SPHBody_" + body->GetBodyName() + "_rst_");
@@ -348,6 +405,12 @@ namespace SPH
 	void WriteRestart::WriteToFile(Real time)
 	{
 		int Itime = int(time);
+		if (restart_format_ == RestartFormat::binary)
+		{
+			writeBinaryCheckpoint(size_t(Itime));
+			return;
+		}
+
 		std::string overall_filefullpath = overall_file_path_ + std::to_string(Itime) + ".dat";
 		if (fs::exists(overall_filefullpath))
 		{
@@ -369,6 +432,70 @@ namespace SPH
 		}
 	}
 	//=============================================================================================//
+	void WriteRestart::writeBinaryCheckpoint(size_t restart_step)
+	{
+		/** the checkpoint is written to a temporary file first so that an interrupted writing 
+		 *  does not destroy an existing checkpoint of the same step */
+		std::string filefullpath = checkpointFilePath(restart_step);
+		std::string temporary_filefullpath = filefullpath + ".tmp";
+		BinaryCheckpointWriter checkpoint(temporary_filefullpath, GlobalStaticVariables::physical_time_);
+		for (size_t i = 0; i < bodies_.size(); ++i)
+		{
+			bodies_[i]->writeParticlesToBinaryCheckpoint(checkpoint);
+		}
+		/** the existing checkpoint is only replaced by a completely written one */
+		fs_error_code error_code;
+		if (!checkpoint.finish())
+		{
+			std::cout << "\n Warning: writing the checkpoint " << temporary_filefullpath
+				<< " failed, the previous checkpoint is kept." << std::endl;
+			fs::remove(temporary_filefullpath, error_code);
+			return;
+		}
+
+		/** renaming replaces the existing checkpoint atomically,
+		 *  except on Windows, where the existing one is moved to a backup first */
+#if defined(_WIN32)
+		std::string backup_filefullpath = filefullpath + ".bak";
+		fs::remove(backup_filefullpath, error_code);
+		if (fs::exists(filefullpath)) fs::rename(filefullpath, backup_filefullpath, error_code);
+#endif
+		fs::rename(temporary_filefullpath, filefullpath, error_code);
+		if (error_code)
+		{
+			std::cout << "\n Warning: the checkpoint " << filefullpath << " cannot be replaced: "
+				<< error_code.message() << ", the new checkpoint is kept in " << temporary_filefullpath << std::endl;
+#if defined(_WIN32)
+			if (!fs::exists(filefullpath)) fs::rename(backup_filefullpath, filefullpath, error_code);
+#endif
+			return;
+		}
+#if defined(_WIN32)
+		fs::remove(backup_filefullpath, error_code);
+#endif
+	}
+	//=============================================================================================//
+	Real ReadRestart::readBinaryCheckpoint(size_t restart_step)
+	{
+		std::cout << "\n Reading the binary checkpoint of the restart step = " << restart_step << std::endl;
+		std::string filefullpath = checkpointFilePath(restart_step);
+		/** the backup is left if the replacement of the checkpoint on Windows was interrupted */
+		if (!fs::exists(filefullpath) && fs::exists(filefullpath + ".bak")) filefullpath += ".bak";
+		if (!fs::exists(filefullpath))
+		{
+			std::cout << "\n Error: the input file:" << filefullpath << " is not exists" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+
+		BinaryCheckpointReader checkpoint(filefullpath);
+		for (size_t i = 0; i < bodies_.size(); ++i)
+		{
+			bodies_[i]->readParticlesFromBinaryCheckpoint(checkpoint);
+		}
+		return checkpoint.PhysicalTime();
+	}
+	//=============================================================================================//
 	Real ReadRestart::ReadRestartTime(size_t restart_step)
 	{
 		std::cout << "\n Reading restart files from the restart step = " << restart_step << std::endl;
@@ -389,6 +516,12 @@ namespace SPH
 	//=============================================================================================//
 	void ReadRestart::ReadFromFile(size_t restart_step)
 	{
+		if (restart_format_ == RestartFormat::binary)
+		{
+			readBinaryCheckpoint(restart_step);
+			return;
+		}
+
 		for (size_t i = 0; i < bodies_.size(); ++i)
 		{
 			std::string filefullpath = file_paths_[i] + std::to_string(restart_step) + ".xml";
@@ -404,30 +537,40 @@ namespace SPH
 		}
 	}
 	//=============================================================================================//
+	Real ConvertRestartFromXmlToBinary::convert(size_t restart_step)
+	{
+		Real restart_time = read_xml_restart_.ReadRestartFiles(restart_step);
+		Real physical_time = GlobalStaticVariables::physical_time_;
+		GlobalStaticVariables::physical_time_ = restart_time;
+		write_binary_restart_.WriteToFile(Real(restart_step));
+		GlobalStaticVariables::physical_time_ = physical_time;
+		return restart_time;
+	}
+	//=============================================================================================//
 	WriteSimBodyPinData::WriteSimBodyPinData(In_Output& in_output, SimTK::RungeKuttaMersonIntegrator& integ, SimTK::MobilizedBody::Pin& pinbody)
 		: WriteSimBodyStates<SimTK::MobilizedBody::Pin>(in_output, integ, pinbody)
 	{
 		filefullpath_ = in_output_.output_folder_ + "/mb_pinbody_data.dat";
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-
-		out_file << "\"time\"" << "   ";
-		out_file << "  " << "angles" << " ";
-		out_file << "  " << "angle_rates" << " ";
-		out_file << "\n";
+		out_file_ = in_output_.background_output_.openAFile(filefullpath_);
 
-		out_file.close();
+		*out_file_ << "\"time\"" << "   ";
+		*out_file_ << "  " << "angles" << " ";
+		*out_file_ << "  " << "angle_rates" << " ";
+		*out_file_ << "\n";
 	};
 	//=============================================================================================//
 	void WriteSimBodyPinData::WriteToFile(Real time)
 	{
-		std::ofstream out_file(filefullpath_.c_str(), ios::app);
-		out_file << time << "   ";
 		const SimTK::State& state = integ_.getState();
-
-		out_file << "  " << mobody_.getAngle(state) <<"  "<< mobody_.getRate(state) <<"  ";
-		
-		out_file << "\n";
-		out_file.close();
+		Real angle = mobody_.getAngle(state);
+		Real angle_rate = mobody_.getRate(state);
+
+		std::ofstream* out_file = out_file_;
+		in_output_.background_output_.addATask([=]() {
+			*out_file << time << "   ";
+			*out_file << "  " << angle <<"  "<< angle_rate <<"  ";
+			*out_file << "\n";
+		});
 	};
 	//=================================================================================================//
 	ReloadMaterialPropertyIO::ReloadMaterialPropertyIO(In_Output& in_output, BaseMaterial *material)
@@ -33,12 +33,16 @@
 #include "base_data_package.h"
 #include "sph_data_conainers.h"
 #include "all_physical_dynamics.h"
+#include "vtu_data_arrays.h"
+#include "background_output.h"
+#include "binary_checkpoint.h"
  
 #include "SimTKcommon.h"
 #include "SimTKmath.h"
 #include "Simbody.h"
 
 #include <fstream>
+#include <memory>
 /** Macro for APPLE compilers*/
 #ifdef __APPLE__
 #include <boost/filesystem.hpp>
@@ -59,11 +63,14 @@ namespace SPH {
 	 * @class In_Output
 	 * @brief The base class which defines folders for output, 
 	 * restart and particle reload folders.
+	 * With nonzero output buffers, the output files are written 
+	 * by a background thread while the simulation continues.
+	 * The queued output is finished when this object is destroyed.
 	 */
 	class In_Output
 	{
 	public:
-		In_Output(SPHSystem &sph_system);
+		In_Output(SPHSystem &sph_system, size_t number_of_output_buffers = 0);
 		virtual ~In_Output() {};
 
 		SPHSystem &sph_system_;
@@ -71,6 +78,10 @@ namespace SPH {
 		std::string restart_folder_;
 		std::string reload_folder_;
 		std::string restart_step_;
+		BackgroundOutput background_output_;
+
+		/** Wait until all queued output is written. */
+		void flushOutput() { background_output_.flush(); };
 	};
 
 	/**
@@ -175,13 +186,19 @@ namespace SPH {
 	 * @class WriteBodyStatesToVtu
 	 * @brief  Write files for bodies
 	 * the output file is VTK XML format can visualized by ParaView
-	 * the data type vtkUnstructedGrid
+	 * the data type vtkUnstructedGrid.
+	 * The data are written as ASCII text or appended binary data,
+	 * which is much faster and smaller for large bodies.
 	 */
 	class WriteBodyStatesToVtu : public WriteBodyStates
 	{
+	protected:
+		VtuFormat vtu_format_;
+		/** Write the data of a body as appended binary data. */
+		void writeBinaryVtuFile(SPHBody* body, std::string& filefullpath);
 	public:
-		WriteBodyStatesToVtu(In_Output& in_output, SPHBodyVector bodies)
-			: WriteBodyStates(in_output, bodies) {};
+		WriteBodyStatesToVtu(In_Output& in_output, SPHBodyVector bodies, VtuFormat vtu_format = VtuFormat::ascii)
+			: WriteBodyStates(in_output, bodies), vtu_format_(vtu_format) {};
 		virtual ~WriteBodyStatesToVtu() {};
 
 		virtual void WriteToFile(Real time) override;
@@ -249,11 +266,12 @@ namespace SPH {
 	protected:
 		SPHBody* observer_;
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 
 		void writeFileHead(std::ofstream& out_file, Real& observed_quantity, string quantity_name, size_t i) {
 			out_file << "  " << quantity_name << "[" << i << "]" << " ";
 		};
-		void writeDataToFile(std::ofstream& out_file, Real& observed_quantity) {
+		static void writeDataToFile(std::ofstream& out_file, const Real& observed_quantity) {
 			out_file << "  " << observed_quantity << " ";
 		};
 
@@ -261,7 +279,7 @@ namespace SPH {
 			for (int j = 0; j < observed_quantity.size(); ++j)
 				out_file << "  " << quantity_name <<"[" << i << "][" << j << "]" << " ";
 		};
-		void writeDataToFile(std::ofstream& out_file, Vecd& observed_quantity) {
+		static void writeDataToFile(std::ofstream& out_file, const Vecd& observed_quantity) {
 			for (int j = 0; j < observed_quantity.size(); ++j)
 				out_file << "  " << observed_quantity[j] << " ";
 		};
@@ -274,28 +292,39 @@ namespace SPH {
 		{
 			filefullpath_ = in_output_.output_folder_ + "/" + observer_->GetBodyName()
 				+ "_" + quantity_name + "_" + in_output_.restart_step_ + ".dat";
-			std::ofstream out_file(filefullpath_.c_str(), ios::app);
-			out_file << "run_time" << "   ";
+			out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+			*out_file_ << "run_time" << "   ";
 			for (size_t i = 0; i != observer_->number_of_particles_; ++i)
 			{
-				writeFileHead(out_file, this->observed_quantities_[i], quantity_name, i);
+				writeFileHead(*out_file_, this->observed_quantities_[i], quantity_name, i);
 			}
-			out_file << "\n";
-			out_file.close();
+			*out_file_ << "\n";
 		};
 		virtual ~WriteAnObservedQuantity() {};
 
 		virtual void WriteToFile(Real time = 0.0) override 
 		{
 			this->parallel_exec();
-			std::ofstream out_file(filefullpath_.c_str(), ios::app);
-			out_file << time << "   ";
-			for (size_t i = 0; i != observer_->number_of_particles_; ++i)
+			/** the observed quantities of a decomposed body are combined from all ranks */
+			for (size_t k = 0; k != this->contact_bodies_.size(); ++k)
 			{
-				writeDataToFile(out_file, this->observed_quantities_[i]);
+				if (this->contact_bodies_[k]->domain_decomposition_ != NULL)
+				{
+					this->contact_bodies_[k]->domain_decomposition_
+						->reduceObservedQuantities(this->observed_quantities_, observer_->base_particles_->pos_n_);
+					break;
+				}
 			}
-			out_file << "\n";
-			out_file.close();
+			std::ofstream* out_file = out_file_;
+			StdLargeVec<DataType> observed_quantities(this->observed_quantities_);
+			in_output_.background_output_.addATask([=]() {
+				*out_file << time << "   ";
+				for (size_t i = 0; i != observed_quantities.size(); ++i)
+				{
+					writeDataToFile(*out_file, observed_quantities[i]);
+				}
+				*out_file << "\n";
+			});
 		};
 	};
 
@@ -311,6 +340,7 @@ namespace SPH {
 	protected:
 		SPHBody* observer_;
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		/** Constructor and Destructor. */
 		WriteObservedDiffusionReactionQuantity(string species_name, In_Output& in_output, SPHBodyContactRelation* body_contact_relation)
@@ -320,14 +350,13 @@ namespace SPH {
 		{
 			filefullpath_ = in_output_.output_folder_ + "/" + observer_->GetBodyName()
 				+ "_" + species_name + "_" + in_output_.restart_step_ + ".dat";
-			std::ofstream out_file(filefullpath_.c_str(), ios::app);
-			out_file << "run_time" << "   ";
+			out_file_ = in_output_.background_output_.openAFile(filefullpath_);
+			*out_file_ << "run_time" << "   ";
 			for (size_t i = 0; i != observer_->number_of_particles_; ++i)
 			{
-				out_file << "  " << species_name << "[" << i << "]" << " ";
+				*out_file_ << "  " << species_name << "[" << i << "]" << " ";
 			}
-			out_file << "\n";
-			out_file.close();
+			*out_file_ << "\n";
 		};
 
 		virtual ~WriteObservedDiffusionReactionQuantity() {};
@@ -338,14 +367,16 @@ namespace SPH {
 		virtual void WriteToFile(Real time) override 
 		{
 			this->parallel_exec();
-			std::ofstream out_file(filefullpath_.c_str(), ios::app);
-			out_file << time << "   ";
-			for (size_t i = 0; i != observer_->number_of_particles_; ++i)
-			{
-				out_file << "  " << this->observed_quantities_[i] << " ";
-			}
-			out_file << "\n";
-			out_file.close();
+			std::ofstream* out_file = out_file_;
+			StdLargeVec<Real> observed_quantities(this->observed_quantities_);
+			in_output_.background_output_.addATask([=]() {
+				*out_file << time << "   ";
+				for (size_t i = 0; i != observed_quantities.size(); ++i)
+				{
+					*out_file << "  " << observed_quantities[i] << " ";
+				}
+				*out_file << "\n";
+			});
 		};
 	};
 
@@ -358,6 +389,7 @@ namespace SPH {
 	{
 	protected:
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteTotalMechanicalEnergy(In_Output& in_output, FluidBody* water_block, Gravity* gravity);
 		virtual ~WriteTotalMechanicalEnergy() {};
@@ -372,6 +404,7 @@ namespace SPH {
 	{
 	protected:
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteMaximumSpeed(In_Output& in_output, SPHBody* sph_body);
 		virtual ~WriteMaximumSpeed() {};
@@ -388,6 +421,7 @@ namespace SPH {
 	protected:
 		int dimension_;
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteTotalViscousForceOnSolid(In_Output& in_output, SolidBody *solid_body);
 		virtual ~WriteTotalViscousForceOnSolid() {};
@@ -404,6 +438,7 @@ namespace SPH {
 	protected:
 		int dimension_;
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteTotalForceOnSolid(In_Output& in_output, SolidBody *solid_body);
 		virtual ~WriteTotalForceOnSolid() {};
@@ -419,6 +454,7 @@ namespace SPH {
 	{
 	protected:
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteUpperFrontInXDirection(In_Output& in_output, SPHBody* body);
 		virtual ~WriteUpperFrontInXDirection() {};
@@ -468,52 +504,84 @@ namespace SPH {
 
 	/**
 	 * @class RestartIO
-	 * @brief Write the restart file in XML format.
+	 * @brief Paths and format of the restart files.
+	 * The XML files are the default, while the binary checkpoint
+	 * is much faster and smaller for large bodies.
 	 */
 	class RestartIO
 	{
 	protected:
+		RestartFormat restart_format_;
 		std::string overall_file_path_;
 		StdVec<std::string> file_paths_;
+		std::string checkpoint_file_path_;
 
+		std::string checkpointFilePath(size_t restart_step) {
+			return checkpoint_file_path_ + std::to_string(restart_step) + ".bin";
+		};
 	public:
-		RestartIO(In_Output& in_output, SPHBodyVector bodies);
+		RestartIO(In_Output& in_output, SPHBodyVector bodies, RestartFormat restart_format = RestartFormat::xml);
 		virtual ~RestartIO() {};
 	};
 
 	/**
 	 * @class WriteRestart
-	 * @brief Write the restart file in XML format.
+	 * @brief Write the restart files in XML or binary format.
 	 */
 	class WriteRestart : public RestartIO, public WriteBodyStates
 	{
+	protected:
+		void writeBinaryCheckpoint(size_t restart_step);
 	public:
-		WriteRestart(In_Output& in_output, SPHBodyVector bodies)
-			: RestartIO(in_output, bodies), WriteBodyStates(in_output, bodies) {};
+		WriteRestart(In_Output& in_output, SPHBodyVector bodies, RestartFormat restart_format = RestartFormat::xml)
+			: RestartIO(in_output, bodies, restart_format), WriteBodyStates(in_output, bodies) {};
 		virtual ~WriteRestart() {};
 
 		virtual void WriteToFile(Real time = 0.0) override;
 	};
 
 	/**
-	 * @class WriteRestart
-	 * @brief Write the restart file in XML format.
+	 * @class ReadRestart
+	 * @brief Read the restart files in XML or binary format.
 	 */
 	class ReadRestart : public RestartIO, public ReadBodyStates
 	{
 	protected:
 		Real ReadRestartTime(size_t restart_step);
+		Real readBinaryCheckpoint(size_t restart_step);
 	public:
-		ReadRestart(In_Output& in_output, SPHBodyVector bodies)
-			: RestartIO(in_output, bodies), ReadBodyStates(in_output, bodies) {};
+		ReadRestart(In_Output& in_output, SPHBodyVector bodies, RestartFormat restart_format = RestartFormat::xml)
+			: RestartIO(in_output, bodies, restart_format), ReadBodyStates(in_output, bodies) {};
 		virtual ~ReadRestart() {};
 		virtual Real ReadRestartFiles(size_t restart_step) {
+			if (restart_format_ == RestartFormat::binary) return readBinaryCheckpoint(restart_step);
 			ReadFromFile(restart_step);
 			return ReadRestartTime(restart_step);
 		};
 		virtual void ReadFromFile(size_t iteration_step = 0) override;
 	};
 
+	/**
+	 * @class ConvertRestartFromXmlToBinary
+	 * @brief Convert the XML restart files of a restart step into a binary checkpoint.
+	 * The bodies should be set up as for the restart simulation, 
+	 * as the XML files are read into them first.
+	 */
+	class ConvertRestartFromXmlToBinary
+	{
+	protected:
+		ReadRestart read_xml_restart_;
+		WriteRestart write_binary_restart_;
+	public:
+		ConvertRestartFromXmlToBinary(In_Output& in_output, SPHBodyVector bodies)
+			: read_xml_restart_(in_output, bodies, RestartFormat::xml),
+			write_binary_restart_(in_output, bodies, RestartFormat::binary) {};
+		virtual ~ConvertRestartFromXmlToBinary() {};
+
+		/** Convert the files of a restart step and return the restart time. */
+		Real convert(size_t restart_step);
+	};
+
 	/**
 	 * @class WriteSimBodyPinData
 	* @brief Write total force acting a solid body.
@@ -522,6 +590,7 @@ namespace SPH {
 	{
 	protected:
 		std::string filefullpath_;
+		std::ofstream* out_file_;
 	public:
 		WriteSimBodyPinData(In_Output& in_output, SimTK::RungeKuttaMersonIntegrator& integ, SimTK::MobilizedBody::Pin& pinbody);
 		virtual ~WriteSimBodyPinData() {};
@@ -0,0 +1,195 @@
+/**
+ * @file 	vtu_data_arrays.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "vtu_data_arrays.h"
+
+#ifdef SPHINXSYS_USE_ZLIB
+#include <zlib.h>
+#endif
+#include <cstring>
+
+namespace SPH
+{
+	//=================================================================================================//
+	VtuDataArrays::VtuDataArrays(size_t number_of_points, bool is_compressed)
+		: number_of_points_(number_of_points), is_compressed_(is_compressed), is_encoded_(false), block_size_(1 << 20)
+	{
+#ifndef SPHINXSYS_USE_ZLIB
+		if (is_compressed_)
+		{
+			std::cout << "\n Warning: zlib is not available, the VTU data are written uncompressed!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			is_compressed_ = false;
+		}
+#endif
+	}
+	//=================================================================================================//
+	string VtuDataArrays::VtkFileAttributes()
+	{
+		string attributes = "type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"LittleEndian\" header_type=\"UInt64\"";
+		if (is_compressed_) attributes += " compressor=\"vtkZLibDataCompressor\"";
+		return attributes;
+	}
+	//=================================================================================================//
+	void VtuDataArrays::addAnArray(string name, string type, size_t number_of_components,
+		const char* data, size_t data_size)
+	{
+		names_.push_back(name);
+		types_.push_back(type);
+		number_of_components_.push_back(number_of_components);
+		data_arrays_.push_back(StdVec<char>(data, data + data_size));
+	}
+	//=================================================================================================//
+	void VtuDataArrays::encodeArrays()
+	{
+		if (is_encoded_) return;
+		for (size_t l = 0; l != data_arrays_.size(); ++l)
+			encodeAnArray(data_arrays_[l]);
+		is_encoded_ = true;
+	}
+	//=================================================================================================//
+	void VtuDataArrays::encodeAnArray(StdVec<char>& data_array)
+	{
+		const char* data = data_array.data();
+		size_t data_size = data_array.size();
+		StdVec<char> encoded_array;
+
+		if (!is_compressed_)
+		{
+			uint64_t header = data_size;
+			encoded_array.resize(sizeof(uint64_t) + data_size);
+			memcpy(encoded_array.data(), &header, sizeof(uint64_t));
+			if (data_size != 0) memcpy(encoded_array.data() + sizeof(uint64_t), data, data_size);
+			data_array.swap(encoded_array);
+			return;
+		}
+#ifdef SPHINXSYS_USE_ZLIB
+		/** header: number of blocks, block size, size of the last partial block and the compressed sizes */
+		size_t number_of_blocks = (data_size + block_size_ - 1) / block_size_;
+		size_t last_block_size = data_size % block_size_;
+		/** no affinity partitioner here, as the encoding may run in the background thread concurrently */
+		StdVec<StdVec<char>> compressed_blocks(number_of_blocks);
+		parallel_for(blocked_range<size_t>(0, number_of_blocks),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t n = r.begin(); n != r.end(); ++n)
+				{
+					size_t block_begin = n * block_size_;
+					uLong source_size = (uLong)SMIN(block_size_, data_size - block_begin);
+					uLongf compressed_size = compressBound(source_size);
+					compressed_blocks[n].resize(compressed_size);
+					compress2(reinterpret_cast<Bytef*>(compressed_blocks[n].data()), &compressed_size,
+						reinterpret_cast<const Bytef*>(data + block_begin), source_size, Z_BEST_SPEED);
+					compressed_blocks[n].resize(compressed_size);
+				}
+			});
+
+		StdVec<uint64_t> header(3 + number_of_blocks);
+		header[0] = number_of_blocks;
+		header[1] = block_size_;
+		header[2] = last_block_size;
+		size_t total_size = header.size() * sizeof(uint64_t);
+		for (size_t n = 0; n != number_of_blocks; ++n)
+		{
+			header[3 + n] = compressed_blocks[n].size();
+			total_size += compressed_blocks[n].size();
+		}
+
+		encoded_array.resize(total_size);
+		memcpy(encoded_array.data(), header.data(), header.size() * sizeof(uint64_t));
+		size_t position = header.size() * sizeof(uint64_t);
+		for (size_t n = 0; n != number_of_blocks; ++n)
+		{
+			memcpy(encoded_array.data() + position, compressed_blocks[n].data(), compressed_blocks[n].size());
+			position += compressed_blocks[n].size();
+		}
+		data_array.swap(encoded_array);
+#endif
+	}
+	//=================================================================================================//
+	void VtuDataArrays::addPositions(StdLargeVec<Vecd>& positions)
+	{
+		addAVectorArray("Position", positions);
+	}
+	//=================================================================================================//
+	void VtuDataArrays::addPointIndexes(string name, StdLargeVec<size_t>& indexes)
+	{
+		StdLargeVec<int> values(number_of_points_);
+		parallel_for(blocked_range<size_t>(0, number_of_points_),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					values[i] = int(indexes[i]);
+			}, static_partitioner());
+		addAnArray(name, "Int32", 1,
+			reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int));
+	}
+	//=================================================================================================//
+	void VtuDataArrays::addAScalarArray(string name, StdLargeVec<Real>& variable)
+	{
+		StdLargeVec<float> values(number_of_points_);
+		parallel_for(blocked_range<size_t>(0, number_of_points_),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					values[i] = float(variable[i]);
+			}, static_partitioner());
+		addAnArray(name, "Float32", 1,
+			reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+	}
+	//=================================================================================================//
+	void VtuDataArrays::addAVectorArray(string name, StdLargeVec<Vecd>& variable)
+	{
+		StdLargeVec<float> values(3 * number_of_points_);
+		parallel_for(blocked_range<size_t>(0, number_of_points_),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+				{
+					Vec3d vector_value = upgradeToVector3D(variable[i]);
+					for (size_t k = 0; k != 3; ++k)
+						values[3 * i + k] = float(vector_value[k]);
+				}
+			}, static_partitioner());
+		addAnArray(name, "Float32", 3,
+			reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+	}
+	//=================================================================================================//
+	void VtuDataArrays::writeADataArrayHeader(ofstream& out_file, size_t array_index, size_t offset)
+	{
+		out_file << "    <DataArray Name=\"" << names_[array_index] << "\" type=\"" << types_[array_index] << "\"";
+		if (number_of_components_[array_index] != 1)
+			out_file << " NumberOfComponents=\"" << number_of_components_[array_index] << "\"";
+		out_file << " format=\"appended\" offset=\"" << offset << "\"/>\n";
+	}
+	//=================================================================================================//
+	void VtuDataArrays::writeDataArrayHeaders(ofstream& out_file)
+	{
+		encodeArrays();
+
+		size_t offset = 0;
+		out_file << "   <Points>\n";
+		writeADataArrayHeader(out_file, 0, offset);
+		offset += data_arrays_[0].size();
+		out_file << "   </Points>\n";
+
+		out_file << "   <PointData  Vectors=\"vector\">\n";
+		for (size_t l = 1; l != data_arrays_.size(); ++l)
+		{
+			writeADataArrayHeader(out_file, l, offset);
+			offset += data_arrays_[l].size();
+		}
+		out_file << "   </PointData>\n";
+	}
+	//=================================================================================================//
+	void VtuDataArrays::writeAppendedData(ofstream& out_file)
+	{
+		encodeArrays();
+
+		out_file << " <AppendedData encoding=\"raw\">\n";
+		out_file << "_";
+		for (size_t l = 0; l != data_arrays_.size(); ++l)
+			out_file.write(data_arrays_[l].data(), data_arrays_[l].size());
+		out_file << "\n </AppendedData>\n";
+	}
+	//=================================================================================================//
+}
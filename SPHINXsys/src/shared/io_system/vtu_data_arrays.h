@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	vtu_data_arrays.h
+ * @brief 	Data arrays of particles encoded for the binary VTU format. 
+ * The arrays are converted to single precision when added, which is a snapshot
+ * of the particle data, and are encoded later, optionally compressed with zlib, 
+ * in parallel and written as appended data in one pass.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+#include "sph_data_conainers.h"
+
+#include <fstream>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+namespace SPH {
+
+	/** The formats of VTU output, i.e. ASCII text, appended raw binary and zlib compressed binary data. */
+	enum class VtuFormat { ascii, binary, compressed };
+
+	/**
+	 * @class VtuDataArrays
+	 * @brief The encoded data arrays of a VTU piece.
+	 * The first array added is the point positions 
+	 * and the other arrays are point data.
+	 * As the arrays are copies of the particle data, 
+	 * the encoding and writing can be carried out in a background thread.
+	 */
+	class VtuDataArrays
+	{
+	protected:
+		size_t number_of_points_;
+		bool is_compressed_;
+		bool is_encoded_;
+		/** Size of the uncompressed blocks, which are compressed in parallel. */
+		size_t block_size_;
+
+		StdVec<string> names_;
+		StdVec<string> types_;
+		StdVec<size_t> number_of_components_;
+		/** Raw bytes of the arrays before encoding and encoded bytes after. */
+		StdVec<StdVec<char>> data_arrays_;
+
+		/** Add the raw bytes of an array. */
+		void addAnArray(string name, string type, size_t number_of_components,
+			const char* data, size_t data_size);
+		/** Encode the raw bytes of an array with the header required by the VTK appended format. */
+		void encodeAnArray(StdVec<char>& data_array);
+		/** Write the XML description of an array with its offset in the appended data. */
+		void writeADataArrayHeader(ofstream& out_file, size_t array_index, size_t offset);
+	public:
+		VtuDataArrays(size_t number_of_points, bool is_compressed = false);
+		virtual ~VtuDataArrays() {};
+
+		/** The attributes of the VTKFile element for this encoding. */
+		string VtkFileAttributes();
+
+		/** Add the point positions, which should be the first array. */
+		void addPositions(StdLargeVec<Vecd>& positions);
+		/** Add the indexes of the points, such as the particle ids which are kept by the sorting. */
+		void addPointIndexes(string name, StdLargeVec<size_t>& indexes);
+		/** Add a scalar array. */
+		void addAScalarArray(string name, StdLargeVec<Real>& variable);
+		/** Add a vector array, which is written with 3 components. */
+		void addAVectorArray(string name, StdLargeVec<Vecd>& variable);
+		/** Add a scalar array computed point by point. */
+		template<typename ScalarFunction>
+		void addAScalarArrayFromFunction(string name, const ScalarFunction& scalar_function)
+		{
+			StdLargeVec<float> values(number_of_points_);
+			parallel_for(blocked_range<size_t>(0, number_of_points_),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t i = r.begin(); i != r.end(); ++i)
+						values[i] = float(scalar_function(i));
+				}, static_partitioner());
+			addAnArray(name, "Float32", 1, 
+				reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+		};
+
+		/** Encode all arrays, which is done before writing if not called explicitly. */
+		void encodeArrays();
+		/** Write the points and point data sections with offsets to the appended data. */
+		void writeDataArrayHeaders(ofstream& out_file);
+		/** Write the appended data section. */
+		void writeAppendedData(ofstream& out_file);
+	};
+}
@@ -127,42 +127,42 @@ namespace SPH
 	Real Kernel::dW(Real inv_h_in, const Real& r_ij) const
 	{
 		Real q = abs(r_ij) * inv_h_in;
-		return factor_dW_1D_ * dW_1D(q) * inv_h_in
+		return factor_W_1D_ * dW_1D(q) * inv_h_in
 			* getSmoothingLengthFactor1D(inv_h_in);
 	}
 	//=================================================================================================//
 	Real Kernel::dW(Real inv_h_in, const Vec2d& r_ij) const
 	{
 		Real q = r_ij.norm() * inv_h_in;
-		return factor_dW_2D_ * dW_2D(q) * inv_h_in
+		return factor_W_2D_ * dW_2D(q) * inv_h_in
 			* getSmoothingLengthFactor2D(inv_h_in);
 	}
 	//=================================================================================================//
 	Real Kernel::dW(Real inv_h_in, const Vec3d& r_ij) const
 	{
 		Real q = r_ij.norm() * inv_h_in;
-		return factor_dW_3D_ * dW_3D(q) * inv_h_in
+		return factor_W_3D_ * dW_3D(q) * inv_h_in
 			* getSmoothingLengthFactor3D(inv_h_in);
 	}
 	//=================================================================================================//
 	Real Kernel::d2W(Real inv_h_in, const Real& r_ij) const
 	{
 		Real q = abs(r_ij) * inv_h_in;
-		return factor_d2W_1D_ * d2W_1D(q) * inv_h_in * inv_h_in
+		return factor_W_1D_ * d2W_1D(q) * inv_h_in * inv_h_in
 			* getSmoothingLengthFactor1D(inv_h_in);
 	}
 	//=================================================================================================//
 	Real Kernel::d2W(Real inv_h_in, const Vec2d& r_ij) const
 	{
 		Real q = r_ij.norm() * inv_h_in;
-		return factor_d2W_2D_ * d2W_2D(q) * inv_h_in * inv_h_in
+		return factor_W_2D_ * d2W_2D(q) * inv_h_in * inv_h_in
 			* getSmoothingLengthFactor2D(inv_h_in);
 	}
 	//=================================================================================================//
 	Real Kernel::d2W(Real inv_h_in, const Vec3d& r_ij) const
 	{
 		Real q = r_ij.norm() * inv_h_in;
-		return factor_d2W_3D_ * d2W_3D(q) * inv_h_in * inv_h_in
+		return factor_W_3D_ * d2W_3D(q) * inv_h_in * inv_h_in
 			* getSmoothingLengthFactor3D(inv_h_in);
 	}
 	//=================================================================================================//
@@ -170,6 +170,12 @@ namespace SPH
 		 *@param[out] (size_t) 1D index.
 		 */
 		size_t transferMeshIndexTo1D(Vecu number_of_grid_points, Vecu grid_index);
+		/**
+		 *@brief This function convert mesh index to the position along the Morton (Z-order) curve.
+		 *@param[in] grid_index Mesh index in each direction.
+		 *@param[out] (size_t) Morton order.
+		 */
+		size_t transferMeshIndexToMortonOrder(Vecu grid_index);
 	};
 
 	/**
@@ -500,6 +506,10 @@ namespace SPH
 		DataType DataValueFromGlobalIndex(Vecu global_data_index);
 		/** initialize the addresses in a data package for all variables. */
 		void initializePackageAddressesInACell(Vecu cell_index);
+		/** the data package in a cell */
+		DataPackageType* DataPackageInACell(Vecu cell_index);
+		/** assign a data package to a cell */
+		void assignDataPackageToACell(Vecu cell_index, DataPackageType* data_pkg);
 		/** find related cell index and data index for a data package address matrix */
 		pair<int, int> CellShiftAndDataIndex(int data_addrs_index_component)
 		{
@@ -55,18 +55,159 @@ namespace SPH {
 			split_cell_lists[i].clear();
 	}
 	//=================================================================================================//
+	void BaseMeshCellLinkedList::computingSequence(StdLargeVec<size_t>& sequence)
+	{
+		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		size_t number_of_particles = body_->number_of_particles_;
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					sequence[i] = transferMeshIndexToMortonOrder(GridIndexFromPosition(pos_n[i]));
+			}, update_affinity_);
+	}
+	//=================================================================================================//
 	MeshCellLinkedList::MeshCellLinkedList(SPHBody* body, Vecd lower_bound,
 		Vecd upper_bound, Real cell_spacing, size_t buffer_width)
 		: BaseMeshCellLinkedList(body, lower_bound, upper_bound, cell_spacing, buffer_width),
-		cutoff_radius_(cell_spacing) {}
+		cutoff_radius_(cell_spacing), cell_linked_lists_(nullptr), use_counting_sort_(true), is_rebuilt_(false),
+		cell_counts_(nullptr) {}
 	//=================================================================================================//
 	MeshCellLinkedList::MeshCellLinkedList(SPHBody* body, Vecd mesh_lower_bound,
 		Vecu number_of_cells, Real cell_spacing)
 		: BaseMeshCellLinkedList(body, mesh_lower_bound, number_of_cells, cell_spacing),
-		cutoff_radius_(cell_spacing) {}
+		cutoff_radius_(cell_spacing), cell_linked_lists_(nullptr), use_counting_sort_(true), is_rebuilt_(false),
+		cell_counts_(nullptr) {}
+	//=================================================================================================//
+	size_t MeshCellLinkedList::TotalNumberOfCells()
+	{
+		size_t total_number_of_cells = 1;
+		for (int n = 0; n != number_of_cells_.size(); ++n)
+			total_number_of_cells *= number_of_cells_[n];
+		return total_number_of_cells;
+	}
+	//=================================================================================================//
+	CellList& MeshCellLinkedList::CellListFrom1DIndex(size_t cell_index_1d)
+	{
+		return *CellListFormIndex(transfer1DtoMeshIndex(number_of_cells_, cell_index_1d));
+	}
 	//=================================================================================================//
 	void MeshCellLinkedList::UpdateCellLists()
 	{
+		if (use_counting_sort_)
+		{
+			UpdateCellListsByCountingSort();
+		}
+		else
+		{
+			UpdateCellListsByRebuilding();
+		}
+	}
+	//=================================================================================================//
+	void MeshCellLinkedList::clearOccupiedCellLists()
+	{
+		parallel_for(blocked_range<size_t>(0, occupied_cells_.size()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t l = r.begin(); l != r.end(); ++l) {
+					CellList& cell_list = CellListFrom1DIndex(occupied_cells_[l]);
+					cell_list.real_particle_indexes_.clear();
+					cell_list.cell_list_data_.clear();
+				}
+			}, update_affinity_);
+		for (size_t l = 0; l != cells_with_extra_data_.size(); ++l)
+			CellListFrom1DIndex(cells_with_extra_data_[l]).cell_list_data_.clear();
+
+		occupied_cells_.clear();
+		cells_with_extra_data_.clear();
+	}
+	//=================================================================================================//
+	void MeshCellLinkedList::clearAllCellLists()
+	{
+		parallel_for(blocked_range<size_t>(0, TotalNumberOfCells()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t l = r.begin(); l != r.end(); ++l) {
+					CellList& cell_list = CellListFrom1DIndex(l);
+					cell_list.concurrent_particle_indexes_.clear();
+					cell_list.real_particle_indexes_.clear();
+					cell_list.cell_list_data_.clear();
+				}
+			}, update_affinity_);
+		occupied_cells_.clear();
+		cells_with_extra_data_.clear();
+	}
+	//=================================================================================================//
+	void MeshCellLinkedList::UpdateCellListsByCountingSort()
+	{
+		if (is_rebuilt_)
+		{
+			clearAllCellLists();
+			is_rebuilt_ = false;
+		}
+		else clearOccupiedCellLists();
+
+		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		size_t number_of_particles = body_->number_of_particles_;
+		particle_cells_.resize(number_of_particles);
+		cell_sorted_particles_.resize(number_of_particles);
+
+		/** count the particles in cells and collect the occupied cells */
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i) {
+					size_t cell_index_1d = transferMeshIndexTo1D(number_of_cells_, GridIndexFromPosition(pos_n[i]));
+					particle_cells_[i] = cell_index_1d;
+					if (cell_counts_[cell_index_1d].fetch_add(1) == 0) occupied_cells_.push_back(cell_index_1d);
+				}
+			}, update_affinity_);
+		parallel_sort(occupied_cells_.begin(), occupied_cells_.end());
+
+		/** prefix sum, after which the counts are the positions for scattering */
+		size_t number_of_occupied_cells = occupied_cells_.size();
+		occupied_cell_offsets_.resize(number_of_occupied_cells + 1);
+		occupied_cell_offsets_[0] = 0;
+		for (size_t l = 0; l != number_of_occupied_cells; ++l) {
+			size_t cell_index_1d = occupied_cells_[l];
+			occupied_cell_offsets_[l + 1] = occupied_cell_offsets_[l] + cell_counts_[cell_index_1d];
+			cell_counts_[cell_index_1d] = occupied_cell_offsets_[l];
+		}
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					cell_sorted_particles_[cell_counts_[particle_cells_[i]].fetch_add(1)] = i;
+			}, update_affinity_);
+
+		/** fill the occupied cell lists in ascending particle order and reset the counts */
+		parallel_for(blocked_range<size_t>(0, number_of_occupied_cells),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t l = r.begin(); l != r.end(); ++l) {
+					size_t cell_index_1d = occupied_cells_[l];
+					cell_counts_[cell_index_1d] = 0;
+					StdLargeVec<size_t>::iterator begin = cell_sorted_particles_.begin() + occupied_cell_offsets_[l];
+					StdLargeVec<size_t>::iterator end = cell_sorted_particles_.begin() + occupied_cell_offsets_[l + 1];
+					std::sort(begin, end);
+
+					CellList& cell_list = CellListFrom1DIndex(cell_index_1d);
+					for (StdLargeVec<size_t>::iterator it = begin; it != end; ++it) {
+						cell_list.real_particle_indexes_.push_back(*it);
+						cell_list.cell_list_data_.emplace_back(make_pair(*it, pos_n[*it]));
+					}
+				}
+			}, update_affinity_);
+
+		SplitCellLists& split_cell_lists = body_->split_cell_lists_;
+		ClearSplitCellLists(split_cell_lists);
+		for (size_t l = 0; l != number_of_occupied_cells; ++l) {
+			Vecu cell_index = transfer1DtoMeshIndex(number_of_cells_, occupied_cells_[l]);
+			Vecu split_index(0);
+			for (int n = 0; n != cell_index.size(); ++n) split_index[n] = cell_index[n] % 3;
+			split_cell_lists[transferMeshIndexTo1D(Vecu(3), split_index)]
+				.push_back(&CellListFrom1DIndex(occupied_cells_[l]));
+		}
+	}
+	//=================================================================================================//
+	void MeshCellLinkedList::UpdateCellListsByRebuilding()
+	{
+		is_rebuilt_ = true;
 		ClearCellLists(number_of_cells_, cell_linked_lists_);
 		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
 		size_t number_of_particles = body_->number_of_particles_;
@@ -76,30 +217,263 @@ namespace SPH {
 				for (size_t i = r.begin(); i != r.end(); ++i) {
 					InsertACellLinkedParticleIndex(i, pos_n[i]);
 				}
-			}, ap);
-		UpdateCellListData(cell_linked_lists_);
+			}, update_affinity_);
+		UpdateCellListData(number_of_cells_, cell_linked_lists_);
 		UpdateSplitCellLists(body_->split_cell_lists_, number_of_cells_, cell_linked_lists_);
 	}
 	//=================================================================================================//
+	SparseMeshCellLinkedList::SparseMeshCellLinkedList(SPHBody* body, Vecd lower_bound,
+		Vecd upper_bound, Real cell_spacing, size_t buffer_width, size_t block_width)
+		: BaseMeshCellLinkedList(body, lower_bound, upper_bound, cell_spacing, buffer_width),
+		block_width_(block_width), number_of_cells_in_block_(1), number_of_blocks_(0),
+		block_addrs_(nullptr), number_of_updates_(0)
+	{
+		for (int n = 0; n != number_of_cells_.size(); ++n) {
+			number_of_cells_in_block_ *= block_width_;
+			number_of_blocks_[n] = (number_of_cells_[n] + block_width_ - 1) / block_width_;
+		}
+	}
+	//=================================================================================================//
+	size_t SparseMeshCellLinkedList::TotalNumberOfBlocks()
+	{
+		size_t total_number_of_blocks = 1;
+		for (int n = 0; n != number_of_blocks_.size(); ++n)
+			total_number_of_blocks *= number_of_blocks_[n];
+		return total_number_of_blocks;
+	}
+	//=================================================================================================//
+	size_t SparseMeshCellLinkedList
+		::BlockIndexFromCellIndex(const Vecu& cell_index, size_t& local_index_1d)
+	{
+		Vecu block_index(0);
+		Vecu local_index(0);
+		for (int n = 0; n != cell_index.size(); ++n) {
+			block_index[n] = cell_index[n] / block_width_;
+			local_index[n] = cell_index[n] % block_width_;
+		}
+		local_index_1d = transferMeshIndexTo1D(Vecu(block_width_), local_index);
+		return transferMeshIndexTo1D(number_of_blocks_, block_index);
+	}
+	//=================================================================================================//
+	CellListBlock* SparseMeshCellLinkedList::allocateABlock(size_t block_index_1d)
+	{
+		std::lock_guard<std::mutex> lock(mutex_block_allocation_);
+		CellListBlock* block = block_addrs_[block_index_1d].load();
+		if (block == nullptr)
+		{
+			if (free_blocks_.empty())
+			{
+				block = new CellListBlock(number_of_cells_in_block_);
+			}
+			else
+			{
+				block = free_blocks_.back();
+				free_blocks_.pop_back();
+			}
+			block->occupied_update_ = number_of_updates_;
+			allocated_blocks_.push_back(block_index_1d);
+			block_addrs_[block_index_1d].store(block);
+		}
+		return block;
+	}
+	//=================================================================================================//
+	CellList* SparseMeshCellLinkedList::findCellList(const Vecu& cell_index)
+	{
+		size_t local_index_1d;
+		CellListBlock* block = block_addrs_[BlockIndexFromCellIndex(cell_index, local_index_1d)].load();
+		return block == nullptr ? nullptr : &block->cell_lists_[local_index_1d];
+	}
+	//=================================================================================================//
+	CellList& SparseMeshCellLinkedList::CellListAllocatedFromIndex(const Vecu& cell_index)
+	{
+		size_t local_index_1d;
+		size_t block_index_1d = BlockIndexFromCellIndex(cell_index, local_index_1d);
+		CellListBlock* block = block_addrs_[block_index_1d].load();
+		if (block == nullptr) block = allocateABlock(block_index_1d);
+		return block->cell_lists_[local_index_1d];
+	}
+	//=================================================================================================//
+	CellList& SparseMeshCellLinkedList::CellListFrom1DIndex(size_t cell_index_1d)
+	{
+		return CellListAllocatedFromIndex(transfer1DtoMeshIndex(number_of_cells_, cell_index_1d));
+	}
+	//=================================================================================================//
+	CellList* SparseMeshCellLinkedList::CellListFormIndex(Vecu cell_index)
+	{
+		size_t local_index_1d;
+		size_t block_index_1d = BlockIndexFromCellIndex(cell_index, local_index_1d);
+		CellListBlock* block = block_addrs_[block_index_1d].load();
+		if (block == nullptr) block = allocateABlock(block_index_1d);
+		block->is_pinned_ = true;
+		return &block->cell_lists_[local_index_1d];
+	}
+	//=================================================================================================//
+	CellListDataVector& SparseMeshCellLinkedList::CellListDataFromIndex(const Vecu& cell_index)
+	{
+		CellList* cell_list = findCellList(cell_index);
+		return cell_list == nullptr ? empty_cell_list_.cell_list_data_ : cell_list->cell_list_data_;
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList::allocateMeshDataMatrix()
+	{
+		deleteMeshDataMatrix();
+		size_t total_number_of_blocks = TotalNumberOfBlocks();
+		block_addrs_ = new std::atomic<CellListBlock*>[total_number_of_blocks];
+		for (size_t l = 0; l != total_number_of_blocks; ++l) block_addrs_[l] = nullptr;
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList::deleteMeshDataMatrix()
+	{
+		if (block_addrs_ == nullptr) return;
+
+		for (size_t l = 0; l != allocated_blocks_.size(); ++l)
+			delete block_addrs_[allocated_blocks_[l]].load();
+		for (size_t l = 0; l != free_blocks_.size(); ++l)
+			delete free_blocks_[l];
+		allocated_blocks_.clear();
+		free_blocks_.clear();
+		occupied_cells_.clear();
+		cells_with_extra_data_.clear();
+
+		delete[] block_addrs_;
+		block_addrs_ = nullptr;
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList::clearOccupiedCellLists()
+	{
+		parallel_for(blocked_range<size_t>(0, occupied_cells_.size()),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t l = r.begin(); l != r.end(); ++l) {
+					CellList& cell_list = CellListFrom1DIndex(occupied_cells_[l]);
+					cell_list.real_particle_indexes_.clear();
+					cell_list.cell_list_data_.clear();
+				}
+			}, update_affinity_);
+		for (size_t l = 0; l != cells_with_extra_data_.size(); ++l) {
+			CellList& cell_list = CellListFrom1DIndex(cells_with_extra_data_[l]);
+			cell_list.concurrent_particle_indexes_.clear();
+			cell_list.cell_list_data_.clear();
+		}
+
+		occupied_cells_.clear();
+		cells_with_extra_data_.clear();
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList::recycleUnoccupiedBlocks()
+	{
+		IndexVector retained_blocks;
+		for (size_t l = 0; l != allocated_blocks_.size(); ++l) {
+			size_t block_index_1d = allocated_blocks_[l];
+			CellListBlock* block = block_addrs_[block_index_1d].load();
+			if (block->is_pinned_ || block->occupied_update_ == number_of_updates_)
+			{
+				retained_blocks.push_back(block_index_1d);
+			}
+			else
+			{
+				free_blocks_.push_back(block);
+				block_addrs_[block_index_1d].store(nullptr);
+			}
+		}
+
+		allocated_blocks_.clear();
+		for (size_t l = 0; l != retained_blocks.size(); ++l)
+			allocated_blocks_.push_back(retained_blocks[l]);
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList::UpdateCellLists()
+	{
+		clearOccupiedCellLists();
+		number_of_updates_++;
+
+		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		size_t number_of_particles = body_->number_of_particles_;
+		cell_sorted_particles_.resize(number_of_particles);
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					cell_sorted_particles_[i] 
+						= std::make_pair(transferMeshIndexTo1D(number_of_cells_, GridIndexFromPosition(pos_n[i])), i);
+			}, update_affinity_);
+		/** sorted by cells and then by particles, so that the cell lists are in ascending particle order */
+		parallel_sort(cell_sorted_particles_.begin(), cell_sorted_particles_.end());
+
+		/** collect the occupied cells, whose blocks are allocated or kept */
+		occupied_cell_offsets_.clear();
+		for (size_t i = 0; i != number_of_particles; ++i) {
+			size_t cell_index_1d = cell_sorted_particles_[i].first;
+			if (i == 0 || cell_index_1d != cell_sorted_particles_[i - 1].first) {
+				occupied_cells_.push_back(cell_index_1d);
+				occupied_cell_offsets_.push_back(i);
+			}
+		}
+		occupied_cell_offsets_.push_back(number_of_particles);
+
+		size_t number_of_occupied_cells = occupied_cells_.size();
+		for (size_t l = 0; l != number_of_occupied_cells; ++l) {
+			size_t local_index_1d;
+			size_t block_index_1d = BlockIndexFromCellIndex(
+				transfer1DtoMeshIndex(number_of_cells_, occupied_cells_[l]), local_index_1d);
+			CellListBlock* block = block_addrs_[block_index_1d].load();
+			if (block == nullptr) block = allocateABlock(block_index_1d);
+			block->occupied_update_ = number_of_updates_;
+		}
+		recycleUnoccupiedBlocks();
+
+		parallel_for(blocked_range<size_t>(0, number_of_occupied_cells),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t l = r.begin(); l != r.end(); ++l) {
+					CellList& cell_list = CellListFrom1DIndex(occupied_cells_[l]);
+					for (size_t s = occupied_cell_offsets_[l]; s != occupied_cell_offsets_[l + 1]; ++s) {
+						size_t particle_index = cell_sorted_particles_[s].second;
+						cell_list.real_particle_indexes_.push_back(particle_index);
+						cell_list.cell_list_data_.emplace_back(make_pair(particle_index, pos_n[particle_index]));
+					}
+				}
+			}, update_affinity_);
+
+		SplitCellLists& split_cell_lists = body_->split_cell_lists_;
+		ClearSplitCellLists(split_cell_lists);
+		for (size_t l = 0; l != number_of_occupied_cells; ++l) {
+			Vecu cell_index = transfer1DtoMeshIndex(number_of_cells_, occupied_cells_[l]);
+			Vecu split_index(0);
+			for (int n = 0; n != cell_index.size(); ++n) split_index[n] = cell_index[n] % 3;
+			split_cell_lists[transferMeshIndexTo1D(Vecu(3), split_index)]
+				.push_back(&CellListFrom1DIndex(occupied_cells_[l]));
+		}
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList
+		::InsertACellLinkedParticleIndex(size_t particle_index, Vecd particle_position)
+	{
+		Vecu cellpos = GridIndexFromPosition(particle_position);
+		cells_with_extra_data_.push_back(transferMeshIndexTo1D(number_of_cells_, cellpos));
+		CellListAllocatedFromIndex(cellpos).concurrent_particle_indexes_.emplace_back(particle_index);
+	}
+	//=================================================================================================//
+	void SparseMeshCellLinkedList
+		::InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position)
+	{
+		Vecu cellpos = GridIndexFromPosition(particle_position);
+		cells_with_extra_data_.push_back(transferMeshIndexTo1D(number_of_cells_, cellpos));
+		CellListAllocatedFromIndex(cellpos).cell_list_data_
+			.emplace_back(make_pair(particle_index, particle_position));
+	}
+	//=================================================================================================//
 	MultilevelMeshCellLinkedList
 		::MultilevelMeshCellLinkedList(SPHBody* body, Vecd lower_bound,
 		Vecd upper_bound, Real reference_cell_spacing, size_t total_levels, size_t buffer_width)
 		: BaseMeshCellLinkedList(body, lower_bound, upper_bound, reference_cell_spacing, buffer_width),
-		total_levels_(total_levels)
+		total_levels_(total_levels), cell_linked_lists_(nullptr)
 	{
-		/**initialize lists. */
-		split_cell_lists_levels_.resize(total_levels);
-		cell_linked_lists_levels_.resize(total_levels);
-
 		/** build the zero level mesh first.*/
 		size_t middle_level = (total_levels - 1) / 2;
 		Real zero_level_cell_spacing = reference_cell_spacing * powern(2.0, (int)middle_level);
 		cell_spacing_levels_.push_back(zero_level_cell_spacing);
+		cutoff_radius_levels_.push_back(zero_level_cell_spacing);
 		MeshCellLinkedList* zero_level_mesh
 			= new MeshCellLinkedList(body, lower_bound,	upper_bound, zero_level_cell_spacing, buffer_width);
 		mesh_cell_linked_list_levels_.push_back(zero_level_mesh);
-		size_t number_of_split_cell_lists = powern(3, Vecd(0).size());
-		split_cell_lists_levels_[0].resize(number_of_split_cell_lists);
 		Vecu zero_level_number_of_cells = zero_level_mesh->NumberOfCells();
 		number_of_cells_levels_.push_back(zero_level_number_of_cells);
 		/** copy zero level mesh perperties to this. */
@@ -109,16 +483,23 @@ namespace SPH {
 		for (size_t level = 1; level != total_levels; ++level) {
 			Real cell_spacing = zero_level_cell_spacing * powern(0.5, (int)level);
 			cell_spacing_levels_.push_back(cell_spacing);
+			cutoff_radius_levels_.push_back(cell_spacing);
 			Vecu number_of_cells
 				= zero_level_number_of_cells * powern(2, (int)level);
 			MeshCellLinkedList* mesh_cell_linked_list_level
 				= new MeshCellLinkedList(body, mesh_lower_bound_, number_of_cells, cell_spacing);
 			mesh_cell_linked_list_levels_.push_back(mesh_cell_linked_list_level);
-			split_cell_lists_levels_[level].resize(number_of_split_cell_lists);
 			number_of_cells_levels_.push_back(number_of_cells);
 		}
 	}
 	//=================================================================================================//
+	MultilevelMeshCellLinkedList::~MultilevelMeshCellLinkedList()
+	{
+		deleteMeshDataMatrix();
+		for (size_t level = 0; level != total_levels_; ++level)
+			delete mesh_cell_linked_list_levels_[level];
+	}
+	//=================================================================================================//
 	size_t MultilevelMeshCellLinkedList
 		::getLevelFromCutOffRadius(Real smoothing_length)
 	{
@@ -126,67 +507,41 @@ namespace SPH {
 		Real cut_off_radius = kernel_->GetCutOffRadius(smoothing_length);
 		for (size_t level = 1; level != cell_spacing_levels_.size(); ++level)
 		{
-			if (cut_off_radius < 0.5 * cell_spacing_levels_[level - 1]) current_level = level;
+			if (cut_off_radius <= 0.5 * cell_spacing_levels_[level - 1]) current_level = level;
 		}
 		return current_level;
 	}
 	//=================================================================================================//
-	Vecu MultilevelMeshCellLinkedList::getLevelCellIndexesFromPosition(Vecd& position, size_t level)
-	{
-		Real cell_spacing = cell_spacing_levels_[level];
-		Vecu& number_of_cells = number_of_cells_levels_[level];
-		Vecd rltpos = position - mesh_lower_bound_;
-		Vecu cell_pos(0);
-		for (int n = 0; n < rltpos.size(); n++)
-		{
-			cell_pos[n] = clamp((int)floor(rltpos[n] / cell_spacing),
-				0, int(number_of_cells[n]) - 1);
-		}
-		return cell_pos;
-	}
-	//=================================================================================================//
 	void MultilevelMeshCellLinkedList::
-		InsertACellLinkedParticleIndex(size_t index_i, Vecd particle_position)
-	{
-		size_t current_level = 0;
-		Real cut_off_radius = kernel_->GetCutOffRadius(base_particles_->smoothing_length_[index_i]);
-		Vecd& position = base_particles_->pos_n_[index_i];
-		Vecu current_cell_index(0);
-		for (size_t level = 1; level != cell_spacing_levels_.size(); ++level)
-		{
-			if (cut_off_radius < 0.5 * cell_spacing_levels_[level - 1]) {
-				current_level = level;
-				current_cell_index = getLevelCellIndexesFromPosition(position, level);
-				InsertACellLinkedListEntryAtALevel(index_i, position, current_cell_index, level);
-			}
-		}
-		mesh_cell_linked_list_levels_[current_level]->InsertACellLinkedParticleIndex(index_i, particle_position);
-	}
-	//=================================================================================================//
-	void MultilevelMeshCellLinkedList::allocateMeshDataMatrix()
+		InsertACellLinkedParticleIndex(size_t particle_index, Vecd particle_position)
 	{
-		for (size_t l = 0; l != total_levels_; ++l) {
-			mesh_cell_linked_list_levels_[l]->allocateMeshDataMatrix();
-		}
+		size_t level = getLevelFromCutOffRadius(base_particles_->smoothing_length_[particle_index]);
+		MeshCellLinkedList* mesh_cell_linked_list_level = mesh_cell_linked_list_levels_[level];
+		mesh_cell_linked_list_level->CellListFormIndex(mesh_cell_linked_list_level->GridIndexFromPosition(particle_position))
+			->concurrent_particle_indexes_.push_back(particle_index);
+		CellListFormIndex(GridIndexFromPosition(particle_position))
+			->concurrent_particle_indexes_.push_back(particle_index);
 	}
 	//=================================================================================================//
-	void MultilevelMeshCellLinkedList::deleteMeshDataMatrix()
+	void MultilevelMeshCellLinkedList::
+		InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position)
 	{
-		for (size_t l = 0; l != total_levels_; ++l) {
-			mesh_cell_linked_list_levels_[l]->deleteMeshDataMatrix();
-		}
+		size_t level = getLevelFromCutOffRadius(base_particles_->smoothing_length_[particle_index]);
+		MeshCellLinkedList* mesh_cell_linked_list_level = mesh_cell_linked_list_levels_[level];
+		mesh_cell_linked_list_level->CellListDataFromIndex(mesh_cell_linked_list_level->GridIndexFromPosition(particle_position))
+			.emplace_back(make_pair(particle_index, particle_position));
+		CellListDataFromIndex(GridIndexFromPosition(particle_position))
+			.emplace_back(make_pair(particle_index, particle_position));
 	}
 	//=================================================================================================//
 	void MultilevelMeshCellLinkedList::UpdateCellLists()
 	{
-		for (size_t level = 0; level != total_levels_; ++level) {
-			matrix_cell cell_linked_list
-				= mesh_cell_linked_list_levels_[level]->CellLinkedLists();
-			ClearCellLists(number_of_cells_levels_[level], cell_linked_list);
-			ClearCellLists(number_of_cells_levels_[level], cell_linked_lists_levels_[level]);
+		ClearCellLists(number_of_cells_, cell_linked_lists_);
+		for (size_t level = 0; level != total_levels_; ++level)
+			ClearCellLists(number_of_cells_levels_[level], mesh_cell_linked_list_levels_[level]->CellLinkedLists());
 
-		}
 		StdLargeVec<Vecd>& pos_n = base_particles_->pos_n_;
+		StdLargeVec<Real>& smoothing_length = base_particles_->smoothing_length_;
 		size_t number_of_particles = body_->number_of_particles_;
 		//rebuild the corresponding particle list.
 		parallel_for(blocked_range<size_t>(0, number_of_particles),
@@ -194,16 +549,26 @@ namespace SPH {
 				for (size_t i = r.begin(); i != r.end(); ++i) {
 					InsertACellLinkedParticleIndex(i, pos_n[i]);
 				}
-			}, ap);
+			}, update_affinity_);
 
-		for (size_t level = 0; level != total_levels_; ++level) {
-			matrix_cell cell_linked_list
-				= mesh_cell_linked_list_levels_[level]->CellLinkedLists();
-			UpdateSplitCellLists(split_cell_lists_levels_[level],
-				number_of_cells_levels_[level], cell_linked_list);
-		}
-		UpdateSplitCellLists(body_->split_cell_lists_, 
-			number_of_cells_levels_[0], cell_linked_lists_levels_[0]);
+		/** the coarsest level also takes the particles with a cutoff radius larger than its cell spacing */
+		Real max_smoothing_length = parallel_reduce(blocked_range<size_t>(0, number_of_particles),
+			Real(0),
+			[&](const blocked_range<size_t>& r, Real temp) -> Real {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					temp = SMAX(temp, smoothing_length[i]);
+				return temp;
+			},
+			[](Real x, Real y) -> Real {
+				return SMAX(x, y);
+			}
+			);
+		cutoff_radius_levels_[0] = SMAX(cell_spacing_levels_[0], kernel_->GetCutOffRadius(max_smoothing_length));
+
+		for (size_t level = 0; level != total_levels_; ++level)
+			UpdateCellListData(number_of_cells_levels_[level], mesh_cell_linked_list_levels_[level]->CellLinkedLists());
+		UpdateCellListData(number_of_cells_, cell_linked_lists_);
+		UpdateSplitCellLists(body_->split_cell_lists_, number_of_cells_, cell_linked_lists_);
 	}
 	//=================================================================================================//
 }
\ No newline at end of file
@@ -35,6 +35,9 @@
 
 #include "base_mesh.h"
 
+#include <atomic>
+#include <mutex>
+
 namespace SPH {
 
 	class SPHSystem;
@@ -55,6 +58,9 @@ namespace SPH {
 		CellListDataVector cell_list_data_;
 		/** the index vector for iterate particles in a split scheme. */
 		IndexVector real_particle_indexes_;
+		/** the estimated cost of the cell in a split scheme,
+		 * i.e. the number of real particles plus their neighbors, updated at configuration rebuilds. */
+		size_t cost_;
 
 		CellList();
 		~CellList() {};
@@ -70,6 +76,9 @@ namespace SPH {
 		SPHBody* body_;
 		BaseParticles* base_particles_;
 		Kernel* kernel_;
+		/** partitioner of the parallel loops updating this cell linked list, which is not shared
+		  * with other cell linked lists so that those of several bodies can be updated concurrently. */
+		affinity_partitioner update_affinity_;
 
 		/** clear the cell lists */
 		void ClearCellLists(Vecu& number_of_cells, matrix_cell cell_linked_lists);
@@ -79,7 +88,7 @@ namespace SPH {
 		void UpdateSplitCellLists(SplitCellLists& split_cell_lists,
 			Vecu& number_of_cells, matrix_cell cell_linked_lists);
 		/** update cell linked list data in this mesh */
-		void UpdateCellListData(matrix_cell cell_linked_lists);
+		void UpdateCellListData(Vecu& number_of_cells, matrix_cell cell_linked_lists);
 	public:
 		/** The buffer size 2 used to expand computational domian for particle searching. */
 		BaseMeshCellLinkedList(SPHBody* body, Vecd lower_bound, Vecd upper_bound, 
@@ -95,10 +104,10 @@ namespace SPH {
 			int target_refinement_level);
 		/** choose a kernel for building up inter refinement level configuration */
 		Kernel& ChoosingKernel(Kernel* original_kernel, Kernel* target_kernel);
-		/** get the address of cell list */
+		/** get the address of cell list, which is kept valid during the simulation */
 		virtual CellList* CellListFormIndex(Vecu cell_index) = 0;
-		/** Get the array for of mesh cell linked lists.*/
-		virtual matrix_cell CellLinkedLists() = 0;
+		/** get the list data of a cell for neighbor searching, empty for an unoccupied cell */
+		virtual CellListDataVector& CellListDataFromIndex(const Vecu& cell_index) = 0;
 
 		/** Assign base particles to the mesh cell linked list. */
 		void assignBaseParticles(BaseParticles* base_particles);
@@ -114,12 +123,19 @@ namespace SPH {
 
 		/** find the nearest list data entry */
 		virtual ListData findNearestListDataEntry(Vecd& position) = 0;
+
+		/** computing the sorting keys of the real particles from the Morton order of their cells */
+		void computingSequence(StdLargeVec<size_t>& sequence);
 	};
 
 	/**
 	 * @class MeshCellLinkedList
 	 * @brief Defining a mesh cell linked list for a body.
 	 * The meshes for all bodies share the same global coordinates.
+	 * By default, the cell lists are updated by a counting sort of the particles,
+	 * which only touches the occupied cells. The original update, 
+	 * clearing and rebuilding all cells with concurrent vectors, is kept for comparison.
+	 * Note that the counting sort does not fill concurrent_particle_indexes_ of the cell lists.
 	 */
 	class MeshCellLinkedList : public BaseMeshCellLinkedList
 	{
@@ -129,6 +145,34 @@ namespace SPH {
 		/** The array for of mesh cells, i.e. mesh data.
 		 * Within each cell, a list is saved with the indexes of particles.*/
 		matrix_cell cell_linked_lists_;
+
+		/** whether the cell lists are updated by counting sort */
+		bool use_counting_sort_;
+		/** whether the last update was carried out by the original rebuilding */
+		bool is_rebuilt_;
+		/** particle counts of cells, which are zero except during updating */
+		std::atomic<size_t>* cell_counts_;
+		/** 1D indexes of the cells of the particles */
+		StdLargeVec<size_t> particle_cells_;
+		/** occupied cells in ascending order of their 1D indexes */
+		ConcurrentIndexVector occupied_cells_;
+		/** offsets of the occupied cells in the particles sorted by cells */
+		IndexVector occupied_cell_offsets_;
+		/** particle indexes sorted by cells */
+		StdLargeVec<size_t> cell_sorted_particles_;
+		/** cells with data entries inserted after updating, such as ghost particles */
+		ConcurrentIndexVector cells_with_extra_data_;
+
+		size_t TotalNumberOfCells();
+		CellList& CellListFrom1DIndex(size_t cell_index_1d);
+		/** clear the cell lists with data since last update */
+		void clearOccupiedCellLists();
+		/** clear all cell lists, including their data entries */
+		void clearAllCellLists();
+		/** original update, clearing and rebuilding all cells */
+		void UpdateCellListsByRebuilding();
+		/** update by per-cell counts, prefix sum and scatter into the particles sorted by cells */
+		void UpdateCellListsByCountingSort();
 	public:
 		/** The buffer size 2 used to expand computational domian for particle searching. */
 		MeshCellLinkedList(SPHBody* body, Vecd lower_bound, Vecd upper_bound,
@@ -141,8 +185,118 @@ namespace SPH {
 
 		/** access protected members */
 		virtual CellList* CellListFormIndex(Vecu cell_index) override;
+		virtual CellListDataVector& CellListDataFromIndex(const Vecu& cell_index) override;
 		/** Get the array for of mesh cell linked lists.*/
-		virtual matrix_cell CellLinkedLists() override { return cell_linked_lists_; };
+		matrix_cell CellLinkedLists() { return cell_linked_lists_; };
+
+		/** allcate memories for mesh data */
+		virtual void allocateMeshDataMatrix() override;
+		/** delete memories for mesh data */
+		virtual void deleteMeshDataMatrix() override;
+
+		/** update the cell lists */
+		virtual void UpdateCellLists() override;
+		/** choose the counting sort or the original rebuilding for updating the cell lists */
+		void setCountingSortUpdate(bool use_counting_sort) { use_counting_sort_ = use_counting_sort; };
+
+		/** output mesh data for visualization */
+		virtual void writeMeshToVtuFile(ofstream &output_file) override {};
+		virtual void writeMeshToPltFile(ofstream &output_file) override {};
+
+		/** Insert a cell-linked_list entry. */
+		void InsertACellLinkedParticleIndex(size_t particle_index, Vecd particle_position) override;
+		void InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position) override;
+
+		/** find the nearest list data entry */
+		virtual ListData findNearestListDataEntry(Vecd& position) override;
+	};
+
+	/**
+	 * @class CellListBlock
+	 * @brief A block of cell lists allocated together in a sparse mesh cell linked list.
+	 */
+	class CellListBlock
+	{
+	public:
+		/** cell lists in the block, in row-major order of their local indexes */
+		StdVec<CellList> cell_lists_;
+		/** whether the block is referred by body parts, and should not be recycled */
+		bool is_pinned_;
+		/** the last update when the block was occupied */
+		size_t occupied_update_;
+
+		explicit CellListBlock(size_t number_of_cells)
+			: cell_lists_(number_of_cells), is_pinned_(false), occupied_update_(0) {};
+		~CellListBlock() {};
+	};
+
+	/**
+	 * @class SparseMeshCellLinkedList
+	 * @brief Defining a block-sparse mesh cell linked list for a body.
+	 * The mesh is the same as that of MeshCellLinkedList, 
+	 * but the cells are grouped into blocks which are only allocated when occupied,
+	 * so that the memory and updating cost scale with the occupied cells rather than 
+	 * the volume of the domain. This is suitable for large and mostly empty domains.
+	 * Blocks unoccupied at an update are recycled, except those referred by body parts.
+	 * The particles are sorted by cells in the update. 
+	 * Note that the update does not fill concurrent_particle_indexes_ of the cell lists.
+	 */
+	class SparseMeshCellLinkedList : public BaseMeshCellLinkedList
+	{
+	protected:
+		/** number of cells along each direction in a block */
+		size_t block_width_;
+		/** number of cells in a block */
+		size_t number_of_cells_in_block_;
+		/** number of blocks by dimension */
+		Vecu number_of_blocks_;
+		/** addresses of blocks, null for unallocated blocks */
+		std::atomic<CellListBlock*>* block_addrs_;
+		/** 1D indexes of the allocated blocks */
+		ConcurrentIndexVector allocated_blocks_;
+		/** blocks for recycling */
+		StdVec<CellListBlock*> free_blocks_;
+		/** for allocating blocks when inserting data entries in parallel */
+		std::mutex mutex_block_allocation_;
+		/** the cell list returned for cells in unallocated blocks */
+		CellList empty_cell_list_;
+		/** number of updates so far */
+		size_t number_of_updates_;
+
+		/** particles sorted by the 1D indexes of their cells, paired as (cell, particle) */
+		StdLargeVec<std::pair<size_t, size_t>> cell_sorted_particles_;
+		/** occupied cells in ascending order of their 1D indexes */
+		IndexVector occupied_cells_;
+		/** offsets of the occupied cells in the particles sorted by cells */
+		IndexVector occupied_cell_offsets_;
+		/** cells with data entries inserted after updating, such as ghost particles */
+		ConcurrentIndexVector cells_with_extra_data_;
+
+		size_t TotalNumberOfBlocks();
+		/** get the block index and the local cell index in the block of a cell */
+		size_t BlockIndexFromCellIndex(const Vecu& cell_index, size_t& local_index_1d);
+		/** find a cell list, null if its block is not allocated */
+		CellList* findCellList(const Vecu& cell_index);
+		/** get a cell list, allocating its block when necessary */
+		CellList& CellListAllocatedFromIndex(const Vecu& cell_index);
+		CellList& CellListFrom1DIndex(size_t cell_index_1d);
+		CellListBlock* allocateABlock(size_t block_index_1d);
+		/** clear the cell lists with data since last update */
+		void clearOccupiedCellLists();
+		/** recycle the blocks which are neither occupied at this update nor pinned */
+		void recycleUnoccupiedBlocks();
+	public:
+		/** The buffer size 2 used to expand computational domian for particle searching. */
+		SparseMeshCellLinkedList(SPHBody* body, Vecd lower_bound, Vecd upper_bound,
+			Real cell_spacing, size_t buffer_width = 2, size_t block_width = 4);
+		/**In the destructor, the dynamically located memory is released.*/
+		virtual ~SparseMeshCellLinkedList() { deleteMeshDataMatrix(); };
+
+		/** access protected members, the block of the cell is allocated and pinned */
+		virtual CellList* CellListFormIndex(Vecu cell_index) override;
+		virtual CellListDataVector& CellListDataFromIndex(const Vecu& cell_index) override;
+		/** number of allocated blocks, for monitoring the memory */
+		size_t NumberOfAllocatedBlocks() { return allocated_blocks_.size(); };
 
 		/** allcate memories for mesh data */
 		virtual void allocateMeshDataMatrix() override;
@@ -168,6 +322,13 @@ namespace SPH {
 	  * @class MultilevelMeshCellLinkedList
 	  * @brief Defining a multimesh cell linked list for a body
 	  * for multiresolution particle configuration.
+	  * Each particle is binned at the level matching its smoothing length,
+	  * i.e. the finest level whose cell spacing is not smaller than its cutoff radius,
+	  * so that the neighbors are searched level by level with a small search range.
+	  * All particles are also projected to the coarsest level,
+	  * which gives the split cell lists and the access to the cell lists by cell index.
+	  * Note that the particles with a cutoff radius larger than the coarsest cell spacing
+	  * are binned at the coarsest level, for which the split algorithms are not safe.
 	  */
 	class MultilevelMeshCellLinkedList : public BaseMeshCellLinkedList
 	{
@@ -179,30 +340,31 @@ namespace SPH {
 		StdVec<Real> cell_spacing_levels_;
 		/** number of cells by dimension */
 		StdVec<Vecu> number_of_cells_levels_;
-		/** split cell list for building configuration.*/
-		StdVec<SplitCellLists> split_cell_lists_levels_;
-		/** Projected cell linked lists for building configuration.*/
-		StdVec<MeshDataMatrix<CellList>> cell_linked_lists_levels_;
+		/** the upper bound of the cutoff radii of the particles binned at each level */
+		StdVec<Real> cutoff_radius_levels_;
 		/** point to every mesh level. */
 		StdVec<MeshCellLinkedList*> mesh_cell_linked_list_levels_;
+		/** cell linked lists with all particles projected to the coarsest level */
+		matrix_cell cell_linked_lists_;
 
 		/** determine mesh level of a particle. */
 		size_t getLevelFromCutOffRadius(Real smoothing_length);
-		/** find cell indexes from point position in a level */
-		Vecu getLevelCellIndexesFromPosition(Vecd& position, size_t level);
-		/** Insert a cell-linked_list entry to the projected particle list. */
-		void InsertACellLinkedListEntryAtALevel(size_t particle_index, Vecd& position, Vecu& cell_index, size_t level);
 	public:
 		/** Constructor to achieve alignment of all mesh levels. */
 		MultilevelMeshCellLinkedList(SPHBody* body, Vecd lower_bound, Vecd upper_bound,
 			Real reference_cell_spacing, size_t total_levels = 1, size_t buffer_width = 2);
 		/**In the destructor, the dynamically located memory is released.*/
-		virtual ~MultilevelMeshCellLinkedList() {};
+		virtual ~MultilevelMeshCellLinkedList();
 
 		/** access protected members */
 		virtual CellList* CellListFormIndex(Vecu cell_index) override;
+		virtual CellListDataVector& CellListDataFromIndex(const Vecu& cell_index) override;
 		/** Get the array for of mesh cell linked lists.*/
-		virtual matrix_cell CellLinkedLists() override { return cell_linked_lists_levels_[0]; };
+		matrix_cell CellLinkedLists() { return cell_linked_lists_; };
+		size_t TotalLevels() { return total_levels_; };
+		/** the cell linked list with only the particles binned at a level */
+		MeshCellLinkedList* MeshCellLinkedListAtLevel(size_t level) { return mesh_cell_linked_list_levels_[level]; };
+		Real CutOffRadiusAtLevel(size_t level) { return cutoff_radius_levels_[level]; };
 
 		/** allcate memories for mesh data */
 		virtual void allocateMeshDataMatrix() override;
@@ -212,12 +374,11 @@ namespace SPH {
 		/** update the cell lists */
 		virtual void UpdateCellLists() override;
 
-		/** Insert a cell-linked_list entry to the projected particle list. */
+		/** Insert a cell-linked_list entry at the level of the particle and to the projected particle list. */
 		void InsertACellLinkedParticleIndex(size_t particle_index, Vecd particle_position) override;
-		void InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position) override {};
+		void InsertACellLinkedListDataEntry(size_t particle_index, Vecd particle_position) override;
 
 		/** find the nearest list data entry */
-		virtual ListData findNearestListDataEntry(Vecd& position) override { return ListData(0, Vecd(0)); };
-
+		virtual ListData findNearestListDataEntry(Vecd& position) override;
 	};
 }
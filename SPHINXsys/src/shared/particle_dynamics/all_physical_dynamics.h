@@ -6,6 +6,8 @@ particle dynamics capabilities. **/
 
 #include "external_force.h"
 #include "general_dynamics.h"
+#include "domain_decomposition.h"
+#include "particle_splitting_merging.h"
 #include "fluid_dynamics.h"
 #include "solid_dynamics.h"
 #include "observer_dynamics.h"
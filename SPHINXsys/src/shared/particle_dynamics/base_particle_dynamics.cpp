@@ -16,14 +16,15 @@ namespace SPH
 			inner_functor(i, dt);
 	}
 	//=============================================================================================//
-	void InnerIterator_parallel(size_t number_of_particles, InnerFunctor &inner_functor, Real dt)
+	void InnerIterator_parallel(size_t number_of_particles, InnerFunctor &inner_functor,
+		LoopPartitioner& loop_partitioner, Real dt)
 	{
-		parallel_for(blocked_range<size_t>(0, number_of_particles),
+		parallel_for(loop_partitioner.ParticleRange(number_of_particles),
 			[&](const blocked_range<size_t>& r) {
 			for (size_t i = r.begin(); i < r.end(); ++i) {
 				inner_functor(i, dt);
 			}
-		}, ap);
+		}, loop_partitioner.ParticleLoopAffinity());
 	}
 	//=================================================================================================//
 	void CellListIteratorSplitting(SplitCellLists& split_cell_lists,
@@ -44,28 +45,28 @@ namespace SPH
 		}
 	}
 	//=================================================================================================//
-	void CellListIteratorSplitting_parallel(SplitCellLists& split_cell_lists,
-		CellListFunctor& cell_list_functor, Real dt)
+	void CellListIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		CellListFunctor& cell_list_functor, LoopPartitioner& loop_partitioner, Real dt)
 	{
 		//forward sweeping
 		for (size_t k = 0; k != split_cell_lists.size(); ++k) {
 			ConcurrentCellLists& cell_lists = split_cell_lists[k];
-			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
-				[&](const blocked_range<size_t>& r) {
-					for (size_t l = r.begin(); l < r.end(); ++l)
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k], k,
+				[&](size_t begin, size_t end) {
+					for (size_t l = begin; l < end; ++l)
 						cell_list_functor(cell_lists[l], dt);
-				}, ap);
+				});
 		}
 	
 		//backward sweeping
 		for (size_t k = split_cell_lists.size(); k >= 1; --k) {
 			ConcurrentCellLists& cell_lists = split_cell_lists[k - 1];
-			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
-				[&](const blocked_range<size_t>& r) {
-					for (size_t l = r.end(); l >= r.begin() + 1; --l) {
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k - 1], split_cell_lists.size() + k - 1,
+				[&](size_t begin, size_t end) {
+					for (size_t l = end; l >= begin + 1; --l) {
 						cell_list_functor(cell_lists[l -1], dt);
 					}
-				}, ap);
+				});
 		}
 	}
 	//=================================================================================================//
@@ -86,14 +87,14 @@ namespace SPH
 		}
 	}
 	//=================================================================================================//
-	void InnerIteratorSplitting_parallel(SplitCellLists& split_cell_lists,
-		InnerFunctor& inner_functor, Real dt)
+	void InnerIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		InnerFunctor& inner_functor, LoopPartitioner& loop_partitioner, Real dt)
 	{
 		for (size_t k = 0; k != split_cell_lists.size(); ++k) {
 			ConcurrentCellLists& cell_lists = split_cell_lists[k];
-			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
-				[&](const blocked_range<size_t>& r) {
-					for (size_t l = r.begin(); l < r.end(); ++l) {
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k], k,
+				[&](size_t begin, size_t end) {
+					for (size_t l = begin; l < end; ++l) {
 						IndexVector& particle_indexes
 							= cell_lists[l]->real_particle_indexes_;
 						for (size_t i = 0; i < particle_indexes.size(); ++i)
@@ -101,7 +102,7 @@ namespace SPH
 							inner_functor(particle_indexes[i], dt);
 						}
 					}
-				}, ap);
+				});
 		}
 	}
 	//=================================================================================================//
@@ -138,16 +139,16 @@ namespace SPH
 		}
 	}
 	//=================================================================================================//
-	void InnerIteratorSplittingSweeping_parallel(SplitCellLists& split_cell_lists,
-		InnerFunctor &inner_functor, Real dt)
+	void InnerIteratorSplittingSweeping_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		InnerFunctor &inner_functor, LoopPartitioner& loop_partitioner, Real dt)
 	{
 		Real dt2 = dt * 0.5;
 		//forward sweeping
 		for (size_t k = 0; k != split_cell_lists.size(); ++k) {
 			ConcurrentCellLists& cell_lists = split_cell_lists[k];
-			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
-				[&](const blocked_range<size_t>& r) {
-					for (size_t l = r.begin(); l < r.end(); ++l) {
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k], k,
+				[&](size_t begin, size_t end) {
+					for (size_t l = begin; l < end; ++l) {
 						IndexVector& particle_indexes
 							= cell_lists[l]->real_particle_indexes_;
 						for (size_t i = 0; i < particle_indexes.size(); ++i)
@@ -155,15 +156,15 @@ namespace SPH
 							inner_functor(particle_indexes[i], dt2);
 						}
 					}
-				}, ap);
+				});
 		}
 
 		//backward sweeping
 		for (size_t k = split_cell_lists.size(); k != 0; --k) {
 			ConcurrentCellLists& cell_lists = split_cell_lists[k - 1];
-			parallel_for(blocked_range<size_t>(0, cell_lists.size()),
-				[&](const blocked_range<size_t>& r) {
-				for (size_t l = r.begin(); l < r.end(); ++l) {
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k - 1], split_cell_lists.size() + k - 1,
+				[&](size_t begin, size_t end) {
+				for (size_t l = begin; l < end; ++l) {
 					IndexVector& particle_indexes
 						= cell_lists[l]->real_particle_indexes_;
 					for (size_t i = particle_indexes.size(); i != 0; --i)
@@ -171,7 +172,7 @@ namespace SPH
 						inner_functor(particle_indexes[i - 1], dt2);
 					}
 				}
-			}, ap);
+			});
 		}
 	}
 	//=============================================================================================//
@@ -37,6 +37,8 @@
 #include "all_meshes.h"
 #include "external_force.h"
 #include "body_relation.h"
+#include "dynamics_profiler.h"
+#include "loop_partitioner.h"
 #include <functional>
 
 using namespace std::placeholders;
@@ -52,7 +54,8 @@ namespace SPH
 	/** Iterators for inner functors. sequential computing. */
 	void InnerIterator(size_t number_of_particles, InnerFunctor &inner_functor, Real dt = 0.0);
 	/** Iterators for inner functors. parallel computing. */
-	void InnerIterator_parallel(size_t number_of_particles, InnerFunctor &inner_functor, Real dt = 0.0);
+	void InnerIterator_parallel(size_t number_of_particles, InnerFunctor &inner_functor,
+		LoopPartitioner& loop_partitioner, Real dt = 0.0);
 
 	/** Iterators for reduce functors. sequential computing. */
 	template <class ReturnType, typename ReduceOperation>
@@ -61,7 +64,8 @@ namespace SPH
 	/** Iterators for reduce functors. parallel computing. */
 	template <class ReturnType, typename ReduceOperation>
 	ReturnType ReduceIterator_parallel(size_t number_of_particles, ReturnType temp,
-		ReduceFunctor<ReturnType> &reduce_functor, ReduceOperation &reduce_operation, Real dt = 0.0);
+		ReduceFunctor<ReturnType> &reduce_functor, ReduceOperation &reduce_operation,
+		LoopPartitioner& loop_partitioner, Real dt = 0.0);
 
 	/** Functor for configuration operation. */
 	typedef std::function<void(CellList*, Real)> CellListFunctor;
@@ -69,21 +73,47 @@ namespace SPH
 	void CellListIteratorSplitting(SplitCellLists& split_cell_lists,
 		CellListFunctor& cell_list_functor, Real dt = 0.0);
 	/** Iterators for inner functors with splitting for configuration dynamics. parallel computing. */
-	void CellListIteratorSplitting_parallel(SplitCellLists& split_cell_lists,
-		CellListFunctor& cell_list_functor, Real dt = 0.0);
+	void CellListIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		CellListFunctor& cell_list_functor, LoopPartitioner& loop_partitioner, Real dt = 0.0);
 
 	/** Iterators for inner functors with splitting. sequential computing. */
 	void InnerIteratorSplitting(SplitCellLists& split_cell_lists,
 		InnerFunctor &inner_functor, Real dt = 0.0);
 	/** Iterators for inner functors with splitting. parallel computing. */
-	void InnerIteratorSplitting_parallel(SplitCellLists& split_cell_lists,
-		InnerFunctor &inner_functor, Real dt = 0.0);
+	void InnerIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		InnerFunctor &inner_functor, LoopPartitioner& loop_partitioner, Real dt = 0.0);
 	/** Iterators for inner functors with splitting. sequential computing. */
 	void InnerIteratorSplittingSweeping(SplitCellLists& split_cell_lists,
 		InnerFunctor& inner_functor, Real dt = 0.0);
 	/** Iterators for inner functors with splitting. parallel computing. */
-	void InnerIteratorSplittingSweeping_parallel(SplitCellLists& split_cell_lists,
-		InnerFunctor& inner_functor, Real dt = 0.0);
+	void InnerIteratorSplittingSweeping_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		InnerFunctor& inner_functor, LoopPartitioner& loop_partitioner, Real dt = 0.0);
+
+	/** Iterators for local functions, such as lambdas, which are inlined into the particle loop 
+	  * instead of being called through a functor. sequential computing. */
+	template <class LocalFunction>
+	void ParticleIterator(size_t number_of_particles, const LocalFunction& local_function, Real dt = 0.0);
+	/** Iterators for inlined local functions. parallel computing. */
+	template <class LocalFunction>
+	void ParticleIterator_parallel(size_t number_of_particles, const LocalFunction& local_function,
+		LoopPartitioner& loop_partitioner, Real dt = 0.0);
+	/** Iterators for inlined local reduce functions. sequential computing. */
+	template <class ReturnType, class LocalReduceFunction, typename ReduceOperation>
+	ReturnType ParticleReducer(size_t number_of_particles, ReturnType temp,
+		const LocalReduceFunction& local_reduce_function, ReduceOperation& reduce_operation, Real dt = 0.0);
+	/** Iterators for inlined local reduce functions. parallel computing. */
+	template <class ReturnType, class LocalReduceFunction, typename ReduceOperation>
+	ReturnType ParticleReducer_parallel(size_t number_of_particles, ReturnType temp,
+		const LocalReduceFunction& local_reduce_function, ReduceOperation& reduce_operation,
+		LoopPartitioner& loop_partitioner, Real dt = 0.0);
+	/** Iterators for inlined local functions with splitting. sequential computing. */
+	template <class LocalFunction>
+	void ParticleIteratorSplitting(SplitCellLists& split_cell_lists,
+		const LocalFunction& local_function, Real dt = 0.0);
+	/** Iterators for inlined local functions with splitting. parallel computing. */
+	template <class LocalFunction>
+	void ParticleIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		const LocalFunction& local_function, LoopPartitioner& loop_partitioner, Real dt = 0.0);
 
 
 	/** A Functor for Summation */
@@ -126,20 +156,75 @@ namespace SPH
 		static Real physical_time_;
 	};
 
+	/**
+	 * @class ParticleDataAccess
+	 * @brief The declared particle variables written by a dynamics
+	 * and those read from the neighbors in its interaction.
+	 * They are used to check whether the per-particle stages of two dynamics
+	 * can be fused into one loop over the particles.
+	 * A dynamics without declaration is never fused.
+	 */
+	class ParticleDataAccess
+	{
+	public:
+		ParticleDataAccess() : is_declared_(false) {};
+		virtual ~ParticleDataAccess() {};
+
+		template <typename VariableType>
+		ParticleDataAccess& writes(StdLargeVec<VariableType>& variable)
+		{
+			is_declared_ = true;
+			written_variables_.push_back(&variable);
+			return *this;
+		};
+		template <typename VariableType>
+		ParticleDataAccess& readsNeighbors(StdLargeVec<VariableType>& variable)
+		{
+			is_declared_ = true;
+			neighbor_read_variables_.push_back(&variable);
+			return *this;
+		};
+		bool isDeclared() const { return is_declared_; };
+		/** whether the stage with this access can be executed for each particle
+		  * directly before the stage with the next access in the same particle loop */
+		bool isFusibleBefore(const ParticleDataAccess& next_access) const
+		{
+			return is_declared_ && next_access.is_declared_
+				&& !isShared(written_variables_, next_access.neighbor_read_variables_)
+				&& !isShared(neighbor_read_variables_, next_access.written_variables_);
+		};
+	protected:
+		bool is_declared_;
+		StdVec<const void*> written_variables_;
+		StdVec<const void*> neighbor_read_variables_;
+
+		static bool isShared(const StdVec<const void*>& variables, const StdVec<const void*>& other_variables)
+		{
+			for (size_t i = 0; i != variables.size(); ++i)
+				for (size_t j = 0; j != other_variables.size(); ++j)
+					if (variables[i] == other_variables[j]) return true;
+			return false;
+		};
+	};
+
 	/**
 	* @class ParticleDynamics
 	* @brief The base class for all particle dynamics
 	* This class contains the only two interface functions available
 	* for particle dynamics. An specific implementation should be realized.
+	* When the profiler is enabled, the executions are timed 
+	* together with the particles and the neighbor entries of the profiled configurations.
+	* The parallel loops of the dynamics use its own partitioner and grain size,
+	* which may be auto-tuned during the first parallel executions.
 	*/
 	template <class ReturnType = void>
-	class ParticleDynamics : public GlobalStaticVariables
+	class ParticleDynamics : public GlobalStaticVariables, public ProfiledDynamics
 	{
 	public:
 		/** Constructor */
 		explicit ParticleDynamics(SPHBody* sph_body) 
-			: GlobalStaticVariables(), sph_body_(sph_body),
-			split_cell_lists_(sph_body->split_cell_lists_),
+			: GlobalStaticVariables(), ProfiledDynamics(sph_body->GetBodyName()), sph_body_(sph_body),
+			split_cell_lists_(sph_body->split_cell_lists_), split_cell_list_chunks_(sph_body->split_cell_list_chunks_),
 			mesh_cell_linked_list_(sph_body->mesh_cell_linked_list_) {};
 		virtual ~ParticleDynamics() {};
 
@@ -147,10 +232,32 @@ namespace SPH
 		  * One is for sequential execution, the other is for parallel. */
 		virtual ReturnType exec(Real dt = 0.0) = 0;
 		virtual ReturnType parallel_exec(Real dt = 0.0) = 0;
+
+		virtual size_t NumberOfNeighborEntries() override
+		{
+			size_t number_of_neighbor_entries = 0;
+			for (size_t k = 0; k != profiled_configurations_.size(); ++k)
+				number_of_neighbor_entries += profiled_configurations_[k]->offsets_.back();
+			return number_of_neighbor_entries;
+		};
+		ParticleDataAccess& DataAccess() { return data_access_; };
+		LoopPartitioner& LoopPartitioning() { return loop_partitioner_; };
+		virtual bool isAutoTuning() override { return loop_partitioner_.isTuning(); };
+		virtual void recordATimedExecution(Real wall_time) override
+		{
+			if (loop_partitioner_.recordAnExecution(wall_time))
+				LoopPartitioner::recordATunedGrainSize(DynamicsName(), loop_partitioner_.GrainSize());
+		};
 	protected:
 		SPHBody* sph_body_;
 		SplitCellLists& split_cell_lists_;
+		SplitCellListChunks& split_cell_list_chunks_;
 		BaseMeshCellLinkedList* mesh_cell_linked_list_;
+		/** the configurations visited by the dynamics */
+		StdVec<ParticleConfiguration*> profiled_configurations_;
+		/** declared in the constructor of a dynamics for fusing it with others */
+		ParticleDataAccess data_access_;
+		LoopPartitioner loop_partitioner_;
 
 		void setBodyUpdated() { sph_body_->setNewlyUpdated(); };
 		/** the function for set global parameters for the particle dynamics */
@@ -252,6 +359,8 @@ namespace SPH
 		MaterialType* material_;
 		/** inner configuration of the designated body */
 		ParticleConfiguration& inner_configuration_;
+		/** inner configuration with only the neighbors j > i, built after requested */
+		ParticleConfiguration& inner_pair_configuration_;
 
 		StdVec<ContactBodyType*>  contact_bodies_;
 		StdVec<ContactParticlesType*>  contact_particles_;
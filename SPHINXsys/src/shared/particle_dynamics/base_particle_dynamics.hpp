@@ -43,6 +43,7 @@ namespace SPH {
 		particles_(dynamic_cast<ParticlesType*>(body_->base_particles_)),
 		material_(dynamic_cast<MaterialType*>(body_->base_particles_->base_material_)),
 		inner_configuration_(body_complex_relation->inner_configuration_),
+		inner_pair_configuration_(body_complex_relation->inner_pair_configuration_),
 		contact_configuration_(body_complex_relation->contact_configuration_)
 	{
 		SPHBodyVector contact_sph_bodies = body_complex_relation->contact_sph_bodies_;
@@ -66,9 +67,10 @@ namespace SPH {
 	//=================================================================================================//
 	template <class ReturnType, typename ReduceOperation>
 	ReturnType ReduceIterator_parallel(size_t number_of_particles, ReturnType temp,
-		ReduceFunctor<ReturnType>& reduce_functor, ReduceOperation& reduce_operation, Real dt)
+		ReduceFunctor<ReturnType>& reduce_functor, ReduceOperation& reduce_operation,
+		LoopPartitioner& loop_partitioner, Real dt)
 	{
-		return parallel_reduce(blocked_range<size_t>(0, number_of_particles),
+		return parallel_reduce(loop_partitioner.ParticleRange(number_of_particles),
 			temp, [&](const blocked_range<size_t>& r, ReturnType temp0)->ReturnType {
 				for (size_t i = r.begin(); i != r.end(); ++i) {
 					temp0 = reduce_operation(temp0, reduce_functor(i, dt));
@@ -77,9 +79,95 @@ namespace SPH {
 			},
 			[&](ReturnType x, ReturnType y)->ReturnType {
 				return reduce_operation(x, y);
-			}
+			}, loop_partitioner.ParticleLoopAffinity()
+			);
+	}
+	//=================================================================================================//
+	template <class LocalFunction>
+	void ParticleIterator(size_t number_of_particles, const LocalFunction& local_function, Real dt)
+	{
+		for (size_t i = 0; i < number_of_particles; ++i)
+			local_function(i, dt);
+	}
+	//=================================================================================================//
+	template <class LocalFunction>
+	void ParticleIterator_parallel(size_t number_of_particles, const LocalFunction& local_function,
+		LoopPartitioner& loop_partitioner, Real dt)
+	{
+		parallel_for(loop_partitioner.ParticleRange(number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i < r.end(); ++i) {
+					local_function(i, dt);
+				}
+			}, loop_partitioner.ParticleLoopAffinity());
+	}
+	//=================================================================================================//
+	template <class ReturnType, class LocalReduceFunction, typename ReduceOperation>
+	ReturnType ParticleReducer(size_t number_of_particles, ReturnType temp,
+		const LocalReduceFunction& local_reduce_function, ReduceOperation& reduce_operation, Real dt)
+	{
+		for (size_t i = 0; i < number_of_particles; ++i)
+		{
+			temp = reduce_operation(temp, local_reduce_function(i, dt));
+		}
+		return temp;
+	}
+	//=================================================================================================//
+	template <class ReturnType, class LocalReduceFunction, typename ReduceOperation>
+	ReturnType ParticleReducer_parallel(size_t number_of_particles, ReturnType temp,
+		const LocalReduceFunction& local_reduce_function, ReduceOperation& reduce_operation,
+		LoopPartitioner& loop_partitioner, Real dt)
+	{
+		return parallel_reduce(loop_partitioner.ParticleRange(number_of_particles),
+			temp, [&](const blocked_range<size_t>& r, ReturnType temp0)->ReturnType {
+				for (size_t i = r.begin(); i != r.end(); ++i) {
+					temp0 = reduce_operation(temp0, local_reduce_function(i, dt));
+				}
+				return temp0;
+			},
+			[&](ReturnType x, ReturnType y)->ReturnType {
+				return reduce_operation(x, y);
+			}, loop_partitioner.ParticleLoopAffinity()
 			);
 	}
 	//=================================================================================================//
+	template <class LocalFunction>
+	void ParticleIteratorSplitting(SplitCellLists& split_cell_lists,
+		const LocalFunction& local_function, Real dt)
+	{
+		for (size_t k = 0; k != split_cell_lists.size(); ++k) {
+			ConcurrentCellLists& cell_lists = split_cell_lists[k];
+			for (size_t l = 0; l != cell_lists.size(); ++l)
+			{
+				IndexVector& particle_indexes
+					= cell_lists[l]->real_particle_indexes_;
+				for (size_t i = 0; i != particle_indexes.size(); ++i)
+				{
+					local_function(particle_indexes[i], dt);
+				}
+			}
+		}
+	}
+	//=================================================================================================//
+	template <class LocalFunction>
+	void ParticleIteratorSplitting_parallel(SplitCellLists& split_cell_lists, SplitCellListChunks& split_cell_list_chunks,
+		const LocalFunction& local_function, LoopPartitioner& loop_partitioner, Real dt)
+	{
+		for (size_t k = 0; k != split_cell_lists.size(); ++k) {
+			ConcurrentCellLists& cell_lists = split_cell_lists[k];
+			loop_partitioner.sweepCellLists(cell_lists, split_cell_list_chunks[k], k,
+				[&](size_t begin, size_t end) {
+					for (size_t l = begin; l < end; ++l) {
+						IndexVector& particle_indexes
+							= cell_lists[l]->real_particle_indexes_;
+						for (size_t i = 0; i < particle_indexes.size(); ++i)
+						{
+							local_function(particle_indexes[i], dt);
+						}
+					}
+				});
+		}
+	}
+	//=================================================================================================//
 }
 //=================================================================================================//
@@ -164,7 +164,7 @@ namespace SPH
 		virtual void InnerInteraction(size_t index_i, Real dt = 0.0) override
 		{
 			DiffusionReactionParticles<BaseParticlesType, BaseMaterialType>* particles = this->particles_;
-			Neighborhood& inner_neighborhood = this->inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = this->inner_configuration_[index_i];
 
 			initializeDiffusionChangeRate(index_i);
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
@@ -13,6 +13,18 @@ namespace SPH
 //=================================================================================================//
 	namespace fluid_dynamics
 	{
+		//=================================================================================================//
+		/** the smallest smoothing length of the real particles, for the time step sizes of variable smoothing lengths */
+		static Real SmallestSmoothingLength(StdLargeVec<Real>& smoothing_length, size_t number_of_particles)
+		{
+			return parallel_reduce(blocked_range<size_t>(0, number_of_particles), Infinity,
+				[&](const blocked_range<size_t>& r, Real temp)->Real {
+					for (size_t i = r.begin(); i != r.end(); ++i)
+						temp = SMIN(temp, smoothing_length[i]);
+					return temp;
+				},
+				[](Real x, Real y)->Real { return SMIN(x, y); });
+		}
 		//=================================================================================================//
 		FluidInitialCondition::
 			FluidInitialCondition(FluidBody* body)
@@ -24,11 +36,19 @@ namespace SPH
 		DensityBySummation::DensityBySummation(SPHBodyComplexRelation* body_complex_relation) :
 			ParticleDynamicsComplex(body_complex_relation), FluidDataDelegateComplex(body_complex_relation),
 			Vol_(particles_->Vol_), Vol_0_(particles_->Vol_0_), sigma_0_(particles_->sigma_0_), 
-			rho_n_(particles_->rho_n_), rho_0_(particles_->rho_0_), mass_(particles_->mass_)
+			rho_n_(particles_->rho_n_), rho_0_(particles_->rho_0_), mass_(particles_->mass_),
+			smoothing_length_(particles_->smoothing_length_)
 		{
 			for (size_t k = 0; k != contact_particles_.size(); ++k)
+			{
 				contact_Vol_0_.push_back(&(contact_particles_[k]->Vol_0_));
-			W0_ = body_->kernel_->W(Vecd(0));
+				data_access_.readsNeighbors(contact_particles_[k]->Vol_0_);
+			}
+			kernel_ = body_->kernel_;
+			W0_ = kernel_->W(Vecd(0));
+			has_variable_smoothing_length_
+				= dynamic_cast<MultilevelMeshCellLinkedList*>(body_->mesh_cell_linked_list_) != nullptr;
+			data_access_.writes(rho_n_).writes(Vol_);
 		}
 		//=================================================================================================//
 		void DensityBySummation::ComplexInteraction(size_t index_i, Real dt)
@@ -36,8 +56,9 @@ namespace SPH
 			Real Vol_0_i = Vol_0_[index_i];
 
 			/** Inner interaction. */
-			Real sigma = W0_;
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Real sigma = has_variable_smoothing_length_ ?
+				kernel_->W(1.0 / smoothing_length_[index_i], Vecd(0)) : W0_;
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 				sigma += inner_neighborhood.W_ij_[n];
 
@@ -45,7 +66,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_0_k = *(contact_Vol_0_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					sigma += contact_neighborhood.W_ij_[n] * Vol_0_k[contact_neighborhood.j_[n]] / Vol_0_i;
@@ -66,9 +87,12 @@ namespace SPH
 			{
 				contact_Vol_.push_back(&(contact_particles_[k]->Vol_));
 				contact_vel_ave_.push_back(&(contact_particles_[k]->vel_ave_));
+				data_access_.readsNeighbors(contact_particles_[k]->Vol_).readsNeighbors(contact_particles_[k]->vel_ave_);
 			}
 			mu_ = material_->ReferenceViscosity();
 			smoothing_length_ = body_->kernel_->GetSmoothingLength();
+			/** the density of the neighbors is read by the pairwise interaction */
+			data_access_.writes(dvel_dt_others_).readsNeighbors(vel_n_).readsNeighbors(Vol_).readsNeighbors(rho_n_);
 		}		
 		//=================================================================================================//
 		void ViscousAcceleration::ComplexInteraction(size_t index_i, Real dt)
@@ -79,7 +103,7 @@ namespace SPH
 			/** Inner interaction. */
 			Vecd acceleration(0);
 			Vecd vel_derivative(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -97,7 +121,50 @@ namespace SPH
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
+				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
+				{
+					size_t index_j = contact_neighborhood.j_[n];
+					Real r_ij = contact_neighborhood.r_ij_[n];
+
+					vel_derivative = 2.0*(vel_i - vel_ave_k[index_j]) / (r_ij + 0.01 * smoothing_length_);
+					acceleration += 2.0 * mu_ * vel_derivative 
+								  * contact_neighborhood.dW_ij_[n] * Vol_k[index_j] / rho_i;
+				}
+			}
+
+			/** Particle summation. */
+			dvel_dt_others_[index_i] += acceleration;
+		}
+		//=================================================================================================//
+		void ViscousAcceleration::PairwiseComplexInteraction(size_t index_i, Real dt)
+		{
+			Real rho_i = rho_n_[index_i];
+			Real Vol_i = Vol_[index_i];
+			Vecd& vel_i = vel_n_[index_i];
+
+			/** Inner interaction, with equal and opposite forces to the neighbors j > i. */
+			Vecd acceleration(0);
+			Vecd vel_derivative(0);
+			Neighborhood inner_neighborhood = inner_pair_configuration_[index_i];
+			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
+			{
+				size_t index_j = inner_neighborhood.j_[n];
+
+				//viscous force
+				vel_derivative = (vel_i - vel_n_[index_j])
+								/ (inner_neighborhood.r_ij_[n] + 0.01 * smoothing_length_);
+				Vecd viscous_force = 2.0 * mu_ * vel_derivative * inner_neighborhood.dW_ij_[n];
+				acceleration += viscous_force * Vol_[index_j] / rho_i;
+				dvel_dt_others_[index_j] -= viscous_force * Vol_i / rho_n_[index_j];
+			}
+
+			/** Contact interaction. */
+			for (size_t k = 0; k < contact_configuration_.size(); ++k)
+			{
+				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
+				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -120,7 +187,7 @@ namespace SPH
 
 			/** Inner interaction. */
 			Vecd acceleration(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -140,7 +207,7 @@ namespace SPH
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -187,7 +254,7 @@ namespace SPH
 
 			/** Inner interaction. */
 			Vecd acceleration_trans(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -201,7 +268,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -232,7 +299,7 @@ namespace SPH
 
 			/** Inner interaction. */
 			Vecd acceleration(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -248,7 +315,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -291,15 +358,23 @@ namespace SPH
 		AcousticTimeStepSize::AcousticTimeStepSize(FluidBody* body)
 			: ParticleDynamicsReduce<Real, ReduceMax>(body),
 			FluidDataDelegateSimple(body), rho_n_(particles_->rho_n_),
-			p_(particles_->p_), vel_n_(particles_->vel_n_)
+			p_(particles_->p_), particle_smoothing_length_(particles_->smoothing_length_), vel_n_(particles_->vel_n_)
 		{
 			smoothing_length_ = body->kernel_->GetSmoothingLength();
+			has_variable_smoothing_length_
+				= dynamic_cast<MultilevelMeshCellLinkedList*>(body->mesh_cell_linked_list_) != nullptr;
 			//time step size due to linear viscosity
 			Real rho_0 = material_->ReferenceDensity();
 			Real mu = material_->ReferenceViscosity();
 			initial_reference_ = mu / rho_0 / smoothing_length_;
 		}
 		//=================================================================================================//
+		void AcousticTimeStepSize::SetupReduce()
+		{
+			if (has_variable_smoothing_length_)
+				smoothing_length_ = SmallestSmoothingLength(particle_smoothing_length_, body_->number_of_particles_);
+		}
+		//=================================================================================================//
 		Real AcousticTimeStepSize::ReduceFunction(size_t index_i, Real dt)
 		{
 			return material_->GetSoundSpeed(p_[index_i], rho_n_[index_i]) + vel_n_[index_i].norm();
@@ -332,6 +407,48 @@ namespace SPH
 			return 0.25 * smoothing_length_ / (speed_max + TinyReal);
 		}
 		//=================================================================================================//
+		FluidTimeStepSizes::FluidTimeStepSizes(FluidBody* body, Real U_max)
+			: ParticleDynamicsReduce<FluidSignalSpeeds, ReduceMaxSignalSpeeds>(body),
+			FluidDataDelegateSimple(body), rho_n_(particles_->rho_n_), p_(particles_->p_),
+			particle_smoothing_length_(particles_->smoothing_length_),
+			vel_n_(particles_->vel_n_), dvel_dt_(particles_->dvel_dt_),
+			acoustic_time_step_(0.0), advection_time_step_(0.0), acceleration_time_step_(0.0)
+		{
+			smoothing_length_ = body->kernel_->GetSmoothingLength();
+			has_variable_smoothing_length_
+				= dynamic_cast<MultilevelMeshCellLinkedList*>(body->mesh_cell_linked_list_) != nullptr;
+			//the same references as those of the acoustic and the advection time step sizes
+			Real rho_0 = material_->ReferenceDensity();
+			Real mu = material_->ReferenceViscosity();
+			Real viscous_speed = mu / rho_0 / smoothing_length_;
+			Real u_max = SMAX(viscous_speed, U_max);
+			initial_reference_ = FluidSignalSpeeds(viscous_speed, u_max * u_max, 0.0);
+		}
+		//=================================================================================================//
+		void FluidTimeStepSizes::SetupReduce()
+		{
+			if (has_variable_smoothing_length_)
+				smoothing_length_ = SmallestSmoothingLength(particle_smoothing_length_, body_->number_of_particles_);
+		}
+		//=================================================================================================//
+		FluidSignalSpeeds FluidTimeStepSizes::ReduceFunction(size_t index_i, Real dt)
+		{
+			Real speed = vel_n_[index_i].norm();
+			return FluidSignalSpeeds(material_->GetSoundSpeed(p_[index_i], rho_n_[index_i]) + speed,
+				speed * speed, dvel_dt_[index_i].norm());
+		}
+		//=================================================================================================//
+		FluidSignalSpeeds FluidTimeStepSizes::OutputResult(FluidSignalSpeeds reduced_value)
+		{
+			Real speed_max = sqrt(reduced_value.speed_sqr_);
+			particles_->signal_speed_max_ = reduced_value.signal_speed_;
+			particles_->speed_max_ = speed_max;
+			acoustic_time_step_ = 0.6 * smoothing_length_ / (reduced_value.signal_speed_ + TinyReal);
+			advection_time_step_ = 0.25 * smoothing_length_ / (speed_max + TinyReal);
+			acceleration_time_step_ = 0.25 * sqrt(smoothing_length_ / (reduced_value.acceleration_ + TinyReal));
+			return reduced_value;
+		}
+		//=================================================================================================//
 		VorticityInFluidField::
 			VorticityInFluidField(SPHBodyInnerRelation* body_inner_relation) : 
 			ParticleDynamicsInner(body_inner_relation), FluidDataDelegateInner(body_inner_relation),
@@ -342,7 +459,7 @@ namespace SPH
 			Vecd& vel_i = vel_n_[index_i];
 
 			Vecd vorticity(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -379,6 +496,8 @@ namespace SPH
 			Vol_[index_i] = mass_[index_i] / rho_n_[index_i];
 			p_[index_i] = material_->GetPressure(rho_n_[index_i]);
 			pos_n_[index_i] += vel_n_[index_i] * dt * 0.5;
+			/** initialized for the pairwise interaction, which also writes to the neighbors */
+			dvel_dt_[index_i] = dvel_dt_others_[index_i];
 		}
 		//=================================================================================================//
 		void PressureRelaxationFirstHalfRiemann::ComplexInteraction(size_t index_i, Real dt)
@@ -388,7 +507,7 @@ namespace SPH
 			Vecd& vel_i = vel_n_[index_i];
 
 			Vecd acceleration = dvel_dt_others_[index_i];
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -410,7 +529,7 @@ namespace SPH
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
 				StdLargeVec<Vecd>& dvel_dt_ave_k = *(contact_dvel_dt_ave_[k]);
 				StdLargeVec<Vecd>& n_k = *(contact_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -434,6 +553,63 @@ namespace SPH
 			dvel_dt_[index_i] = acceleration;
 		}
 		//=================================================================================================//
+		void PressureRelaxationFirstHalfRiemann::PairwiseComplexInteraction(size_t index_i, Real dt)
+		{
+			Real rho_i = rho_n_[index_i];
+			Real p_i = p_[index_i];
+			Real Vol_i = Vol_[index_i];
+			Vecd& vel_i = vel_n_[index_i];
+
+			/** Inner interaction, with equal and opposite forces to the neighbors j > i. */
+			Vecd acceleration(0);
+			Neighborhood inner_neighborhood = inner_pair_configuration_[index_i];
+			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
+			{
+				size_t index_j = inner_neighborhood.j_[n];
+				Real dW_ij = inner_neighborhood.dW_ij_[n];
+				Vecd& e_ij = inner_neighborhood.e_ij_[n];
+
+				/** Solving Riemann problem or not, which is symmetric for the pair. */
+				Real p_star = getPStar(e_ij, vel_i, p_i, rho_i,	vel_n_[index_j], p_[index_j], rho_n_[index_j]);
+
+				Vecd pressure_force = 2.0 * p_star * dW_ij * e_ij;
+				acceleration -= pressure_force * Vol_[index_j] / rho_i;
+				dvel_dt_[index_j] += pressure_force * Vol_i / rho_n_[index_j];
+			}
+
+			/** Contact interaction. */
+			for (size_t k = 0; k < contact_configuration_.size(); ++k)
+			{
+				Vecd& dvel_dt_others_i = dvel_dt_others_[index_i];
+
+				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
+				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
+				StdLargeVec<Vecd>& dvel_dt_ave_k = *(contact_dvel_dt_ave_[k]);
+				StdLargeVec<Vecd>& n_k = *(contact_n_[k]);
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
+				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
+				{
+					size_t index_j = contact_neighborhood.j_[n];
+					Vecd& e_ij = contact_neighborhood.e_ij_[n];
+					Real dW_ij = contact_neighborhood.dW_ij_[n];
+					Real r_ij = contact_neighborhood.r_ij_[n];
+
+					Real face_wall_external_acceleration
+						= dot((dvel_dt_others_i - dvel_dt_ave_k[index_j]), -e_ij);
+					Vecd vel_in_wall = 2.0 * vel_ave_k[index_j] - vel_i;
+					Real p_in_wall = p_i + rho_i * r_ij * SMAX(0.0, face_wall_external_acceleration);
+					Real rho_in_wall = material_->DensityFromPressure(p_in_wall);
+
+					//solving Riemann problem or not
+					Real p_star = getPStar(n_k[index_j], vel_i, p_i, rho_i, vel_in_wall, p_in_wall, rho_in_wall);
+
+					//pressure force
+					acceleration -= 2.0 * p_star * e_ij * Vol_k[index_j] * dW_ij / rho_i;
+				}
+			}
+			dvel_dt_[index_i] += acceleration;
+		}
+		//=================================================================================================//
 		Real PressureRelaxationFirstHalfRiemann::getPStar(Vecd& e_ij,
 			Vecd& vel_i, Real p_i, Real rho_i, Vecd& vel_j, Real p_j, Real rho_j)
 		{
@@ -455,6 +631,8 @@ namespace SPH
 		void PressureRelaxationSecondHalfRiemann::Initialization(size_t index_i, Real dt)
 		{
 			pos_n_[index_i] += vel_n_[index_i] * dt * 0.5;
+			/** initialized for the pairwise interaction, which also writes to the neighbors */
+			drho_dt_[index_i] = 0.0;
 		}
 //=================================================================================================//
 		void PressureRelaxationSecondHalfRiemann::ComplexInteraction(size_t index_i, Real dt)
@@ -465,7 +643,7 @@ namespace SPH
 
 			Real density_change_rate = 0.0;
 			Vecd vel_star(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -487,7 +665,7 @@ namespace SPH
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
 				StdLargeVec<Vecd>& dvel_dt_ave_k = *(contact_dvel_dt_ave_[k]);
 				StdLargeVec<Vecd>& n_k = *(contact_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -511,6 +689,63 @@ namespace SPH
 			drho_dt_[index_i] = density_change_rate;
 		}
 		//=================================================================================================//
+		void PressureRelaxationSecondHalfRiemann::PairwiseComplexInteraction(size_t index_i, Real dt)
+		{
+			Real rho_i = rho_n_[index_i];
+			Real p_i = p_[index_i];
+			Real Vol_i = Vol_[index_i];
+			Vecd vel_i = vel_n_[index_i];
+
+			/** Inner interaction, with the velocity divergence also added to the neighbors j > i. */
+			Real density_change_rate = 0.0;
+			Vecd vel_star(0);
+			Neighborhood inner_neighborhood = inner_pair_configuration_[index_i];
+			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
+			{
+				size_t index_j = inner_neighborhood.j_[n];
+				Vecd& e_ij = inner_neighborhood.e_ij_[n];
+				Real dW_ij = inner_neighborhood.dW_ij_[n];
+
+				/** Solving Riemann problem or not, which gives the same interface velocity for the pair. */
+				vel_star = getVStar(e_ij, vel_i, p_i, rho_i, vel_n_[index_j], p_[index_j], rho_n_[index_j]);
+
+				density_change_rate += 2.0 * rho_i * Vol_[index_j] * dot(vel_i - vel_star, e_ij) * dW_ij;
+				drho_dt_[index_j] += 2.0 * rho_n_[index_j] * Vol_i * dot(vel_star - vel_n_[index_j], e_ij) * dW_ij;
+			}
+
+			/** Contact interaction. */
+			for (size_t k = 0; k < contact_configuration_.size(); ++k)
+			{
+				Vecd& dvel_dt_others_i = dvel_dt_others_[index_i];
+
+				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
+				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
+				StdLargeVec<Vecd>& dvel_dt_ave_k = *(contact_dvel_dt_ave_[k]);
+				StdLargeVec<Vecd>& n_k = *(contact_n_[k]);
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
+				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
+				{
+					size_t index_j = contact_neighborhood.j_[n];
+					Vecd& e_ij = contact_neighborhood.e_ij_[n];
+					Real r_ij = contact_neighborhood.r_ij_[n];
+					Real dW_ij = contact_neighborhood.dW_ij_[n];
+
+					Vecd vel_in_wall = 2.0 * vel_ave_k[index_j] - vel_i;
+					Real face_wall_external_acceleration
+						= dot((dvel_dt_others_i - dvel_dt_ave_k[index_j]), e_ij);
+					Real p_in_wall = p_i + rho_i * r_ij * SMAX(0.0, face_wall_external_acceleration);
+					Real rho_in_wall = material_->DensityFromPressure(p_in_wall);
+
+					//solving Riemann problem or not
+					vel_star = getVStar(n_k[index_j], vel_i, p_i, rho_i, vel_in_wall, p_in_wall, rho_in_wall);
+
+					density_change_rate += 2.0 * rho_i * Vol_k[index_j]	* dot(vel_i - vel_star, e_ij) * dW_ij;
+				}
+			}
+
+			drho_dt_[index_i] += density_change_rate;
+		}
+		//=================================================================================================//
 		Vecd PressureRelaxationSecondHalfRiemann::getVStar(Vecd& e_ij, Vecd& vel_i, Real p_i, Real rho_i,
 			Vecd& vel_j, Real p_j, Real rho_j)
 		{
@@ -555,7 +790,7 @@ namespace SPH
 			Matd tau_i = tau_[index_i];
 
 			Vecd acceleration(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -569,7 +804,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -602,7 +837,7 @@ namespace SPH
 			Matd tau_i = tau_[index_i];
 
 			Matd stress_rate(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -618,7 +853,7 @@ namespace SPH
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -757,7 +992,9 @@ namespace SPH
 			for (size_t k = 0; k != contact_particles_.size(); ++k)
 			{
 				contact_n_.push_back(&(contact_particles_[k]->n_));
+				data_access_.readsNeighbors(contact_particles_[k]->n_);
 			}
+			data_access_.writes(gradient_p_).writes(gradient_vel_).readsNeighbors(p_);
 		}
 		//=================================================================================================//
 		void ViscousAccelerationWallModel::ComplexInteraction(size_t index_i, Real dt)
@@ -773,7 +1010,7 @@ namespace SPH
 			// computing the  outer region values for near wall particles
 			if (contact_configuration_.size() != 0)
 			{
-				Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+				Neighborhood inner_neighborhood = inner_configuration_[index_i];
 				for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 				{
 					Vecd nablaW_ij = inner_neighborhood.dW_ij_[n] * inner_neighborhood.e_ij_[n];
@@ -789,7 +1026,7 @@ namespace SPH
 				{
 					StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 					StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
-					Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+					Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 					for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 					{
 						Vecd nablaW_ij = contact_neighborhood.dW_ij_[n] * contact_neighborhood.e_ij_[n];
@@ -806,7 +1043,7 @@ namespace SPH
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Vecd>& vel_ave_k = *(contact_vel_ave_[k]);
 				StdLargeVec<Vecd>& n_k = *(contact_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				// solving inner region momentum balance equation in the tangential direction
 				// using outer region values as upper boundary conditions
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
@@ -838,6 +1075,19 @@ namespace SPH
 		}
 		//=================================================================================================//
 	}		
+//=================================================================================================//
+	template class InlinedParticleDynamicsComplex<fluid_dynamics::DensityBySummation>;
+	template class InlinedParticleDynamicsComplex<fluid_dynamics::DensityBySummationFreeSurface>;
+	template class InlinedParticleDynamicsComplex<fluid_dynamics::ViscousAcceleration>;
+	template class InlinedParticleDynamicsReduce<fluid_dynamics::AcousticTimeStepSize>;
+	template class InlinedParticleDynamicsReduce<fluid_dynamics::AdvectionTimeStepSize>;
+	template class InlinedParticleDynamicsReduce<fluid_dynamics::FluidTimeStepSizes>;
+	template class InlinedParticleDynamicsComplex1Level<fluid_dynamics::PressureRelaxationFirstHalfRiemann>;
+	template class InlinedParticleDynamicsComplex1Level<fluid_dynamics::PressureRelaxationSecondHalfRiemann>;
+	template class FusedParticleDynamicsComplex1LevelReduce<fluid_dynamics::PressureRelaxationSecondHalfRiemann,
+		fluid_dynamics::AcousticTimeStepSize>;
+	template class FusedParticleDynamicsComplex1LevelReduce<fluid_dynamics::PressureRelaxationSecondHalfRiemann,
+		fluid_dynamics::FluidTimeStepSizes>;
 //=================================================================================================//
 }
 //=================================================================================================//
\ No newline at end of file
@@ -73,7 +73,10 @@ namespace SPH
 
 		protected:
 			Real W0_;
-			StdLargeVec<Real>& Vol_, & Vol_0_, & sigma_0_, & rho_n_, & rho_0_, & mass_;
+			/** with a multilevel cell linked list, W0 is taken with the smoothing length of each particle */
+			bool has_variable_smoothing_length_;
+			Kernel* kernel_;
+			StdLargeVec<Real>& Vol_, & Vol_0_, & sigma_0_, & rho_n_, & rho_0_, & mass_, & smoothing_length_;
 			StdVec<StdLargeVec<Real>*> contact_Vol_0_;
 			
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
@@ -116,6 +119,7 @@ namespace SPH
 			StdVec<StdLargeVec<Vecd>*> contact_vel_ave_;
 
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override;
 		};
 
 		/**
@@ -130,6 +134,10 @@ namespace SPH
 			virtual ~AngularConservativeViscousAcceleration() {};
 		protected:
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			/** the pairwise interaction is not implemented yet */
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override {
+				ParticleDynamicsComplex::PairwiseComplexInteraction(index_i, dt);
+			};
 		};
 
 		/**
@@ -211,9 +219,12 @@ namespace SPH
 			explicit AcousticTimeStepSize(FluidBody* body);
 			virtual ~AcousticTimeStepSize() {};
 		protected:
-			StdLargeVec<Real>& rho_n_, & p_;
+			StdLargeVec<Real>& rho_n_, & p_, & particle_smoothing_length_;
 			StdLargeVec<Vecd>& vel_n_;
+			/** the smallest one of the particles with a multilevel cell linked list */
 			Real smoothing_length_;
+			bool has_variable_smoothing_length_;
+			virtual void SetupReduce() override;
 			Real ReduceFunction(size_t index_i, Real dt = 0.0) override;
 			Real OutputResult(Real reduced_value) override;
 		};
@@ -232,6 +243,61 @@ namespace SPH
 			Real OutputResult(Real reduced_value) override;
 		};
 
+		/**
+		* @struct FluidSignalSpeeds
+		* @brief The maxima which determine the time step sizes of a fluid body.
+		*/
+		struct FluidSignalSpeeds
+		{
+			Real signal_speed_;		/**< sound speed plus particle speed */
+			Real speed_sqr_;		/**< square of particle speed */
+			Real acceleration_;		/**< norm of the pressure-induced acceleration */
+
+			FluidSignalSpeeds() : signal_speed_(0.0), speed_sqr_(0.0), acceleration_(0.0) {};
+			FluidSignalSpeeds(Real signal_speed, Real speed_sqr, Real acceleration)
+				: signal_speed_(signal_speed), speed_sqr_(speed_sqr), acceleration_(acceleration) {};
+		};
+		/** A Functor for the maxima of the signal speeds */
+		struct ReduceMaxSignalSpeeds {
+			FluidSignalSpeeds operator () (const FluidSignalSpeeds& x, const FluidSignalSpeeds& y) const {
+				return FluidSignalSpeeds(SMAX(x.signal_speed_, y.signal_speed_),
+					SMAX(x.speed_sqr_, y.speed_sqr_), SMAX(x.acceleration_, y.acceleration_));
+			};
+		};
+
+		/**
+		* @class FluidTimeStepSizes
+		* @brief Computing the acoustic and the advection time step sizes in one particle loop.
+		* The time step sizes are the same as those of AcousticTimeStepSize and AdvectionTimeStepSize,
+		* and are obtained after the execution.
+		* Being a reduce dynamics, it can also be fused into the update loop of
+		* the second half of the pressure relaxation.
+		* Note that the advection time step size of the next outer step
+		* is already known from the last acoustic step, as the velocity is not changed in between.
+		*/
+		class FluidTimeStepSizes
+			: public ParticleDynamicsReduce<FluidSignalSpeeds, ReduceMaxSignalSpeeds>, public FluidDataDelegateSimple
+		{
+		public:
+			explicit FluidTimeStepSizes(FluidBody* body, Real U_max);
+			virtual ~FluidTimeStepSizes() {};
+
+			Real AcousticTimeStep() { return acoustic_time_step_; };
+			Real AdvectionTimeStep() { return advection_time_step_; };
+			/** the time step size limited by the pressure-induced acceleration */
+			Real AccelerationTimeStep() { return acceleration_time_step_; };
+		protected:
+			StdLargeVec<Real>& rho_n_, & p_, & particle_smoothing_length_;
+			StdLargeVec<Vecd>& vel_n_, & dvel_dt_;
+			/** the smallest one of the particles with a multilevel cell linked list */
+			Real smoothing_length_;
+			bool has_variable_smoothing_length_;
+			Real acoustic_time_step_, advection_time_step_, acceleration_time_step_;
+			virtual void SetupReduce() override;
+			FluidSignalSpeeds ReduceFunction(size_t index_i, Real dt = 0.0) override;
+			FluidSignalSpeeds OutputResult(FluidSignalSpeeds reduced_value) override;
+		};
+
 		/**
 		* @class VorticityInFluidField
 		* @brief  compute vorticity in fluid field (without consider wall boundary effect)
@@ -270,6 +336,7 @@ namespace SPH
 
 			virtual void Initialization(size_t index_i, Real dt = 0.0) override;
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override;
 			virtual void Update(size_t index_i, Real dt = 0.0) override;
 		};
 
@@ -305,6 +372,7 @@ namespace SPH
 				Vecd& vel_j, Real p_j, Real rho_j);
 			virtual void Initialization(size_t index_i, Real dt = 0.0) override;
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override;
 			virtual void Update(size_t index_i, Real dt = 0.0) override;
 		};
 
@@ -351,6 +419,10 @@ namespace SPH
 			StdLargeVec<Matd>& tau_, & dtau_dt_;
 			virtual void Initialization(size_t index_i, Real dt = 0.0) override;
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			/** the pairwise interaction is not implemented yet */
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override {
+				ParticleDynamicsComplex::PairwiseComplexInteraction(index_i, dt);
+			};
 		};
 
 		/**
@@ -367,6 +439,10 @@ namespace SPH
 			Real mu_p_, lambda_;
 
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			/** the pairwise interaction is not implemented yet */
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override {
+				ParticleDynamicsComplex::PairwiseComplexInteraction(index_i, dt);
+			};
 			virtual void Update(size_t index_i, Real dt = 0.0) override;
 		};
 
@@ -508,6 +584,25 @@ namespace SPH
 			StdVec<StdLargeVec<Vecd>*> contact_n_;
 
 			virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) override;
+			/** the pairwise interaction is not implemented yet */
+			virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0) override {
+				ParticleDynamicsComplex::PairwiseComplexInteraction(index_i, dt);
+			};
 		};
 	}
+
+	/** The inlined algorithms of the fluid dynamics used in each time step,
+	  * which are instantiated together with the particle functions in fluid_dynamics.cpp. */
+	extern template class InlinedParticleDynamicsComplex<fluid_dynamics::DensityBySummation>;
+	extern template class InlinedParticleDynamicsComplex<fluid_dynamics::DensityBySummationFreeSurface>;
+	extern template class InlinedParticleDynamicsComplex<fluid_dynamics::ViscousAcceleration>;
+	extern template class InlinedParticleDynamicsReduce<fluid_dynamics::AcousticTimeStepSize>;
+	extern template class InlinedParticleDynamicsReduce<fluid_dynamics::AdvectionTimeStepSize>;
+	extern template class InlinedParticleDynamicsReduce<fluid_dynamics::FluidTimeStepSizes>;
+	extern template class InlinedParticleDynamicsComplex1Level<fluid_dynamics::PressureRelaxationFirstHalfRiemann>;
+	extern template class InlinedParticleDynamicsComplex1Level<fluid_dynamics::PressureRelaxationSecondHalfRiemann>;
+	extern template class FusedParticleDynamicsComplex1LevelReduce<fluid_dynamics::PressureRelaxationSecondHalfRiemann,
+		fluid_dynamics::AcousticTimeStepSize>;
+	extern template class FusedParticleDynamicsComplex1LevelReduce<fluid_dynamics::PressureRelaxationSecondHalfRiemann,
+		fluid_dynamics::FluidTimeStepSizes>;
 }
@@ -0,0 +1,190 @@
+/**
+ * @file 	domain_decomposition.cpp
+ * @author	Chi ZHang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "domain_decomposition.h"
+
+namespace SPH {
+	//=================================================================================================//
+	DomainDecompositionInAxisDirection
+		::DomainDecompositionInAxisDirection(SPHBody* body, int axis_direction)
+		: BoundingInAxisDirection(body, axis_direction),
+		rank_(MPIEnvironment::Rank()), number_of_ranks_(MPIEnvironment::NumberOfRanks())
+	{
+		/** the cells of the cell linked list are divided evenly */
+		size_t number_of_cells = number_of_cells_[axis_];
+		subdomain_bounds_.push_back(-Infinity);
+		for (int r = 1; r < number_of_ranks_; ++r)
+			subdomain_bounds_.push_back(mesh_lower_bound_[axis_]
+				+ cell_spacing_ * Real(r * number_of_cells / number_of_ranks_));
+		subdomain_bounds_.push_back(Infinity);
+
+		body_->domain_decomposition_ = this;
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::setSubdomainBounds(StdVec<Real>& inner_bounds)
+	{
+		if (int(inner_bounds.size()) != number_of_ranks_ - 1)
+		{
+			std::cout << "\n Error: the number of subdomain bounds does not match the number of ranks!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+		for (size_t r = 0; r != inner_bounds.size(); ++r)
+			subdomain_bounds_[r + 1] = inner_bounds[r];
+	}
+	//=================================================================================================//
+	int DomainDecompositionInAxisDirection::RankOfPosition(Vecd& position)
+	{
+		int rank = 0;
+		while (rank + 1 < number_of_ranks_ && position[axis_] >= subdomain_bounds_[rank + 1]) rank++;
+		return rank;
+	}
+	//=================================================================================================//
+	size_t DomainDecompositionInAxisDirection::TotalNumberOfParticles()
+	{
+		return MPIEnvironment::reduceSum(body_->number_of_particles_);
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::distributeParticles()
+	{
+		/** the particles after the current one have been checked already */
+		for (size_t i = body_->number_of_particles_; i != 0; --i)
+		{
+			if (!isInSubdomain(pos_n_[i - 1])) particles_->switchToBufferParticle(i - 1);
+		}
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::appendRealParticles(StdVec<Real>& buffer)
+	{
+		size_t position = 0;
+		while (position < buffer.size())
+		{
+			size_t index_i = body_->number_of_particles_;
+			if (index_i >= particles_->real_particles_bound_)
+			{
+				std::cout << "\n Error: the migrated particles exceed the real particles bound of "
+					<< body_->GetBodyName() << "!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				exit(1);
+			}
+			particles_->unpackAParticle(index_i, buffer, position);
+			particles_->sorted_id_[particles_->particle_id_[index_i]] = index_i;
+			body_->number_of_particles_++;
+		}
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::migrateParticles()
+	{
+		StdVec<Real> send_to_lower, send_to_upper, receive_from_lower, receive_from_upper;
+		for (size_t i = body_->number_of_particles_; i != 0; --i)
+		{
+			int rank = RankOfPosition(pos_n_[i - 1]);
+			if (rank == rank_) continue;
+			particles_->packAParticle(i - 1, rank < rank_ ? send_to_lower : send_to_upper);
+			particles_->switchToBufferParticle(i - 1);
+		}
+		MPIEnvironment::exchangeWithNeighborRanks(send_to_lower, send_to_upper,
+			receive_from_lower, receive_from_upper);
+		appendRealParticles(receive_from_lower);
+		appendRealParticles(receive_from_upper);
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::packParticles(IndexVector& particles, StdVec<Real>& buffer)
+	{
+		for (size_t i = 0; i != particles.size(); ++i)
+			particles_->packAParticle(particles[i], buffer);
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection
+		::insertHaloParticles(StdVec<Real>& buffer, IndexVector& halo_particles)
+	{
+		halo_particles.clear();
+		size_t position = 0;
+		while (position < buffer.size())
+		{
+			size_t expected_particle_index = particles_->insertAGhostParticle(buffer, position);
+			halo_particles.push_back(expected_particle_index);
+			/** insert ghost particle to cell linked list */
+			mesh_cell_linked_list_->InsertACellLinkedListDataEntry(expected_particle_index, pos_n_[expected_particle_index]);
+		}
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::createHaloParticles()
+	{
+		lower_halo_sources_.clear();
+		upper_halo_sources_.clear();
+		Real lower_bound = subdomain_bounds_[rank_];
+		Real upper_bound = subdomain_bounds_[rank_ + 1];
+		for (size_t i = 0; i != body_->number_of_particles_; ++i)
+		{
+			if (rank_ > 0 && pos_n_[i][axis_] < lower_bound + cell_spacing_)
+				lower_halo_sources_.push_back(i);
+			if (rank_ + 1 < number_of_ranks_ && pos_n_[i][axis_] > upper_bound - cell_spacing_)
+				upper_halo_sources_.push_back(i);
+		}
+
+		StdVec<Real> send_to_lower, send_to_upper, receive_from_lower, receive_from_upper;
+		packParticles(lower_halo_sources_, send_to_lower);
+		packParticles(upper_halo_sources_, send_to_upper);
+		MPIEnvironment::exchangeWithNeighborRanks(send_to_lower, send_to_upper,
+			receive_from_lower, receive_from_upper);
+		insertHaloParticles(receive_from_lower, lower_halo_particles_);
+		insertHaloParticles(receive_from_upper, upper_halo_particles_);
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection
+		::updateHaloParticles(StdVec<Real>& buffer, IndexVector& halo_particles)
+	{
+		size_t position = 0;
+		for (size_t i = 0; i != halo_particles.size(); ++i)
+			particles_->unpackAParticle(halo_particles[i], buffer, position);
+		if (position != buffer.size())
+		{
+			std::cout << "\n Error: the halo of " << body_->GetBodyName()
+				<< " does not match the neighbor rank!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection::exec(Real dt)
+	{
+		StdVec<Real> send_to_lower, send_to_upper, receive_from_lower, receive_from_upper;
+		packParticles(lower_halo_sources_, send_to_lower);
+		packParticles(upper_halo_sources_, send_to_upper);
+		MPIEnvironment::exchangeWithNeighborRanks(send_to_lower, send_to_upper,
+			receive_from_lower, receive_from_upper);
+		updateHaloParticles(receive_from_lower, lower_halo_particles_);
+		updateHaloParticles(receive_from_upper, upper_halo_particles_);
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection
+		::reduceObservedQuantities(StdLargeVec<Real>& observed_quantities, StdLargeVec<Vecd>& positions)
+	{
+		StdVec<Real> values(observed_quantities.size(), 0.0);
+		for (size_t i = 0; i != observed_quantities.size(); ++i)
+			if (isInSubdomain(positions[i])) values[i] = observed_quantities[i];
+		MPIEnvironment::reduceSum(values);
+		for (size_t i = 0; i != observed_quantities.size(); ++i)
+			observed_quantities[i] = values[i];
+	}
+	//=================================================================================================//
+	void DomainDecompositionInAxisDirection
+		::reduceObservedQuantities(StdLargeVec<Vecd>& observed_quantities, StdLargeVec<Vecd>& positions)
+	{
+		int dimension = Vecd(0).size();
+		StdVec<Real> values(observed_quantities.size() * dimension, 0.0);
+		for (size_t i = 0; i != observed_quantities.size(); ++i)
+			if (isInSubdomain(positions[i]))
+				for (int k = 0; k != dimension; ++k)
+					values[i * dimension + k] = observed_quantities[i][k];
+		MPIEnvironment::reduceSum(values);
+		for (size_t i = 0; i != observed_quantities.size(); ++i)
+			for (int k = 0; k != dimension; ++k)
+				observed_quantities[i][k] = values[i * dimension + k];
+	}
+	//=================================================================================================//
+}
@@ -0,0 +1,101 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+* @file 	domain_decomposition.h
+* @brief 	The decomposition of a body into subdomains of the MPI ranks,
+* with the halo of ghost particles from the neighbor subdomains
+* and the migration of particles between the subdomains.
+* @author	Chi ZHang and Xiangyu Hu
+* @version	0.1
+*/
+
+#pragma once
+
+#include "general_dynamics.h"
+#include "mpi_environment.h"
+
+namespace SPH
+{
+	/**
+	* @class DomainDecompositionInAxisDirection
+	* @brief Decomposes a body into slabs along an axis direction, one for each rank in the order of the ranks.
+	* The bounds between the slabs are aligned to the cells of the cell linked list,
+	* and the first and the last slabs are open to the lower and upper sides.
+	* Each rank keeps the real particles in its slab,
+	* and the real particles within one cell of a bound are copied as ghost particles,
+	* i.e. the halo, to the neighbor rank on the other side of the bound.
+	* The sequence in each time step is: migrateParticles() after the position updates,
+	* then the cell linked list update, createHaloParticles() and the configuration update.
+	* The states of the halo are updated by exec(), which the 1-level and split dynamics of the body,
+	* also the inlined and fused ones, call between the initialization and the interaction by themselves,
+	* and which should be called before other interactions using the changed states.
+	* Note that a particle should not move further than a slab between two migrations,
+	* and the indexes of body parts by particle are not kept by the migration.
+	*/
+	class DomainDecompositionInAxisDirection : public BoundingInAxisDirection
+	{
+	protected:
+		int rank_;
+		int number_of_ranks_;
+		/** the bounds of the slabs along the axis, the slab of rank r is between the bounds r and r + 1 */
+		StdVec<Real> subdomain_bounds_;
+		/** the real particles sent to the lower and upper neighbor ranks as halo */
+		IndexVector lower_halo_sources_, upper_halo_sources_;
+		/** the ghost particles received from the lower and upper neighbor ranks */
+		IndexVector lower_halo_particles_, upper_halo_particles_;
+
+		void packParticles(IndexVector& particles, StdVec<Real>& buffer);
+		void insertHaloParticles(StdVec<Real>& buffer, IndexVector& halo_particles);
+		void updateHaloParticles(StdVec<Real>& buffer, IndexVector& halo_particles);
+		void appendRealParticles(StdVec<Real>& buffer);
+	public:
+		DomainDecompositionInAxisDirection(SPHBody* body, int axis_direction = 0);
+		virtual ~DomainDecompositionInAxisDirection() {};
+
+		/** Reset the bounds between the slabs, i.e. number of ranks - 1 increasing values. */
+		void setSubdomainBounds(StdVec<Real>& inner_bounds);
+		StdVec<Real>& SubdomainBounds() { return subdomain_bounds_; };
+		int RankOfPosition(Vecd& position);
+		bool isInSubdomain(Vecd& position) { return RankOfPosition(position) == rank_; };
+		/** the number of real particles of the body summed over all ranks */
+		size_t TotalNumberOfParticles();
+
+		/** Keep only the particles in the slab of this rank,
+		  * called once after all ranks have generated or reloaded the same particles. */
+		void distributeParticles();
+		/** Send the real particles which left the slab to the neighbor ranks and receive theirs. */
+		void migrateParticles();
+		/** Exchange the halo and insert the received particles into the cell linked list,
+		  * called after the cell linked list update. */
+		void createHaloParticles();
+		/** Update the states of the halo particles. */
+		virtual void exec(Real dt = 0.0) override;
+		/** This class is only implemented in sequential due to the communication. */
+		virtual void parallel_exec(Real dt = 0.0) override { exec(); };
+
+		/** Combine the quantities observed at given positions on all ranks,
+		  * taking the values obtained on the rank whose slab contains the position. */
+		void reduceObservedQuantities(StdLargeVec<Real>& observed_quantities, StdLargeVec<Vecd>& positions);
+		void reduceObservedQuantities(StdLargeVec<Vecd>& observed_quantities, StdLargeVec<Vecd>& positions);
+	};
+}
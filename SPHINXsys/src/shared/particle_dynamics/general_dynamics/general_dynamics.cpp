@@ -14,6 +14,7 @@ namespace SPH {
 		pos_n_(particles_->pos_n_), dvel_dt_others_(particles_->dvel_dt_others_),
 		gravity_(gravity)
 	{
+		data_access_.writes(dvel_dt_others_);
 	}
 	//=================================================================================================//
 	void InitializeATimeStep::setupDynamics(Real dt)
@@ -46,7 +47,6 @@ namespace SPH {
 	BoundingBodyDomain::BoundingBodyDomain(SPHBody* body)
 		: ParticleDynamics<void>(body), DataDelegateSimple<SPHBody, BaseParticles>(body),
 		pos_n_(particles_->pos_n_),
-		cell_linked_lists_(mesh_cell_linked_list_->CellLinkedLists()),
 		number_of_cells_(mesh_cell_linked_list_->NumberOfCells()),
 		cell_spacing_(mesh_cell_linked_list_->CellSpacing()),
 		mesh_lower_bound_(mesh_cell_linked_list_->MeshLowerBound())
@@ -194,14 +194,14 @@ namespace SPH {
 	void MirrorBoundaryConditionInAxisDirection::UpdatingGhostStates
 		::updateForLowerBound(size_t index_i, Real dt)
 	{
-		particles_->updateFromAnotherParticle(index_i, particles_->particle_id_[index_i]);
+		particles_->updateFromAnotherParticle(index_i, particles_->sorted_id_[particles_->particle_id_[index_i]]);
 		particles_->mirrorInAxisDirection(index_i, body_lower_bound_, axis_);
 	}
 	//=================================================================================================//
 	void MirrorBoundaryConditionInAxisDirection::UpdatingGhostStates
 		::updateForUpperBound(size_t index_i, Real dt)
 	{
-		particles_->updateFromAnotherParticle(index_i, particles_->particle_id_[index_i]);
+		particles_->updateFromAnotherParticle(index_i, particles_->sorted_id_[particles_->particle_id_[index_i]]);
 		particles_->mirrorInAxisDirection(index_i, body_upper_bound_, axis_);
 	}
 	//=================================================================================================//
@@ -216,12 +216,12 @@ namespace SPH {
 	void MirrorBoundaryConditionInAxisDirection::UpdatingGhostStates
 		::parallel_exec(Real dt)
 	{
-		parallel_for(blocked_range<size_t>(0, ghost_particles_.size()),
+		parallel_for(loop_partitioner_.ParticleRange(ghost_particles_.size()),
 			[&](const blocked_range<size_t>& r) {
 				for (size_t i = r.begin(); i < r.end(); ++i) {
 					checking_bound_update_(ghost_particles_[i], dt);
 				}
-			}, ap);
+			}, loop_partitioner_.ParticleLoopAffinity());
 	}
 	//=================================================================================================//
 	VelocityBoundCheck::
@@ -295,5 +295,7 @@ namespace SPH {
 		return pos_n_[index_i];
 	}
 	//=================================================================================================//
+	template class InlinedParticleDynamicsSimple<InitializeATimeStep>;
+	//=================================================================================================//
 }
 //=================================================================================================//
\ No newline at end of file
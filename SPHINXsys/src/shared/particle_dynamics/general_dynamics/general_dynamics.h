@@ -85,7 +85,6 @@ namespace SPH
 		virtual ~BoundingBodyDomain() {};
 	protected:
 		StdLargeVec<Vecd>& pos_n_;
-		matrix_cell cell_linked_lists_;
 		Vecu number_of_cells_;
 		Real cell_spacing_;
 		Vecd mesh_lower_bound_;
@@ -318,4 +317,8 @@ namespace SPH
 		StdLargeVec<Vecd>& pos_n_;
 		Vecd ReduceFunction(size_t index_i, Real dt = 0.0) override;
 	};
+
+	/** The inlined algorithm of the time step initialization,
+	  * which is instantiated together with the particle function in general_dynamics.cpp. */
+	extern template class InlinedParticleDynamicsSimple<InitializeATimeStep>;
 }
@@ -0,0 +1,203 @@
+/**
+ * @file 	particle_splitting_merging.cpp
+ * @author	Chi ZHang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "particle_splitting_merging.h"
+#include "sph_system.h"
+#include "body_relation.h"
+
+namespace SPH {
+	//=================================================================================================//
+	RefinementNearShape::RefinementNearShape(SPHBody* body, ComplexShape* shape,
+		Real refinement_width, Real finest_smoothing_length)
+		: RefinementIndicator(), pos_n_(body->base_particles_->pos_n_), shape_(shape),
+		refinement_width_(refinement_width), finest_smoothing_length_(finest_smoothing_length),
+		coarsest_smoothing_length_(body->kernel_->GetSmoothingLength()) {}
+	//=================================================================================================//
+	Real RefinementNearShape::TargetSmoothingLength(size_t index_i)
+	{
+		return std::abs(shape_->findSignedDistance(pos_n_[index_i])) < refinement_width_ ?
+			finest_smoothing_length_ : coarsest_smoothing_length_;
+	}
+	//=================================================================================================//
+	RefinementByVorticity::RefinementByVorticity(FluidBody* body,
+		Real vorticity_threshold, Real finest_smoothing_length)
+		: RefinementIndicator(),
+		vorticity_(dynamic_cast<FluidParticles*>(body->base_particles_)->vorticity_),
+		vorticity_threshold_(vorticity_threshold), finest_smoothing_length_(finest_smoothing_length),
+		coarsest_smoothing_length_(body->kernel_->GetSmoothingLength()) {}
+	//=================================================================================================//
+	Real RefinementByVorticity::TargetSmoothingLength(size_t index_i)
+	{
+		return vorticity_[index_i].norm() > vorticity_threshold_ ?
+			finest_smoothing_length_ : coarsest_smoothing_length_;
+	}
+	//=================================================================================================//
+	ParticleSplittingAndMerging::ParticleSplittingAndMerging(SPHBodyInnerRelation* body_inner_relation,
+		RefinementIndicator* refinement_indicator, size_t number_of_buffer_particles)
+		: ParticleDynamics<void>(body_inner_relation->sph_body_),
+		DataDelegateInner<SPHBody, BaseParticles>(body_inner_relation),
+		refinement_indicator_(refinement_indicator),
+		pos_n_(particles_->pos_n_), vel_n_(particles_->vel_n_),
+		Vol_(particles_->Vol_), Vol_0_(particles_->Vol_0_), sigma_0_(particles_->sigma_0_),
+		rho_n_(particles_->rho_n_), mass_(particles_->mass_), smoothing_length_(particles_->smoothing_length_),
+		number_of_splittings_(0), number_of_mergings_(0)
+	{
+		if (dynamic_cast<MultilevelMeshCellLinkedList*>(body_->mesh_cell_linked_list_) == nullptr)
+		{
+			std::cout << "\n Error: the particle splitting and merging of " << body_->GetBodyName()
+				<< " requires a multilevel cell linked list!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+
+		for (size_t i = 0; i != number_of_buffer_particles; ++i)
+			particles_->addABufferParticle();
+		particles_->real_particles_bound_ += number_of_buffer_particles;
+		body_->allocateConfigurationMemoriesForBodyBuffer();
+
+		target_smoothing_length_.resize(particles_->real_particles_bound_, 0.0);
+		is_adapted_.resize(particles_->real_particles_bound_, false);
+		is_merged_away_.resize(particles_->real_particles_bound_, false);
+
+		/** the children are at the centers of the 2^d sub-cells of the parent */
+		int dimension = Vecd(0).size();
+		for (int c = 0; c != (1 << dimension); ++c)
+		{
+			Vecd offset(0);
+			for (int k = 0; k != dimension; ++k)
+				offset[k] = (c >> k) & 1 ? 0.25 : -0.25;
+			splitting_stencil_.push_back(offset);
+		}
+	}
+	//=================================================================================================//
+	bool ParticleSplittingAndMerging::isToBeSplit(size_t index_i)
+	{
+		return smoothing_length_[index_i] > 1.001 * target_smoothing_length_[index_i];
+	}
+	//=================================================================================================//
+	size_t ParticleSplittingAndMerging::findMergingPartner(size_t index_i, size_t number_of_particles)
+	{
+		Real smoothing_length_i = smoothing_length_[index_i];
+		Real merged_smoothing_length = smoothing_length_i * pow(2.0, 1.0 / Real(Vecd(0).size()));
+		if (merged_smoothing_length > 1.001 * target_smoothing_length_[index_i]) return MaxSize_t;
+
+		size_t partner = MaxSize_t;
+		Real min_distance = Infinity;
+		Neighborhood inner_neighborhood = inner_configuration_[index_i];
+		for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
+		{
+			size_t index_j = inner_neighborhood.j_[n];
+			/** ghost particles and the particles adapted already are excluded */
+			if (index_j >= number_of_particles || is_adapted_[index_j] || is_merged_away_[index_j]) continue;
+			if (std::abs(smoothing_length_[index_j] - smoothing_length_i) > 0.001 * smoothing_length_i) continue;
+			if (merged_smoothing_length > 1.001 * target_smoothing_length_[index_j]) continue;
+
+			if (inner_neighborhood.r_ij_[n] < min_distance)
+			{
+				min_distance = inner_neighborhood.r_ij_[n];
+				partner = index_j;
+			}
+		}
+		return partner;
+	}
+	//=================================================================================================//
+	void ParticleSplittingAndMerging::splitAParticle(size_t index_i)
+	{
+		size_t number_of_new_particles = splitting_stencil_.size() - 1;
+		if (body_->number_of_particles_ + number_of_new_particles > particles_->real_particles_bound_)
+		{
+			std::cout << "\n Error: not enough buffer particles for the particle splitting of "
+				<< body_->GetBodyName() << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+
+		Real number_of_children = Real(splitting_stencil_.size());
+		Real particle_spacing = pow(Vol_[index_i], 1.0 / Real(Vecd(0).size()));
+		Vecd parent_position = pos_n_[index_i];
+		mass_[index_i] /= number_of_children;
+		Vol_[index_i] /= number_of_children;
+		Vol_0_[index_i] /= number_of_children;
+		sigma_0_[index_i] *= number_of_children;
+		smoothing_length_[index_i] *= 0.5;
+		is_adapted_[index_i] = true;
+
+		/** the velocity and the other states of the children are those of the parent */
+		for (size_t k = 1; k != splitting_stencil_.size(); ++k)
+		{
+			size_t index_k = body_->number_of_particles_;
+			particles_->copyFromAnotherParticle(index_k, index_i);
+			pos_n_[index_k] = parent_position + splitting_stencil_[k] * particle_spacing;
+			is_adapted_[index_k] = true;
+			is_merged_away_[index_k] = false;
+			body_->number_of_particles_++;
+		}
+		pos_n_[index_i] = parent_position + splitting_stencil_[0] * particle_spacing;
+		number_of_splittings_++;
+	}
+	//=================================================================================================//
+	void ParticleSplittingAndMerging::mergeParticles(size_t index_i, size_t index_j)
+	{
+		Real mass = mass_[index_i] + mass_[index_j];
+		Real Vol = Vol_[index_i] + Vol_[index_j];
+		pos_n_[index_i] = (mass_[index_i] * pos_n_[index_i] + mass_[index_j] * pos_n_[index_j]) / mass;
+		vel_n_[index_i] = (mass_[index_i] * vel_n_[index_i] + mass_[index_j] * vel_n_[index_j]) / mass;
+		smoothing_length_[index_i] *= pow(Vol / Vol_[index_i], 1.0 / Real(Vecd(0).size()));
+		sigma_0_[index_i] *= Vol_[index_i] / Vol;
+		Vol_0_[index_i] += Vol_0_[index_j];
+		Vol_[index_i] = Vol;
+		mass_[index_i] = mass;
+		rho_n_[index_i] = mass / Vol;
+		is_adapted_[index_i] = true;
+		is_merged_away_[index_j] = true;
+		number_of_mergings_++;
+	}
+	//=================================================================================================//
+	void ParticleSplittingAndMerging::exec(Real dt)
+	{
+		size_t number_of_particles = body_->number_of_particles_;
+		number_of_splittings_ = 0;
+		number_of_mergings_ = 0;
+		std::fill(is_adapted_.begin(), is_adapted_.end(), false);
+		std::fill(is_merged_away_.begin(), is_merged_away_.end(), false);
+		parallel_for(loop_partitioner_.ParticleRange(number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					target_smoothing_length_[i] = refinement_indicator_->TargetSmoothingLength(i);
+			}, loop_partitioner_.ParticleLoopAffinity());
+
+		/** the children are appended after the present real particles and not adapted again */
+		for (size_t i = 0; i != number_of_particles; ++i)
+		{
+			if (is_adapted_[i] || is_merged_away_[i]) continue;
+			if (isToBeSplit(i))
+			{
+				splitAParticle(i);
+				continue;
+			}
+			size_t partner = findMergingPartner(i, number_of_particles);
+			if (partner != MaxSize_t) mergeParticles(i, partner);
+		}
+
+		/** the particles after the current one have been checked already */
+		for (size_t i = body_->number_of_particles_; i != 0; --i)
+		{
+			if (is_merged_away_[i - 1]) particles_->switchToBufferParticle(i - 1);
+		}
+
+		/** the Verlet lists from and to this body refer to the particles before the adaptation,
+		  * so that they are rebuilt even if the number of particles is unchanged. */
+		if (number_of_splittings_ + number_of_mergings_ == 0) return;
+		SPHBodyVector& bodies = body_->getSPHSystem().bodies_;
+		for (size_t k = 0; k != bodies.size(); ++k)
+		{
+			StdVec<SPHBodyBaseRelation*>& body_relations = bodies[k]->body_relations_;
+			for (size_t l = 0; l != body_relations.size(); ++l)
+				body_relations[l]->invalidateVerletList(body_);
+		}
+	}
+	//=================================================================================================//
+}
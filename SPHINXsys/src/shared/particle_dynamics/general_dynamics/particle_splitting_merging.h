@@ -0,0 +1,143 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+* @file 	particle_splitting_merging.h
+* @brief 	Runtime refinement and coarsening of the particle resolution
+* by splitting and merging particles, driven by refinement indicators.
+* @author	Chi ZHang and Xiangyu Hu
+* @version	0.1
+*/
+
+#pragma once
+
+#include "general_dynamics.h"
+
+namespace SPH
+{
+	/**
+	* @class RefinementIndicator
+	* @brief The smoothing length required at a particle, i.e. the local resolution.
+	* It is evaluated for all real particles in parallel.
+	*/
+	class RefinementIndicator
+	{
+	public:
+		RefinementIndicator() {};
+		virtual ~RefinementIndicator() {};
+
+		virtual Real TargetSmoothingLength(size_t index_i) = 0;
+	};
+
+	/**
+	* @class RefinementNearShape
+	* @brief The finest smoothing length within a width from the surface of a shape,
+	* such as a wall, and the smoothing length of the body kernel otherwise.
+	*/
+	class RefinementNearShape : public RefinementIndicator
+	{
+	public:
+		RefinementNearShape(SPHBody* body, ComplexShape* shape,
+			Real refinement_width, Real finest_smoothing_length);
+		virtual ~RefinementNearShape() {};
+
+		virtual Real TargetSmoothingLength(size_t index_i) override;
+	protected:
+		StdLargeVec<Vecd>& pos_n_;
+		ComplexShape* shape_;
+		Real refinement_width_;
+		Real finest_smoothing_length_, coarsest_smoothing_length_;
+	};
+
+	/**
+	* @class RefinementByVorticity
+	* @brief The finest smoothing length where the magnitude of the vorticity exceeds a threshold,
+	* and the smoothing length of the body kernel otherwise.
+	* The vorticity is computed before by fluid_dynamics::VorticityInFluidField.
+	*/
+	class RefinementByVorticity : public RefinementIndicator
+	{
+	public:
+		RefinementByVorticity(FluidBody* body, Real vorticity_threshold, Real finest_smoothing_length);
+		virtual ~RefinementByVorticity() {};
+
+		virtual Real TargetSmoothingLength(size_t index_i) override;
+	protected:
+		StdLargeVec<Vecd>& vorticity_;
+		Real vorticity_threshold_;
+		Real finest_smoothing_length_, coarsest_smoothing_length_;
+	};
+
+	/**
+	* @class ParticleSplittingAndMerging
+	* @brief Adapts the particle resolution to the target smoothing lengths of a refinement indicator.
+	* A particle coarser than its target is split into 2^d children on a regular stencil
+	* within its volume, each with 1/2^d of its mass and volume, its velocity and half of its smoothing length,
+	* so that the mass and the momentum are conserved.
+	* Two neighboring particles of the same resolution are merged into one at their center of mass
+	* if the merged particle is not coarser than the targets of both,
+	* with the summed mass and volume and the mass-averaged velocity.
+	* The other variables of a merged particle are taken from the one kept.
+	* The children are realized from the buffer particles reserved at construction,
+	* and the merged-away particles are switched back to the buffer.
+	* The smoothing length of a particle is always the one of its volume,
+	* so that the body should use a multilevel cell linked list for the variable smoothing lengths,
+	* see RealBody::useMultilevelMeshCellLinkedList.
+	* The inner configuration should be up to date before exec(),
+	* and the cell linked list and the configurations should be updated after it,
+	* for which the Verlet lists from and to the body are rebuilt.
+	* Note that the indexes of body parts by particle are not kept by the adaptation.
+	*/
+	class ParticleSplittingAndMerging
+		: public ParticleDynamics<void>, public DataDelegateInner<SPHBody, BaseParticles>
+	{
+	public:
+		ParticleSplittingAndMerging(SPHBodyInnerRelation* body_inner_relation,
+			RefinementIndicator* refinement_indicator, size_t number_of_buffer_particles);
+		virtual ~ParticleSplittingAndMerging() {};
+
+		/** the numbers of the splittings and the mergings by the last execution */
+		size_t NumberOfSplittings() { return number_of_splittings_; };
+		size_t NumberOfMergings() { return number_of_mergings_; };
+
+		virtual void exec(Real dt = 0.0) override;
+		/** This class is only implemented in sequential due to memory conflicts,
+		  * except the evaluation of the refinement indicator. */
+		virtual void parallel_exec(Real dt = 0.0) override { exec(); };
+	protected:
+		RefinementIndicator* refinement_indicator_;
+		StdLargeVec<Vecd>& pos_n_, & vel_n_;
+		StdLargeVec<Real>& Vol_, & Vol_0_, & sigma_0_, & rho_n_, & mass_, & smoothing_length_;
+		/** the offsets of the children in units of the particle spacing of the parent */
+		StdVec<Vecd> splitting_stencil_;
+		StdLargeVec<Real> target_smoothing_length_;
+		/** whether a particle is split or merged already, or merged away, in this execution */
+		StdLargeVec<bool> is_adapted_, is_merged_away_;
+		size_t number_of_splittings_, number_of_mergings_;
+
+		bool isToBeSplit(size_t index_i);
+		/** the neighbor to be merged with, or MaxSize_t if there is none */
+		size_t findMergingPartner(size_t index_i, size_t number_of_particles);
+		void splitAParticle(size_t index_i);
+		void mergeParticles(size_t index_i, size_t index_j);
+	};
+}
@@ -0,0 +1,163 @@
+/**
+ * @file 	loop_partitioner.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "loop_partitioner.h"
+#include "mesh_cell_linked_list.h"
+
+#include <iomanip>
+#include <algorithm>
+
+namespace SPH {
+	//=================================================================================================//
+	bool LoopPartitioner::is_tuning_by_default_ = false;
+	size_t LoopPartitioner::chunks_per_thread_ = 4;
+	StdVec<size_t> LoopPartitioner::default_candidate_grain_sizes_ = { 1, 16, 64, 256, 1024 };
+	std::mutex LoopPartitioner::mutex_tuned_grain_sizes_;
+	std::map<std::string, size_t> LoopPartitioner::tuned_grain_sizes_;
+	//=================================================================================================//
+	LoopPartitioner::LoopPartitioner()
+		: grain_size_(1), number_of_parallel_loops_(0), is_tuning_(false),
+		candidate_index_(0), trial_(0), number_of_trials_(0)
+	{
+		if (is_tuning_by_default_) enableAutoTuning();
+	}
+	//=================================================================================================//
+	void LoopPartitioner::setGrainSize(size_t grain_size)
+	{
+		grain_size_ = SMAX(grain_size, size_t(1));
+		is_tuning_ = false;
+	}
+	//=================================================================================================//
+	void LoopPartitioner::enableAutoTuning(const StdVec<size_t>& candidate_grain_sizes, size_t number_of_trials)
+	{
+		if (candidate_grain_sizes.empty() || number_of_trials == 0)
+		{
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			std::cout << "\n Auto-tuning failure: no candidate grain size or no trial is given!" << std::endl;
+			exit(1);
+		}
+		candidate_grain_sizes_ = candidate_grain_sizes;
+		tuning_wall_times_.assign(candidate_grain_sizes_.size(), Infinity);
+		candidate_index_ = 0;
+		trial_ = 0;
+		number_of_trials_ = number_of_trials;
+		number_of_parallel_loops_ = 0;
+		grain_size_ = SMAX(candidate_grain_sizes_[0], size_t(1));
+		is_tuning_ = true;
+	}
+	//=================================================================================================//
+	bool LoopPartitioner::recordAnExecution(Real wall_time)
+	{
+		if (!is_tuning_ || number_of_parallel_loops_ == 0) return false;
+		number_of_parallel_loops_ = 0;
+
+		tuning_wall_times_[candidate_index_] = SMIN(tuning_wall_times_[candidate_index_], wall_time);
+		if (++trial_ < number_of_trials_) return false;
+
+		trial_ = 0;
+		if (++candidate_index_ < candidate_grain_sizes_.size())
+		{
+			grain_size_ = SMAX(candidate_grain_sizes_[candidate_index_], size_t(1));
+			return false;
+		}
+
+		size_t fastest = std::min_element(tuning_wall_times_.begin(), tuning_wall_times_.end())
+			- tuning_wall_times_.begin();
+		grain_size_ = SMAX(candidate_grain_sizes_[fastest], size_t(1));
+		is_tuning_ = false;
+		return true;
+	}
+	//=================================================================================================//
+	void LoopPartitioner::partitionCellLists(ConcurrentCellLists& cell_lists, IndexVector& chunks)
+	{
+		chunks.clear();
+		chunks.push_back(0);
+
+		size_t number_of_cells = cell_lists.size();
+		size_t total_cost = 0;
+		for (size_t l = 0; l != number_of_cells; ++l)
+			total_cost += SMAX(cell_lists[l]->cost_, cell_lists[l]->real_particle_indexes_.size());
+		size_t number_of_chunks = SMIN(number_of_cells,
+			chunks_per_thread_ * size_t(this_task_arena::max_concurrency()));
+
+		/** cut a chunk as soon as its accumulated cost reaches its share of the total cost */
+		size_t accumulated_cost = 0;
+		for (size_t l = 0; l + 1 < number_of_cells; ++l)
+		{
+			accumulated_cost += SMAX(cell_lists[l]->cost_, cell_lists[l]->real_particle_indexes_.size());
+			if (accumulated_cost * number_of_chunks >= chunks.size() * total_cost && total_cost != 0)
+				chunks.push_back(l + 1);
+		}
+		if (number_of_cells != 0) chunks.push_back(number_of_cells);
+	}
+	//=================================================================================================//
+	IndexVector& LoopPartitioner::SweepChunks(ConcurrentCellLists& cell_lists, IndexVector& chunks, size_t sweep_index)
+	{
+		if (!chunks.empty() && chunks.back() == cell_lists.size()) return chunks;
+
+		/** e.g. the configuration has not been updated after the cell linked list */
+		if (sweep_index >= cell_list_chunks_.size()) cell_list_chunks_.resize(sweep_index + 1);
+		partitionCellLists(cell_lists, cell_list_chunks_[sweep_index]);
+		return cell_list_chunks_[sweep_index];
+	}
+	//=================================================================================================//
+	affinity_partitioner& LoopPartitioner::SweepAffinity(size_t sweep_index)
+	{
+		if (sweep_index >= sweep_affinities_.size()) sweep_affinities_.resize(sweep_index + 1);
+		if (sweep_affinities_[sweep_index] == nullptr)
+			sweep_affinities_[sweep_index].reset(new affinity_partitioner());
+		return *sweep_affinities_[sweep_index];
+	}
+	//=================================================================================================//
+	void LoopPartitioner::recordASweep(size_t sweep_index, Real max_busy_time, Real total_busy_time)
+	{
+		if (total_busy_time <= 0.0) return;
+		if (sweep_index >= sweep_imbalances_.size()) sweep_imbalances_.resize(sweep_index + 1);
+
+		SweepImbalance& sweep_imbalance = sweep_imbalances_[sweep_index];
+		Real imbalance = max_busy_time * Real(this_task_arena::max_concurrency()) / total_busy_time;
+		sweep_imbalance.number_of_sweeps_++;
+		sweep_imbalance.sum_imbalance_ += imbalance;
+		sweep_imbalance.max_imbalance_ = SMAX(sweep_imbalance.max_imbalance_, imbalance);
+	}
+	//=================================================================================================//
+	void LoopPartitioner::printSweepImbalances(std::ostream& out)
+	{
+		std::ios_base::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << "\n Load imbalances of the sweeps over split cell lists:\n";
+		out << std::setw(8) << "sweep" << std::setw(10) << "sweeps" << std::setw(12) << "mean" << std::setw(12) << "max" << "\n";
+		for (size_t k = 0; k != sweep_imbalances_.size(); ++k)
+			out << std::setw(8) << k << std::setw(10) << sweep_imbalances_[k].number_of_sweeps_
+				<< std::fixed << std::setprecision(3)
+				<< std::setw(12) << sweep_imbalances_[k].MeanImbalance()
+				<< std::setw(12) << sweep_imbalances_[k].max_imbalance_ << "\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+	//=================================================================================================//
+	void LoopPartitioner::recordATunedGrainSize(const std::string& dynamics_name, size_t grain_size)
+	{
+		std::lock_guard<std::mutex> lock(mutex_tuned_grain_sizes_);
+		tuned_grain_sizes_[dynamics_name] = grain_size;
+	}
+	//=================================================================================================//
+	void LoopPartitioner::printTunedGrainSizes(std::ostream& out)
+	{
+		std::lock_guard<std::mutex> lock(mutex_tuned_grain_sizes_);
+		size_t name_width = 8;
+		for (auto& tuned : tuned_grain_sizes_) name_width = SMAX(name_width, tuned.first.size());
+
+		out << "\n Tuned grain sizes of the particle dynamics:\n";
+		out << std::left << std::setw(name_width + 2) << " dynamics" << std::right
+			<< std::setw(12) << "grain size" << "\n";
+		for (auto& tuned : tuned_grain_sizes_)
+			out << " " << std::left << std::setw(name_width + 1) << tuned.first << std::right
+				<< std::setw(12) << tuned.second << "\n";
+		out << std::right;
+	}
+	//=================================================================================================//
+}
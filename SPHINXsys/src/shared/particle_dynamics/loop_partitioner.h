@@ -0,0 +1,184 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	loop_partitioner.h
+ * @brief 	The partitioner state and the grain size of the parallel loops of a particle dynamics,
+ * with an optional auto-tuning of the grain size during the first executions.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+#include "sph_data_conainers.h"
+#include "dynamics_profiler.h"
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <memory>
+
+namespace SPH {
+
+	/**
+	 * @struct SweepImbalance
+	 * @brief The load imbalance of the parallel sweeps over the cell lists of a split,
+	 * i.e. the longest busy time of a thread over the mean busy time of all threads.
+	 */
+	struct SweepImbalance
+	{
+		size_t number_of_sweeps_;
+		Real sum_imbalance_;
+		Real max_imbalance_;
+
+		SweepImbalance() : number_of_sweeps_(0), sum_imbalance_(0.0), max_imbalance_(0.0) {};
+		Real MeanImbalance() { return number_of_sweeps_ == 0 ? 0.0 : sum_imbalance_ / Real(number_of_sweeps_); };
+	};
+
+	/**
+	 * @class LoopPartitioner
+	 * @brief Owned by each particle dynamics, so that the affinity history of its loops
+	 * is not mixed up with that of the loops of other dynamics.
+	 * The affinity of the loops over particles and that of the loops over cell lists
+	 * are kept separately, and each sweep over split cell lists has its own affinity,
+	 * as the cell lists of the splits are different. The grain size only applies to the loops over particles,
+	 * the loops over cell lists are already coarse.
+	 * During auto-tuning, each candidate grain size is tried for a number of parallel executions
+	 * and the one with the shortest wall time of a single execution is locked in.
+	 * The sequential executions are not counted.
+	 * The cell lists of a split are swept in chunks of about equal estimated costs,
+	 * so that the threads are balanced even if the particles are distributed very unevenly in the cells.
+	 * The chunks are partitioned by the inner configuration of the body after estimating the costs,
+	 * and they are only partitioned again here if they do not match the present cell lists.
+	 * The imbalance of each sweep is recorded when the profiler is enabled.
+	 */
+	class LoopPartitioner
+	{
+	public:
+		LoopPartitioner();
+		virtual ~LoopPartitioner() {};
+
+		/** set the grain size, which also stops a running tuning */
+		void setGrainSize(size_t grain_size);
+		size_t GrainSize() { return grain_size_; };
+		void enableAutoTuning(const StdVec<size_t>& candidate_grain_sizes, size_t number_of_trials = 3);
+		void enableAutoTuning() { enableAutoTuning(default_candidate_grain_sizes_); };
+		bool isTuning() { return is_tuning_; };
+
+		/** the range and the partitioner of a parallel loop over particles */
+		blocked_range<size_t> ParticleRange(size_t number_of_particles)
+		{
+			number_of_parallel_loops_++;
+			return blocked_range<size_t>(0, number_of_particles, grain_size_);
+		};
+		affinity_partitioner& ParticleLoopAffinity() { return particle_loop_affinity_; };
+		/** the partitioner of a parallel loop over cell lists other than the sweeps over split cell lists */
+		affinity_partitioner& CellListLoopAffinity() { return cell_list_loop_affinity_; };
+		/** parallel sweep over the cell lists of a split in the given chunks of balanced costs,
+		  * the chunk function is given the range of the cell lists in a chunk. */
+		template <class ChunkFunction>
+		void sweepCellLists(ConcurrentCellLists& cell_lists, IndexVector& chunks, size_t sweep_index,
+			const ChunkFunction& chunk_function);
+		StdVec<SweepImbalance>& SweepImbalances() { return sweep_imbalances_; };
+		void printSweepImbalances(std::ostream& out = std::cout);
+		/** record the wall time of an execution, return true when the tuning is just finished */
+		bool recordAnExecution(Real wall_time);
+
+		/** the dynamics defined afterwards are tuned from the start, e.g. for a whole case */
+		static void enableAutoTuningByDefault(bool is_tuning = true) { is_tuning_by_default_ = is_tuning; };
+		static void recordATunedGrainSize(const std::string& dynamics_name, size_t grain_size);
+		static void printTunedGrainSizes(std::ostream& out = std::cout);
+		/** the number of chunks of cell lists for each thread in a sweep */
+		static void setChunksPerThread(size_t chunks_per_thread) { chunks_per_thread_ = SMAX(chunks_per_thread, size_t(1)); };
+		/** partition the cell lists into chunks of about equal estimated costs */
+		static void partitionCellLists(ConcurrentCellLists& cell_lists, IndexVector& chunks);
+	protected:
+		size_t grain_size_;
+		affinity_partitioner particle_loop_affinity_;
+		affinity_partitioner cell_list_loop_affinity_;
+		/** the number of parallel loops over particles since the last recorded execution */
+		size_t number_of_parallel_loops_;
+		/** the chunks partitioned by the sweeps themselves, for each sweep */
+		StdVec<IndexVector> cell_list_chunks_;
+		/** the partitioner of each sweep */
+		StdVec<std::unique_ptr<affinity_partitioner>> sweep_affinities_;
+		StdVec<SweepImbalance> sweep_imbalances_;
+
+		/** the given chunks if they match the cell lists, otherwise those partitioned for the sweep */
+		IndexVector& SweepChunks(ConcurrentCellLists& cell_lists, IndexVector& chunks, size_t sweep_index);
+		affinity_partitioner& SweepAffinity(size_t sweep_index);
+		void recordASweep(size_t sweep_index, Real max_busy_time, Real total_busy_time);
+
+		bool is_tuning_;
+		StdVec<size_t> candidate_grain_sizes_;
+		/** the shortest wall time of each candidate */
+		StdVec<Real> tuning_wall_times_;
+		size_t candidate_index_;
+		size_t trial_;
+		size_t number_of_trials_;
+
+		static bool is_tuning_by_default_;
+		static size_t chunks_per_thread_;
+		static StdVec<size_t> default_candidate_grain_sizes_;
+		static std::mutex mutex_tuned_grain_sizes_;
+		static std::map<std::string, size_t> tuned_grain_sizes_;
+	};
+	//=================================================================================================//
+	template <class ChunkFunction>
+	void LoopPartitioner::sweepCellLists(ConcurrentCellLists& cell_lists, IndexVector& chunks,
+		size_t sweep_index, const ChunkFunction& chunk_function)
+	{
+		IndexVector& sweep_chunks = SweepChunks(cell_lists, chunks, sweep_index);
+		affinity_partitioner& sweep_affinity = SweepAffinity(sweep_index);
+		if (!DynamicsProfiler::isEnabled())
+		{
+			parallel_for(blocked_range<size_t>(0, sweep_chunks.size() - 1),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t n = r.begin(); n < r.end(); ++n)
+						chunk_function(sweep_chunks[n], sweep_chunks[n + 1]);
+				}, sweep_affinity);
+			return;
+		}
+
+		enumerable_thread_specific<Real> busy_times(0.0);
+		parallel_for(blocked_range<size_t>(0, sweep_chunks.size() - 1),
+			[&](const blocked_range<size_t>& r) {
+				tick_count start = tick_count::now();
+				for (size_t n = r.begin(); n < r.end(); ++n)
+					chunk_function(sweep_chunks[n], sweep_chunks[n + 1]);
+				busy_times.local() += (tick_count::now() - start).seconds();
+			}, sweep_affinity);
+
+		Real max_busy_time = 0.0;
+		Real total_busy_time = 0.0;
+		for (auto& busy_time : busy_times)
+		{
+			max_busy_time = SMAX(max_busy_time, busy_time);
+			total_busy_time += busy_time;
+		}
+		recordASweep(sweep_index, max_busy_time, total_busy_time);
+	}
+	//=================================================================================================//
+}
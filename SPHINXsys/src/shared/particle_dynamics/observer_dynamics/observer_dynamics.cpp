@@ -36,7 +36,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -55,7 +55,7 @@ namespace SPH
 			/** Add the kernel weight correction to W_ij_ of neighboring particles. */
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					Vecd normalized_weight_correction = B_ * weight_correction;
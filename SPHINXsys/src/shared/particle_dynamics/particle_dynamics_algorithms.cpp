@@ -6,12 +6,19 @@
 */
 
 #include "particle_dynamics_algorithms.h"
+#include "domain_decomposition.h"
 
 //=================================================================================================//
 namespace SPH {
+	//=================================================================================================//
+	void updateHaloAfterInitialization(SPHBody* body)
+	{
+		if (body->domain_decomposition_ != NULL) body->domain_decomposition_->exec();
+	}
 	//=================================================================================================//
 	void ParticleDynamicsSimple::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
@@ -20,14 +27,16 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsSimple::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsInner::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
@@ -36,14 +45,16 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsInner::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_inner_interaction_, dt);
+		InnerIterator_parallel(number_of_particles, functor_inner_interaction_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsInnerWithUpdate::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		ParticleDynamicsInner::exec(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
 		InnerIterator(number_of_particles, functor_update_, dt);
@@ -51,33 +62,39 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsInnerWithUpdate::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		ParticleDynamicsInner::parallel_exec(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsInner1Level::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
 		InnerIterator(number_of_particles, functor_initialization_, dt);
+		updateHaloAfterInitialization(sph_body_);
 		InnerIterator(number_of_particles, functor_inner_interaction_, dt);
 		InnerIterator(number_of_particles, functor_update_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsInner1Level::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_initialization_, dt);
-		InnerIterator_parallel(number_of_particles, functor_inner_interaction_, dt);
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_initialization_, loop_partitioner_, dt);
+		updateHaloAfterInitialization(sph_body_);
+		InnerIterator_parallel(number_of_particles, functor_inner_interaction_, loop_partitioner_, dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsContact::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
@@ -86,30 +103,73 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsContact::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_contact_interaction_, dt);
+		InnerIterator_parallel(number_of_particles, functor_contact_interaction_, loop_partitioner_, dt);
+	}
+	//=================================================================================================//
+	void ParticleDynamicsComplex::setSymmetricPairs(bool use_symmetric_pairs)
+	{
+		use_symmetric_pairs_ = use_symmetric_pairs;
+		if (use_symmetric_pairs_) body_complex_relation_->requestInnerPairConfiguration();
+		profiled_configurations_[0] = use_symmetric_pairs_ ?
+			&body_complex_relation_->inner_pair_configuration_ : &body_complex_relation_->inner_configuration_;
+	}
+	//=================================================================================================//
+	void ParticleDynamicsComplex::PairwiseComplexInteraction(size_t index_i, Real dt)
+	{
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		std::cout << "\n Pairwise interaction failure: not implemented for this particle dynamics!" << std::endl;
+		exit(1);
+	}
+	//=================================================================================================//
+	void ParticleDynamicsComplex::ComplexInteractionIterator(Real dt)
+	{
+		if (use_symmetric_pairs_)
+		{
+			InnerIteratorSplitting(split_cell_lists_, functor_pairwise_interaction_, dt);
+		}
+		else
+		{
+			size_t number_of_particles = sph_body_->number_of_particles_;
+			InnerIterator(number_of_particles, functor_complex_interaction_, dt);
+		}
+	}
+	//=================================================================================================//
+	void ParticleDynamicsComplex::ComplexInteractionIterator_parallel(Real dt)
+	{
+		if (use_symmetric_pairs_)
+		{
+			InnerIteratorSplitting_parallel(split_cell_lists_, split_cell_list_chunks_, functor_pairwise_interaction_, loop_partitioner_, dt);
+		}
+		else
+		{
+			size_t number_of_particles = sph_body_->number_of_particles_;
+			InnerIterator_parallel(number_of_particles, functor_complex_interaction_, loop_partitioner_, dt);
+		}
 	}
 	//=================================================================================================//
 	void ParticleDynamicsComplex::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
-		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator(number_of_particles, functor_complex_interaction_, dt);
+		ComplexInteractionIterator(dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsComplex::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
-		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_complex_interaction_, dt);
+		ComplexInteractionIterator_parallel(dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsComplexWithUpdate::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		ParticleDynamicsComplex::exec(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
 		InnerIterator(number_of_particles, functor_update_, dt);
@@ -117,49 +177,58 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsComplexWithUpdate::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		ParticleDynamicsComplex::parallel_exec(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsComplex1Level::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
 		InnerIterator(number_of_particles, functor_initialization_, dt);
-		InnerIterator(number_of_particles, functor_complex_interaction_, dt);
+		updateHaloAfterInitialization(sph_body_);
+		ComplexInteractionIterator(dt);
 		InnerIterator(number_of_particles, functor_update_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsComplex1Level::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_initialization_, dt);
-		InnerIterator_parallel(number_of_particles, functor_complex_interaction_, dt);
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_initialization_, loop_partitioner_, dt);
+		updateHaloAfterInitialization(sph_body_);
+		ComplexInteractionIterator_parallel(dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//===============================================================//
 	void ParticleDynamicsComplexSplit::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
 		InnerIterator(number_of_particles, functor_initialization_, dt);
+		updateHaloAfterInitialization(sph_body_);
 		InnerIteratorSplitting(split_cell_lists_, functor_complex_interaction_, dt);
 		InnerIterator(number_of_particles, this->functor_update_, dt);
 	}
 	//===============================================================//
 	void ParticleDynamicsComplexSplit::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		size_t number_of_particles = sph_body_->number_of_particles_;
-		InnerIterator_parallel(number_of_particles, functor_initialization_, dt);
-		InnerIteratorSplitting_parallel(split_cell_lists_, functor_complex_interaction_, dt);
-		InnerIterator_parallel(number_of_particles, functor_update_, dt);
+		InnerIterator_parallel(number_of_particles, functor_initialization_, loop_partitioner_, dt);
+		updateHaloAfterInitialization(sph_body_);
+		InnerIteratorSplitting_parallel(split_cell_lists_, split_cell_list_chunks_, functor_complex_interaction_, loop_partitioner_, dt);
+		InnerIterator_parallel(number_of_particles, functor_update_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	ParticleDynamicsCellListSplitting
@@ -173,6 +242,7 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsCellListSplitting::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		CellListIteratorSplitting(split_cell_lists_, functor_cell_list_, dt);
@@ -180,13 +250,15 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsCellListSplitting::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
-		CellListIteratorSplitting_parallel(split_cell_lists_, functor_cell_list_, dt);
+		CellListIteratorSplitting_parallel(split_cell_lists_, split_cell_list_chunks_, functor_cell_list_, loop_partitioner_, dt);
 	}
 	//=================================================================================================//
 	void ParticleDynamicsInnerSplitting::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		InnerIteratorSplittingSweeping(split_cell_lists_, functor_inner_interaction_, dt);
@@ -194,13 +266,15 @@ namespace SPH {
 	//=================================================================================================//
 	void ParticleDynamicsInnerSplitting::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
-		InnerIteratorSplittingSweeping_parallel(split_cell_lists_, functor_inner_interaction_, dt);
+		InnerIteratorSplittingSweeping_parallel(split_cell_lists_, split_cell_list_chunks_, functor_inner_interaction_, loop_partitioner_, dt);
 	}
 	//=============================================================================================//
 	void ParticleDynamicsComplexSplitting::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
 		InnerIteratorSplittingSweeping(split_cell_lists_, functor_particle_interaction_, dt);
@@ -208,9 +282,10 @@ namespace SPH {
 	//=============================================================================================//
 	void ParticleDynamicsComplexSplitting::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, sph_body_->number_of_particles_);
 		setBodyUpdated();
 		setupDynamics(dt);
-		InnerIteratorSplittingSweeping_parallel(split_cell_lists_, functor_particle_interaction_, dt);
+		InnerIteratorSplittingSweeping_parallel(split_cell_lists_, split_cell_list_chunks_, functor_particle_interaction_, loop_partitioner_, dt);
 	}
 	//=============================================================================================//
 }
@@ -40,6 +40,10 @@
 
 namespace SPH 
 {
+	/** Update the halo of a decomposed body, so that the ghost particles
+	  * take the initialized states before the interaction. */
+	void updateHaloAfterInitialization(SPHBody* body);
+
 	/**
 	* @class ParticleDynamicsSimple
 	* @brief Simple particle dynamics without considering particle interaction
@@ -67,6 +71,8 @@ namespace SPH
 		class ParticleDynamicsReduce : public ParticleDynamics<ReturnType>
 	{
 	public:
+		typedef ReturnType ReduceReturnType;
+
 		explicit ParticleDynamicsReduce(SPHBody* body) : 
 			ParticleDynamics<ReturnType>(body), initial_reference_(),
 			functor_reduce_function_(std::bind(&ParticleDynamicsReduce::ReduceFunction, this, _1, _2)) {};
@@ -75,6 +81,7 @@ namespace SPH
 		virtual ReturnType exec(Real dt = 0.0) override
 		{
 			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
 			this->setBodyUpdated();
 			SetupReduce();
 			ReturnType temp = ReduceIterator(number_of_particles,
@@ -84,10 +91,11 @@ namespace SPH
 		virtual ReturnType parallel_exec(Real dt = 0.0) override
 		{
 			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
 			this->setBodyUpdated();
 			SetupReduce();
 			ReturnType temp = ReduceIterator_parallel(number_of_particles,
-				initial_reference_, functor_reduce_function_, reduce_operation_, dt);
+				initial_reference_, functor_reduce_function_, reduce_operation_, this->loop_partitioner_, dt);
 			return this->OutputResult(temp);
 		};
 	protected:
@@ -112,7 +120,10 @@ namespace SPH
 	public:
 		explicit ParticleDynamicsInner(SPHBodyInnerRelation* body_inner_relation) 
 			: ParticleDynamics<void>(body_inner_relation->sph_body_),
-			functor_inner_interaction_(std::bind(&ParticleDynamicsInner::InnerInteraction, this, _1, _2)) {};
+			functor_inner_interaction_(std::bind(&ParticleDynamicsInner::InnerInteraction, this, _1, _2))
+		{
+			profiled_configurations_.push_back(&body_inner_relation->inner_configuration_);
+		};
 		virtual ~ParticleDynamicsInner() {};
 
 		virtual void exec(Real dt = 0.0) override;
@@ -169,7 +180,11 @@ namespace SPH
 	public:
 		explicit ParticleDynamicsContact(SPHBodyContactRelation* body_contact_relation)
 			: ParticleDynamics<void>(body_contact_relation->sph_body_),
-			functor_contact_interaction_(std::bind(&ParticleDynamicsContact::ContactInteraction, this, _1, _2)) {};
+			functor_contact_interaction_(std::bind(&ParticleDynamicsContact::ContactInteraction, this, _1, _2))
+		{
+			for (size_t k = 0; k != body_contact_relation->contact_configuration_.size(); ++k)
+				profiled_configurations_.push_back(&body_contact_relation->contact_configuration_[k]);
+		};
 		virtual ~ParticleDynamicsContact() {};
 
 		virtual void exec(Real dt = 0.0) override;
@@ -182,20 +197,47 @@ namespace SPH
 	/**
 	* @class ParticleDynamicsComplex
 	* @brief complex operations combining both inner and contact particle dynamics together
+	* Optionally, for the dynamics implementing the pairwise interaction,
+	* each inner particle pair is computed only once with the neighbors j > i,
+	* and the equal and opposite contributions are added to both particles.
+	* The particles are then iterated by the split cell lists so that 
+	* no two particles of the same neighborhood are written concurrently.
+	* Note that the pairwise interaction is not suitable for periodic conditions, 
+	* which insert ghost entries of the particles from the other side of the domain.
 	*/
 	class ParticleDynamicsComplex : public ParticleDynamics<void>
 	{
 	public:
 		ParticleDynamicsComplex(SPHBodyComplexRelation* body_complex_relation)
 			: ParticleDynamics<void>(body_complex_relation->sph_body_),
-			functor_complex_interaction_(std::bind(&ParticleDynamicsComplex::ComplexInteraction, this, _1, _2)) {};
+			body_complex_relation_(body_complex_relation), use_symmetric_pairs_(false),
+			functor_complex_interaction_(std::bind(&ParticleDynamicsComplex::ComplexInteraction, this, _1, _2)),
+			functor_pairwise_interaction_(std::bind(&ParticleDynamicsComplex::PairwiseComplexInteraction, this, _1, _2))
+		{
+			profiled_configurations_.push_back(&body_complex_relation->inner_configuration_);
+			for (size_t k = 0; k != body_complex_relation->contact_configuration_.size(); ++k)
+				profiled_configurations_.push_back(&body_complex_relation->contact_configuration_[k]);
+		};
 		virtual ~ParticleDynamicsComplex() {};
 
 		virtual void exec(Real dt = 0.0) override;
 		virtual void parallel_exec(Real dt = 0.0) override;
+		/** compute each inner particle pair once by the pairwise interaction */
+		void setSymmetricPairs(bool use_symmetric_pairs);
 	protected:
+		SPHBodyComplexRelation* body_complex_relation_;
+		bool use_symmetric_pairs_;
+
 		virtual void ComplexInteraction(size_t index_i, Real dt = 0.0) = 0;
 		InnerFunctor functor_complex_interaction_;
+		/** the inner interaction with the neighbors j > i, which also writes to the neighbors, 
+		  * and the contact interaction of particle i. */
+		virtual void PairwiseComplexInteraction(size_t index_i, Real dt = 0.0);
+		InnerFunctor functor_pairwise_interaction_;
+
+		/** iterate the complex or the pairwise interaction */
+		void ComplexInteractionIterator(Real dt = 0.0);
+		void ComplexInteractionIterator_parallel(Real dt = 0.0);
 	};
 
 	/**
@@ -282,7 +324,10 @@ namespace SPH
 	public:
 		explicit ParticleDynamicsInnerSplitting(SPHBodyInnerRelation* body_inner_relation)
 			: ParticleDynamics<void>(body_inner_relation->sph_body_),
-			functor_inner_interaction_(std::bind(&ParticleDynamicsInnerSplitting::InnerInteraction, this, _1, _2)) {};
+			functor_inner_interaction_(std::bind(&ParticleDynamicsInnerSplitting::InnerInteraction, this, _1, _2))
+		{
+			profiled_configurations_.push_back(&body_inner_relation->inner_configuration_);
+		};
 		virtual ~ParticleDynamicsInnerSplitting() {};
 
 		virtual void exec(Real dt = 0.0) override;
@@ -302,7 +347,12 @@ namespace SPH
 	public:
 		explicit ParticleDynamicsComplexSplitting(SPHBodyComplexRelation* body_complex_relation)
 			: ParticleDynamics<void>(body_complex_relation->sph_body_),
-			functor_particle_interaction_(std::bind(&ParticleDynamicsComplexSplitting::ParticleInteraction, this, _1, _2)) {};
+			functor_particle_interaction_(std::bind(&ParticleDynamicsComplexSplitting::ParticleInteraction, this, _1, _2))
+		{
+			profiled_configurations_.push_back(&body_complex_relation->inner_configuration_);
+			for (size_t k = 0; k != body_complex_relation->contact_configuration_.size(); ++k)
+				profiled_configurations_.push_back(&body_complex_relation->contact_configuration_[k]);
+		};
 		virtual ~ParticleDynamicsComplexSplitting() {};
 
 		virtual void exec(Real dt = 0.0) override;
@@ -11,6 +11,7 @@ namespace SPH {
 	//=================================================================================================//
 	void PartDynamicsByParticle::exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, constrained_particles_.size());
 		setBodyUpdated();
 		setupDynamics(dt);
 		for (size_t i = 0; i < constrained_particles_.size(); ++i)
@@ -21,18 +22,21 @@ namespace SPH {
 	//=================================================================================================//
 	void PartDynamicsByParticle::parallel_exec(Real dt)
 	{
+		DynamicsTiming dynamics_timing(this, constrained_particles_.size());
 		setBodyUpdated();
 		setupDynamics(dt);
-		parallel_for(blocked_range<size_t>(0, constrained_particles_.size()),
+		parallel_for(loop_partitioner_.ParticleRange(constrained_particles_.size()),
 			[&](const blocked_range<size_t>& r) {
 			for (size_t i = r.begin(); i < r.end(); ++i) {
 				Update(constrained_particles_[i], dt);
 			}
-		}, ap);
+		}, loop_partitioner_.ParticleLoopAffinity());
 	}
 	//=================================================================================================//
 	void PartDynamicsByCell::exec(Real dt)
 	{
+		/** the particles in the constrained cells are not counted. */
+		DynamicsTiming dynamics_timing(this, 0);
 		setBodyUpdated();
 		setupDynamics(dt);
 		for (size_t i = 0; i != constrained_cells_.size(); ++i) {
@@ -43,6 +47,8 @@ namespace SPH {
 	//=================================================================================================//
 	void PartDynamicsByCell::parallel_exec(Real dt)
 	{
+		/** the particles in the constrained cells are not counted. */
+		DynamicsTiming dynamics_timing(this, 0);
 		setBodyUpdated();
 		setupDynamics(dt);
 		parallel_for(blocked_range<size_t>(0, constrained_cells_.size()),
@@ -51,7 +57,7 @@ namespace SPH {
 					CellListDataVector& list_data = constrained_cells_[i]->cell_list_data_;
 					for (size_t num = 0; num < list_data.size(); ++num) Update(list_data[num].first, dt);
 				}
-			}, ap);
+			}, loop_partitioner_.CellListLoopAffinity());
 	}
 	//=================================================================================================//
 }
\ No newline at end of file
@@ -93,6 +93,7 @@ namespace SPH {
 
 		virtual ReturnType exec(Real dt = 0.0) override
 		{
+			DynamicsTiming dynamics_timing(this, constrained_particles_.size());
 			ReturnType temp = initial_reference_;
 			this->SetupReduce();
 			//note that base member need to referred by pointer
@@ -105,6 +106,7 @@ namespace SPH {
 		};
 		virtual ReturnType parallel_exec(Real dt = 0.0) override
 		{
+			DynamicsTiming dynamics_timing(this, constrained_particles_.size());
 			ReturnType temp = initial_reference_;
 			this->SetupReduce();
 			//note that base member need to referred by pointer
@@ -0,0 +1,200 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+* @file 	particle_dynamics_fused.h
+* @brief 	The particle dynamics algorithms which fuse the per-particle stages
+*			of two dynamics of the same body into one loop over the particles.
+* @detail	The simple dynamics, the time step initialization and the time step size
+*			are often only a short stage between the loops of interaction dynamics.
+*			Each loop reads and writes the particle data from the memory,
+*			which, instead of the computation, limits the performance.
+*			Here, such a stage is executed in the loop of another dynamics.
+*			A stage executed before an interaction is fused only if
+*			the declared data access of both dynamics allows.
+*			The update and the reduce stages are always fusible after the interaction,
+*			as they concern only the particle itself.
+* @author	Chi ZHang and Xiangyu Hu
+* @version	0.1
+*/
+#pragma once
+
+#include "particle_dynamics_inlined.h"
+
+#include <utility>
+
+namespace SPH
+{
+	/**
+	* @class FusedParticleDynamicsSimpleComplex
+	* @brief The update of a simple dynamics followed by the complex interaction
+	* of a dynamics type derived from ParticleDynamicsComplex in the same particle loop.
+	* The simple dynamics is set up before the complex dynamics.
+	* As the pairwise interaction writes to the neighbors, the loops are not fused
+	* when the symmetric pairs are used. Neither are they for a decomposed body,
+	* whose halo is updated between the two loops.
+	*/
+	template <class SimpleDynamicsType, class DynamicsType>
+	class FusedParticleDynamicsSimpleComplex : public InlinedParticleDynamicsComplex<DynamicsType>
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit FusedParticleDynamicsSimpleComplex(InlinedParticleDynamicsSimple<SimpleDynamicsType>& simple_dynamics,
+			ConstructorArgs&&... args)
+			: InlinedParticleDynamicsComplex<DynamicsType>(std::forward<ConstructorArgs>(args)...),
+			simple_dynamics_(simple_dynamics)
+		{
+			if (simple_dynamics_.FusedBody() != this->sph_body_
+				|| !simple_dynamics_.DataAccess().isFusibleBefore(this->DataAccess()))
+			{
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				std::cout << "\n Fusion failure: " << simple_dynamics_.DynamicsName() << " and "
+					<< this->DynamicsName() << " are not of the same body or their declared data access conflicts!" << std::endl;
+				exit(1);
+			}
+		};
+		virtual ~FusedParticleDynamicsSimpleComplex() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			simple_dynamics_.setupFusedStage(dt);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			if (this->use_symmetric_pairs_ || this->sph_body_->domain_decomposition_ != NULL)
+			{
+				ParticleIterator(number_of_particles,
+					[&](size_t index_i, Real dt) { simple_dynamics_.FusedStage(index_i, dt); }, dt);
+				updateHaloAfterInitialization(this->sph_body_);
+				this->InlinedComplexInteraction(dt);
+			}
+			else
+			{
+				ParticleIterator(number_of_particles,
+					[&](size_t index_i, Real dt) {
+						simple_dynamics_.FusedStage(index_i, dt);
+						this->DynamicsType::ComplexInteraction(index_i, dt);
+					}, dt);
+			}
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			simple_dynamics_.setupFusedStage(dt);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			if (this->use_symmetric_pairs_ || this->sph_body_->domain_decomposition_ != NULL)
+			{
+				ParticleIterator_parallel(number_of_particles,
+					[&](size_t index_i, Real dt) { simple_dynamics_.FusedStage(index_i, dt); }, this->loop_partitioner_, dt);
+				updateHaloAfterInitialization(this->sph_body_);
+				this->InlinedComplexInteraction_parallel(dt);
+			}
+			else
+			{
+				ParticleIterator_parallel(number_of_particles,
+					[&](size_t index_i, Real dt) {
+						simple_dynamics_.FusedStage(index_i, dt);
+						this->DynamicsType::ComplexInteraction(index_i, dt);
+					}, this->loop_partitioner_, dt);
+			}
+		};
+	protected:
+		InlinedParticleDynamicsSimple<SimpleDynamicsType>& simple_dynamics_;
+	};
+
+	/**
+	* @class FusedParticleDynamicsComplex1LevelReduce
+	* @brief A dynamics type derived from ParticleDynamicsComplex1Level
+	* with its update stage and the following reduce dynamics in the same particle loop,
+	* e.g. the second half of the pressure relaxation and the acoustic time step size.
+	* The reduce function is called with the default zero time step size
+	* and the result is obtained after the execution.
+	*/
+	template <class DynamicsType, class ReduceDynamicsType>
+	class FusedParticleDynamicsComplex1LevelReduce : public InlinedParticleDynamicsComplex1Level<DynamicsType>
+	{
+		typedef typename ReduceDynamicsType::ReduceReturnType ReturnType;
+	public:
+		template <typename... ConstructorArgs>
+		explicit FusedParticleDynamicsComplex1LevelReduce(InlinedParticleDynamicsReduce<ReduceDynamicsType>& reduce_dynamics,
+			ConstructorArgs&&... args)
+			: InlinedParticleDynamicsComplex1Level<DynamicsType>(std::forward<ConstructorArgs>(args)...),
+			reduce_dynamics_(reduce_dynamics), fused_result_()
+		{
+			if (reduce_dynamics_.FusedBody() != this->sph_body_)
+			{
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				std::cout << "\n Fusion failure: " << this->DynamicsName() << " and "
+					<< reduce_dynamics_.DynamicsName() << " are not of the same body!" << std::endl;
+				exit(1);
+			}
+		};
+		virtual ~FusedParticleDynamicsComplex1LevelReduce() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			this->InlinedComplexInteraction(dt);
+			ReturnType initial_reference = reduce_dynamics_.setupFusedStage();
+			auto reduce_operation = [&](ReturnType x, ReturnType y) { return reduce_dynamics_.FusedReduceOperation(x, y); };
+			ReturnType temp = ParticleReducer(number_of_particles, initial_reference,
+				[&](size_t index_i, Real dt)->ReturnType {
+					this->DynamicsType::Update(index_i, dt);
+					return reduce_dynamics_.FusedStage(index_i);
+				}, reduce_operation, dt);
+			fused_result_ = reduce_dynamics_.OutputFusedResult(temp);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, this->loop_partitioner_, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			this->InlinedComplexInteraction_parallel(dt);
+			ReturnType initial_reference = reduce_dynamics_.setupFusedStage();
+			auto reduce_operation = [&](ReturnType x, ReturnType y) { return reduce_dynamics_.FusedReduceOperation(x, y); };
+			ReturnType temp = ParticleReducer_parallel(number_of_particles, initial_reference,
+				[&](size_t index_i, Real dt)->ReturnType {
+					this->DynamicsType::Update(index_i, dt);
+					return reduce_dynamics_.FusedStage(index_i);
+				}, reduce_operation, this->loop_partitioner_, dt);
+			fused_result_ = reduce_dynamics_.OutputFusedResult(temp);
+		};
+		/** the output of the reduce dynamics from the last execution */
+		ReturnType FusedResult() { return fused_result_; };
+	protected:
+		InlinedParticleDynamicsReduce<ReduceDynamicsType>& reduce_dynamics_;
+		ReturnType fused_result_;
+	};
+}
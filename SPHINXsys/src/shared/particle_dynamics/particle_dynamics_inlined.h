@@ -0,0 +1,344 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+* @file 	particle_dynamics_inlined.h
+* @brief 	The particle dynamics algorithms with static dispatch.
+* @detail	The algorithms in particle_dynamics_algorithms.h call the particle functions,
+*			such as Update or ComplexInteraction, through functors bound to virtual functions.
+*			Here, the algorithm is derived from a given dynamics type and calls the particle
+*			functions of the dynamics type directly in the particle loop,
+*			so that they can be inlined and vectorized by the compiler.
+*			The dynamics type is constructed with the same arguments.
+*			Note that the particle functions are those of the dynamics type,
+*			i.e. they can not be overridden further by deriving from the algorithm.
+*			For inlining, the algorithm is explicitly instantiated in the translation unit
+*			where the particle functions of the dynamics type are defined.
+* @author	Chi ZHang and Xiangyu Hu
+* @version	0.1
+*/
+#pragma once
+
+#include "particle_dynamics_algorithms.h"
+
+#include <utility>
+
+namespace SPH
+{
+	/**
+	* @class InlinedParticleDynamicsSimple
+	* @brief Simple particle dynamics for a dynamics type derived from ParticleDynamicsSimple.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsSimple : public DynamicsType
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsSimple(ConstructorArgs&&... args)
+			: DynamicsType(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsSimple() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, this->loop_partitioner_, dt);
+		};
+
+		/** the body, the setup and the particle function for being fused into the loop of another dynamics */
+		SPHBody* FusedBody() { return this->sph_body_; };
+		void setupFusedStage(Real dt = 0.0)
+		{
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+		};
+		void FusedStage(size_t index_i, Real dt = 0.0) { this->DynamicsType::Update(index_i, dt); };
+	};
+
+	/**
+	* @class InlinedParticleDynamicsReduce
+	* @brief Reduce dynamics for a dynamics type derived from ParticleDynamicsReduce.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsReduce : public DynamicsType
+	{
+		typedef typename DynamicsType::ReduceReturnType ReturnType;
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsReduce(ConstructorArgs&&... args)
+			: DynamicsType(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsReduce() {};
+
+		virtual ReturnType exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->SetupReduce();
+			ReturnType temp = ParticleReducer(number_of_particles, this->initial_reference_,
+				[&](size_t index_i, Real dt)->ReturnType { return this->DynamicsType::ReduceFunction(index_i, dt); },
+				this->reduce_operation_, dt);
+			return this->OutputResult(temp);
+		};
+		virtual ReturnType parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->SetupReduce();
+			ReturnType temp = ParticleReducer_parallel(number_of_particles, this->initial_reference_,
+				[&](size_t index_i, Real dt)->ReturnType { return this->DynamicsType::ReduceFunction(index_i, dt); },
+				this->reduce_operation_, this->loop_partitioner_, dt);
+			return this->OutputResult(temp);
+		};
+
+		/** the body, the setup, the particle function and the output
+		  * for being fused into the loop of another dynamics */
+		SPHBody* FusedBody() { return this->sph_body_; };
+		ReturnType setupFusedStage()
+		{
+			this->setBodyUpdated();
+			this->SetupReduce();
+			return this->initial_reference_;
+		};
+		ReturnType FusedStage(size_t index_i, Real dt = 0.0) { return this->DynamicsType::ReduceFunction(index_i, dt); };
+		ReturnType FusedReduceOperation(ReturnType x, ReturnType y) { return this->reduce_operation_(x, y); };
+		ReturnType OutputFusedResult(ReturnType reduced_value) { return this->OutputResult(reduced_value); };
+	};
+
+	/**
+	* @class InlinedParticleDynamicsInner
+	* @brief Inner interactions for a dynamics type derived from ParticleDynamicsInner.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsInner : public DynamicsType
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsInner(ConstructorArgs&&... args)
+			: DynamicsType(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsInner() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::InnerInteraction(index_i, dt); }, dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::InnerInteraction(index_i, dt); }, this->loop_partitioner_, dt);
+		};
+	};
+
+	/**
+	* @class InlinedParticleDynamicsInner1Level
+	* @brief Inner interactions for a dynamics type derived from ParticleDynamicsInner1Level.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsInner1Level : public DynamicsType
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsInner1Level(ConstructorArgs&&... args)
+			: DynamicsType(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsInner1Level() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::InnerInteraction(index_i, dt); }, dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, this->loop_partitioner_, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::InnerInteraction(index_i, dt); }, this->loop_partitioner_, dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, this->loop_partitioner_, dt);
+		};
+	};
+
+	/**
+	* @class InlinedParticleDynamicsComplex
+	* @brief Complex interactions for a dynamics type derived from ParticleDynamicsComplex.
+	* The symmetric pairs are iterated by the split cell lists as in ParticleDynamicsComplex.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsComplex : public DynamicsType
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsComplex(ConstructorArgs&&... args)
+			: DynamicsType(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsComplex() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			DynamicsTiming dynamics_timing(this, this->sph_body_->number_of_particles_);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			InlinedComplexInteraction(dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			DynamicsTiming dynamics_timing(this, this->sph_body_->number_of_particles_);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			InlinedComplexInteraction_parallel(dt);
+		};
+	protected:
+		void InlinedComplexInteraction(Real dt)
+		{
+			if (this->use_symmetric_pairs_)
+			{
+				ParticleIteratorSplitting(this->split_cell_lists_,
+					[&](size_t index_i, Real dt) { this->DynamicsType::PairwiseComplexInteraction(index_i, dt); }, dt);
+			}
+			else
+			{
+				ParticleIterator(this->sph_body_->number_of_particles_,
+					[&](size_t index_i, Real dt) { this->DynamicsType::ComplexInteraction(index_i, dt); }, dt);
+			}
+		};
+		void InlinedComplexInteraction_parallel(Real dt)
+		{
+			if (this->use_symmetric_pairs_)
+			{
+				ParticleIteratorSplitting_parallel(this->split_cell_lists_, this->split_cell_list_chunks_,
+					[&](size_t index_i, Real dt) { this->DynamicsType::PairwiseComplexInteraction(index_i, dt); }, this->loop_partitioner_, dt);
+			}
+			else
+			{
+				ParticleIterator_parallel(this->sph_body_->number_of_particles_,
+					[&](size_t index_i, Real dt) { this->DynamicsType::ComplexInteraction(index_i, dt); }, this->loop_partitioner_, dt);
+			}
+		};
+	};
+
+	/**
+	* @class InlinedParticleDynamicsComplexWithUpdate
+	* @brief Complex interactions for a dynamics type derived from ParticleDynamicsComplexWithUpdate.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsComplexWithUpdate : public InlinedParticleDynamicsComplex<DynamicsType>
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsComplexWithUpdate(ConstructorArgs&&... args)
+			: InlinedParticleDynamicsComplex<DynamicsType>(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsComplexWithUpdate() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			InlinedParticleDynamicsComplex<DynamicsType>::exec(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			InlinedParticleDynamicsComplex<DynamicsType>::parallel_exec(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, this->loop_partitioner_, dt);
+		};
+	};
+
+	/**
+	* @class InlinedParticleDynamicsComplex1Level
+	* @brief Complex interactions for a dynamics type derived from ParticleDynamicsComplex1Level.
+	*/
+	template <class DynamicsType>
+	class InlinedParticleDynamicsComplex1Level : public InlinedParticleDynamicsComplex<DynamicsType>
+	{
+	public:
+		template <typename... ConstructorArgs>
+		explicit InlinedParticleDynamicsComplex1Level(ConstructorArgs&&... args)
+			: InlinedParticleDynamicsComplex<DynamicsType>(std::forward<ConstructorArgs>(args)...) {};
+		virtual ~InlinedParticleDynamicsComplex1Level() {};
+
+		virtual void exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			this->InlinedComplexInteraction(dt);
+			ParticleIterator(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, dt);
+		};
+		virtual void parallel_exec(Real dt = 0.0) override
+		{
+			size_t number_of_particles = this->sph_body_->number_of_particles_;
+			DynamicsTiming dynamics_timing(this, number_of_particles);
+			this->setBodyUpdated();
+			this->setupDynamics(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Initialization(index_i, dt); }, this->loop_partitioner_, dt);
+			updateHaloAfterInitialization(this->sph_body_);
+			this->InlinedComplexInteraction_parallel(dt);
+			ParticleIterator_parallel(number_of_particles,
+				[&](size_t index_i, Real dt) { this->DynamicsType::Update(index_i, dt); }, this->loop_partitioner_, dt);
+		};
+	};
+}
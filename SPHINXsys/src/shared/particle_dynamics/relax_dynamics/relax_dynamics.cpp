@@ -40,7 +40,7 @@ namespace SPH
 		void RelaxationAccelerationInner::InnerInteraction(size_t index_i, Real dt)
 		{
 			Vecd acceleration(0);// = -2.0 * complex_shape_->computeKernelIntegral(pos_n_[index_i], kernel_);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -73,7 +73,7 @@ namespace SPH
 		void RelaxationAccelerationComplex::ComplexInteraction(size_t index_i, Real dt)
 		{
 			Vecd acceleration(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -84,7 +84,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -98,44 +98,46 @@ namespace SPH
 		}
 		//=================================================================================================//
 		BodySurfaceBounding::
-			BodySurfaceBounding(SPHBody* body, NearBodySurface* body_part) :
+			BodySurfaceBounding(SPHBody* body, NearBodySurface* body_part, bool use_exact_shape) :
 			PartDynamicsByCell(body, body_part),
-			RelaxDataDelegateSimple(body), pos_n_(particles_->pos_n_)
+			RelaxDataDelegateSimple(body), pos_n_(particles_->pos_n_),
+			surface_shape_(use_exact_shape ? body->body_shape_ : body->getLevelSetShape())
 		{
 		}
 		//=================================================================================================//
 		void BodySurfaceBounding::Update(size_t index_i, Real dt)
 		{
-			Real phi = body_->body_shape_->findSignedDistance(pos_n_[index_i]);
+			Real phi = surface_shape_->findSignedDistance(pos_n_[index_i]);
 			if (phi > -0.5 * body_->particle_spacing_)
 			{
-				Vecd unit_normal = body_->body_shape_->findNormalDirection(pos_n_[index_i]);
+				Vecd unit_normal = surface_shape_->findNormalDirection(pos_n_[index_i]);
 				unit_normal /= unit_normal.norm() + TinyReal;
 				pos_n_[index_i] -= (phi + 0.5 * body_->particle_spacing_) * unit_normal;
 			}
 		}
 		//=================================================================================================//
 		ConstraintSurfaceParticles::
-			ConstraintSurfaceParticles(SPHBody* body, BodySurface* body_part)
+			ConstraintSurfaceParticles(SPHBody* body, BodySurface* body_part, bool use_exact_shape)
 			:PartDynamicsByParticle(body, body_part),
-			RelaxDataDelegateSimple(body), pos_n_(particles_->pos_n_)
+			RelaxDataDelegateSimple(body), pos_n_(particles_->pos_n_),
+			surface_shape_(use_exact_shape ? body->body_shape_ : body->getLevelSetShape())
 		{
 		}
 		//=================================================================================================//
 		void ConstraintSurfaceParticles::Update(size_t index_i, Real dt)
 		{
-			Real phi = body_->body_shape_->findSignedDistance(pos_n_[index_i]);
-			Vecd unit_normal = body_->body_shape_->findNormalDirection(pos_n_[index_i]);
+			Real phi = surface_shape_->findSignedDistance(pos_n_[index_i]);
+			Vecd unit_normal = surface_shape_->findNormalDirection(pos_n_[index_i]);
 			unit_normal /= unit_normal.norm() + TinyReal;
 			pos_n_[index_i] -= (phi + 0.5 * body_->particle_spacing_) * unit_normal;
 		}
 		//=================================================================================================//
-		RelaxationStepInner::RelaxationStepInner(SPHBodyInnerRelation* body_inner_relation) :
+		RelaxationStepInner::RelaxationStepInner(SPHBodyInnerRelation* body_inner_relation, bool use_exact_shape) :
 			ParticleDynamics<void>(body_inner_relation->sph_body_),
 			sph_body_(body_inner_relation->sph_body_), inner_relation_(body_inner_relation),
 			relaxation_acceleration_inner_(inner_relation_),
 			get_time_step_square_(sph_body_), update_particle_position_(sph_body_),
-			surface_bounding_(sph_body_, new NearBodySurface(sph_body_)) {}
+			surface_bounding_(sph_body_, new NearBodySurface(sph_body_), use_exact_shape) {}
 		//=================================================================================================//
 		void RelaxationStepInner::exec(Real dt)
 		{
@@ -176,7 +178,7 @@ namespace SPH
 
 			/** Inner interaction. */
 			Real sigma = W0_;
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 				sigma += inner_neighborhood.W_ij_[n];
 
@@ -184,7 +186,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_0_k = *(contact_Vol_0_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
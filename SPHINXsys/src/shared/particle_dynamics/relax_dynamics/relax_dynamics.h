@@ -127,17 +127,20 @@ namespace SPH
 		* @class BodySurfaceBounding
 		* @brief constrain surface particles by
 		* map contrained particles to geometry face and
-		* r = r + phi * norm (vector distance to face)
+		* r = r + phi * norm (vector distance to face).
+		* The distance and the normal are probed from the level set of the body shape,
+		* or queried from the exact body shape if use_exact_shape is true.
 		*/
 		class BodySurfaceBounding : 
 			public PartDynamicsByCell,
 			public RelaxDataDelegateSimple
 		{
 		public:
-			BodySurfaceBounding(SPHBody *body, NearBodySurface* body_part);
+			BodySurfaceBounding(SPHBody *body, NearBodySurface* body_part, bool use_exact_shape = false);
 			virtual ~BodySurfaceBounding() {};
 		protected:
 			StdLargeVec<Vecd>& pos_n_;
+			ComplexShape* surface_shape_;
 			virtual void Update(size_t index_i, Real dt = 0.0) override;
 		};
 
@@ -145,17 +148,20 @@ namespace SPH
 		* @class ConstraintSurfaceParticles
 		* @brief constrain surface particles by
 		* map contrained particles to geometry face and
-		* r = r + phi * norm (vector distance to face)
+		* r = r + phi * norm (vector distance to face).
+		* The distance and the normal are probed from the level set of the body shape,
+		* or queried from the exact body shape if use_exact_shape is true.
 		*/
 		class ConstraintSurfaceParticles : 
 			public PartDynamicsByParticle,
 			public RelaxDataDelegateSimple
 		{
 		public:
-			ConstraintSurfaceParticles(SPHBody* body, BodySurface* body_part);
+			ConstraintSurfaceParticles(SPHBody* body, BodySurface* body_part, bool use_exact_shape = false);
 			virtual ~ConstraintSurfaceParticles() {};
 		protected:
 			StdLargeVec<Vecd>& pos_n_;
+			ComplexShape* surface_shape_;
 			virtual void Update(size_t index_i, Real dt = 0.0) override;
 		};
 
@@ -169,7 +175,7 @@ namespace SPH
 			SPHBody* sph_body_;
 			SPHBodyInnerRelation* inner_relation_;
 		public:
-			explicit RelaxationStepInner(SPHBodyInnerRelation* body_inner_relation);
+			explicit RelaxationStepInner(SPHBodyInnerRelation* body_inner_relation, bool use_exact_shape = false);
 			virtual ~RelaxationStepInner() {};
 
 			RelaxationAccelerationInner relaxation_acceleration_inner_;
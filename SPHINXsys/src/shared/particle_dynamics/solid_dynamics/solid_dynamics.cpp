@@ -22,7 +22,7 @@ namespace SPH
 		void NormalDirectionSummation::ComplexInteraction(size_t index_i, Real dt)
 		{
 			Vecd gradient(0.0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				gradient += inner_neighborhood.dW_ij_[n] * inner_neighborhood.e_ij_[n];
@@ -31,7 +31,7 @@ namespace SPH
 			/** Contact interaction. */
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					gradient += contact_neighborhood.dW_ij_[n] * contact_neighborhood.e_ij_[n];
@@ -56,7 +56,7 @@ namespace SPH
 			Matd local_configuration(0.0);
 			Vecd gradient(0.0);
 
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -71,7 +71,7 @@ namespace SPH
 			for (size_t k = 0; k < contact_configuration_.size(); ++k)
 			{
 				StdLargeVec<Real>& Vol_0_k = *(contact_Vol_0_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -172,7 +172,7 @@ namespace SPH
 			{
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Vecd>& vel_n_k = *(contact_vel_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -202,7 +202,7 @@ namespace SPH
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Real>& rho_n_k = *(contact_rho_n_[k]);
 				StdLargeVec<Vecd>& vel_n_k = *(contact_vel_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -254,7 +254,7 @@ namespace SPH
 				StdLargeVec<Vecd>& vel_n_k = *(contact_vel_n_[k]);
 				StdLargeVec<Vecd>& dvel_dt_others_k = *(contact_dvel_dt_others_[k]);
 				Fluid* fluid_k = contact_material_[k];
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -334,7 +334,7 @@ namespace SPH
 		{
 			/** a small number added to diagnal to avoid divide zero */
 			Matd local_configuration(Eps);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -361,7 +361,7 @@ namespace SPH
 			Vecd& pos_n_i = pos_n_[index_i];
 
 			Matd deformation(0.0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -406,7 +406,7 @@ namespace SPH
 			//including gravity and force from fluid
 			Vecd acceleration = dvel_dt_others_[index_i]
 				+ force_from_fluid_[index_i] / mass_[index_i];
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -433,7 +433,7 @@ namespace SPH
 			Vecd& vel_n_i = vel_n_[index_i];
 
 			Matd deformation_gradient_change_rate(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -555,7 +555,7 @@ namespace SPH
 			Vecd error(0);
 			Real parameter_a(0);
 			Real parameter_c(0);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			for (size_t n = 0; n != inner_neighborhood.current_size_; ++n)
 			{
 				size_t index_j = inner_neighborhood.j_[n];
@@ -610,7 +610,7 @@ namespace SPH
 			Vecd& vel_n_i = vel_n_[index_i];
 
 			StdVec<Real> parameter_b(50);
-			Neighborhood& inner_neighborhood = inner_configuration_[index_i];
+			Neighborhood inner_neighborhood = inner_configuration_[index_i];
 			size_t number_of_neighbors = inner_neighborhood.current_size_;
 			parameter_b.resize(number_of_neighbors);
 			//forward sweep
@@ -688,7 +688,7 @@ namespace SPH
 				StdLargeVec<Real>& Vol_k = *(contact_Vol_[k]);
 				StdLargeVec<Real>& rho_n_k = *(contact_rho_n_[k]);
 				StdLargeVec<Vecd>& vel_n_k = *(contact_vel_n_[k]);
-				Neighborhood& contact_neighborhood = contact_configuration_[k][index_i];
+				Neighborhood contact_neighborhood = contact_configuration_[k][index_i];
 				for (size_t n = 0; n != contact_neighborhood.current_size_; ++n)
 				{
 					size_t index_j = contact_neighborhood.j_[n];
@@ -58,7 +58,9 @@ namespace SPH
 	void BaseParticles::initializeABaseParticle(Vecd pnt, Real Vol_0, Real sigma_0)
 	{
 		particle_id_.push_back(pos_n_.size());
+		sorted_id_.push_back(pos_n_.size());
 		is_sortable_.push_back(true);
+		sequence_.push_back(0);
 
 		pos_n_.push_back(pnt);
 		vel_n_.push_back(Vecd(0));
@@ -72,13 +74,15 @@ namespace SPH
 		rho_0_.push_back(rho);
 		rho_n_.push_back(rho);
 		mass_.push_back(rho * Vol_0);
-		smoothing_length_.push_back(0);
+		smoothing_length_.push_back(body_->kernel_->GetSmoothingLength());
 	}
 	//=================================================================================================//
 	void BaseParticles::addABufferParticle()
 	{
 		particle_id_.push_back(pos_n_.size());
+		sorted_id_.push_back(pos_n_.size());
 		is_sortable_.push_back(true);
+		sequence_.push_back(0);
 
 		//update registered data in particle dynamics
 		for (size_t i = 0; i != registered_matrices_.size(); ++i) 
@@ -107,11 +111,81 @@ namespace SPH
 			(*registered_scalars_[i])[this_index] = (*registered_scalars_[i])[another_index];
 	}
 	//=================================================================================================//
+	void BaseParticles::switchToBufferParticle(size_t index_i)
+	{
+		size_t last_real_particle_index = body_->number_of_particles_ - 1;
+		if (index_i != last_real_particle_index)
+		{
+			swapParticles(index_i, last_real_particle_index);
+			std::swap(is_sortable_[index_i], is_sortable_[last_real_particle_index]);
+		}
+		body_->number_of_particles_--;
+	}
+	//=================================================================================================//
 	bool BaseParticles::isSwappingAllowed(size_t this_particle_index, size_t that_particle_index)
 	{
 		return  is_sortable_[this_particle_index] && is_sortable_[that_particle_index];
 	}
 	//=================================================================================================//
+	void BaseParticles::swapParticles(size_t this_index, size_t that_index)
+	{
+		for (size_t i = 0; i != registered_matrices_.size(); ++i)
+			std::swap((*registered_matrices_[i])[this_index], (*registered_matrices_[i])[that_index]);
+		for (size_t i = 0; i != registered_vectors_.size(); ++i)
+			std::swap((*registered_vectors_[i])[this_index], (*registered_vectors_[i])[that_index]);
+		for (size_t i = 0; i != registered_scalars_.size(); ++i)
+			std::swap((*registered_scalars_[i])[this_index], (*registered_scalars_[i])[that_index]);
+
+		std::swap(particle_id_[this_index], particle_id_[that_index]);
+		std::swap(sequence_[this_index], sequence_[that_index]);
+		sorted_id_[particle_id_[this_index]] = this_index;
+		sorted_id_[particle_id_[that_index]] = that_index;
+	}
+	//=================================================================================================//
+	void BaseParticles::sortRealParticles()
+	{
+		size_t number_of_particles = body_->number_of_particles_;
+		sortable_particles_.clear();
+		for (size_t i = 0; i != number_of_particles; ++i)
+			if (is_sortable_[i]) sortable_particles_.push_back(i);
+
+		/** Ties are broken by the present index so that the sorting is deterministic. */
+		sorted_particles_ = sortable_particles_;
+		StdLargeVec<size_t>& sequence = sequence_;
+		parallel_sort(sorted_particles_.begin(), sorted_particles_.end(),
+			[&](const size_t& a, const size_t& b)->bool {
+				return sequence[a] < sequence[b] || (sequence[a] == sequence[b] && a < b);
+			});
+
+		for (size_t i = 0; i != registered_matrices_.size(); ++i)
+			sortAVariable(*registered_matrices_[i]);
+		for (size_t i = 0; i != registered_vectors_.size(); ++i)
+			sortAVariable(*registered_vectors_[i]);
+		for (size_t i = 0; i != registered_scalars_.size(); ++i)
+			sortAVariable(*registered_scalars_[i]);
+		sortAVariable(particle_id_);
+		sortAVariable(sequence_);
+
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					sorted_id_[particle_id_[i]] = i;
+			}, sorting_affinity_);
+	}
+	//=================================================================================================//
+	void BaseParticles::firstTouchParticleData()
+	{
+		for (size_t i = 0; i != registered_matrices_.size(); ++i)
+			FirstTouch::relocate(*registered_matrices_[i]);
+		for (size_t i = 0; i != registered_vectors_.size(); ++i)
+			FirstTouch::relocate(*registered_vectors_[i]);
+		for (size_t i = 0; i != registered_scalars_.size(); ++i)
+			FirstTouch::relocate(*registered_scalars_[i]);
+		FirstTouch::relocate(particle_id_);
+		FirstTouch::relocate(sorted_id_);
+		FirstTouch::relocate(sequence_);
+	}
+	//=================================================================================================//
 	size_t BaseParticles ::insertAGhostParticle(size_t index_i)
 	{
 		number_of_ghost_particles_ += 1;
@@ -130,6 +204,60 @@ namespace SPH
 		return expected_particle_index;
 	}
 	//=================================================================================================//
+	size_t BaseParticles::insertAGhostParticle(StdVec<Real>& buffer, size_t& position)
+	{
+		number_of_ghost_particles_ += 1;
+		size_t expected_size = real_particles_bound_ + number_of_ghost_particles_;
+		size_t expected_particle_index = expected_size - 1;
+		if (expected_size > pos_n_.size()) addABufferParticle();
+		unpackAParticle(expected_particle_index, buffer, position);
+		return expected_particle_index;
+	}
+	//=================================================================================================//
+	void BaseParticles::packAParticle(size_t index_i, StdVec<Real>& buffer)
+	{
+		for (size_t i = 0; i != registered_matrices_.size(); ++i)
+		{
+			Matd& matrix = (*registered_matrices_[i])[index_i];
+			for (int k = 0; k != matrix.nrow(); ++k)
+				for (int l = 0; l != matrix.ncol(); ++l)
+					buffer.push_back(matrix(k, l));
+		}
+		for (size_t i = 0; i != registered_vectors_.size(); ++i)
+		{
+			Vecd& vector = (*registered_vectors_[i])[index_i];
+			for (int k = 0; k != vector.size(); ++k)
+				buffer.push_back(vector[k]);
+		}
+		for (size_t i = 0; i != registered_scalars_.size(); ++i)
+			buffer.push_back((*registered_scalars_[i])[index_i]);
+
+		buffer.push_back(Real(particle_id_[index_i]));
+		buffer.push_back(is_sortable_[index_i] ? 1.0 : 0.0);
+	}
+	//=================================================================================================//
+	void BaseParticles::unpackAParticle(size_t index_i, StdVec<Real>& buffer, size_t& position)
+	{
+		for (size_t i = 0; i != registered_matrices_.size(); ++i)
+		{
+			Matd& matrix = (*registered_matrices_[i])[index_i];
+			for (int k = 0; k != matrix.nrow(); ++k)
+				for (int l = 0; l != matrix.ncol(); ++l)
+					matrix(k, l) = buffer[position++];
+		}
+		for (size_t i = 0; i != registered_vectors_.size(); ++i)
+		{
+			Vecd& vector = (*registered_vectors_[i])[index_i];
+			for (int k = 0; k != vector.size(); ++k)
+				vector[k] = buffer[position++];
+		}
+		for (size_t i = 0; i != registered_scalars_.size(); ++i)
+			(*registered_scalars_[i])[index_i] = buffer[position++];
+
+		particle_id_[index_i] = size_t(buffer[position++]);
+		is_sortable_[index_i] = buffer[position++] != 0.0;
+	}
+	//=================================================================================================//
 	void  BaseParticles::mirrorInAxisDirection(size_t particle_index_i, Vecd body_bound, int axis_direction)
 	{
 		pos_n_[particle_index_i][axis_direction]
@@ -156,11 +284,11 @@ namespace SPH
 		//write header of particles data
 		output_file << "   <PointData  Vectors=\"vector\">\n";
 
-		//write particles ID
+		//write particles ID, which is kept by the sorting
 		output_file << "    <DataArray Name=\"Particle_ID\" type=\"Int32\" Format=\"ascii\">\n";
 		output_file << "    ";
 		for (size_t i = 0; i != number_of_particles; ++i) {
-			output_file << i << " ";
+			output_file << particle_id_[i] << " ";
 		}
 		output_file << std::endl;
 		output_file << "    </DataArray>\n";
@@ -195,6 +323,54 @@ namespace SPH
 		}
 	}
 	//=================================================================================================//
+	void BaseParticles::writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays)
+	{
+		data_arrays.addPositions(pos_n_);
+		data_arrays.addPointIndexes("Particle_ID", particle_id_);
+
+		for (size_t l = 0; l != vectors_to_write_.size(); ++l) {
+			string variable_name = vectors_to_write_[l];
+			data_arrays.addAVectorArray(variable_name, *(registered_vectors_[vectors_map_[variable_name]]));
+		}
+
+		for (size_t l = 0; l != scalars_to_write_.size(); ++l) {
+			string variable_name = scalars_to_write_[l];
+			data_arrays.addAScalarArray(variable_name, *(registered_scalars_[scalars_map_[variable_name]]));
+		}
+	}
+	//=================================================================================================//
+	void BaseParticles::writeParticlesToBinaryCheckpoint(BinaryCheckpointWriter& checkpoint)
+	{
+		size_t number_of_particles = body_->number_of_particles_;
+		checkpoint.writeABodyHead(body_name_, number_of_particles);
+		writeRegisteredVariablesToCheckpoint(checkpoint, registered_matrices_, matrices_map_, "Matrix", number_of_particles);
+		writeRegisteredVariablesToCheckpoint(checkpoint, registered_vectors_, vectors_map_, "Vector", number_of_particles);
+		writeRegisteredVariablesToCheckpoint(checkpoint, registered_scalars_, scalars_map_, "Scalar", number_of_particles);
+		checkpoint.writeAnArray("ParticleID", particle_id_, number_of_particles);
+	}
+	//=================================================================================================//
+	void BaseParticles::readParticlesFromBinaryCheckpoint(BinaryCheckpointReader& checkpoint)
+	{
+		size_t number_of_particles = checkpoint.NumberOfParticles(body_name_);
+		if (number_of_particles > real_particles_bound_)
+		{
+			std::cout << "
+ Error: the checkpoint has more particles than the body " << body_name_ << " allows" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+		body_->number_of_particles_ = number_of_particles;
+
+		readRegisteredVariablesFromCheckpoint(checkpoint, registered_matrices_, matrices_map_, "Matrix");
+		readRegisteredVariablesFromCheckpoint(checkpoint, registered_vectors_, vectors_map_, "Vector");
+		readRegisteredVariablesFromCheckpoint(checkpoint, registered_scalars_, scalars_map_, "Scalar");
+		if (checkpoint.readAnArray(body_name_, "ParticleID", particle_id_))
+		{
+			for (size_t i = 0; i != number_of_particles; ++i)
+				sorted_id_[particle_id_[i]] = i;
+		}
+	}
+	//=================================================================================================//
 	void BaseParticles::writeToXmlForReloadParticle(std::string &filefullpath)
 	{
 		const SimTK::String xml_name("particles_xml"), ele_name("particles");
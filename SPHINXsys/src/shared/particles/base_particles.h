@@ -33,6 +33,8 @@
 #include "base_data_package.h"
 #include "sph_data_conainers.h"
 #include "xml_engine.h"
+#include "vtu_data_arrays.h"
+#include "binary_checkpoint.h"
 
 #include <fstream>
 using namespace std;
@@ -65,10 +67,13 @@ namespace SPH {
 		BaseParticles(SPHBody* body);
 		virtual ~BaseParticles() {};
 	
-		/** For a real particle, its initial value is the index.
-		 *	For a ghost particle, it is the index of its corresponding real particle. */
+		/** For a real particle, its initial value is the index and it is kept after particle sorting.
+		 *	For a ghost particle, it is the particle id of its corresponding real particle. */
 		StdLargeVec<size_t> particle_id_;
+		/** The current index of a particle from its original index, i.e. the inverse of particle_id_. */
+		StdLargeVec<size_t> sorted_id_;
 		StdLargeVec<bool> is_sortable_;  /**< whether subject to sorting. */
+		StdLargeVec<size_t> sequence_;	/**< the sorting key, such as the Morton order of the particle cell. */
 
 		StdLargeVec<Vecd> pos_n_;	/**< current position */
 		StdLargeVec<Vecd> vel_n_;	/**< current particle velocity */
@@ -81,7 +86,7 @@ namespace SPH {
 		StdLargeVec<Real> rho_0_;	/**< initial particle density*/
 		StdLargeVec<Real> mass_;	/**< particle mass */
 		StdLargeVec<Real> sigma_0_;	/**< reference number density. */
-		StdLargeVec<Real> smoothing_length_;
+		StdLargeVec<Real> smoothing_length_;	/**< variable smoothing length, used with a multilevel cell linked list */
 
 		//----------------------------------------------------------------------
 		//Global information for all partiles
@@ -127,18 +132,35 @@ namespace SPH {
 		void copyFromAnotherParticle(size_t this_index, size_t another_index);
 		/** Update the state of a particle from another particle */
 		void updateFromAnotherParticle(size_t this_index, size_t another_index);
+		/** Remove a real particle by moving the last real particle to its place,
+		 *  the removed one becomes the first buffer particle. */
+		void switchToBufferParticle(size_t index_i);
 
 		/** Swapping particles. */
-		void swapParticles(size_t this_index, size_t that_index) {};
+		void swapParticles(size_t this_index, size_t that_index);
+		/** Sort the sortable real particles according to the sorting keys in sequence_.
+		 *  All registered variables are reordered and particle_id_ is kept as the stable identity. */
+		void sortRealParticles();
+		/** Relocate the registered variables and the particle indexes, with their memory pages touched first
+		 *  in the static partition of the particles, see FirstTouch. */
+		void firstTouchParticleData();
 		/** Check whether particles allowed for swaping*/
 		bool isSwappingAllowed(size_t this_index, size_t that_index);
 		/** Insert a ghost particle into the particle list. */
 		size_t insertAGhostParticle(size_t index_i);
+		/** Insert a ghost particle with the state unpacked from a buffer, e.g. received from another rank. */
+		size_t insertAGhostParticle(StdVec<Real>& buffer, size_t& position);
+		/** Append the registered variables, the particle id and the sortable tag of a particle to a buffer. */
+		void packAParticle(size_t index_i, StdVec<Real>& buffer);
+		/** Unpack a particle packed by packAParticle from the position of a buffer, which is then advanced. */
+		void unpackAParticle(size_t index_i, StdVec<Real>& buffer, size_t& position);
 		/** Get mirror a particle along an axis direaction. */
 		void mirrorInAxisDirection(size_t particle_index_i, Vecd body_bound, int axis_direction);
 
 		/** Write particle data in VTU format for Paraview. */
 		virtual void writeParticlesToVtuFile(ofstream &output_file);
+		/** Write particle data to the data arrays of a binary VTU file. */
+		virtual void writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays);
 		/** Write particle data in PLT format for Tecplot. */
 		virtual void writeParticlesToPltFile(ofstream& output_file) {};
 
@@ -146,6 +168,10 @@ namespace SPH {
 		virtual void writeParticlesToXmlForRestart(std::string& filefullpath) {};
 		/** Initialize particle data from restart xml file. */
 		virtual void readParticleFromXmlForRestart(std::string& filefullpath) {};
+		/** Write all registered particle data and the particle IDs to a binary checkpoint. */
+		virtual void writeParticlesToBinaryCheckpoint(BinaryCheckpointWriter& checkpoint);
+		/** Initialize particle data from a binary checkpoint. */
+		virtual void readParticlesFromBinaryCheckpoint(BinaryCheckpointReader& checkpoint);
 
 		/** Output particle position and volume in XML file for reloading particles. */
 		virtual void writeToXmlForReloadParticle(std::string &filefullpath);
@@ -163,5 +189,58 @@ namespace SPH {
 	protected:
 		SPHBody* body_; /**< The body in which the particles belongs to. */
 		string body_name_;
+
+		IndexVector sortable_particles_;	/**< the real particles which are allowed to be sorted */
+		IndexVector sorted_particles_;		/**< the sortable particles in the order after sorting */
+		/** partitioner of the parallel loops of the sorting, which is not shared with other bodies */
+		affinity_partitioner sorting_affinity_;
+		/** Reorder a variable so that the particle from sorted_particles_[k] moves to sortable_particles_[k]. */
+		template<typename VariableType>
+		void sortAVariable(StdLargeVec<VariableType>& variable)
+		{
+			size_t total_sortable_particles = sortable_particles_.size();
+			StdLargeVec<VariableType> sorted_variable(total_sortable_particles);
+			parallel_for(blocked_range<size_t>(0, total_sortable_particles),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t k = r.begin(); k != r.end(); ++k)
+						sorted_variable[k] = variable[sorted_particles_[k]];
+				}, sorting_affinity_);
+			parallel_for(blocked_range<size_t>(0, total_sortable_particles),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t k = r.begin(); k != r.end(); ++k)
+						variable[sortable_particles_[k]] = sorted_variable[k];
+				}, sorting_affinity_);
+		};
+
+		/** Names of registered variables in checkpoints, which are the registered names if available,
+		 *  otherwise, such as for diffusion species, given by the type and the registration index. */
+		template<typename VariableType>
+		StdVec<string> checkpointNames(StdVec<StdLargeVec<VariableType>*>& registered_variables,
+			map<string, size_t>& name_map, string type_name)
+		{
+			StdVec<string> names;
+			for (size_t l = 0; l != registered_variables.size(); ++l)
+				names.push_back(type_name + "_" + std::to_string(l));
+			for (auto& name_index : name_map) names[name_index.second] = name_index.first;
+			return names;
+		};
+		template<typename VariableType>
+		void writeRegisteredVariablesToCheckpoint(BinaryCheckpointWriter& checkpoint,
+			StdVec<StdLargeVec<VariableType>*>& registered_variables,
+			map<string, size_t>& name_map, string type_name, size_t number_of_particles)
+		{
+			StdVec<string> names = checkpointNames(registered_variables, name_map, type_name);
+			for (size_t l = 0; l != registered_variables.size(); ++l)
+				checkpoint.writeAnArray(names[l], *registered_variables[l], number_of_particles);
+		};
+		template<typename VariableType>
+		void readRegisteredVariablesFromCheckpoint(BinaryCheckpointReader& checkpoint,
+			StdVec<StdLargeVec<VariableType>*>& registered_variables,
+			map<string, size_t>& name_map, string type_name)
+		{
+			StdVec<string> names = checkpointNames(registered_variables, name_map, type_name);
+			for (size_t l = 0; l != registered_variables.size(); ++l)
+				checkpoint.readAnArray(body_name_, names[l], *registered_variables[l]);
+		};
 	};
 }
@@ -113,6 +113,15 @@ namespace SPH {
 				output_file << "    </DataArray>\n";
 			}
 		};
+		/** Write particle data to the data arrays of a binary VTU file. */
+		virtual void writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays) override {
+			BaseParticlesType::writeParticlesToVtuDataArrays(data_arrays);
+
+			map<string, size_t>::iterator itr;
+			for (itr = species_indexes_map_.begin(); itr != species_indexes_map_.end(); ++itr) {
+				data_arrays.addAScalarArray(itr->first, species_n_[itr->second]);
+			}
+		};
 		/** Write particle data in PLT format for Tecplot. */
 		virtual void writeParticlesToPltFile(ofstream& output_file) override
 		{
@@ -142,7 +151,7 @@ namespace SPH {
 					output_file << this->pos_n_[i][j] << "  ";
 				}
 
-				output_file << i << " ";
+				output_file << this->particle_id_[i] << " ";
 
 				for (itr = species_indexes_map_.begin(); itr != species_indexes_map_.end(); ++itr) 
 				{
@@ -10,14 +10,58 @@
 namespace SPH
 {
 	//=================================================================================================//
-	void Neighborhood::addANeighbor(Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index)
+	void ParticleConfiguration::resize(size_t number_of_particles)
 	{
-		j_.push_back(j_index);
-		W_ij_.push_back(kernel.W(vec_r_ij));
-		dW_ij_.push_back(kernel.dW(vec_r_ij));
-		Real r_ij = vec_r_ij.norm();
-		r_ij_.push_back(r_ij);
-		e_ij_.push_back(vec_r_ij / (r_ij + TinyReal));
+		size_t capacity = offsets_.capacity();
+		offsets_.resize(number_of_particles + 1, offsets_.back());
+		/** only newly allocated offsets are relocated */
+		if (FirstTouch::isEnabled() && offsets_.capacity() > capacity) FirstTouch::relocate(offsets_);
+	}
+	//=================================================================================================//
+	void ParticleConfiguration::allocateNeighbors(size_t number_of_particles)
+	{
+		offsets_[0] = 0;
+		for (size_t i = 0; i != number_of_particles; ++i)
+			offsets_[i + 1] += offsets_[i];
+		size_t total_entries = offsets_[number_of_particles];
+		for (size_t i = number_of_particles + 1; i < offsets_.size(); ++i)
+			offsets_[i] = total_entries;
+
+		if (total_entries > j_.size())
+		{
+			if (FirstTouch::isEnabled())
+			{
+				allocateNeighborsByFirstTouch(number_of_particles, total_entries);
+				return;
+			}
+			j_.resize(total_entries);
+			W_ij_.resize(total_entries);
+			dW_ij_.resize(total_entries);
+			r_ij_.resize(total_entries);
+			e_ij_.resize(total_entries);
+		}
+	}
+	//=================================================================================================//
+	void ParticleConfiguration::allocateNeighborsByFirstTouch(size_t number_of_particles, size_t total_entries)
+	{
+		FirstTouch::allocateUntouched(j_, total_entries);
+		FirstTouch::allocateUntouched(W_ij_, total_entries);
+		FirstTouch::allocateUntouched(dW_ij_, total_entries);
+		FirstTouch::allocateUntouched(r_ij_, total_entries);
+		FirstTouch::allocateUntouched(e_ij_, total_entries);
+		/** the entries of a particle are touched by the thread which works on the particle */
+		parallel_for(blocked_range<size_t>(0, number_of_particles),
+			[&](const blocked_range<size_t>& r) {
+				for (size_t i = r.begin(); i != r.end(); ++i)
+					for (size_t n = offsets_[i]; n != offsets_[i + 1]; ++n)
+					{
+						j_[n] = 0;
+						W_ij_[n] = 0.0;
+						dW_ij_[n] = 0.0;
+						r_ij_[n] = 0.0;
+						e_ij_[n] = Vecd(0);
+					}
+			}, static_partitioner());
 	}
 	//=================================================================================================//
 }
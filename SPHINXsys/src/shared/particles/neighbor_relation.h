@@ -38,14 +38,38 @@ namespace SPH {
 	/**
 	 * @class Neighborhood
 	 * @brief A neighborhood around particle i.
+	 * It is a light-weight view into the contiguous storage of a particle configuration,
+	 * so that it is obtained by value and iterated as before.
 	 */
 	class Neighborhood
 	{
 	public:
 		/** the currnet number of neighors */
 		size_t current_size_;
-		/** the limit of neighors does not require memory allocation  */
-		size_t memory_size_;
+
+		size_t* j_;		/**< index of the neighbor particle. */
+		Real* W_ij_;	/**< kernel value */
+		Real* dW_ij_;	/**< derivative of kernel function */
+		Real* r_ij_;	/**< distance between j and i. */
+		Vecd* e_ij_;	/**< unit vector pointing from j to i */
+
+		Neighborhood(size_t current_size, size_t* j, Real* W_ij, Real* dW_ij, Real* r_ij, Vecd* e_ij)
+			: current_size_(current_size), j_(j), W_ij_(W_ij), dW_ij_(dW_ij), r_ij_(r_ij), e_ij_(e_ij) {};
+		~Neighborhood() {};
+	};
+
+	/**
+	 * @class ParticleConfiguration
+	 * @brief The neighborhoods for all particles in a body.
+	 * The neighbor data are saved in compressed sparse row format, i.e.
+	 * the neighbors of particle i are the entries from offsets_[i] to offsets_[i + 1]
+	 * in the contiguous arrays.
+	 */
+	class ParticleConfiguration
+	{
+	public:
+		/** the first neighbor entry of each particle, with an extra entry for the total number of entries. */
+		StdLargeVec<size_t> offsets_;
 
 		StdLargeVec<size_t> j_;		/**< index of the neighbor particle. */
 		StdLargeVec<Real> W_ij_;	/**< kernel value */
@@ -53,16 +77,74 @@ namespace SPH {
 		StdLargeVec<Real> r_ij_;	/**< distance between j and i. */
 		StdLargeVec<Vecd> e_ij_;	/**< unit vector pointing from j to i */
 
-		/** default constructor */
-		Neighborhood()
-			: current_size_(0), memory_size_(0) {};
-		~Neighborhood() {};
+		ParticleConfiguration() : offsets_(1, 0) {};
+		~ParticleConfiguration() {};
 
-		void addANeighbor(Kernel& kernel, Vecd& vec_r_ij, size_t i_index, size_t j_index);
+		/** the number of particles with a neighborhood */
+		size_t size() { return offsets_.size() - 1; };
+		/** allocate neighborhoods, without neighbors, for all particles */
+		void resize(size_t number_of_particles);
+		/** get the neighborhood of a particle */
+		Neighborhood operator[](size_t particle_index)
+		{
+			size_t begin = offsets_[particle_index];
+			return Neighborhood(offsets_[particle_index + 1] - begin, j_.data() + begin,
+				W_ij_.data() + begin, dW_ij_.data() + begin, r_ij_.data() + begin, e_ij_.data() + begin);
+		};
+		/**
+		 * @brief Allocate the neighbor entries after the numbers of neighbors 
+		 * of the first number_of_particles are saved in offsets_[i + 1]. 
+		 * The other particles have no neighbor.
+		 */
+		void allocateNeighbors(size_t number_of_particles);
+		/** set the neighbor data of an entry */
+		void setANeighbor(size_t entry_index, Kernel& kernel, Vecd& vec_r_ij, size_t j_index)
+		{
+			j_[entry_index] = j_index;
+			W_ij_[entry_index] = kernel.W(vec_r_ij);
+			dW_ij_[entry_index] = kernel.dW(vec_r_ij);
+			Real r_ij = vec_r_ij.norm();
+			r_ij_[entry_index] = r_ij;
+			e_ij_[entry_index] = vec_r_ij / (r_ij + TinyReal);
+		};
+		/** set the neighbor data of an entry in a Verlet list, 
+		  * for which the neighbor beyond the cutoff radius is given zero kernel values */
+		void setAVerletListNeighbor(size_t entry_index, Kernel& kernel, Vecd& vec_r_ij, 
+			size_t j_index, Real cutoff_radius_sqr)
+		{
+			if (vec_r_ij.normSqr() <= cutoff_radius_sqr)
+			{
+				setANeighbor(entry_index, kernel, vec_r_ij, j_index);
+			}
+			else
+			{
+				j_[entry_index] = j_index;
+				W_ij_[entry_index] = 0.0;
+				dW_ij_[entry_index] = 0.0;
+				Real r_ij = vec_r_ij.norm();
+				r_ij_[entry_index] = r_ij;
+				e_ij_[entry_index] = vec_r_ij / (r_ij + TinyReal);
+			}
+		};
+		/** set the neighbor data of an entry in a Verlet list with the variable smoothing length of the pair,
+		  * given by its inverse */
+		void setAVerletListNeighbor(size_t entry_index, Kernel& kernel, Real inv_h, Vecd& vec_r_ij,
+			size_t j_index, Real cutoff_radius_sqr)
+		{
+			j_[entry_index] = j_index;
+			Real r_ij = vec_r_ij.norm();
+			r_ij_[entry_index] = r_ij;
+			e_ij_[entry_index] = vec_r_ij / (r_ij + TinyReal);
+			bool is_within_cutoff = vec_r_ij.normSqr() <= cutoff_radius_sqr;
+			W_ij_[entry_index] = is_within_cutoff ? kernel.W(inv_h, vec_r_ij) : 0.0;
+			dW_ij_[entry_index] = is_within_cutoff ? kernel.dW(inv_h, vec_r_ij) : 0.0;
+		};
+	protected:
+		/** allocate the neighbor entries with their memory pages touched first
+		  * in the static partition of the particles, the present entries are discarded */
+		void allocateNeighborsByFirstTouch(size_t number_of_particles, size_t total_entries);
 	};
 
-	/** A neighborhoods for all particles in a body. */
-	using ParticleConfiguration = StdLargeVec<Neighborhood>;
 	/** All contact neighborhoods for all particles in a body. */
 	using ContatcParticleConfiguration = StdVec<ParticleConfiguration>;
 }
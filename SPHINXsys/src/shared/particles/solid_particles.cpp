@@ -154,6 +154,14 @@ namespace SPH {
 		output_file << "    </DataArray>\n";
 	}
 	//=================================================================================================//
+	void ElasticSolidParticles::writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays)
+	{
+		SolidParticles::writeParticlesToVtuDataArrays(data_arrays);
+
+		data_arrays.addAScalarArrayFromFunction("von Mises stress", 
+			[&](size_t i)->Real { return von_Mises_stress(i); });
+	}
+	//=================================================================================================//
 	void ElasticSolidParticles::writeParticlesToXmlForRestart(std::string &filefullpath)
 	{
 		unique_ptr<XmlEngine> restart_xml(new XmlEngine("particles_xml", "particles"));
@@ -228,6 +236,13 @@ namespace SPH {
 		output_file << "    </DataArray>\n";
 	}
 	//=================================================================================================//
+	void ActiveMuscleParticles::writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays)
+	{
+		ElasticSolidParticles::writeParticlesToVtuDataArrays(data_arrays);
+
+		data_arrays.addAScalarArray("Active Stress", active_contraction_stress_);
+	}
+	//=================================================================================================//
 	void ActiveMuscleParticles::writeParticlesToXmlForRestart(std::string& filefullpath)
 	{
 		unique_ptr<XmlEngine> restart_xml(new XmlEngine("particles_xml", "particles"));
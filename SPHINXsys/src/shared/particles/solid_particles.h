@@ -121,6 +121,8 @@ namespace SPH {
 
 		/** Write particle data in VTU format for Paraview */
 		virtual void writeParticlesToVtuFile(ofstream &output_file) override;
+		/** Write particle data to the data arrays of a binary VTU file */
+		virtual void writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays) override;
 		/** Write particle data in PLT format for Tecplot */
 		virtual void writeParticlesToPltFile(ofstream &output_file) override;
 		/** Write particle data in XML format for restart */
@@ -150,6 +152,8 @@ namespace SPH {
 
 		/** Write particle data in VTU format for Paraview */
 		virtual void writeParticlesToVtuFile(ofstream& output_file) override;
+		/** Write particle data to the data arrays of a binary VTU file */
+		virtual void writeParticlesToVtuDataArrays(VtuDataArrays& data_arrays) override;
 		/** Write particle data in PLT format for Tecplot */
 		virtual void writeParticlesToPltFile(ofstream& output_file) override;
 		/** Write particle data in XML format for restart */
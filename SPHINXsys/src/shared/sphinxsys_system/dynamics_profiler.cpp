@@ -0,0 +1,192 @@
+/**
+ * @file 	dynamics_profiler.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "dynamics_profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace SPH {
+	//=================================================================================================//
+	bool DynamicsProfiler::is_enabled_ = false;
+	std::mutex DynamicsProfiler::mutex_profiles_;
+	std::map<std::string, DynamicsProfile> DynamicsProfiler::profiles_;
+	//=================================================================================================//
+	void DynamicsProfiler::recordACall(const std::string& dynamics_name, Real wall_time,
+		size_t number_of_particles, size_t number_of_neighbor_entries)
+	{
+		std::lock_guard<std::mutex> lock(mutex_profiles_);
+		DynamicsProfile& profile = profiles_[dynamics_name];
+		profile.number_of_calls_++;
+		profile.wall_time_ += wall_time;
+		profile.number_of_particles_ += number_of_particles;
+		profile.number_of_neighbor_entries_ += number_of_neighbor_entries;
+	}
+	//=================================================================================================//
+	void DynamicsProfiler::clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_profiles_);
+		profiles_.clear();
+	}
+	//=================================================================================================//
+	StdVec<std::pair<std::string, DynamicsProfile>> DynamicsProfiler::Profiles()
+	{
+		std::lock_guard<std::mutex> lock(mutex_profiles_);
+		StdVec<std::pair<std::string, DynamicsProfile>> profiles(profiles_.begin(), profiles_.end());
+		std::stable_sort(profiles.begin(), profiles.end(),
+			[](const std::pair<std::string, DynamicsProfile>& a, const std::pair<std::string, DynamicsProfile>& b)
+			{ return a.second.wall_time_ > b.second.wall_time_; });
+		return profiles;
+	}
+	//=================================================================================================//
+	void DynamicsProfiler::printReport(std::ostream& out)
+	{
+		StdVec<std::pair<std::string, DynamicsProfile>> profiles = Profiles();
+		Real total_wall_time = 0.0;
+		size_t name_width = 8;
+		for (size_t i = 0; i != profiles.size(); ++i)
+		{
+			total_wall_time += profiles[i].second.wall_time_;
+			name_width = SMAX(name_width, profiles[i].first.size());
+		}
+
+		std::ios_base::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << "\n Profiles of the particle dynamics:\n";
+		out << std::left << std::setw(name_width + 2) << " dynamics" << std::right
+			<< std::setw(10) << "calls" << std::setw(14) << "time [s]" << std::setw(14) << "per call [ms]"
+			<< std::setw(10) << "share" << std::setw(16) << "particles/s" << std::setw(16) << "neighbors/s" << "\n";
+		for (size_t i = 0; i != profiles.size(); ++i)
+		{
+			const DynamicsProfile& profile = profiles[i].second;
+			Real wall_time = profile.wall_time_ + TinyReal;
+			out << " " << std::left << std::setw(name_width + 1) << profiles[i].first << std::right
+				<< std::setw(10) << profile.number_of_calls_
+				<< std::fixed << std::setprecision(6) << std::setw(14) << profile.wall_time_
+				<< std::setprecision(3) << std::setw(14) << 1000.0 * profile.wall_time_ / Real(profile.number_of_calls_)
+				<< std::setprecision(1) << std::setw(9) << 100.0 * profile.wall_time_ / (total_wall_time + TinyReal) << "%"
+				<< std::scientific << std::setprecision(3)
+				<< std::setw(16) << Real(profile.number_of_particles_) / wall_time
+				<< std::setw(16) << Real(profile.number_of_neighbor_entries_) / wall_time << "\n";
+		}
+		out << std::fixed << std::setprecision(6) << " Total recorded wall time: " << total_wall_time << " seconds.\n";
+		out.flags(flags);
+		out.precision(precision);
+	}
+	//=================================================================================================//
+	void DynamicsProfiler::writeReportToCsv(const std::string& filefullpath)
+	{
+		StdVec<std::pair<std::string, DynamicsProfile>> profiles = Profiles();
+		std::ofstream out_file(filefullpath.c_str(), std::ios::trunc);
+		out_file << "dynamics,calls,wall_time,particles,neighbor_entries\n";
+		out_file << std::setprecision(9);
+		for (size_t i = 0; i != profiles.size(); ++i)
+		{
+			const DynamicsProfile& profile = profiles[i].second;
+			out_file << "\"" << profiles[i].first << "\"," << profile.number_of_calls_ << ","
+				<< profile.wall_time_ << "," << profile.number_of_particles_ << ","
+				<< profile.number_of_neighbor_entries_ << "\n";
+		}
+		out_file.close();
+	}
+	//=================================================================================================//
+	void DynamicsProfiler::writeReportToJson(const std::string& filefullpath)
+	{
+		StdVec<std::pair<std::string, DynamicsProfile>> profiles = Profiles();
+		std::ofstream out_file(filefullpath.c_str(), std::ios::trunc);
+		out_file << std::setprecision(9);
+		out_file << "[\n";
+		for (size_t i = 0; i != profiles.size(); ++i)
+		{
+			const DynamicsProfile& profile = profiles[i].second;
+			out_file << "  {\"dynamics\": \"" << profiles[i].first << "\", "
+				<< "\"calls\": " << profile.number_of_calls_ << ", "
+				<< "\"wall_time\": " << profile.wall_time_ << ", "
+				<< "\"particles\": " << profile.number_of_particles_ << ", "
+				<< "\"neighbor_entries\": " << profile.number_of_neighbor_entries_ << "}"
+				<< (i + 1 != profiles.size() ? ",\n" : "\n");
+		}
+		out_file << "]\n";
+		out_file.close();
+	}
+	//=================================================================================================//
+	std::string DynamicsProfiler::ClassName(const std::type_info& type_info)
+	{
+		std::string class_name = type_info.name();
+#ifdef __GNUG__
+		int status = 0;
+		char* demangled_name = abi::__cxa_demangle(type_info.name(), nullptr, nullptr, &status);
+		if (status == 0) class_name = demangled_name;
+		std::free(demangled_name);
+#endif
+		/** drop the namespace of the library and the class keyword of MSVC */
+		size_t position = class_name.find("class ");
+		if (position == 0) class_name.erase(0, 6);
+		while ((position = class_name.find("SPH::")) != std::string::npos)
+			class_name.erase(position, 5);
+		return class_name;
+	}
+	//=================================================================================================//
+	std::string ProfiledDynamics::DynamicsName()
+	{
+		if (dynamics_name_.empty())
+			dynamics_name_ = body_name_ + "/" + DynamicsProfiler::ClassName(typeid(*this));
+		return dynamics_name_;
+	}
+	//=================================================================================================//
+	DynamicsTiming::DynamicsTiming(ProfiledDynamics* dynamics, size_t number_of_particles)
+		: dynamics_(dynamics), operation_name_(""), is_enabled_(DynamicsProfiler::isEnabled()),
+		is_tuning_(dynamics->isAutoTuning()), is_recorded_(false), number_of_particles_(number_of_particles)
+	{
+		if (is_enabled_ || is_tuning_)
+		{
+			is_recorded_ = dynamics_->profiling_depth_ == 0;
+			dynamics_->profiling_depth_++;
+			if (is_recorded_) start_ = tick_count::now();
+		}
+	}
+	//=================================================================================================//
+	DynamicsTiming::DynamicsTiming(const std::string& body_name, const std::string& operation,
+		size_t number_of_particles)
+		: dynamics_(nullptr), operation_name_(""), is_enabled_(DynamicsProfiler::isEnabled()),
+		is_tuning_(false), is_recorded_(is_enabled_), number_of_particles_(number_of_particles)
+	{
+		if (is_enabled_)
+		{
+			operation_name_ = body_name + "/" + operation;
+			start_ = tick_count::now();
+		}
+	}
+	//=================================================================================================//
+	DynamicsTiming::~DynamicsTiming()
+	{
+		if (!is_enabled_ && !is_tuning_) return;
+
+		if (dynamics_ != nullptr)
+		{
+			dynamics_->profiling_depth_--;
+			if (is_recorded_)
+			{
+				Real wall_time = (tick_count::now() - start_).seconds();
+				if (is_enabled_)
+					DynamicsProfiler::recordACall(dynamics_->DynamicsName(), wall_time,
+						number_of_particles_, dynamics_->NumberOfNeighborEntries());
+				if (is_tuning_) dynamics_->recordATimedExecution(wall_time);
+			}
+		}
+		else
+		{
+			Real wall_time = (tick_count::now() - start_).seconds();
+			DynamicsProfiler::recordACall(operation_name_, wall_time, number_of_particles_, 0);
+		}
+	}
+	//=================================================================================================//
+}
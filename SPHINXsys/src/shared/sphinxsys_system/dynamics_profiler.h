@@ -0,0 +1,143 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	dynamics_profiler.h
+ * @brief 	Optional timing and throughput instrumentation of particle dynamics,
+ * configuration and cell linked list updates.
+ * The records are aggregated by the name of the dynamics object
+ * and reported as a table, a CSV or a JSON file.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <typeinfo>
+
+namespace SPH {
+
+	/**
+	 * @struct DynamicsProfile
+	 * @brief The aggregated records of a named dynamics.
+	 */
+	struct DynamicsProfile
+	{
+		size_t number_of_calls_;
+		Real wall_time_;					/**< in seconds. */
+		size_t number_of_particles_;		/**< particles processed in all calls. */
+		size_t number_of_neighbor_entries_;	/**< neighbor entries visited in all calls. */
+
+		DynamicsProfile() : number_of_calls_(0), wall_time_(0.0),
+			number_of_particles_(0), number_of_neighbor_entries_(0) {};
+	};
+
+	/**
+	 * @class DynamicsProfiler
+	 * @brief The global registry of the profiles.
+	 * Nothing is recorded unless the profiler is enabled,
+	 * so that the instrumentation costs only a flag check otherwise.
+	 * The records may come from several threads.
+	 */
+	class DynamicsProfiler
+	{
+	public:
+		static void enable(bool is_enabled = true) { is_enabled_ = is_enabled; };
+		static bool isEnabled() { return is_enabled_; };
+		/** add the records of one call to the profile of the named dynamics */
+		static void recordACall(const std::string& dynamics_name, Real wall_time,
+			size_t number_of_particles, size_t number_of_neighbor_entries);
+		/** discard all profiles, e.g. after the pre-simulation */
+		static void clear();
+		/** a copy of the profiles, sorted by descending wall time */
+		static StdVec<std::pair<std::string, DynamicsProfile>> Profiles();
+		/** report as a table, which can be called at any time of the run */
+		static void printReport(std::ostream& out = std::cout);
+		static void writeReportToCsv(const std::string& filefullpath);
+		static void writeReportToJson(const std::string& filefullpath);
+		/** the readable class name used for the default name of dynamics */
+		static std::string ClassName(const std::type_info& type_info);
+	protected:
+		static bool is_enabled_;
+		static std::mutex mutex_profiles_;
+		static std::map<std::string, DynamicsProfile> profiles_;
+	};
+
+	/**
+	 * @class ProfiledDynamics
+	 * @brief The name and the profiling state of a dynamics.
+	 * Without a given name, the body name and the class name are used.
+	 */
+	class ProfiledDynamics
+	{
+	public:
+		explicit ProfiledDynamics(const std::string& body_name)
+			: body_name_(body_name), dynamics_name_(""), profiling_depth_(0) {};
+		virtual ~ProfiledDynamics() {};
+
+		void setDynamicsName(const std::string& dynamics_name) { dynamics_name_ = dynamics_name; };
+		std::string DynamicsName();
+		/** the number of neighbor entries visited by one execution */
+		virtual size_t NumberOfNeighborEntries() { return 0; };
+		/** whether the dynamics needs the wall time of its executions, e.g. for auto-tuning */
+		virtual bool isAutoTuning() { return false; };
+		virtual void recordATimedExecution(Real wall_time) {};
+	protected:
+		std::string body_name_;
+		std::string dynamics_name_;
+		/** the number of nested executions, only the outermost one is recorded */
+		size_t profiling_depth_;
+
+		friend class DynamicsTiming;
+	};
+
+	/**
+	 * @class DynamicsTiming
+	 * @brief Records the wall time from construction to destruction,
+	 * i.e. it is defined at the beginning of the scope to be timed.
+	 * The wall time of a dynamics under auto-tuning is also given back to it,
+	 * even if the profiler is not enabled.
+	 */
+	class DynamicsTiming
+	{
+	public:
+		/** timing the execution of a dynamics */
+		DynamicsTiming(ProfiledDynamics* dynamics, size_t number_of_particles);
+		/** timing an operation of a body which is not a dynamics, such as configuration updates */
+		DynamicsTiming(const std::string& body_name, const std::string& operation, size_t number_of_particles);
+		~DynamicsTiming();
+	protected:
+		ProfiledDynamics* dynamics_;
+		std::string operation_name_;
+		bool is_enabled_;
+		bool is_tuning_;
+		bool is_recorded_;
+		size_t number_of_particles_;
+		tick_count start_;
+	};
+}
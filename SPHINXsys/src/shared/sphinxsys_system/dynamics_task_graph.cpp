@@ -0,0 +1,128 @@
+/**
+ * @file 	dynamics_task_graph.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "dynamics_task_graph.h"
+
+#include <algorithm>
+#include <map>
+
+namespace SPH {
+	//=================================================================================================//
+	DynamicsTaskGraph::DynamicsTaskGraph()
+		: is_graph_built_(false), start_node_(nullptr)
+	{
+	}
+	//=================================================================================================//
+	DynamicsTaskGraph::~DynamicsTaskGraph()
+	{
+		for (size_t i = 0; i != task_nodes_.size(); ++i) delete task_nodes_[i];
+		delete start_node_;
+		for (size_t i = 0; i != tasks_.size(); ++i) delete tasks_[i];
+	}
+	//=================================================================================================//
+	DynamicsTask& DynamicsTaskGraph::addATask(const std::string& task_name, std::function<void()> task_function)
+	{
+		if (is_graph_built_)
+		{
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			std::cout << "\n Task graph failure: the task " << task_name
+				<< " is added after the graph has been executed!" << std::endl;
+			exit(1);
+		}
+		tasks_.push_back(new DynamicsTask(task_name, task_function));
+		return *tasks_.back();
+	}
+	//=================================================================================================//
+	StdVec<IndexVector> DynamicsTaskGraph::TaskDependencies()
+	{
+		StdVec<IndexVector> task_dependencies(tasks_.size());
+		/** the last task writing a resource and the tasks reading it since */
+		std::map<const void*, size_t> last_writers;
+		std::map<const void*, IndexVector> readers_since_writing;
+		for (size_t i = 0; i != tasks_.size(); ++i)
+		{
+			IndexVector& dependencies = task_dependencies[i];
+			DynamicsTask* task = tasks_[i];
+			for (size_t k = 0; k != task->read_resources_.size(); ++k)
+			{
+				const void* resource = task->read_resources_[k];
+				if (last_writers.count(resource)) dependencies.push_back(last_writers[resource]);
+			}
+			for (size_t k = 0; k != task->written_resources_.size(); ++k)
+			{
+				const void* resource = task->written_resources_[k];
+				if (last_writers.count(resource)) dependencies.push_back(last_writers[resource]);
+				IndexVector& readers = readers_since_writing[resource];
+				dependencies.insert(dependencies.end(), readers.begin(), readers.end());
+			}
+			std::sort(dependencies.begin(), dependencies.end());
+			dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+			/** a task reading and writing the same resource does not wait for itself */
+			dependencies.erase(std::remove(dependencies.begin(), dependencies.end(), i), dependencies.end());
+
+			for (size_t k = 0; k != task->read_resources_.size(); ++k)
+				readers_since_writing[task->read_resources_[k]].push_back(i);
+			for (size_t k = 0; k != task->written_resources_.size(); ++k)
+			{
+				last_writers[task->written_resources_[k]] = i;
+				readers_since_writing[task->written_resources_[k]].clear();
+			}
+		}
+		return task_dependencies;
+	}
+	//=================================================================================================//
+	void DynamicsTaskGraph::buildGraph()
+	{
+		start_node_ = new tbb::flow::broadcast_node<tbb::flow::continue_msg>(graph_);
+		for (size_t i = 0; i != tasks_.size(); ++i)
+		{
+			std::function<void()>& task_function = tasks_[i]->task_function_;
+			task_nodes_.push_back(new TaskNode(graph_,
+				[&task_function](const tbb::flow::continue_msg&) { task_function(); }));
+		}
+
+		StdVec<IndexVector> task_dependencies = TaskDependencies();
+		for (size_t i = 0; i != tasks_.size(); ++i)
+		{
+			if (task_dependencies[i].empty())
+			{
+				tbb::flow::make_edge(*start_node_, *task_nodes_[i]);
+			}
+			else
+			{
+				for (size_t k = 0; k != task_dependencies[i].size(); ++k)
+					tbb::flow::make_edge(*task_nodes_[task_dependencies[i][k]], *task_nodes_[i]);
+			}
+		}
+		is_graph_built_ = true;
+	}
+	//=================================================================================================//
+	void DynamicsTaskGraph::execute()
+	{
+		if (!is_graph_built_) buildGraph();
+		start_node_->try_put(tbb::flow::continue_msg());
+		graph_.wait_for_all();
+	}
+	//=================================================================================================//
+	void DynamicsTaskGraph::executeSequentially()
+	{
+		for (size_t i = 0; i != tasks_.size(); ++i) tasks_[i]->task_function_();
+	}
+	//=================================================================================================//
+	void DynamicsTaskGraph::printTaskGraph(std::ostream& out)
+	{
+		StdVec<IndexVector> task_dependencies = TaskDependencies();
+		out << "\n Tasks and their dependencies:\n";
+		for (size_t i = 0; i != tasks_.size(); ++i)
+		{
+			out << " " << i << " " << tasks_[i]->task_name_ << " <-";
+			for (size_t k = 0; k != task_dependencies[i].size(); ++k)
+				out << " " << task_dependencies[i][k];
+			out << "\n";
+		}
+	}
+	//=================================================================================================//
+}
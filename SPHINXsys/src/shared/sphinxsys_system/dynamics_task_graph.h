@@ -0,0 +1,118 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	dynamics_task_graph.h
+ * @brief 	Optional concurrent execution of the dynamics and body operations
+ * which do not depend on each other, e.g. those of different bodies.
+ * The tasks are declared in the sequential order of the time stepping,
+ * together with the resources, such as bodies or particle variables,
+ * which they read and write. The dependencies are deduced from the resources,
+ * so that the result is that of the sequential execution.
+ * The graph is executed by the TBB flow graph.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+#include "sph_data_conainers.h"
+
+#include "tbb/flow_graph.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace SPH {
+
+	/**
+	 * @class DynamicsTask
+	 * @brief A task of the graph, a dynamics or a body operation,
+	 * with the resources it reads and writes.
+	 */
+	class DynamicsTask
+	{
+	public:
+		DynamicsTask(const std::string& task_name, std::function<void()> task_function)
+			: task_name_(task_name), task_function_(task_function) {};
+		virtual ~DynamicsTask() {};
+
+		/** a resource, such as a body or a particle variable, identified by its address */
+		template <class ResourceType>
+		DynamicsTask& reads(ResourceType* resource)
+		{
+			read_resources_.push_back(resource);
+			return *this;
+		};
+		template <class ResourceType>
+		DynamicsTask& writes(ResourceType* resource)
+		{
+			written_resources_.push_back(resource);
+			return *this;
+		};
+
+		std::string task_name_;
+		std::function<void()> task_function_;
+		StdVec<const void*> read_resources_;
+		StdVec<const void*> written_resources_;
+	};
+
+	/**
+	 * @class DynamicsTaskGraph
+	 * @brief The tasks of a part of the time stepping, executed concurrently as allowed by the dependencies.
+	 * A task depends on the preceding tasks writing a resource it reads or writes,
+	 * and on those reading a resource it writes since the last writing.
+	 * The tasks themselves are executed with their own parallel loops.
+	 * Note that each particle dynamics, configuration, cell linked list and particle sorting
+	 * has its own affinity partitioner, so that the tasks executed concurrently do not share one.
+	 */
+	class DynamicsTaskGraph
+	{
+	public:
+		DynamicsTaskGraph();
+		virtual ~DynamicsTaskGraph();
+
+		/** add a task after those added before, the resources of which are then given to the returned task */
+		DynamicsTask& addATask(const std::string& task_name, std::function<void()> task_function);
+		/** execute all tasks once and wait for them */
+		void execute();
+		/** execute the tasks one after another in the order of adding, for checking the results */
+		void executeSequentially();
+		/** the dependencies of each task, as the indexes of the tasks which it waits for */
+		StdVec<IndexVector> TaskDependencies();
+		/** print the tasks with their dependencies */
+		void printTaskGraph(std::ostream& out = std::cout);
+	protected:
+		typedef tbb::flow::continue_node<tbb::flow::continue_msg> TaskNode;
+
+		StdVec<DynamicsTask*> tasks_;
+		bool is_graph_built_;
+		tbb::flow::graph graph_;
+		tbb::flow::broadcast_node<tbb::flow::continue_msg>* start_node_;
+		StdVec<TaskNode*> task_nodes_;
+
+		/** deduce the dependencies from the resources and build the flow graph */
+		void buildGraph();
+	};
+}
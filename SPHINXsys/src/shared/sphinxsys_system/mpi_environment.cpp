@@ -0,0 +1,144 @@
+/**
+ * @file 	mpi_environment.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "mpi_environment.h"
+
+#include <iostream>
+#include <cstdlib>
+#ifdef SPHINXSYS_USE_MPI
+#include <mpi.h>
+#endif
+
+namespace SPH {
+	//=================================================================================================//
+	int MPIEnvironment::rank_ = 0;
+	int MPIEnvironment::number_of_ranks_ = 1;
+	int MPIEnvironment::local_rank_ = 0;
+	int MPIEnvironment::number_of_local_ranks_ = 1;
+	//=================================================================================================//
+	MPIEnvironment::MPIEnvironment(int* argc, char*** argv)
+	{
+#ifdef SPHINXSYS_USE_MPI
+		MPI_Init(argc, argv);
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+		MPI_Comm_size(MPI_COMM_WORLD, &number_of_ranks_);
+		MPI_Comm node_comm;
+		MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank_, MPI_INFO_NULL, &node_comm);
+		MPI_Comm_rank(node_comm, &local_rank_);
+		MPI_Comm_size(node_comm, &number_of_local_ranks_);
+		MPI_Comm_free(&node_comm);
+#endif
+	}
+	//=================================================================================================//
+	MPIEnvironment::~MPIEnvironment()
+	{
+#ifdef SPHINXSYS_USE_MPI
+		MPI_Finalize();
+#endif
+	}
+	//=================================================================================================//
+	std::string MPIEnvironment::RankSuffix()
+	{
+		return number_of_ranks_ == 1 ? "" : "_rank_" + std::to_string(rank_);
+	}
+	//=================================================================================================//
+	void MPIEnvironment::barrier()
+	{
+#ifdef SPHINXSYS_USE_MPI
+		MPI_Barrier(MPI_COMM_WORLD);
+#endif
+	}
+	//=================================================================================================//
+	Real MPIEnvironment::reduceMin(Real local_value)
+	{
+		double global_value = local_value;
+#ifdef SPHINXSYS_USE_MPI
+		double value = local_value;
+		MPI_Allreduce(&value, &global_value, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+		return global_value;
+	}
+	//=================================================================================================//
+	Real MPIEnvironment::reduceMax(Real local_value)
+	{
+		double global_value = local_value;
+#ifdef SPHINXSYS_USE_MPI
+		double value = local_value;
+		MPI_Allreduce(&value, &global_value, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+		return global_value;
+	}
+	//=================================================================================================//
+	Real MPIEnvironment::reduceSum(Real local_value)
+	{
+		double global_value = local_value;
+#ifdef SPHINXSYS_USE_MPI
+		double value = local_value;
+		MPI_Allreduce(&value, &global_value, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+		return global_value;
+	}
+	//=================================================================================================//
+	size_t MPIEnvironment::reduceSum(size_t local_value)
+	{
+		unsigned long long global_value = local_value;
+#ifdef SPHINXSYS_USE_MPI
+		unsigned long long value = local_value;
+		MPI_Allreduce(&value, &global_value, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
+		return size_t(global_value);
+	}
+	//=================================================================================================//
+	void MPIEnvironment::reduceSum(StdVec<Real>& local_values)
+	{
+#ifdef SPHINXSYS_USE_MPI
+		StdVec<double> values(local_values.begin(), local_values.end());
+		StdVec<double> global_values(values.size());
+		MPI_Allreduce(values.data(), global_values.data(), int(values.size()),
+			MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+		for (size_t i = 0; i != local_values.size(); ++i)
+			local_values[i] = global_values[i];
+#endif
+	}
+	//=================================================================================================//
+	void MPIEnvironment::exchangeWithNeighborRanks(StdVec<Real>& send_to_lower, StdVec<Real>& send_to_upper,
+		StdVec<Real>& receive_from_lower, StdVec<Real>& receive_from_upper)
+	{
+		receive_from_lower.clear();
+		receive_from_upper.clear();
+#ifdef SPHINXSYS_USE_MPI
+		int lower_rank = rank_ > 0 ? rank_ - 1 : MPI_PROC_NULL;
+		int upper_rank = rank_ + 1 < number_of_ranks_ ? rank_ + 1 : MPI_PROC_NULL;
+		/** the data are sent as bytes, so that the exchange does not depend on the type of Real */
+		unsigned long long size_to_lower = send_to_lower.size();
+		unsigned long long size_to_upper = send_to_upper.size();
+		unsigned long long size_from_lower = 0;
+		unsigned long long size_from_upper = 0;
+		/** shift upwards, then downwards */
+		MPI_Sendrecv(&size_to_upper, 1, MPI_UNSIGNED_LONG_LONG, upper_rank, 0,
+			&size_from_lower, 1, MPI_UNSIGNED_LONG_LONG, lower_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		MPI_Sendrecv(&size_to_lower, 1, MPI_UNSIGNED_LONG_LONG, lower_rank, 1,
+			&size_from_upper, 1, MPI_UNSIGNED_LONG_LONG, upper_rank, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+		receive_from_lower.resize(size_from_lower);
+		receive_from_upper.resize(size_from_upper);
+		MPI_Sendrecv(send_to_upper.data(), int(size_to_upper * sizeof(Real)), MPI_BYTE, upper_rank, 2,
+			receive_from_lower.data(), int(size_from_lower * sizeof(Real)), MPI_BYTE, lower_rank, 2,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		MPI_Sendrecv(send_to_lower.data(), int(size_to_lower * sizeof(Real)), MPI_BYTE, lower_rank, 3,
+			receive_from_upper.data(), int(size_from_upper * sizeof(Real)), MPI_BYTE, upper_rank, 3,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+#else
+		if (!send_to_lower.empty() || !send_to_upper.empty())
+		{
+			std::cout << "\n Error: no neighbor ranks to exchange with, as MPI is not activated!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			exit(1);
+		}
+#endif
+	}
+	//=================================================================================================//
+}
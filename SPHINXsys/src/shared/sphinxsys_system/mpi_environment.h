@@ -0,0 +1,80 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	mpi_environment.h
+ * @brief 	The ranks of a distributed-memory run and the communication between them.
+ * Without MPI, i.e. SPHINXSYS_USE_MPI is not defined, there is only one rank
+ * and the global reductions return the local values.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+
+#include <string>
+
+namespace SPH {
+
+	/**
+	 * @class MPIEnvironment
+	 * @brief Initializes MPI at construction and finalizes it at destruction,
+	 * therefore, it is defined once at the beginning of the main function, before the SPHSystem.
+	 * The rank information and the communication are given by static functions.
+	 */
+	class MPIEnvironment
+	{
+	public:
+		MPIEnvironment(int* argc, char*** argv);
+		virtual ~MPIEnvironment();
+
+		static int Rank() { return rank_; };
+		static int NumberOfRanks() { return number_of_ranks_; };
+		static bool isRoot() { return rank_ == 0; };
+		/** the rank among the ranks on the same node, which share its processors */
+		static int LocalRank() { return local_rank_; };
+		static int NumberOfLocalRanks() { return number_of_local_ranks_; };
+		/** the suffix distinguishing the output folders of the ranks, empty for a single rank */
+		static std::string RankSuffix();
+		static void barrier();
+
+		/** global reductions of the local values of all ranks */
+		static Real reduceMin(Real local_value);
+		static Real reduceMax(Real local_value);
+		static Real reduceSum(Real local_value);
+		static size_t reduceSum(size_t local_value);
+		/** element-wise sum of the local arrays, which have the same size on all ranks */
+		static void reduceSum(StdVec<Real>& local_values);
+
+		/** Exchange buffers with the lower and upper neighbor ranks, i.e. rank - 1 and rank + 1.
+		  * The receive buffers are empty if the neighbor rank does not exist. */
+		static void exchangeWithNeighborRanks(StdVec<Real>& send_to_lower, StdVec<Real>& send_to_upper,
+			StdVec<Real>& receive_from_lower, StdVec<Real>& receive_from_upper);
+	protected:
+		static int rank_;
+		static int number_of_ranks_;
+		static int local_rank_;
+		static int number_of_local_ranks_;
+	};
+}
@@ -0,0 +1,156 @@
+/**
+ * @file 	multi_rate_integrator.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "multi_rate_integrator.h"
+
+#include <iomanip>
+
+namespace SPH {
+	//=================================================================================================//
+	TimeSteppingLevel::TimeSteppingLevel(const std::string& level_name, ParticleDynamics<Real>& time_step_size,
+		std::function<void(Real)> time_step, size_t level_depth)
+		: level_name_(level_name), time_step_size_(time_step_size), time_step_(time_step),
+		level_depth_(level_depth), is_sub_levels_concurrent_(false), dt_(0.0),
+		number_of_steps_(0), number_of_sub_cyclings_(0), number_of_steps_in_last_sub_cycling_(0)
+	{
+	}
+	//=================================================================================================//
+	void TimeSteppingLevel::setSynchronization(std::function<void(Real)> before_sub_cycling,
+		std::function<void(Real)> after_sub_cycling)
+	{
+		before_sub_cycling_ = before_sub_cycling;
+		after_sub_cycling_ = after_sub_cycling;
+	}
+	//=================================================================================================//
+	Real TimeSteppingLevel::advanceAStep()
+	{
+		dt_ = time_step_size_.parallel_exec();
+		return advanceATimeStep(dt_);
+	}
+	//=================================================================================================//
+	void TimeSteppingLevel::advance(Real interval)
+	{
+		Real time_sum = 0.0;
+		size_t number_of_steps = 0;
+		while (time_sum < interval)
+		{
+			dt_ = time_step_size_.parallel_exec();
+			if (dt_ <= 0.0)
+			{
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				std::cout << "\n Multi-rate time stepping failure: the time step size of "
+					<< level_name_ << " is not positive!" << std::endl;
+				exit(1);
+			}
+			if (interval - time_sum < dt_) dt_ = interval - time_sum;
+			time_sum += advanceATimeStep(dt_);
+			number_of_steps++;
+		}
+		number_of_steps_in_last_sub_cycling_ = number_of_steps;
+		number_of_sub_cyclings_++;
+	}
+	//=================================================================================================//
+	Real TimeSteppingLevel::advanceATimeStep(Real dt)
+	{
+		tick_count time_instance = tick_count::now();
+		time_step_(dt);
+		time_stepping_interval_ += tick_count::now() - time_instance;
+		number_of_steps_++;
+
+		if (!sub_levels_.empty())
+		{
+			if (before_sub_cycling_) before_sub_cycling_(dt);
+			time_instance = tick_count::now();
+			subCycleSubLevels(dt);
+			sub_cycling_interval_ += tick_count::now() - time_instance;
+			if (after_sub_cycling_) after_sub_cycling_(dt);
+		}
+		return dt;
+	}
+	//=================================================================================================//
+	void TimeSteppingLevel::subCycleSubLevels(Real dt)
+	{
+		if (is_sub_levels_concurrent_)
+		{
+			parallel_for(blocked_range<size_t>(0, sub_levels_.size(), 1),
+				[&](const blocked_range<size_t>& r) {
+					for (size_t l = r.begin(); l != r.end(); ++l)
+						sub_levels_[l]->advance(dt);
+				});
+		}
+		else
+		{
+			for (size_t l = 0; l != sub_levels_.size(); ++l)
+				sub_levels_[l]->advance(dt);
+		}
+	}
+	//=================================================================================================//
+	void TimeSteppingLevel::printReport(std::ostream& out)
+	{
+		std::string indent(2 * level_depth_ + 1, ' ');
+		Real steps_per_sub_cycling = number_of_sub_cyclings_ == 0 ? 0.0
+			: Real(number_of_steps_) / Real(number_of_sub_cyclings_);
+		out << indent << "level " << level_depth_ << " " << level_name_ << ": " << number_of_steps_ << " steps";
+		if (level_depth_ != 0) out << ", " << std::fixed << std::setprecision(1) << steps_per_sub_cycling << " per parent step";
+		out << std::fixed << std::setprecision(6) << ", time stepping " << time_stepping_interval_.seconds() << " s";
+		if (!sub_levels_.empty()) out << ", sub-cycling " << sub_cycling_interval_.seconds() << " s";
+		out << "\n";
+		for (size_t l = 0; l != sub_levels_.size(); ++l) sub_levels_[l]->printReport(out);
+	}
+	//=================================================================================================//
+	MultiRateIntegrator::~MultiRateIntegrator()
+	{
+		for (size_t l = 0; l != levels_.size(); ++l) delete levels_[l];
+	}
+	//=================================================================================================//
+	TimeSteppingLevel& MultiRateIntegrator::addALevel(const std::string& level_name,
+		ParticleDynamics<Real>& time_step_size, std::function<void(Real)> time_step, TimeSteppingLevel* parent_level)
+	{
+		if (levels_.empty() == (parent_level != nullptr))
+		{
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			std::cout << "\n Multi-rate time stepping failure: only the first level "
+				<< "is without a parent level, but not " << level_name << "!" << std::endl;
+			exit(1);
+		}
+		size_t level_depth = parent_level == nullptr ? 0 : parent_level->LevelDepth() + 1;
+		levels_.push_back(new TimeSteppingLevel(level_name, time_step_size, time_step, level_depth));
+		if (parent_level != nullptr) parent_level->addASubLevel(levels_.back());
+		return *levels_.back();
+	}
+	//=================================================================================================//
+	TimeSteppingLevel* MultiRateIntegrator::TopLevel()
+	{
+		if (levels_.empty())
+		{
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			std::cout << "\n Multi-rate time stepping failure: no level is given!" << std::endl;
+			exit(1);
+		}
+		return levels_.front();
+	}
+	//=================================================================================================//
+	Real MultiRateIntegrator::advanceAStep()
+	{
+		return TopLevel()->advanceAStep();
+	}
+	//=================================================================================================//
+	void MultiRateIntegrator::advance(Real interval)
+	{
+		TopLevel()->advance(interval);
+	}
+	//=================================================================================================//
+	void MultiRateIntegrator::printReport(std::ostream& out)
+	{
+		std::ios_base::fmtflags flags = out.flags();
+		std::streamsize precision = out.precision();
+		out << "\n Multi-rate time stepping:\n";
+		TopLevel()->printReport(out);
+		out.flags(flags);
+		out.precision(precision);
+	}
+	//=================================================================================================//
+}
@@ -0,0 +1,121 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	multi_rate_integrator.h
+ * @brief 	Multi-rate time stepping of coupled bodies, such as fluid and solid
+ * or electrophysiology and mechanics, in which the body with the smaller time step size
+ * is sub-cycled within each time step of the other.
+ * The sub-cycling, the synchronization and the statistics are given here
+ * instead of the nested loops in the cases.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_particle_dynamics.h"
+
+#include <functional>
+#include <iostream>
+#include <string>
+
+namespace SPH {
+
+	/**
+	 * @class TimeSteppingLevel
+	 * @brief A level of the multi-rate time stepping, usually a body, with its time step size
+	 * and the dynamics of a time step. Each time step is followed by the sub-cycling of the sub-levels,
+	 * which may be surrounded by synchronizations, e.g. for averaging the solid velocity for the fluid.
+	 * The sub-levels are loosely coupled if they do not read the data of each other during sub-cycling,
+	 * in which case they can be advanced concurrently.
+	 */
+	class TimeSteppingLevel
+	{
+	public:
+		/** a level can also be used alone for sub-cycling a body, then with a non-zero depth */
+		TimeSteppingLevel(const std::string& level_name, ParticleDynamics<Real>& time_step_size,
+			std::function<void(Real)> time_step, size_t level_depth = 1);
+		virtual ~TimeSteppingLevel() {};
+
+		/** called in each time step, before and after the sub-cycling with the time step size */
+		void setSynchronization(std::function<void(Real)> before_sub_cycling,
+			std::function<void(Real)> after_sub_cycling);
+		void setConcurrentSubLevels(bool is_concurrent = true) { is_sub_levels_concurrent_ = is_concurrent; };
+		void addASubLevel(TimeSteppingLevel* sub_level) { sub_levels_.push_back(sub_level); };
+
+		/** a time step with the present time step size, including the sub-cycling of the sub-levels */
+		Real advanceAStep();
+		/** sub-cycling until the end of the interval, the last time step size is cut to the interval */
+		void advance(Real interval);
+		Real TimeStepSize() { return dt_; };
+		size_t NumberOfStepsInLastSubCycling() { return number_of_steps_in_last_sub_cycling_; };
+		std::string LevelName() { return level_name_; };
+		size_t LevelDepth() { return level_depth_; };
+		/** statistics of the level and, indented, its sub-levels */
+		void printReport(std::ostream& out);
+	protected:
+		std::string level_name_;
+		ParticleDynamics<Real>& time_step_size_;
+		std::function<void(Real)> time_step_;
+		std::function<void(Real)> before_sub_cycling_, after_sub_cycling_;
+		size_t level_depth_;
+		bool is_sub_levels_concurrent_;
+		StdVec<TimeSteppingLevel*> sub_levels_;
+		Real dt_;
+
+		size_t number_of_steps_;
+		size_t number_of_sub_cyclings_;
+		size_t number_of_steps_in_last_sub_cycling_;
+		/** wall times of the time steps themselves and of the sub-cycling of the sub-levels */
+		tick_count::interval_t time_stepping_interval_, sub_cycling_interval_;
+
+		Real advanceATimeStep(Real dt);
+		void subCycleSubLevels(Real dt);
+	};
+
+	/**
+	 * @class MultiRateIntegrator
+	 * @brief The owner of the levels, the first added level is the top level
+	 * and the others are sub-cycled within the level given as their parent.
+	 * The time step sizes are given by the reduce dynamics of the bodies,
+	 * such as AcousticTimeStepSize or GetElectroPhysiologyTimeStepSize.
+	 */
+	class MultiRateIntegrator
+	{
+	public:
+		MultiRateIntegrator() {};
+		virtual ~MultiRateIntegrator();
+
+		TimeSteppingLevel& addALevel(const std::string& level_name, ParticleDynamics<Real>& time_step_size,
+			std::function<void(Real)> time_step, TimeSteppingLevel* parent_level = nullptr);
+		/** a time step of the top level, of which the time step size is returned */
+		Real advanceAStep();
+		/** time stepping of the top level until the end of the interval */
+		void advance(Real interval);
+		void printReport(std::ostream& out = std::cout);
+	protected:
+		StdVec<TimeSteppingLevel*> levels_;
+
+		TimeSteppingLevel* TopLevel();
+	};
+}
@@ -48,6 +48,8 @@ namespace SPH {
 	using ConcurrentCellLists = LargeVec<CellList*>;
 	/** Split cell list for split algorithms. */
 	using SplitCellLists = StdVec<ConcurrentCellLists>;
+	/** The beginning of each chunk of the cell lists and the end of the last one, for each split. */
+	using SplitCellListChunks = StdVec<IndexVector>;
 	/** Pair of point and volume. */
 	using PositionsAndVolumes = vector<pair<Point, Real>>;
 }
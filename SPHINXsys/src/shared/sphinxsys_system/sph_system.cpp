@@ -6,6 +6,9 @@
 
 #include "sph_system.h"
 #include "base_body.h"
+#include "body_relation.h"
+#include "thread_pinning.h"
+#include "mpi_environment.h"
 #include "particle_generator_lattice.h"
 
 namespace SPH
@@ -16,9 +19,10 @@ namespace SPH
 		: lower_bound_(lower_bound), upper_bound_(upper_bound),
 		tbb_init_(number_of_threads), particle_spacing_ref_(particle_spacing_ref),
 		restart_step_(0), run_particle_relaxation_(false),
-		reload_particles_(false)
+		reload_particles_(false), use_level_set_cache_(true), thread_pinning_(nullptr)
 	{
-		output_folder_ = "./output";
+		/** each rank of a distributed-memory run writes to its own folders */
+		output_folder_ = "./output" + MPIEnvironment::RankSuffix();
 		if (fs::exists(output_folder_) && restart_step_ == 0)
 		{
 			fs::remove_all(output_folder_);
@@ -28,7 +32,7 @@ namespace SPH
 			fs::create_directory(output_folder_);
 		}
 
-		restart_folder_ = "./restart";
+		restart_folder_ = "./restart" + MPIEnvironment::RankSuffix();
 		if (fs::exists(restart_folder_) && restart_step_ == 0)
 		{
 			fs::remove_all(restart_folder_);
@@ -39,6 +43,15 @@ namespace SPH
 		}
 
 		reload_folder_ = "./reload";
+		/** the cached level sets are kept over runs, the folder is created when a level set is cached */
+		level_set_cache_folder_ = "./level_set_cache" + MPIEnvironment::RankSuffix();
+	}
+	//===============================================================//
+	SPHSystem::~SPHSystem()
+	{
+		for (auto& inner_relation : created_inner_relations_) delete inner_relation;
+		for (auto& contact_relation : created_contact_relations_) delete contact_relation;
+		delete thread_pinning_;
 	}
 	//===============================================================//
 	void SPHSystem::addABody(SPHBody* body)
@@ -56,15 +69,31 @@ namespace SPH
 		fictitious_bodies_.push_back(body);
 	}
 	//===============================================================//
+	void SPHSystem::pinThreadsToProcessors()
+	{
+		if (thread_pinning_ == nullptr) thread_pinning_ = new ThreadPinning();
+	}
+	//===============================================================//
+	void SPHSystem::enableFirstTouchAllocation()
+	{
+		FirstTouch::enable();
+	}
+	//===============================================================//
 	void SPHSystem::initializeSystemCellLinkedLists()
 	{
 		for (auto &body : bodies_)
 		{
+			if (FirstTouch::isEnabled()) body->base_particles_->firstTouchParticleData();
 			body->updateCellLinkedList();
 		}
 	}
 	//===============================================================//
 	void SPHSystem::initializeSystemConfigurations()
+	{
+		updateSystemConfigurations();
+	}
+	//===============================================================//
+	void SPHSystem::updateSystemConfigurations()
 	{
 		for (auto& body : bodies_)
 		{
@@ -76,6 +105,56 @@ namespace SPH
 		}
 	}
 	//===============================================================//
+	SPHBodyInnerRelation* SPHSystem::findInnerRelation(SPHBody* body)
+	{
+		for (auto& inner_relation : inner_relations_)
+			if (inner_relation->sph_body_ == body) return inner_relation;
+		return nullptr;
+	}
+	//===============================================================//
+	SPHBodyContactRelation* SPHSystem::findContactRelation(SPHBody* body, SPHBodyVector& contact_bodies)
+	{
+		for (auto& contact_relation : contact_relations_)
+			if (contact_relation->sph_body_ == body
+				&& contact_relation->contact_sph_bodies_ == contact_bodies) return contact_relation;
+		return nullptr;
+	}
+	//===============================================================//
+	SPHBodyInnerRelation* SPHSystem::getInnerRelation(SPHBody* body)
+	{
+		SPHBodyInnerRelation* inner_relation = findInnerRelation(body);
+		if (inner_relation == nullptr)
+		{
+			/** the new relation registers itself */
+			inner_relation = new SPHBodyInnerRelation(body);
+			created_inner_relations_.push_back(inner_relation);
+		}
+		return inner_relation;
+	}
+	//===============================================================//
+	SPHBodyContactRelation* SPHSystem::getContactRelation(SPHBody* body, SPHBodyVector contact_bodies)
+	{
+		SPHBodyContactRelation* contact_relation = findContactRelation(body, contact_bodies);
+		if (contact_relation == nullptr)
+		{
+			contact_relation = new SPHBodyContactRelation(body, contact_bodies);
+			created_contact_relations_.push_back(contact_relation);
+		}
+		return contact_relation;
+	}
+	//===============================================================//
+	void SPHSystem::registerARelation(SPHBodyInnerRelation* inner_relation)
+	{
+		if (findInnerRelation(inner_relation->sph_body_) == nullptr)
+			inner_relations_.push_back(inner_relation);
+	}
+	//===============================================================//
+	void SPHSystem::registerARelation(SPHBodyContactRelation* contact_relation)
+	{
+		if (findContactRelation(contact_relation->sph_body_, contact_relation->contact_sph_bodies_) == nullptr)
+			contact_relations_.push_back(contact_relation);
+	}
+	//===============================================================//
 	void SPHSystem::handleCommandlineOptions(int ac, char* av[])
 	{
 		try {
@@ -19,9 +19,13 @@ namespace po = boost::program_options;
 #ifdef __APPLE__
 #include <boost/filesystem.hpp>
 namespace fs = boost::filesystem;
+/** error code for the non-throwing file system operations */
+typedef boost::system::error_code fs_error_code;
 #else
 #include <experimental/filesystem>
 namespace fs = std::experimental::filesystem;
+/** error code for the non-throwing file system operations */
+typedef std::error_code fs_error_code;
 #endif
 
 namespace SPH 
@@ -31,6 +35,9 @@ namespace SPH
 	 */
 	class SPHBody;
 	class SPHSystem;
+	class SPHBodyInnerRelation;
+	class SPHBodyContactRelation;
+	class ThreadPinning;
 
 	/**
 	 * @class SPHSystem
@@ -52,7 +59,7 @@ namespace SPH
 		 */
  		SPHSystem(Vecd lower_bound, Vecd upper_bound, Real particle_spacing_ref, 
 			int number_of_threads = tbb::task_scheduler_init::automatic);
-		virtual ~SPHSystem() {};
+		virtual ~SPHSystem();
 
 		Vecd lower_bound_, upper_bound_;	/**< Lower and Upper domain bound. */
 		task_scheduler_init tbb_init_;		/**< TBB library. */
@@ -66,6 +73,8 @@ namespace SPH
 		std::string output_folder_;		/**< folder for saving output files. */
 		std::string restart_folder_;	/**< folder for saving restart files. */
 		std::string reload_folder_;		/**< folder for saving particle reload files. */
+		std::string level_set_cache_folder_;	/**< folder for the level sets cached over runs. */
+		bool use_level_set_cache_;		/**< reload the level sets from and save them to the cache folder. */
 
 
 
@@ -79,12 +88,46 @@ namespace SPH
 		void addARealBody(SPHBody* body);
 		/** Add a new body to the SPH fictitious bodies. */
 		void addAFictitiousBody(SPHBody* body);
+		/** Pin the worker threads of the task scheduler to the logical processors, one thread each,
+		  * so that the threads stay close to the memory they touched first, see ThreadPinning.
+		  * It is called right after the system is created, before enabling the first-touch allocation. */
+		void pinThreadsToProcessors();
+		/** Allocate the particle data and the neighbor configurations by the first touch
+		  * of the threads of the parallel loops, see FirstTouch.
+		  * Both are called right after the system is created,
+		  * and the particle data are relocated in the pre-simulation. */
+		void enableFirstTouchAllocation();
 		/** Initialize cell linked lists. */
 		void initializeSystemCellLinkedLists();
 		/** Initialize particle interacting configurations. */
 		void initializeSystemConfigurations();
+		/** Update the configurations of all relations subscribed to the bodies,
+		  * each unique inner and contact relation only once. */
+		void updateSystemConfigurations();
+
+		/** The inner relation of a body, which is created and owned by the system if not registered yet. */
+		SPHBodyInnerRelation* getInnerRelation(SPHBody* body);
+		/** The contact relation of a body with the given contact bodies in the same order,
+		  * which is created and owned by the system if not registered yet. */
+		SPHBodyContactRelation* getContactRelation(SPHBody* body, SPHBodyVector contact_bodies);
+		/** Register a relation if no relation of the same body (and contact bodies) is registered yet. */
+		void registerARelation(SPHBodyInnerRelation* inner_relation);
+		void registerARelation(SPHBodyContactRelation* contact_relation);
 
 		/** handle the commandline options*/
 		void handleCommandlineOptions(int ac, char* av[]);
+	protected:
+		/** The registry of the relations shared by the complex relations, one for each body (and contact bodies).
+		  * Note that the registered relations should live as long as the system. */
+		StdVec<SPHBodyInnerRelation*> inner_relations_;
+		StdVec<SPHBodyContactRelation*> contact_relations_;
+		/** The relations created by the registry. */
+		StdVec<SPHBodyInnerRelation*> created_inner_relations_;
+		StdVec<SPHBodyContactRelation*> created_contact_relations_;
+
+		SPHBodyInnerRelation* findInnerRelation(SPHBody* body);
+		SPHBodyContactRelation* findContactRelation(SPHBody* body, SPHBodyVector& contact_bodies);
+
+		ThreadPinning* thread_pinning_;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+ * @file 	thread_pinning.cpp
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#include "thread_pinning.h"
+#include "mpi_environment.h"
+
+#include <thread>
+#if defined(__linux__)
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace SPH {
+	//=================================================================================================//
+	ThreadPinning::ThreadPinning()
+		: tbb::task_scheduler_observer(), allowed_processors_(findProcessorsOfLocalRank()),
+		next_processor_(0), number_of_pinned_threads_(0)
+	{
+		observe(true);
+	}
+	//=================================================================================================//
+	ThreadPinning::~ThreadPinning()
+	{
+		observe(false);
+	}
+	//=================================================================================================//
+	void ThreadPinning::on_scheduler_entry(bool is_worker)
+	{
+		if (is_worker) pinTheCurrentThread();
+	}
+	//=================================================================================================//
+	void ThreadPinning::pinTheCurrentThread()
+	{
+		size_t processor = allowed_processors_[next_processor_.fetch_add(1) % allowed_processors_.size()];
+		if (pinToProcessor(processor)) number_of_pinned_threads_++;
+	}
+	//=================================================================================================//
+	StdVec<size_t> ThreadPinning::findAllowedProcessors()
+	{
+		StdVec<size_t> allowed_processors;
+#if defined(__linux__)
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		if (sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set) == 0)
+			for (size_t processor = 0; processor != CPU_SETSIZE; ++processor)
+				if (CPU_ISSET(processor, &cpu_set)) allowed_processors.push_back(processor);
+#elif defined(_WIN32)
+		DWORD_PTR process_mask, system_mask;
+		if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask) != 0)
+			for (size_t processor = 0; processor != 8 * sizeof(DWORD_PTR); ++processor)
+				if ((process_mask >> processor) & 1) allowed_processors.push_back(processor);
+#endif
+		if (allowed_processors.empty())
+		{
+			size_t number_of_processors = SMAX(size_t(std::thread::hardware_concurrency()), size_t(1));
+			for (size_t processor = 0; processor != number_of_processors; ++processor)
+				allowed_processors.push_back(processor);
+		}
+		return allowed_processors;
+	}
+	//=================================================================================================//
+	StdVec<size_t> ThreadPinning::findProcessorsOfLocalRank()
+	{
+		StdVec<size_t> allowed_processors = findAllowedProcessors();
+		size_t number_of_local_ranks = size_t(MPIEnvironment::NumberOfLocalRanks());
+		size_t processors_per_rank = SMAX(allowed_processors.size() / number_of_local_ranks, size_t(1));
+		size_t offset = (size_t(MPIEnvironment::LocalRank()) * processors_per_rank) % allowed_processors.size();
+		return StdVec<size_t>(allowed_processors.begin() + offset,
+			allowed_processors.begin() + SMIN(offset + processors_per_rank, allowed_processors.size()));
+	}
+	//=================================================================================================//
+	bool ThreadPinning::pinToProcessor(size_t processor)
+	{
+#if defined(__linux__)
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(processor, &cpu_set);
+		return sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) == 0;
+#elif defined(_WIN32)
+		if (processor >= 8 * sizeof(DWORD_PTR)) return false;
+		return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << processor) != 0;
+#else
+		return false;
+#endif
+	}
+	//=================================================================================================//
+}
@@ -0,0 +1,72 @@
+/* -------------------------------------------------------------------------*
+*								SPHinXsys									*
+* --------------------------------------------------------------------------*
+* SPHinXsys (pronunciation: s'finksis) is an acronym from Smoothed Particle	*
+* Hydrodynamics for industrial compleX systems. It provides C++ APIs for	*
+* physical accurate simulation and aims to model coupled industrial dynamic *
+* systems including fluid, solid, multi-body dynamics and beyond with SPH	*
+* (smoothed particle hydrodynamics), a meshless computational method using	*
+* particle discretization.													*
+*																			*
+* SPHinXsys is partially funded by German Research Foundation				*
+* (Deutsche Forschungsgemeinschaft) DFG HU1527/6-1, HU1527/10-1				*
+* and HU1527/12-1.															*
+*                                                                           *
+* Portions copyright (c) 2017-2020 Technical University of Munich and		*
+* the authors' affiliations.												*
+*                                                                           *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may   *
+* not use this file except in compliance with the License. You may obtain a *
+* copy of the License at http://www.apache.org/licenses/LICENSE-2.0.        *
+*                                                                           *
+* --------------------------------------------------------------------------*/
+/**
+ * @file 	thread_pinning.h
+ * @brief 	Optional pinning of the threads of the task scheduler to the logical processors,
+ * so that a thread stays on the NUMA node of the memory it touched first.
+ * @author	Chi Zhang and Xiangyu Hu
+ * @version	0.1
+ */
+
+#pragma once
+
+#include "base_data_package.h"
+
+#include <atomic>
+
+namespace SPH {
+
+	/**
+	 * @class ThreadPinning
+	 * @brief Observes the worker threads entering the task scheduler and pins each of them to a logical processor,
+	 * in the order of the processor numbers. The main thread is left unpinned,
+	 * so that the threads it spawns later, e.g. for the background output, are not confined to one processor.
+	 * Only the processors allowed for the process, e.g. by taskset, numactl or a batch system,
+	 * are used, round-robin if there are more threads than these processors.
+	 * These processors are divided among the MPI ranks on the same node,
+	 * so that each rank pins its threads to its own part of them.
+	 * Pinning is only implemented for Linux and Windows, and does nothing otherwise.
+	 */
+	class ThreadPinning : public tbb::task_scheduler_observer
+	{
+	public:
+		ThreadPinning();
+		virtual ~ThreadPinning();
+
+		virtual void on_scheduler_entry(bool is_worker) override;
+		size_t NumberOfPinnedThreads() { return number_of_pinned_threads_; };
+		/** the processors in the affinity mask of the calling thread, all processors if not supported */
+		static StdVec<size_t> findAllowedProcessors();
+	protected:
+		/** the logical processors of the local MPI rank, taken from those allowed for the calling thread */
+		StdVec<size_t> allowed_processors_;
+		std::atomic<size_t> next_processor_;
+		std::atomic<size_t> number_of_pinned_threads_;
+
+		void pinTheCurrentThread();
+		/** the part of the allowed processors for the local MPI rank */
+		static StdVec<size_t> findProcessorsOfLocalRank();
+		/** pin the calling thread to the processor, return false if not supported or failed */
+		static bool pinToProcessor(size_t processor);
+	};
+}
@@ -0,0 +1,136 @@
+/**
+ * @file 	BackgroundOutput.cpp
+ * @brief 	2D test of writing the body states by a background thread.
+ * @details The states of a water block are written as binary VTU files,
+ * 			once in the calling thread and once by the background thread of another output.
+ * 			The particles are moved right after the background output is queued,
+ * 			but the two files should be the same, as the background thread writes a snapshot.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	The content of a file.
+ */
+std::string ReadFile(std::string filefullpath)
+{
+	std::ifstream in_file(filefullpath.c_str(), ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/**
+	 * @brief Output in the calling thread and output in the background with two buffers.
+	 */
+	In_Output in_output(sph_system);
+	WriteBodyStatesToVtu write_body_states(in_output, { water_block }, VtuFormat::binary);
+	In_Output background_in_output(sph_system, 2);
+	WriteBodyStatesToVtu background_write_body_states(background_in_output, { water_block }, VtuFormat::binary);
+	/** the files of the two outputs are distinguished by the output time */
+	std::string filefullpath = in_output.output_folder_ + "/SPHBody_WaterBody_0.vtu";
+	std::string background_filefullpath = in_output.output_folder_ + "/SPHBody_WaterBody_10000.vtu";
+	/**
+	 * @brief 	Write the same body states in the two ways.
+	 */
+	water_block->setNewlyUpdated();
+	write_body_states.WriteToFile(0.0);
+	water_block->setNewlyUpdated();
+	background_write_body_states.WriteToFile(1.0);
+	/** move the particles while the background thread may still be writing */
+	for (size_t i = 0; i != water_block->number_of_particles_; ++i)
+		water_block->base_particles_->pos_n_[i] += Vec2d(particle_spacing_ref, 0.0);
+	background_in_output.flushOutput();
+
+	std::string content = ReadFile(filefullpath);
+	std::string background_content = ReadFile(background_filefullpath);
+	if (content.empty())
+	{
+		std::cout << "\n Error: the output file " << filefullpath << " is not written!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	if (background_content != content)
+	{
+		std::cout << "\n Error: the output file " << background_filefullpath << " written in the background "
+			<< "differs from the output file " << filefullpath << "!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The body states written in the background are the same as those written directly." << endl;
+
+	return 0;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file 	CellLinkedListUpdate.cpp
+ * @brief 	2D test of updating the cell linked list by counting sort.
+ * @details Two identical water blocks are created and their particles are moved in the same way,
+ * 			but the cell linked list of one of them is updated by the original clearing and rebuilding.
+ * 			After each update, and after inserting ghost entries as for a periodic boundary,
+ * 			the particles listed in each cell should be the same for the two water blocks.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Move the particles by a displacement given by their particle ids,
+ * so that a particle is moved in the same way whatever its present index is.
+ */
+void MoveParticles(RealBody* body, size_t step)
+{
+	BaseParticles* particles = body->base_particles_;
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		Real phase = Real(particles->particle_id_[i] + step);
+		particles->pos_n_[i] += 0.5 * particle_spacing_ref * Vec2d(sin(1.7 * phase), cos(2.3 * phase));
+	}
+}
+/**
+ * @brief 	Insert the ghost entries of the particles near the left side at the right side,
+ * with the indexes after those of the real particles.
+ */
+void InsertGhostEntries(RealBody* body)
+{
+	StdLargeVec<Vecd>& pos_n = body->base_particles_->pos_n_;
+	size_t ghost_index = body->number_of_particles_;
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		if (pos_n[i][0] < 2.0 * particle_spacing_ref)
+		{
+			body->mesh_cell_linked_list_->InsertACellLinkedListDataEntry(ghost_index, pos_n[i] + Vec2d(DL, 0.0));
+			ghost_index++;
+		}
+	}
+}
+/**
+ * @brief 	The number of cells whose listed particles, including the ghost entries, differ in the two cell linked lists.
+ */
+size_t NumberOfMismatchedCells(BaseMeshCellLinkedList* mesh_cell_linked_list,
+	BaseMeshCellLinkedList* other_mesh_cell_linked_list)
+{
+	auto compare_indexes = [](const ListData& a, const ListData& b) { return a.first < b.first; };
+	size_t number_of_mismatches = 0;
+	Vecu number_of_cells = mesh_cell_linked_list->NumberOfCells();
+	for (size_t l = 0; l != number_of_cells[0]; ++l)
+		for (size_t m = 0; m != number_of_cells[1]; ++m)
+		{
+			CellList* cell_list = mesh_cell_linked_list->CellListFormIndex(Vecu(l, m));
+			CellList* other_cell_list = other_mesh_cell_linked_list->CellListFormIndex(Vecu(l, m));
+			/** the order of the particles in a cell may differ */
+			IndexVector real_particle_indexes = cell_list->real_particle_indexes_;
+			IndexVector other_real_particle_indexes = other_cell_list->real_particle_indexes_;
+			std::sort(real_particle_indexes.begin(), real_particle_indexes.end());
+			std::sort(other_real_particle_indexes.begin(), other_real_particle_indexes.end());
+			CellListDataVector cell_list_data = cell_list->cell_list_data_;
+			CellListDataVector other_cell_list_data = other_cell_list->cell_list_data_;
+			std::sort(cell_list_data.begin(), cell_list_data.end(), compare_indexes);
+			std::sort(other_cell_list_data.begin(), other_cell_list_data.end(), compare_indexes);
+
+			bool is_matched = real_particle_indexes == other_real_particle_indexes
+				&& cell_list_data.size() == other_cell_list_data.size();
+			for (size_t n = 0; is_matched && n != cell_list_data.size(); ++n)
+				is_matched = cell_list_data[n].first == other_cell_list_data[n].first
+				&& cell_list_data[n].second == other_cell_list_data[n].second;
+			if (!is_matched) number_of_mismatches++;
+		}
+	return number_of_mismatches;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** The same water block, but with its cell linked list updated by rebuilding. */
+	WaterBlock* rebuilt_water_block = new WaterBlock(sph_system, "RebuiltWaterBody", 0);
+	FluidParticles 	rebuilt_fluid_particles(rebuilt_water_block, water_material);
+	MeshCellLinkedList* rebuilt_mesh_cell_linked_list
+		= dynamic_cast<MeshCellLinkedList*>(rebuilt_water_block->mesh_cell_linked_list_);
+	if (rebuilt_mesh_cell_linked_list == nullptr)
+	{
+		std::cout << "\n Error: the water block does not use the default cell linked list!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	rebuilt_mesh_cell_linked_list->setCountingSortUpdate(false);
+	/** Build the cell linked lists. */
+	sph_system.initializeSystemCellLinkedLists();
+	if (rebuilt_water_block->number_of_particles_ != water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: the two water blocks have different numbers of particles!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	Move the particles, and compare the cell lists after each update and after inserting ghost entries.
+	 */
+	size_t number_of_steps = 5;
+	for (size_t step = 0; step != number_of_steps; ++step)
+	{
+		size_t number_of_mismatches = NumberOfMismatchedCells(water_block->mesh_cell_linked_list_,
+			rebuilt_water_block->mesh_cell_linked_list_);
+		if (number_of_mismatches != 0)
+		{
+			std::cout << "\n Error: the particles listed in " << number_of_mismatches << " cells differ "
+				<< "after the update at step " << step << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+
+		InsertGhostEntries(water_block);
+		InsertGhostEntries(rebuilt_water_block);
+		number_of_mismatches = NumberOfMismatchedCells(water_block->mesh_cell_linked_list_,
+			rebuilt_water_block->mesh_cell_linked_list_);
+		if (number_of_mismatches != 0)
+		{
+			std::cout << "\n Error: the particles listed in " << number_of_mismatches << " cells differ "
+				<< "after inserting the ghost entries at step " << step << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+
+		/** the ghost entries of this step are removed by the next update */
+		MoveParticles(water_block, step);
+		MoveParticles(rebuilt_water_block, step);
+		water_block->updateCellLinkedList();
+		rebuilt_water_block->updateCellLinkedList();
+	}
+	cout << "The particles listed in all cells are the same with the counting sort "
+		<< "and the rebuilding in " << number_of_steps << " steps." << endl;
+
+	return 0;
+}
@@ -0,0 +1,359 @@
+/**
+ * @file 	DambreakMPI.cpp
+ * @brief 	2D dambreak example with the water block decomposed among MPI ranks.
+ * @details The water block is divided into slabs of the MPI ranks, which exchange
+ * 			the halo and the migrating particles. Run with, e.g., mpirun -n 2.
+ * 			A run with one rank writes the observed pressure as reference,
+ * 			to which the observed pressure of a later run with more ranks is compared.
+ * @author 	Luhui Han, Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 5.366; 						/**< Tank length. */
+Real DH = 5.366; 						/**< Tank height. */
+Real LL = 2.0; 							/**< Liquid colume length. */
+Real LH = 1.0; 							/**< Liquid colume height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real gravity_g = 1.0;					/**< Gravity force of fluid. */
+Real U_max = 2.0*sqrt(gravity_g*LH);		/**< Characteristic velocity. */
+Real c_f = 10.0* U_max;					/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	//geometry
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, LH));
+	water_block_shape.push_back(Point(LL, LH));
+	water_block_shape.push_back(Point(LL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/** create outer wall shape */
+std::vector<Point> CreatOuterWallShape()
+{
+	std::vector<Point> outer_wall_shape;
+	outer_wall_shape.push_back(Point(-BW, -BW));
+	outer_wall_shape.push_back(Point(-BW, DH + BW));
+	outer_wall_shape.push_back(Point(DL + BW, DH + BW));
+	outer_wall_shape.push_back(Point(DL + BW, -BW));
+	outer_wall_shape.push_back(Point(-BW, -BW));
+
+	return outer_wall_shape;
+}
+/**
+* @brief create inner wall shape
+*/
+std::vector<Point> CreatInnerWallShape()
+{
+	std::vector<Point> inner_wall_shape;
+	inner_wall_shape.push_back(Point(0.0, 0.0));
+	inner_wall_shape.push_back(Point(0.0, DH));
+	inner_wall_shape.push_back(Point(DL, DH));
+	inner_wall_shape.push_back(Point(DL, 0.0));
+	inner_wall_shape.push_back(Point(0.0, 0.0));
+
+	return inner_wall_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Wall boundary body definition.
+ */
+class WallBoundary : public SolidBody
+{
+public:
+	WallBoundary(SPHSystem &sph_system, string body_name, int refinement_level)
+		: SolidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> outer_shape = CreatOuterWallShape();
+		std::vector<Point> inner_shape = CreatInnerWallShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(outer_shape, ShapeBooleanOps::add);
+		body_shape_->addAPolygon(inner_shape, ShapeBooleanOps::sub);
+	}
+};
+/**
+ * @brief 	Fluid observer body definition.
+ */
+class FluidObserver : public FictitiousBody
+{
+public:
+	FluidObserver(SPHSystem &sph_system, string body_name, int refinement_level)
+		: FictitiousBody(sph_system, body_name, refinement_level, 1.3)
+	{
+		body_input_points_volumes_.push_back(make_pair(Point(DL, 0.2), 0.0));
+	}
+};
+/**
+ * @brief 	Output of the observed pressure, which also keeps the history of the observed values.
+ */
+class WriteAndRecordWaterPressure : public WriteAnObservedQuantity<Real, FluidParticles, &FluidParticles::p_>
+{
+public:
+	StdVec<Real> recorded_pressure_;
+
+	WriteAndRecordWaterPressure(In_Output& in_output, SPHBodyContactRelation* body_contact_relation)
+		: WriteAnObservedQuantity<Real, FluidParticles, &FluidParticles::p_>("Pressure", in_output, body_contact_relation) {};
+	virtual ~WriteAndRecordWaterPressure() {};
+
+	virtual void WriteToFile(Real time = 0.0) override
+	{
+		WriteAnObservedQuantity<Real, FluidParticles, &FluidParticles::p_>::WriteToFile(time);
+		recorded_pressure_.push_back(observed_quantities_[0]);
+	};
+};
+/** The file of the observed pressure from the run with one rank. */
+string reference_pressure_file = "./reference_pressure_of_one_rank.dat";
+/**
+ * @brief 	Compare the observed pressure with that of the run with one rank.
+ * The decomposed run sums the particle interactions in different orders,
+ * hence the root mean square difference is required to be within 5 percent of the reference.
+ */
+bool isConsistentWithOneRank(StdVec<Real>& recorded_pressure)
+{
+	std::ifstream in_file(reference_pressure_file.c_str());
+	if (!in_file.good())
+	{
+		std::cout << "\n Error: the reference pressure " << reference_pressure_file
+			<< " is not found, please run the case with one rank first!" << std::endl;
+		return false;
+	}
+	StdVec<Real> reference_pressure;
+	Real pressure;
+	while (in_file >> pressure) reference_pressure.push_back(pressure);
+	if (reference_pressure.size() != recorded_pressure.size())
+	{
+		std::cout << "\n Error: the number of the observed pressure does not match the reference!" << std::endl;
+		return false;
+	}
+	Real difference = 0.0;
+	Real reference = 0.0;
+	for (size_t i = 0; i != reference_pressure.size(); ++i)
+	{
+		difference += (recorded_pressure[i] - reference_pressure[i]) * (recorded_pressure[i] - reference_pressure[i]);
+		reference += reference_pressure[i] * reference_pressure[i];
+	}
+	Real relative_difference = sqrt(difference / (reference + TinyReal));
+	cout << "The relative difference of the observed pressure to the run with one rank is "
+		<< relative_difference << endl;
+	return relative_difference < 0.05;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main(int ac, char* av[])
+{
+	/** MPI is initialized before the system, so that each rank writes to its own output folder. */
+	MPIEnvironment mpi_environment(&ac, &av);
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/** Set the starting time. */
+	GlobalStaticVariables::physical_time_ = 0.0;
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterBlock *water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	WaterMaterial 	*water_material = new WaterMaterial();
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/**
+	 * @brief 	Particle and body creation of wall boundary.
+	 */
+	WallBoundary *wall_boundary = new WallBoundary(sph_system, "Wall",	0);
+	SolidParticles 					solid_particles(wall_boundary);
+	/**
+	 * @brief 	Particle and body creation of fluid observer.
+	 */
+	FluidObserver *fluid_observer = new FluidObserver(sph_system, "Fluidobserver", 0);
+	BaseParticles 	observer_particles(fluid_observer);
+	/** topology */
+	SPHBodyComplexRelation* water_block_complex_relation = new SPHBodyComplexRelation(water_block, { wall_boundary });
+	SPHBodyComplexRelation* wall_complex_relation = new SPHBodyComplexRelation(wall_boundary, {});
+	SPHBodyContactRelation* fluid_observer_contact_relation = new SPHBodyContactRelation(fluid_observer, { water_block });
+	/**
+	 * @brief 	The water block is decomposed into slabs along the x direction, one for each rank.
+	 * The wall and the observer are not decomposed, i.e. each rank has all of their particles.
+	 */
+	DomainDecompositionInAxisDirection water_block_decomposition(water_block, 0);
+	water_block_decomposition.distributeParticles();
+	size_t total_number_of_water_particles = water_block_decomposition.TotalNumberOfParticles();
+	/**
+	 * @brief 	Define all numerical methods which are used in this case.
+	 */
+	 /** Define external force. */
+	Gravity 							gravity(Vecd(0.0, -gravity_g));
+	/** Initialize normal direction of the wall boundary. */
+	solid_dynamics::NormalDirectionSummation 	get_wall_normal(wall_complex_relation);
+	/** Initialize particle acceleration. */
+	InitializeATimeStep 	initialize_a_fluid_step(water_block, &gravity);
+	/** Evaluation of density by summation approach. */
+	fluid_dynamics::DensityBySummationFreeSurface		update_fluid_density(water_block_complex_relation);
+	/** Time step sizes with and without considering sound wave speed,
+	  * which are taken as the minimum of all ranks. */
+	fluid_dynamics::FluidTimeStepSizes		get_fluid_time_step_sizes(water_block, U_max);
+	/** Pressure relaxation algorithm by using position verlet time stepping. */
+	fluid_dynamics::PressureRelaxationFirstHalfRiemann 	pressure_relaxation_first_half(water_block_complex_relation);
+	fluid_dynamics::PressureRelaxationSecondHalfRiemann pressure_relaxation_second_half(water_block_complex_relation);
+	/**
+	 * @brief Output, the states of the decomposed body are written by each rank
+	 * and the energy and the observed pressure are combined from all ranks.
+	 */
+	In_Output in_output(sph_system);
+	/** Output the body states. */
+	WriteBodyStatesToVtu 		write_body_states(in_output, sph_system.real_bodies_);
+	/** Output the mechanical energy of fluid body. */
+	WriteTotalMechanicalEnergy 	write_water_mechanical_energy(in_output, water_block, &gravity);
+	/** output the observed data from fluid body. */
+	WriteAndRecordWaterPressure write_recorded_water_pressure(in_output, fluid_observer_contact_relation);
+	/** Pre-simulation*/
+	sph_system.initializeSystemCellLinkedLists();
+	water_block_decomposition.createHaloParticles();
+	sph_system.initializeSystemConfigurations();
+	get_wall_normal.exec();
+	/** Output the start states of bodies. */
+	write_body_states.WriteToFile(GlobalStaticVariables::physical_time_);
+	/** Output the Hydrostatic mechanical energy of fluid. */
+	write_water_mechanical_energy.WriteToFile(GlobalStaticVariables::physical_time_);
+	/**
+	 * @brief 	Basic parameters.
+	 */
+	int number_of_iterations = 0;
+	int screen_output_interval = 100;
+	Real End_Time = 2.0; 	/**< End time. */
+	Real D_Time = 0.1;		/**< Time stamps for output of body states. */
+	Real Dt = 0.0;			/**< Default advection time step sizes. */
+	get_fluid_time_step_sizes.parallel_exec();
+	Real dt = MPIEnvironment::reduceMin(get_fluid_time_step_sizes.AcousticTimeStep());
+	/** statistics for computing CPU time. */
+	tick_count t1 = tick_count::now();
+	tick_count::interval_t interval;
+	/**
+	 * @brief 	Main loop starts here.
+	 * Note that all ranks take the same time steps, as the communication is collective.
+	 */
+	while (GlobalStaticVariables::physical_time_ < End_Time)
+	{
+		Real integration_time = 0.0;
+		/** Integrate time (loop) until the next output time. */
+		while (integration_time < D_Time)
+		{
+			/** Acceleration due to viscous force and gravity. */
+			Dt = MPIEnvironment::reduceMin(get_fluid_time_step_sizes.AdvectionTimeStep());
+			initialize_a_fluid_step.parallel_exec();
+			update_fluid_density.parallel_exec();
+			/** Dynamics including pressure relaxation,
+			  * in which the halo is updated between the initialization and the interaction. */
+			Real relaxation_time = 0.0;
+			while (relaxation_time < Dt)
+			{
+				pressure_relaxation_first_half.parallel_exec(dt);
+				pressure_relaxation_second_half.parallel_exec(dt);
+				get_fluid_time_step_sizes.parallel_exec();
+				dt = MPIEnvironment::reduceMin(get_fluid_time_step_sizes.AcousticTimeStep());
+				relaxation_time += dt;
+				integration_time += dt;
+				GlobalStaticVariables::physical_time_ += dt;
+			}
+			if (number_of_iterations % screen_output_interval == 0 && MPIEnvironment::isRoot())
+			{
+				cout << fixed << setprecision(9) << "N=" << number_of_iterations << "	Time = "
+					<< GlobalStaticVariables::physical_time_
+					<< "	Dt = " << Dt << "	dt = " << dt << "\n";
+			}
+			number_of_iterations++;
+			/** Migrate the particles which left the slab, then update cell linked list, halo and configuration. */
+			water_block_decomposition.migrateParticles();
+			water_block->updateCellLinkedList();
+			water_block_decomposition.createHaloParticles();
+			water_block_complex_relation->updateConfiguration();
+			fluid_observer_contact_relation->updateConfiguration();
+		}
+
+		tick_count t2 = tick_count::now();
+		write_water_mechanical_energy.WriteToFile(GlobalStaticVariables::physical_time_);
+		write_body_states.WriteToFile(GlobalStaticVariables::physical_time_);
+		write_recorded_water_pressure.WriteToFile(GlobalStaticVariables::physical_time_);
+		tick_count t3 = tick_count::now();
+		interval += t3 - t2;
+	}
+	tick_count t4 = tick_count::now();
+
+	tick_count::interval_t tt;
+	tt = t4 - t1 - interval;
+	if (MPIEnvironment::isRoot())
+		cout << "Total wall time for computation: " << tt.seconds()
+			<< " seconds with " << MPIEnvironment::NumberOfRanks() << " ranks." << endl;
+	/** The particles are only moved between the ranks, never lost or duplicated. */
+	if (water_block_decomposition.TotalNumberOfParticles() != total_number_of_water_particles)
+	{
+		std::cout << "\n Error: the number of water particles is not conserved by the migration!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/** The run with one rank gives the reference, which the decomposed runs should reproduce. */
+	if (MPIEnvironment::isRoot())
+	{
+		if (MPIEnvironment::NumberOfRanks() == 1)
+		{
+			std::ofstream out_file(reference_pressure_file.c_str());
+			out_file << setprecision(12);
+			for (size_t i = 0; i != write_recorded_water_pressure.recorded_pressure_.size(); ++i)
+				out_file << write_recorded_water_pressure.recorded_pressure_[i] << "\n";
+		}
+		else if (!isConsistentWithOneRank(write_recorded_water_pressure.recorded_pressure_))
+		{
+			std::cout << "\n Error: the observed pressure differs from the run with one rank!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
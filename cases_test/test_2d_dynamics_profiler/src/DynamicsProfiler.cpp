@@ -0,0 +1,171 @@
+/**
+ * @file 	DynamicsProfiler.cpp
+ * @brief 	2D test of the timing and throughput profiler of the particle dynamics.
+ * @details The density of a water block is computed by summation several times,
+ * 			before and after the profiler is enabled.
+ * 			Only the executions after enabling should be recorded,
+ * 			and the records should be written into the CSV and the JSON reports.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	The content of a file.
+ */
+std::string ReadFile(std::string filefullpath)
+{
+	std::ifstream in_file(filefullpath.c_str());
+	return std::string(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** topology */
+	SPHBodyComplexRelation* water_block_complex_relation = new SPHBodyComplexRelation(water_block, {});
+	/** The profiled dynamics with a given name. */
+	fluid_dynamics::DensityBySummation update_fluid_density(water_block_complex_relation);
+	update_fluid_density.setDynamicsName("DensitySummation");
+	In_Output in_output(sph_system);
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	/**
+	 * @brief 	Nothing is recorded before the profiler is enabled.
+	 */
+	update_fluid_density.parallel_exec();
+	if (!DynamicsProfiler::Profiles().empty())
+	{
+		std::cout << "\n Error: the profiles are recorded before the profiler is enabled!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	Each execution after enabling is recorded.
+	 */
+	DynamicsProfiler::enable();
+	size_t number_of_executions = 10;
+	for (size_t n = 0; n != number_of_executions; ++n)
+	{
+		update_fluid_density.parallel_exec();
+	}
+	water_block->updateCellLinkedList();
+	water_block_complex_relation->updateConfiguration();
+	DynamicsProfiler::enable(false);
+
+	StdVec<std::pair<std::string, DynamicsProfile>> profiles = DynamicsProfiler::Profiles();
+	auto profile = std::find_if(profiles.begin(), profiles.end(),
+		[](const std::pair<std::string, DynamicsProfile>& named_profile) { return named_profile.first == "DensitySummation"; });
+	if (profile == profiles.end())
+	{
+		std::cout << "\n Error: the profile of the dynamics is not recorded!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	if (profile->second.number_of_calls_ != number_of_executions
+		|| profile->second.number_of_particles_ != number_of_executions * water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: " << profile->second.number_of_calls_ << " calls with "
+			<< profile->second.number_of_particles_ << " particles are recorded for "
+			<< number_of_executions << " executions!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/** the configuration updates are recorded together with the dynamics */
+	if (profiles.size() < 2)
+	{
+		std::cout << "\n Error: the updates of the cell linked list and the configuration are not recorded!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	The reports.
+	 */
+	DynamicsProfiler::printReport();
+	std::string csv_filefullpath = in_output.output_folder_ + "/dynamics_profile.csv";
+	std::string json_filefullpath = in_output.output_folder_ + "/dynamics_profile.json";
+	DynamicsProfiler::writeReportToCsv(csv_filefullpath);
+	DynamicsProfiler::writeReportToJson(json_filefullpath);
+	if (ReadFile(csv_filefullpath).find("DensitySummation") == std::string::npos
+		|| ReadFile(json_filefullpath).find("DensitySummation") == std::string::npos)
+	{
+		std::cout << "\n Error: the profile of the dynamics is not written into the reports!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "All " << number_of_executions << " executions after enabling the profiler are recorded." << endl;
+
+	return 0;
+}
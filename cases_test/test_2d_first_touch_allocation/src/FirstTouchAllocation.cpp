@@ -0,0 +1,154 @@
+/**
+ * @file 	FirstTouchAllocation.cpp
+ * @brief 	2D test of the first-touch allocation of the particle data and the neighbor lists.
+ * @details The worker threads are pinned to the processors, the particle data of a water block
+ * 			are relocated by the first touch in the pre-simulation,
+ * 			and its configuration is allocated by the first touch.
+ * 			The main thread should stay unpinned, the particle positions should not be changed
+ * 			by the relocation, and the neighbors should be the same as those found by brute force.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	The neighbors of each particle found by brute force,
+ * i.e. all other particles within the cutoff radius in ascending order.
+ */
+StdVec<IndexVector> NeighborsByBruteForce(RealBody* body)
+{
+	StdLargeVec<Vecd>& pos_n = body->base_particles_->pos_n_;
+	Real cutoff_radius_sqr = powern(body->kernel_->GetCutOffRadius(), 2);
+	StdVec<IndexVector> neighbors(body->number_of_particles_);
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+		for (size_t j = 0; j != body->number_of_particles_; ++j)
+			if (j != i && (pos_n[i] - pos_n[j]).normSqr() <= cutoff_radius_sqr) neighbors[i].push_back(j);
+	return neighbors;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/** The worker threads are pinned, but not the main thread. */
+	StdVec<size_t> main_thread_processors = ThreadPinning::findAllowedProcessors();
+	sph_system.pinThreadsToProcessors();
+	/** The particle data and the neighbor lists are placed on the NUMA nodes of the threads using them. */
+	sph_system.enableFirstTouchAllocation();
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** topology */
+	SPHBodyInnerRelation* water_block_inner_relation = new SPHBodyInnerRelation(water_block);
+	/** The positions before the particle data are relocated. */
+	StdLargeVec<Vecd> initial_pos_n = water_block->base_particles_->pos_n_;
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	/**
+	 * @brief 	Compare the particle positions and the neighbors.
+	 */
+	if (ThreadPinning::findAllowedProcessors() != main_thread_processors)
+	{
+		std::cout << "\n Error: the main thread is pinned together with the worker threads!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	StdLargeVec<Vecd>& pos_n = water_block->base_particles_->pos_n_;
+	for (size_t i = 0; i != water_block->number_of_particles_; ++i)
+	{
+		if (pos_n[i] != initial_pos_n[i])
+		{
+			std::cout << "\n Error: the position of particle " << i << " is changed by the relocation!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+	}
+	StdVec<IndexVector> neighbors = NeighborsByBruteForce(water_block);
+	size_t number_of_mismatches = 0;
+	for (size_t i = 0; i != water_block->number_of_particles_; ++i)
+	{
+		Neighborhood neighborhood = water_block_inner_relation->inner_configuration_[i];
+		IndexVector neighbors_i(neighborhood.j_, neighborhood.j_ + neighborhood.current_size_);
+		std::sort(neighbors_i.begin(), neighbors_i.end());
+		if (neighbors_i != neighbors[i]) number_of_mismatches++;
+	}
+	if (number_of_mismatches != 0)
+	{
+		std::cout << "\n Error: the neighbors of " << number_of_mismatches << " particles differ "
+			<< "from those found by brute force!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The neighbors of all " << water_block->number_of_particles_ << " particles in the "
+		<< "first-touch allocated configuration are the same as those found by brute force." << endl;
+
+	return 0;
+}
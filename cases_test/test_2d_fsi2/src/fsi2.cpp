@@ -172,6 +172,13 @@ int main(int ac, char* av[])
 		constrain_beam_base(inserted_body, new BeamBase(inserted_body, "BeamBase"));
 	/** Update norm .*/
 	solid_dynamics::UpdateElasticNormalDirection 	inserted_body_update_normal(inserted_body);
+	/** Sub-cycling of the inserted body within each acoustic time step of the fluid. */
+	TimeSteppingLevel inserted_body_time_stepping("InsertedBody", inserted_body_computing_time_step_size,
+		[&](Real dt_s) {
+			inserted_body_stress_relaxation_first_half.parallel_exec(dt_s);
+			constrain_beam_base.parallel_exec();
+			inserted_body_stress_relaxation_second_half.parallel_exec(dt_s);
+		});
 	/**
 	 * @brief Write observation data into files.
 	 */
@@ -181,6 +188,35 @@ int main(int ac, char* av[])
 		write_beam_tip_displacement("Displacement", in_output, beam_observer_contact);
 	WriteAnObservedQuantity<Vecd, BaseParticles, &BaseParticles::vel_n_>
 		write_fluid_velocity("Velocity", in_output, fluid_observer_contact);
+	/**
+	 * @brief Updating cell linked lists and configurations of both bodies as a task graph,
+	 * in which the tasks of the inserted body run concurrently with those of the water block.
+	 * The resources are the bodies, their cell linked lists and their relations.
+	 */
+	BaseMeshCellLinkedList* water_block_cell_linked_list = water_block->mesh_cell_linked_list_;
+	BaseMeshCellLinkedList* inserted_body_cell_linked_list = inserted_body->mesh_cell_linked_list_;
+	DynamicsTaskGraph update_configurations;
+	update_configurations.addATask("inserted body cell linked list",
+		[&]() { inserted_body->updateCellLinkedList(); })
+		.reads(inserted_body).writes(inserted_body_cell_linked_list);
+	update_configurations.addATask("periodic bounding",
+		[&]() { periodic_bounding.parallel_exec(); })
+		.reads(water_block_cell_linked_list).writes(water_block);
+	update_configurations.addATask("water block cell linked list",
+		[&]() { water_block->updateCellLinkedList(); })
+		.reads(water_block).writes(water_block_cell_linked_list);
+	/** one need update configuration after periodic condition. */
+	update_configurations.addATask("periodic condition",
+		[&]() { periodic_condition.parallel_exec(); })
+		.writes(water_block).writes(water_block_cell_linked_list);
+	update_configurations.addATask("water block configuration",
+		[&]() { water_block_complex->updateConfiguration(); })
+		.reads(water_block).reads(water_block_cell_linked_list).reads(inserted_body)
+		.reads(inserted_body_cell_linked_list).writes(water_block_complex);
+	update_configurations.addATask("inserted body configuration",
+		[&]() { inserted_body_contact->updateConfiguration(); })
+		.reads(inserted_body).reads(water_block).reads(water_block_cell_linked_list)
+		.writes(inserted_body_contact);
 
 	/**
 	 * @brief Pre-simulation.
@@ -229,7 +265,6 @@ int main(int ac, char* av[])
 	Real D_Time = End_Time / 200.0;	/**< time stamps for output. */
 	Real Dt = 0.0;					/**< Default advection time step sizes for fluid. */
 	Real dt = 0.0; 					/**< Default acoustic time step sizes for fluid. */
-	Real dt_s = 0.0;				/**< Default acoustic time step sizes for solid. */
 	size_t inner_ite_dt = 0;
 	size_t inner_ite_dt_s = 0;
 	/** Statistics for computing time. */
@@ -264,19 +299,9 @@ int main(int ac, char* av[])
 				pressure_relaxation_second_half.parallel_exec(dt);
 
 				/** Solid dynamics. */
-				inner_ite_dt_s = 0;
-				Real dt_s_sum = 0.0;
 				average_velocity_and_acceleration.initialize_displacement_.parallel_exec();
-				while (dt_s_sum < dt) {
-
-					dt_s = inserted_body_computing_time_step_size.parallel_exec();
-					if (dt - dt_s_sum < dt_s) dt_s = dt - dt_s_sum;
-					inserted_body_stress_relaxation_first_half.parallel_exec(dt_s);
-					constrain_beam_base.parallel_exec();
-					inserted_body_stress_relaxation_second_half.parallel_exec(dt_s);
-					dt_s_sum += dt_s;
-					inner_ite_dt_s++;
-				}
+				inserted_body_time_stepping.advance(dt);
+				inner_ite_dt_s = inserted_body_time_stepping.NumberOfStepsInLastSubCycling();
 				average_velocity_and_acceleration.update_averages_.parallel_exec(dt);
 
 				dt = get_fluid_time_step_size.parallel_exec();
@@ -298,15 +323,8 @@ int main(int ac, char* av[])
 			}
 			number_of_iterations++;
 
-			/** Water block configuration and periodic condition. */
-			periodic_bounding.parallel_exec();
-
-			water_block->updateCellLinkedList();
-			periodic_condition.parallel_exec();
-			water_block_complex->updateConfiguration();
-			/** one need update configuration after periodic condition. */
-			inserted_body->updateCellLinkedList();
-			inserted_body_contact->updateConfiguration();
+			/** Water block configuration and periodic condition, and the configuration of the inserted body. */
+			update_configurations.execute();
 			/** write run-time observation into file */
 			write_beam_tip_displacement.WriteToFile(GlobalStaticVariables::physical_time_);
 		}
@@ -326,6 +344,7 @@ int main(int ac, char* av[])
 	tick_count::interval_t tt;
 	tt = t4 - t1 - interval;
 	cout << "Total wall time for computation: " << tt.seconds() << " seconds." << endl;
+	inserted_body_time_stepping.printReport(cout);
 
 	return 0;
 }
@@ -0,0 +1,276 @@
+/**
+ * @file 	InlinedDynamics.cpp
+ * @brief 	2D test of the inlined and fused particle dynamics with the dambreak.
+ * @details Two identical water blocks are created in the same tank without interacting with each other.
+ * 			One of them is computed by the default particle dynamics,
+ * 			the other by the inlined particle dynamics, with the initialization fused into the density summation
+ * 			and the time step sizes fused into the second half of the pressure relaxation.
+ * 			With the same time step sizes, the particles of the two water blocks should move in the same way.
+ * @author 	Luhui Han, Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 5.366; 						/**< Tank length. */
+Real DH = 5.366; 						/**< Tank height. */
+Real LL = 2.0; 							/**< Liquid colume length. */
+Real LH = 1.0; 							/**< Liquid colume height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real gravity_g = 1.0;					/**< Gravity force of fluid. */
+Real U_max = 2.0*sqrt(gravity_g*LH);		/**< Characteristic velocity. */
+Real c_f = 10.0* U_max;					/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	//geometry
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, LH));
+	water_block_shape.push_back(Point(LL, LH));
+	water_block_shape.push_back(Point(LL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/** create outer wall shape */
+std::vector<Point> CreatOuterWallShape()
+{
+	std::vector<Point> outer_wall_shape;
+	outer_wall_shape.push_back(Point(-BW, -BW));
+	outer_wall_shape.push_back(Point(-BW, DH + BW));
+	outer_wall_shape.push_back(Point(DL + BW, DH + BW));
+	outer_wall_shape.push_back(Point(DL + BW, -BW));
+	outer_wall_shape.push_back(Point(-BW, -BW));
+
+	return outer_wall_shape;
+}
+/**
+* @brief create inner wall shape
+*/
+std::vector<Point> CreatInnerWallShape()
+{
+	std::vector<Point> inner_wall_shape;
+	inner_wall_shape.push_back(Point(0.0, 0.0));
+	inner_wall_shape.push_back(Point(0.0, DH));
+	inner_wall_shape.push_back(Point(DL, DH));
+	inner_wall_shape.push_back(Point(DL, 0.0));
+	inner_wall_shape.push_back(Point(0.0, 0.0));
+
+	return inner_wall_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Wall boundary body definition.
+ */
+class WallBoundary : public SolidBody
+{
+public:
+	WallBoundary(SPHSystem &sph_system, string body_name, int refinement_level)
+		: SolidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> outer_shape = CreatOuterWallShape();
+		std::vector<Point> inner_shape = CreatInnerWallShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(outer_shape, ShapeBooleanOps::add);
+		body_shape_->addAPolygon(inner_shape, ShapeBooleanOps::sub);
+	}
+};
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/** Set the starting time. */
+	GlobalStaticVariables::physical_time_ = 0.0;
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterBlock *water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	WaterMaterial 	*water_material = new WaterMaterial();
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** The same water block computed by the inlined particle dynamics. */
+	WaterBlock *inlined_water_block = new WaterBlock(sph_system, "InlinedWaterBody", 0);
+	FluidParticles 	inlined_fluid_particles(inlined_water_block, water_material);
+	/**
+	 * @brief 	Particle and body creation of wall boundary.
+	 */
+	WallBoundary *wall_boundary = new WallBoundary(sph_system, "Wall",	0);
+	SolidParticles 					solid_particles(wall_boundary);
+
+	/** topology */
+	SPHBodyComplexRelation* water_block_complex_relation = new SPHBodyComplexRelation(water_block, { wall_boundary });
+	SPHBodyComplexRelation* inlined_water_block_complex_relation
+		= new SPHBodyComplexRelation(inlined_water_block, { wall_boundary });
+	SPHBodyComplexRelation* wall_complex_relation = new SPHBodyComplexRelation(wall_boundary, {});
+
+	/**
+	 * @brief 	Define all numerical methods which are used in this case.
+	 */
+	 /** Define external force. */
+	Gravity 							gravity(Vecd(0.0, -gravity_g));
+	/** Initialize normal direction of the wall boundary. */
+	solid_dynamics::NormalDirectionSummation 	get_wall_normal(wall_complex_relation);
+	/**
+	 * @brief 	The default particle dynamics.
+	 */
+	InitializeATimeStep 	initialize_a_fluid_step(water_block, &gravity);
+	fluid_dynamics::DensityBySummationFreeSurface 		update_fluid_density(water_block_complex_relation);
+	fluid_dynamics::AdvectionTimeStepSize 			get_fluid_advection_time_step_size(water_block, U_max);
+	fluid_dynamics::AcousticTimeStepSize get_fluid_time_step_size(water_block);
+	fluid_dynamics::PressureRelaxationFirstHalfRiemann
+		pressure_relaxation_first_half(water_block_complex_relation);
+	fluid_dynamics::PressureRelaxationSecondHalfRiemann
+		pressure_relaxation_second_half(water_block_complex_relation);
+	/**
+	 * @brief 	The inlined particle dynamics.
+	 */
+	InlinedParticleDynamicsSimple<InitializeATimeStep> 	inlined_initialize_a_fluid_step(inlined_water_block, &gravity);
+	/** Evaluation of density by summation approach,
+	  * fused with the initialization of particle acceleration in one particle loop. */
+	FusedParticleDynamicsSimpleComplex<InitializeATimeStep, fluid_dynamics::DensityBySummationFreeSurface>
+		inlined_update_fluid_density(inlined_initialize_a_fluid_step, inlined_water_block_complex_relation);
+	/** Time step sizes with and without considering sound wave speed, which are computed together. */
+	InlinedParticleDynamicsReduce<fluid_dynamics::FluidTimeStepSizes>
+		get_inlined_fluid_time_step_sizes(inlined_water_block, U_max);
+	/** The time step sizes are computed in the update loop of the second half. */
+	InlinedParticleDynamicsComplex1Level<fluid_dynamics::PressureRelaxationFirstHalfRiemann>
+		inlined_pressure_relaxation_first_half(inlined_water_block_complex_relation);
+	FusedParticleDynamicsComplex1LevelReduce<fluid_dynamics::PressureRelaxationSecondHalfRiemann,
+		fluid_dynamics::FluidTimeStepSizes> inlined_pressure_relaxation_second_half(get_inlined_fluid_time_step_sizes,
+			inlined_water_block_complex_relation);
+
+	/** Pre-simulation*/
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	get_wall_normal.exec();
+	if (inlined_water_block->number_of_particles_ != water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: the two water blocks have different numbers of particles!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+
+	/**
+	 * @brief 	Basic parameters.
+	 */
+	size_t number_of_iterations = 20;
+	Real Dt = 0.0;			/**< Default advection time step sizes. */
+	Real dt = 0.0; 			/**< Default acoustic time step sizes. */
+	Real time_step_tolerance = 1.0e-8;
+	Real position_tolerance = 1.0e-8 * particle_spacing_ref;
+	/** The time step sizes of the first step, which are later obtained from the pressure relaxation. */
+	get_inlined_fluid_time_step_sizes.parallel_exec();
+	/**
+	 * @brief 	Main loop starts here.
+	 */
+	for (size_t iteration = 0; iteration != number_of_iterations; ++iteration)
+	{
+		initialize_a_fluid_step.parallel_exec();
+		Dt = get_fluid_advection_time_step_size.parallel_exec();
+		update_fluid_density.parallel_exec();
+		Real inlined_Dt = get_inlined_fluid_time_step_sizes.AdvectionTimeStep();
+		inlined_update_fluid_density.parallel_exec();
+		if (ABS(inlined_Dt - Dt) > time_step_tolerance * Dt)
+		{
+			std::cout << "\n Error: the advection time step size " << inlined_Dt << " of the inlined dynamics "
+				<< "differs from " << Dt << " at iteration " << iteration << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+
+		/** Both water blocks are relaxed with the acoustic time step sizes of the default dynamics. */
+		Real relaxation_time = 0.0;
+		while (relaxation_time < Dt)
+		{
+			pressure_relaxation_first_half.parallel_exec(dt);
+			pressure_relaxation_second_half.parallel_exec(dt);
+			inlined_pressure_relaxation_first_half.parallel_exec(dt);
+			inlined_pressure_relaxation_second_half.parallel_exec(dt);
+			dt = get_fluid_time_step_size.parallel_exec();
+			/** The acoustic time step size of the inlined dynamics has been obtained
+			  * in the update loop of the second half, together with the advection time step size. */
+			Real inlined_dt = get_inlined_fluid_time_step_sizes.AcousticTimeStep();
+			if (ABS(inlined_dt - dt) > time_step_tolerance * dt)
+			{
+				std::cout << "\n Error: the acoustic time step size " << inlined_dt << " of the inlined dynamics "
+					<< "differs from " << dt << " at iteration " << iteration << "!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				return 1;
+			}
+			relaxation_time += dt;
+			GlobalStaticVariables::physical_time_ += dt;
+		}
+
+		/** the particles are not sorted, so that they are compared by their indexes */
+		StdLargeVec<Vecd>& pos_n = water_block->base_particles_->pos_n_;
+		StdLargeVec<Vecd>& inlined_pos_n = inlined_water_block->base_particles_->pos_n_;
+		for (size_t i = 0; i != water_block->number_of_particles_; ++i)
+		{
+			if ((inlined_pos_n[i] - pos_n[i]).norm() > position_tolerance)
+			{
+				std::cout << "\n Error: the position of particle " << i << " computed by the inlined dynamics "
+					<< "differs from the default one at iteration " << iteration << "!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				return 1;
+			}
+		}
+
+		/** Update cell linked list and configuration. */
+		water_block->updateCellLinkedList();
+		inlined_water_block->updateCellLinkedList();
+		water_block_complex_relation->updateConfiguration();
+		inlined_water_block_complex_relation->updateConfiguration();
+	}
+	cout << fixed << setprecision(9) << "The inlined dynamics moves the particles in the same way "
+		<< "as the default dynamics until Time = " << GlobalStaticVariables::physical_time_ << "." << endl;
+
+	return 0;
+}
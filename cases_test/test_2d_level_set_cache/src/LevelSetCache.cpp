@@ -0,0 +1,191 @@
+/**
+ * @file 	LevelSetCache.cpp
+ * @brief 	2D test of writing a level set to a cache file and reloading it.
+ * @details The level set of a block with a circular hole is computed and written to a cache file,
+ * 			which is then reloaded into a level set without data packages.
+ * 			The reloaded level set should have the same package layout and package data cell by cell.
+ * 			A cache file read with another key, or truncated, should be rejected,
+ * 			so that the level set is recomputed, again with the same package layout and level set as the original one.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+#include "level_set.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Block length. */
+Real DH = 1.0; 							/**< Block height. */
+Real particle_spacing_ref = 0.025; 		/**< Reference particle spacing. */
+Real mesh_spacing = 4.0 * particle_spacing_ref;	/**< Cell spacing of the level set. */
+size_t buffer_width = 4;				/**< Buffer width of the level set. */
+/** create a block shape */
+std::vector<Point> CreatBlockShape()
+{
+	std::vector<Point> block_shape;
+	block_shape.push_back(Point(0.0, 0.0));
+	block_shape.push_back(Point(0.0, DH));
+	block_shape.push_back(Point(DL, DH));
+	block_shape.push_back(Point(DL, 0.0));
+	block_shape.push_back(Point(0.0, 0.0));
+	return block_shape;
+}
+/**
+ * @brief 	Level set giving access to the packages of the cells for the comparison.
+ */
+class CachedLevelSet : public LevelSet
+{
+public:
+	CachedLevelSet(ComplexShape& complex_shape, Vecd lower_bound, Vecd upper_bound, bool is_data_initialized)
+		: LevelSet(complex_shape, lower_bound, upper_bound, mesh_spacing, buffer_width, is_data_initialized) {};
+	virtual ~CachedLevelSet() {};
+
+	/** the far-field package index of a cell, or -1 for a data package */
+	int FarFieldIndex(Vecu cell_index)
+	{
+		LevelSetDataPackage* data_pkg = DataPackageInACell(cell_index);
+		for (size_t k = 0; k != singular_data_pkgs_addrs.size(); ++k)
+			if (data_pkg == singular_data_pkgs_addrs[k]) return int(k);
+		return -1;
+	};
+	LevelSetDataPackage* PackageInACell(Vecu cell_index) { return DataPackageInACell(cell_index); };
+};
+/**
+ * @brief 	The number of cells whose packages differ in the two level sets.
+ * Otherwise than for all data, only the package layout and the level set are compared,
+ * as the other data are not all computed by the initialization of the packages.
+ */
+size_t NumberOfDifferentCells(CachedLevelSet& level_set, CachedLevelSet& other_level_set, bool is_all_data_compared)
+{
+	size_t number_of_different_cells = 0;
+	Vecu number_of_cells = level_set.NumberOfCells();
+	for (size_t i = 0; i != number_of_cells[0]; ++i)
+		for (size_t j = 0; j != number_of_cells[1]; ++j)
+		{
+			Vecu cell_index(i, j);
+			int far_field_index = level_set.FarFieldIndex(cell_index);
+			if (far_field_index != other_level_set.FarFieldIndex(cell_index))
+			{
+				number_of_different_cells++;
+				continue;
+			}
+			if (far_field_index != -1) continue;
+
+			LevelSetDataPackage* data_pkg = level_set.PackageInACell(cell_index);
+			LevelSetDataPackage* other_data_pkg = other_level_set.PackageInACell(cell_index);
+			if (data_pkg->is_core_pkg_ != other_data_pkg->is_core_pkg_
+				|| data_pkg->is_inner_pkg_ != other_data_pkg->is_inner_pkg_
+				|| memcmp(&data_pkg->phi_, &other_data_pkg->phi_, sizeof(data_pkg->phi_)) != 0)
+			{
+				number_of_different_cells++;
+				continue;
+			}
+			if (is_all_data_compared
+				&& (memcmp(&data_pkg->n_, &other_data_pkg->n_, sizeof(data_pkg->n_)) != 0
+					|| memcmp(&data_pkg->kappa_, &other_data_pkg->kappa_, sizeof(data_pkg->kappa_)) != 0
+					|| memcmp(&data_pkg->near_interface_id_, &other_data_pkg->near_interface_id_,
+						sizeof(data_pkg->near_interface_id_)) != 0))
+				number_of_different_cells++;
+		}
+	return number_of_different_cells;
+}
+/**
+ * @brief 	Check that a cache file is rejected, and that the level set recomputed instead
+ * is the same as the original one.
+ */
+bool isRejectedAndRecomputed(ComplexShape& shape, Vecd lower_bound, Vecd upper_bound,
+	CachedLevelSet& level_set, string filefullpath, uint64_t cache_key)
+{
+	CachedLevelSet recomputed_level_set(shape, lower_bound, upper_bound, false);
+	if (recomputed_level_set.readFromCacheFile(filefullpath, cache_key))
+	{
+		std::cout << "\n Error: the cache file " << filefullpath << " is not rejected!" << std::endl;
+		return false;
+	}
+	if (recomputed_level_set.inner_data_pkgs_.size() != 0)
+	{
+		std::cout << "\n Error: the rejected cache file " << filefullpath << " has changed the level set!" << std::endl;
+		return false;
+	}
+	recomputed_level_set.initializeDataPackages();
+	size_t number_of_different_cells = NumberOfDifferentCells(level_set, recomputed_level_set, false);
+	if (number_of_different_cells != 0)
+	{
+		std::cout << "\n Error: " << number_of_different_cells << " cells of the level set recomputed after "
+			<< "rejecting " << filefullpath << " differ from the original ones!" << std::endl;
+		return false;
+	}
+	return true;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief The shape, the level set and its cache file.
+	 */
+	std::vector<Point> block_shape = CreatBlockShape();
+	ComplexShape shape("BlockWithHole");
+	shape.addAPolygon(block_shape, ShapeBooleanOps::add);
+	shape.addACircle(Vec2d(0.5 * DL, 0.5 * DH), 0.25 * DH, 100, ShapeBooleanOps::sub);
+	Vecd lower_bound, upper_bound;
+	shape.findBounds(lower_bound, upper_bound);
+	uint64_t cache_key = shape.ContentHash();
+	string cache_filefullpath = "./BlockWithHole_levelset.cache";
+
+	CachedLevelSet level_set(shape, lower_bound, upper_bound, true);
+	level_set.writeToCacheFile(cache_filefullpath, cache_key);
+	/**
+	 * @brief 	Reload the cache file and compare the level sets cell by cell.
+	 */
+	CachedLevelSet reloaded_level_set(shape, lower_bound, upper_bound, false);
+	if (!reloaded_level_set.readFromCacheFile(cache_filefullpath, cache_key))
+	{
+		std::cout << "\n Error: the cache file " << cache_filefullpath << " cannot be reloaded!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	size_t number_of_different_cells = NumberOfDifferentCells(level_set, reloaded_level_set, true);
+	if (number_of_different_cells != 0
+		|| reloaded_level_set.core_data_pkgs_.size() != level_set.core_data_pkgs_.size()
+		|| reloaded_level_set.inner_data_pkgs_.size() != level_set.inner_data_pkgs_.size())
+	{
+		std::cout << "\n Error: " << number_of_different_cells << " cells of the reloaded level set "
+			<< "differ from the original ones, or the numbers of packages differ!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The reloaded level set is the same as the original one in all "
+		<< level_set.NumberOfCells()[0] * level_set.NumberOfCells()[1] << " cells." << endl;
+	/**
+	 * @brief 	A changed key and a truncated cache file lead to the recomputation.
+	 */
+	if (!isRejectedAndRecomputed(shape, lower_bound, upper_bound, level_set, cache_filefullpath, cache_key + 1))
+	{
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	std::ifstream cache_file(cache_filefullpath.c_str(), ios::binary);
+	string cache_data((std::istreambuf_iterator<char>(cache_file)), std::istreambuf_iterator<char>());
+	cache_file.close();
+	string truncated_filefullpath = "./BlockWithHole_levelset_truncated.cache";
+	std::ofstream truncated_file(truncated_filefullpath.c_str(), ios::trunc | ios::binary);
+	truncated_file.write(cache_data.data(), cache_data.size() / 2);
+	truncated_file.close();
+	if (!isRejectedAndRecomputed(shape, lower_bound, upper_bound, level_set, truncated_filefullpath, cache_key))
+	{
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The cache file with a changed key and the truncated one are rejected." << endl;
+
+	return 0;
+}
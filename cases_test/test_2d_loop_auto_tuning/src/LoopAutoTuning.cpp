@@ -0,0 +1,149 @@
+/**
+ * @file 	LoopAutoTuning.cpp
+ * @brief 	2D test of tuning the grain size of the parallel loops of a particle dynamics.
+ * @details The densities of two identical water blocks are computed by summation,
+ * 			but the grain size of the dynamics of one of them is tuned during the first executions.
+ * 			A candidate grain size should be locked in after the tuning,
+ * 			and the densities should be the same for the two water blocks with all grain sizes.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	WaterBlock* tuned_water_block = new WaterBlock(sph_system, "TunedWaterBody", 0);
+	FluidParticles 	tuned_fluid_particles(tuned_water_block, water_material);
+	/** topology */
+	SPHBodyComplexRelation* water_block_complex_relation = new SPHBodyComplexRelation(water_block, {});
+	SPHBodyComplexRelation* tuned_water_block_complex_relation = new SPHBodyComplexRelation(tuned_water_block, {});
+	/**
+	 * @brief 	The dynamics with the default grain size and the dynamics with a tuned grain size.
+	 */
+	fluid_dynamics::DensityBySummation update_fluid_density(water_block_complex_relation);
+	/** only the dynamics defined while the auto-tuning is enabled by default are tuned */
+	LoopPartitioner::enableAutoTuningByDefault();
+	fluid_dynamics::DensityBySummation update_tuned_fluid_density(tuned_water_block_complex_relation);
+	LoopPartitioner::enableAutoTuningByDefault(false);
+	/** the default candidates, each of which is tried in three executions */
+	StdVec<size_t> candidate_grain_sizes = { 1, 16, 64, 256, 1024 };
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	if (update_fluid_density.LoopPartitioning().isTuning() || !update_tuned_fluid_density.LoopPartitioning().isTuning())
+	{
+		std::cout << "\n Error: the auto-tuning is not only enabled for the dynamics defined after enabling it!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	Compute the densities until all candidates are tried.
+	 */
+	size_t number_of_executions = candidate_grain_sizes.size() * 3 + 2;
+	for (size_t n = 0; n != number_of_executions; ++n)
+	{
+		update_fluid_density.parallel_exec();
+		update_tuned_fluid_density.parallel_exec();
+
+		StdLargeVec<Real>& rho_n = fluid_particles.rho_n_;
+		StdLargeVec<Real>& tuned_rho_n = tuned_fluid_particles.rho_n_;
+		for (size_t i = 0; i != water_block->number_of_particles_; ++i)
+		{
+			if (tuned_rho_n[i] != rho_n[i])
+			{
+				std::cout << "\n Error: the density of particle " << i << " differs with the grain size "
+					<< update_tuned_fluid_density.LoopPartitioning().GrainSize() << "!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				return 1;
+			}
+		}
+	}
+	size_t tuned_grain_size = update_tuned_fluid_density.LoopPartitioning().GrainSize();
+	if (update_tuned_fluid_density.LoopPartitioning().isTuning()
+		|| std::find(candidate_grain_sizes.begin(), candidate_grain_sizes.end(), tuned_grain_size)
+		== candidate_grain_sizes.end())
+	{
+		std::cout << "\n Error: no candidate grain size is locked in after "
+			<< number_of_executions << " executions!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	LoopPartitioner::printTunedGrainSizes();
+	cout << "The densities are the same with all candidate grain sizes, "
+		<< "and the grain size " << tuned_grain_size << " is locked in." << endl;
+
+	return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file 	MultilevelCellLinkedList.cpp
+ * @brief 	2D test of the neighbor search with the multilevel cell linked list.
+ * @details Two identical water blocks are created, one of them with a two-level cell linked list.
+ * 			As all particles have the smoothing length of the body kernel,
+ * 			the neighbors and the kernel gradients found with the two lists should be the same.
+ * 			A third water block with a three-level cell linked list has particles of two smoothing lengths,
+ * 			whose neighbors and kernel gradients should be the same as those found by brute force
+ * 			with the larger smoothing length of each pair.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	The neighbors of each particle, given by their particle ids,
+ * with the kernel gradients.
+ */
+StdVec<std::map<size_t, Real>> NeighborsByParticleId(SPHBodyInnerRelation* inner_relation)
+{
+	BaseParticles* particles = inner_relation->sph_body_->base_particles_;
+	size_t number_of_particles = inner_relation->sph_body_->number_of_particles_;
+	StdVec<std::map<size_t, Real>> neighbors(number_of_particles);
+	for (size_t i = 0; i != number_of_particles; ++i)
+	{
+		Neighborhood neighborhood = inner_relation->inner_configuration_[i];
+		std::map<size_t, Real>& neighbors_i = neighbors[particles->particle_id_[i]];
+		for (size_t n = 0; n != neighborhood.current_size_; ++n)
+			neighbors_i[particles->particle_id_[neighborhood.j_[n]]] = neighborhood.dW_ij_[n];
+	}
+	return neighbors;
+}
+/**
+ * @brief 	The neighbors of each particle found by checking all pairs,
+ * with the cutoff radius and the kernel gradient of the larger smoothing length of the pair.
+ */
+StdVec<std::map<size_t, Real>> NeighborsByBruteForce(RealBody* body)
+{
+	BaseParticles* particles = body->base_particles_;
+	Kernel* kernel = body->kernel_;
+	size_t number_of_particles = body->number_of_particles_;
+	StdVec<std::map<size_t, Real>> neighbors(number_of_particles);
+	for (size_t i = 0; i != number_of_particles; ++i)
+		for (size_t j = 0; j != number_of_particles; ++j)
+		{
+			if (j == i) continue;
+			Real smoothing_length_ij = SMAX(particles->smoothing_length_[i], particles->smoothing_length_[j]);
+			Vecd displacement = particles->pos_n_[i] - particles->pos_n_[j];
+			Real cutoff_radius = kernel->GetCutOffRadius(smoothing_length_ij);
+			if (displacement.normSqr() <= cutoff_radius * cutoff_radius)
+				neighbors[particles->particle_id_[i]][particles->particle_id_[j]]
+					= kernel->dW(1.0 / smoothing_length_ij, displacement);
+		}
+	return neighbors;
+}
+/**
+ * @brief 	The number of particles whose neighbors differ in the two lists.
+ */
+size_t NumberOfMismatches(StdVec<std::map<size_t, Real>>& neighbors,
+	StdVec<std::map<size_t, Real>>& other_neighbors, Real dW_tolerance)
+{
+	size_t number_of_mismatches = 0;
+	for (size_t i = 0; i != neighbors.size(); ++i)
+	{
+		if (neighbors[i].size() != other_neighbors[i].size())
+		{
+			number_of_mismatches++;
+			continue;
+		}
+		for (auto& neighbor : neighbors[i])
+		{
+			auto other_neighbor = other_neighbors[i].find(neighbor.first);
+			if (other_neighbor == other_neighbors[i].end()
+				|| ABS(other_neighbor->second - neighbor.second) > ABS(dW_tolerance))
+			{
+				number_of_mismatches++;
+				break;
+			}
+		}
+	}
+	return number_of_mismatches;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** The same water block, but searching the neighbors with two levels. */
+	WaterBlock* multilevel_water_block = new WaterBlock(sph_system, "MultilevelWaterBody", 0);
+	multilevel_water_block->useMultilevelMeshCellLinkedList(2);
+	FluidParticles 	multilevel_fluid_particles(multilevel_water_block, water_material);
+	/** The same water block with three levels, whose particles in the left half have
+	  * twice the smoothing length of the body kernel and are binned at the coarsest level. */
+	WaterBlock* variable_water_block = new WaterBlock(sph_system, "VariableWaterBody", 0);
+	variable_water_block->useMultilevelMeshCellLinkedList(3);
+	FluidParticles 	variable_fluid_particles(variable_water_block, water_material);
+	for (size_t i = 0; i != variable_water_block->number_of_particles_; ++i)
+		if (variable_fluid_particles.pos_n_[i][0] < 0.5 * DL)
+			variable_fluid_particles.smoothing_length_[i] = 2.0 * variable_water_block->kernel_->GetSmoothingLength();
+	/** topology */
+	SPHBodyInnerRelation* water_block_inner_relation = new SPHBodyInnerRelation(water_block);
+	SPHBodyInnerRelation* multilevel_water_block_inner_relation = new SPHBodyInnerRelation(multilevel_water_block);
+	SPHBodyInnerRelation* variable_water_block_inner_relation = new SPHBodyInnerRelation(variable_water_block);
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	/**
+	 * @brief 	Compare the neighbors found with the two cell linked lists.
+	 */
+	if (multilevel_water_block->number_of_particles_ != water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: the two water blocks have different numbers of particles!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	StdVec<std::map<size_t, Real>> neighbors = NeighborsByParticleId(water_block_inner_relation);
+	StdVec<std::map<size_t, Real>> multilevel_neighbors = NeighborsByParticleId(multilevel_water_block_inner_relation);
+	Real dW_tolerance = 1.0e-6 * water_block->kernel_->dW(Vec2d(0.5 * particle_spacing_ref, 0.0));
+	size_t number_of_mismatches = NumberOfMismatches(neighbors, multilevel_neighbors, dW_tolerance);
+	if (number_of_mismatches != 0)
+	{
+		std::cout << "\n Error: the neighbors of " << number_of_mismatches << " particles found with "
+			<< "the multilevel cell linked list differ from those of the single level one!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The neighbors of all " << neighbors.size()
+		<< " particles are the same with the two cell linked lists." << endl;
+	/**
+	 * @brief 	Compare the neighbors of the particles with two smoothing lengths with those by brute force.
+	 */
+	StdVec<std::map<size_t, Real>> variable_neighbors = NeighborsByParticleId(variable_water_block_inner_relation);
+	StdVec<std::map<size_t, Real>> brute_force_neighbors = NeighborsByBruteForce(variable_water_block);
+	number_of_mismatches = NumberOfMismatches(brute_force_neighbors, variable_neighbors, dW_tolerance);
+	if (number_of_mismatches != 0)
+	{
+		std::cout << "\n Error: the neighbors of " << number_of_mismatches << " particles with two smoothing lengths "
+			<< "differ from those found by brute force!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	cout << "The neighbors of all " << variable_neighbors.size() << " particles with two smoothing lengths "
+		<< "are the same as those found by brute force." << endl;
+
+	return 0;
+}
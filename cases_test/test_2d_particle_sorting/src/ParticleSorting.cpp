@@ -0,0 +1,203 @@
+/**
+ * @file 	ParticleSorting.cpp
+ * @brief 	2D test of sorting the particles along the Morton curve of the cell linked list.
+ * @details Two identical water blocks are created and their particles are moved in the same way,
+ * 			but only the particles of one of them are sorted at each update of the cell linked list.
+ * 			The neighbors, given by the particle ids, should be the same for the two water blocks.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a water block shape */
+std::vector<Point> CreatWaterBlockShape()
+{
+	std::vector<Point> water_block_shape;
+	water_block_shape.push_back(Point(0.0, 0.0));
+	water_block_shape.push_back(Point(0.0, DH));
+	water_block_shape.push_back(Point(DL, DH));
+	water_block_shape.push_back(Point(DL, 0.0));
+	water_block_shape.push_back(Point(0.0, 0.0));
+	return water_block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatWaterBlockShape();
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Move the particles by a displacement given by their particle ids,
+ * so that a particle is moved in the same way whatever its present index is.
+ */
+void MoveParticles(RealBody* body, size_t step)
+{
+	BaseParticles* particles = body->base_particles_;
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		Real phase = Real(particles->particle_id_[i] + step);
+		particles->pos_n_[i] += 0.3 * particle_spacing_ref * Vec2d(sin(1.7 * phase), cos(2.3 * phase));
+	}
+}
+/**
+ * @brief 	The neighbors of each particle, given by their particle ids,
+ * with the kernel gradients.
+ */
+StdVec<std::map<size_t, Real>> NeighborsByParticleId(SPHBodyInnerRelation* inner_relation)
+{
+	BaseParticles* particles = inner_relation->sph_body_->base_particles_;
+	size_t number_of_particles = inner_relation->sph_body_->number_of_particles_;
+	StdVec<std::map<size_t, Real>> neighbors(number_of_particles);
+	for (size_t i = 0; i != number_of_particles; ++i)
+	{
+		Neighborhood neighborhood = inner_relation->inner_configuration_[i];
+		std::map<size_t, Real>& neighbors_i = neighbors[particles->particle_id_[i]];
+		for (size_t n = 0; n != neighborhood.current_size_; ++n)
+			neighbors_i[particles->particle_id_[neighborhood.j_[n]]] = neighborhood.dW_ij_[n];
+	}
+	return neighbors;
+}
+/**
+ * @brief 	The number of particles whose neighbors differ in the two lists.
+ */
+size_t NumberOfMismatches(StdVec<std::map<size_t, Real>>& neighbors,
+	StdVec<std::map<size_t, Real>>& other_neighbors, Real dW_tolerance)
+{
+	size_t number_of_mismatches = 0;
+	for (size_t i = 0; i != neighbors.size(); ++i)
+	{
+		if (neighbors[i].size() != other_neighbors[i].size())
+		{
+			number_of_mismatches++;
+			continue;
+		}
+		for (auto& neighbor : neighbors[i])
+		{
+			auto other_neighbor = other_neighbors[i].find(neighbor.first);
+			if (other_neighbor == other_neighbors[i].end()
+				|| ABS(other_neighbor->second - neighbor.second) > ABS(dW_tolerance))
+			{
+				number_of_mismatches++;
+				break;
+			}
+		}
+	}
+	return number_of_mismatches;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** The same water block, but with its particles sorted at each update of the cell linked list. */
+	WaterBlock* sorted_water_block = new WaterBlock(sph_system, "SortedWaterBody", 0);
+	sorted_water_block->setParticleSortingPeriod(1);
+	FluidParticles 	sorted_fluid_particles(sorted_water_block, water_material);
+	/** topology */
+	SPHBodyInnerRelation* water_block_inner_relation = new SPHBodyInnerRelation(water_block);
+	SPHBodyInnerRelation* sorted_water_block_inner_relation = new SPHBodyInnerRelation(sorted_water_block);
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	if (sorted_water_block->number_of_particles_ != water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: the two water blocks have different numbers of particles!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	Move and sort the particles, and compare the neighbors after each update.
+	 */
+	Real dW_tolerance = 1.0e-6 * water_block->kernel_->dW(Vec2d(0.5 * particle_spacing_ref, 0.0));
+	size_t number_of_steps = 5;
+	for (size_t step = 0; step != number_of_steps; ++step)
+	{
+		MoveParticles(water_block, step);
+		MoveParticles(sorted_water_block, step);
+		water_block->updateCellLinkedList();
+		sorted_water_block->updateCellLinkedList();
+		water_block_inner_relation->updateConfiguration();
+		sorted_water_block_inner_relation->updateConfiguration();
+
+		/** the sorted index of a particle is the inverse of its particle id */
+		BaseParticles* sorted_particles = sorted_water_block->base_particles_;
+		for (size_t i = 0; i != sorted_water_block->number_of_particles_; ++i)
+		{
+			if (sorted_particles->sorted_id_[sorted_particles->particle_id_[i]] != i)
+			{
+				std::cout << "\n Error: the sorted index of particle " << sorted_particles->particle_id_[i]
+					<< " does not point to its present index " << i << "!" << std::endl;
+				std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+				return 1;
+			}
+		}
+
+		StdVec<std::map<size_t, Real>> neighbors = NeighborsByParticleId(water_block_inner_relation);
+		StdVec<std::map<size_t, Real>> sorted_neighbors = NeighborsByParticleId(sorted_water_block_inner_relation);
+		size_t number_of_mismatches = NumberOfMismatches(neighbors, sorted_neighbors, dW_tolerance);
+		if (number_of_mismatches != 0)
+		{
+			std::cout << "\n Error: the neighbors of " << number_of_mismatches << " particles differ "
+				<< "after sorting the particles at step " << step << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+	}
+	cout << "The neighbors of all " << water_block->number_of_particles_ << " particles are the same "
+		<< "with and without sorting in " << number_of_steps << " steps." << endl;
+
+	return 0;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file 	ParticleSplittingMerging.cpp
+ * @brief 	2D test of the particle splitting and merging.
+ * @details The particles of a water block near a refinement region are split,
+ * 			and then merged back when the refinement region is removed.
+ * 			The total mass and momentum should be conserved by each pass,
+ * 			and the particles should be taken from and returned to the buffer consistently.
+ * 			The inner configuration is a Verlet list, which should be rebuilt after each pass
+ * 			and have the same neighbors as those found by brute force.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 1.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a block shape */
+std::vector<Point> CreatBlockShape(Point lower_bound, Point upper_bound)
+{
+	std::vector<Point> block_shape;
+	block_shape.push_back(lower_bound);
+	block_shape.push_back(Point(lower_bound[0], upper_bound[1]));
+	block_shape.push_back(upper_bound);
+	block_shape.push_back(Point(upper_bound[0], lower_bound[1]));
+	block_shape.push_back(lower_bound);
+	return block_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> water_block_shape = CreatBlockShape(Point(0.0, 0.0), Point(DL, DH));
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(water_block_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * application dependent initial condition, a shear flow with non-zero momentum
+ */
+class ShearFlowInitialCondition
+	: public fluid_dynamics::FluidInitialCondition
+{
+public:
+	ShearFlowInitialCondition(FluidBody* water)
+		: fluid_dynamics::FluidInitialCondition(water) {};
+protected:
+	void Update(size_t index_i, Real dt) override
+	{
+		vel_n_[index_i][0] = 1.0 + pos_n_[index_i][1];
+		vel_n_[index_i][1] = 0.5 * pos_n_[index_i][0];
+	}
+};
+/**
+ * @brief 	The total mass and momentum of the real particles.
+ */
+std::pair<Real, Vecd> TotalMassAndMomentum(SPHBody* body)
+{
+	BaseParticles* particles = body->base_particles_;
+	Real total_mass = 0.0;
+	Vecd total_momentum(0);
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		total_mass += particles->mass_[i];
+		total_momentum += particles->mass_[i] * particles->vel_n_[i];
+	}
+	return std::make_pair(total_mass, total_momentum);
+}
+/**
+ * @brief 	Check the conservation and the buffer bookkeeping of a splitting and merging pass.
+ */
+bool isConsistentAdaptation(SPHBody* body, ParticleSplittingAndMerging& particle_splitting_merging,
+	size_t number_of_particles_before, std::pair<Real, Vecd>& mass_and_momentum_before)
+{
+	BaseParticles* particles = body->base_particles_;
+	bool is_consistent = true;
+	/** each splitting realizes 2^d - 1 buffer particles and each merging returns one */
+	size_t number_of_children = 1 << Vecd(0).size();
+	size_t expected_number_of_particles = number_of_particles_before
+		+ (number_of_children - 1) * particle_splitting_merging.NumberOfSplittings()
+		- particle_splitting_merging.NumberOfMergings();
+	if (body->number_of_particles_ != expected_number_of_particles
+		|| body->number_of_particles_ > particles->real_particles_bound_)
+	{
+		std::cout << "\n Error: the number of particles " << body->number_of_particles_
+			<< " does not match the expected " << expected_number_of_particles << "!" << std::endl;
+		is_consistent = false;
+	}
+	/** the real particles keep distinct particle ids, i.e. no buffer particle is realized twice */
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		if (particles->sorted_id_[particles->particle_id_[i]] != i)
+		{
+			std::cout << "\n Error: the particle ids are not consistent at particle " << i << "!" << std::endl;
+			is_consistent = false;
+			break;
+		}
+	}
+	std::pair<Real, Vecd> mass_and_momentum = TotalMassAndMomentum(body);
+	Real mass_error = ABS(mass_and_momentum.first - mass_and_momentum_before.first);
+	Real momentum_error = (mass_and_momentum.second - mass_and_momentum_before.second).norm();
+	if (mass_error > 1.0e-10 * mass_and_momentum_before.first
+		|| momentum_error > 1.0e-10 * mass_and_momentum_before.second.norm())
+	{
+		std::cout << "\n Error: the mass or the momentum is not conserved, with the errors "
+			<< mass_error << " and " << momentum_error << "!" << std::endl;
+		is_consistent = false;
+	}
+	return is_consistent;
+}
+/**
+ * @brief 	The number of particles whose neighbors in the inner configuration, i.e. those with
+ * nonzero kernel gradients, differ from those found by brute force with the larger smoothing length of each pair.
+ */
+size_t NumberOfMismatchesWithBruteForce(SPHBodyInnerRelation* inner_relation)
+{
+	SPHBody* body = inner_relation->sph_body_;
+	BaseParticles* particles = body->base_particles_;
+	Kernel* kernel = body->kernel_;
+	size_t number_of_mismatches = 0;
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		IndexVector brute_force_neighbors;
+		for (size_t j = 0; j != body->number_of_particles_; ++j)
+		{
+			Real cutoff_radius = kernel->GetCutOffRadius(
+				SMAX(particles->smoothing_length_[i], particles->smoothing_length_[j]));
+			if (j != i && (particles->pos_n_[i] - particles->pos_n_[j]).normSqr() < cutoff_radius * cutoff_radius)
+				brute_force_neighbors.push_back(j);
+		}
+		IndexVector neighbors;
+		Neighborhood neighborhood = inner_relation->inner_configuration_[i];
+		for (size_t n = 0; n != neighborhood.current_size_; ++n)
+			if (neighborhood.dW_ij_[n] != 0.0) neighbors.push_back(neighborhood.j_[n]);
+		std::sort(neighbors.begin(), neighbors.end());
+		if (neighbors != brute_force_neighbors) number_of_mismatches++;
+	}
+	return number_of_mismatches;
+}
+/**
+ * @brief 	Check that the Verlet list is invalidated by a pass and rebuilt with the right neighbors.
+ */
+bool isRebuiltConfiguration(SPHBody* body, SPHBodyInnerRelation* inner_relation)
+{
+	bool is_rebuilt = true;
+	if (inner_relation->isUpdatedAlready())
+	{
+		std::cout << "\n Error: the Verlet list is not invalidated by the adaptation!" << std::endl;
+		is_rebuilt = false;
+	}
+	size_t number_of_rebuilds = inner_relation->NumberOfRebuilds();
+	body->updateCellLinkedList();
+	inner_relation->updateConfiguration();
+	if (inner_relation->NumberOfRebuilds() != number_of_rebuilds + 1)
+	{
+		std::cout << "\n Error: the Verlet list is not rebuilt after the adaptation!" << std::endl;
+		is_rebuilt = false;
+	}
+	size_t number_of_mismatches = NumberOfMismatchesWithBruteForce(inner_relation);
+	if (number_of_mismatches != 0)
+	{
+		std::cout << "\n Error: the neighbors of " << number_of_mismatches << " particles "
+			<< "differ from those found by brute force!" << std::endl;
+		is_rebuilt = false;
+	}
+	return is_rebuilt;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem --
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DL + BW, DH + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	/** The particles have variable smoothing lengths after splitting. */
+	water_block->useMultilevelMeshCellLinkedList();
+	WaterMaterial* water_material = new WaterMaterial();
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** topology */
+	SPHBodyInnerRelation* water_block_inner_relation = new SPHBodyInnerRelation(water_block);
+	water_block_inner_relation->setSkinRadius(0.5 * particle_spacing_ref);
+	/** The refinement region is a block in the middle, which is removed for the merging pass. */
+	std::vector<Point> refinement_block_shape = CreatBlockShape(Point(0.4 * DL, 0.4 * DH), Point(0.6 * DL, 0.6 * DH));
+	ComplexShape refinement_shape("RefinementRegion");
+	refinement_shape.addAPolygon(refinement_block_shape, ShapeBooleanOps::add);
+	Real smoothing_length = water_block->kernel_->GetSmoothingLength();
+	RefinementNearShape refinement_near_block(water_block, &refinement_shape, 0.1 * DL, 0.5 * smoothing_length);
+	RefinementNearShape no_refinement(water_block, &refinement_shape, 0.0, 0.5 * smoothing_length);
+	/**
+	 * @brief 	Define all numerical methods which are used in this case.
+	 */
+	ShearFlowInitialCondition initial_condition(water_block);
+	ParticleSplittingAndMerging particle_splitting(water_block_inner_relation, &refinement_near_block, 1000);
+	ParticleSplittingAndMerging particle_merging(water_block_inner_relation, &no_refinement, 0);
+	/** Pre-simulation*/
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	initial_condition.exec();
+	/**
+	 * @brief 	The splitting pass, and then the merging pass after the configuration update.
+	 */
+	size_t number_of_particles = water_block->number_of_particles_;
+	std::pair<Real, Vecd> mass_and_momentum = TotalMassAndMomentum(water_block);
+	particle_splitting.exec();
+	bool is_consistent = isConsistentAdaptation(water_block, particle_splitting, number_of_particles, mass_and_momentum);
+	cout << "The splitting pass has " << particle_splitting.NumberOfSplittings() << " splittings and "
+		<< particle_splitting.NumberOfMergings() << " mergings." << endl;
+
+	is_consistent = isRebuiltConfiguration(water_block, water_block_inner_relation) && is_consistent;
+
+	number_of_particles = water_block->number_of_particles_;
+	mass_and_momentum = TotalMassAndMomentum(water_block);
+	particle_merging.exec();
+	is_consistent = isConsistentAdaptation(water_block, particle_merging, number_of_particles, mass_and_momentum)
+		&& is_consistent;
+	cout << "The merging pass has " << particle_merging.NumberOfSplittings() << " splittings and "
+		<< particle_merging.NumberOfMergings() << " mergings." << endl;
+	is_consistent = isRebuiltConfiguration(water_block, water_block_inner_relation) && is_consistent;
+
+	if (particle_splitting.NumberOfSplittings() == 0 || particle_merging.NumberOfMergings() == 0)
+	{
+		std::cout << "\n Error: the test has no splitting or merging!" << std::endl;
+		is_consistent = false;
+	}
+	if (!is_consistent)
+	{
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
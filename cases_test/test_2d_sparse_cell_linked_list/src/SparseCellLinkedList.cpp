@@ -0,0 +1,244 @@
+/**
+ * @file 	SparseCellLinkedList.cpp
+ * @brief 	2D test of the neighbor search with the sparse cell linked list.
+ * @details Two identical water blocks, each of two patches in the opposite corners of a large domain,
+ * 			are created and their particles are moved in the same way,
+ * 			but one of them uses the block-sparse cell linked list.
+ * 			The inner neighbors and the contact neighbors of a probe body
+ * 			should be the same with the dense and the sparse cell linked lists.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief Basic geometry parameters and numerical setup.
+ */
+Real DL = 2.0; 							/**< Domain length. */
+Real DH = 1.0; 							/**< Domain height. */
+Real particle_spacing_ref = 0.025; 		/**< Initial reference particle spacing. */
+Real BW = particle_spacing_ref * 4; 	/**< Extending width for BCs. */
+Real DS = 20.0; 						/**< Size of the mostly empty domain. */
+/**
+ * @brief Material properties of the fluid.
+ */
+Real rho0_f = 1.0;						/**< Reference density of fluid. */
+Real c_f = 10.0;						/**< Reference sound speed. */
+/** create a rectangle shape */
+std::vector<Point> CreatRectangleShape(Point lower_bound, Point upper_bound)
+{
+	std::vector<Point> rectangle_shape;
+	rectangle_shape.push_back(lower_bound);
+	rectangle_shape.push_back(Point(lower_bound[0], upper_bound[1]));
+	rectangle_shape.push_back(upper_bound);
+	rectangle_shape.push_back(Point(upper_bound[0], lower_bound[1]));
+	rectangle_shape.push_back(lower_bound);
+	return rectangle_shape;
+}
+/**
+*@brief 	Fluid body definition.
+*/
+class WaterBlock : public FluidBody
+{
+public:
+	WaterBlock(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition, two patches in the opposite corners of the domain. */
+		std::vector<Point> lower_patch_shape = CreatRectangleShape(Point(0.0, 0.0), Point(DL, DH));
+		std::vector<Point> upper_patch_shape = CreatRectangleShape(Point(DS - DL, DS - DH), Point(DS, DS));
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(lower_patch_shape, ShapeBooleanOps::add);
+		body_shape_->addAPolygon(upper_patch_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+*@brief 	Probe body definition, overlapping a side of the lower patch of the water blocks.
+*/
+class Probe : public FluidBody
+{
+public:
+	Probe(SPHSystem& sph_system, string body_name, int refinement_level)
+		: FluidBody(sph_system, body_name, refinement_level)
+	{
+		/** Geomtry definition. */
+		std::vector<Point> probe_shape = CreatRectangleShape(Point(DL - 0.2, 0.0), Point(DL + 0.2, DH));
+		body_shape_ = new ComplexShape(body_name);
+		body_shape_->addAPolygon(probe_shape, ShapeBooleanOps::add);
+	}
+};
+/**
+ * @brief 	Case dependent material properties definition.
+ */
+class WaterMaterial : public WeaklyCompressibleFluid
+{
+public:
+	WaterMaterial() : WeaklyCompressibleFluid()
+	{
+		/** Basic material parameters*/
+		rho_0_ = rho0_f;
+		c_0_ = c_f;
+
+		/** Compute the derived material parameters*/
+		assignDerivedMaterialParameters();
+	}
+};
+/**
+ * @brief 	Move the particles by a displacement given by their particle ids,
+ * so that a particle is moved in the same way whatever its present index is.
+ */
+void MoveParticles(RealBody* body, size_t step)
+{
+	BaseParticles* particles = body->base_particles_;
+	for (size_t i = 0; i != body->number_of_particles_; ++i)
+	{
+		Real phase = Real(particles->particle_id_[i] + step);
+		particles->pos_n_[i] += 0.3 * particle_spacing_ref * Vec2d(sin(1.7 * phase), cos(2.3 * phase));
+	}
+}
+/**
+ * @brief 	The inner neighbors of each particle, given by their particle ids,
+ * with the kernel gradients.
+ */
+StdVec<std::map<size_t, Real>> NeighborsByParticleId(SPHBodyInnerRelation* inner_relation)
+{
+	BaseParticles* particles = inner_relation->sph_body_->base_particles_;
+	size_t number_of_particles = inner_relation->sph_body_->number_of_particles_;
+	StdVec<std::map<size_t, Real>> neighbors(number_of_particles);
+	for (size_t i = 0; i != number_of_particles; ++i)
+	{
+		Neighborhood neighborhood = inner_relation->inner_configuration_[i];
+		std::map<size_t, Real>& neighbors_i = neighbors[particles->particle_id_[i]];
+		for (size_t n = 0; n != neighborhood.current_size_; ++n)
+			neighbors_i[particles->particle_id_[neighborhood.j_[n]]] = neighborhood.dW_ij_[n];
+	}
+	return neighbors;
+}
+/**
+ * @brief 	The contact neighbors of each particle, given by the particle ids of the contact body,
+ * with the kernel gradients.
+ */
+StdVec<std::map<size_t, Real>> ContactNeighborsByParticleId(SPHBodyContactRelation* contact_relation)
+{
+	BaseParticles* contact_particles = contact_relation->contact_sph_bodies_[0]->base_particles_;
+	size_t number_of_particles = contact_relation->sph_body_->number_of_particles_;
+	StdVec<std::map<size_t, Real>> neighbors(number_of_particles);
+	for (size_t i = 0; i != number_of_particles; ++i)
+	{
+		Neighborhood neighborhood = contact_relation->contact_configuration_[0][i];
+		for (size_t n = 0; n != neighborhood.current_size_; ++n)
+			neighbors[i][contact_particles->particle_id_[neighborhood.j_[n]]] = neighborhood.dW_ij_[n];
+	}
+	return neighbors;
+}
+/**
+ * @brief 	The number of particles whose neighbors differ in the two lists.
+ */
+size_t NumberOfMismatches(StdVec<std::map<size_t, Real>>& neighbors,
+	StdVec<std::map<size_t, Real>>& other_neighbors, Real dW_tolerance)
+{
+	size_t number_of_mismatches = 0;
+	for (size_t i = 0; i != neighbors.size(); ++i)
+	{
+		if (neighbors[i].size() != other_neighbors[i].size())
+		{
+			number_of_mismatches++;
+			continue;
+		}
+		for (auto& neighbor : neighbors[i])
+		{
+			auto other_neighbor = other_neighbors[i].find(neighbor.first);
+			if (other_neighbor == other_neighbors[i].end()
+				|| ABS(other_neighbor->second - neighbor.second) > ABS(dW_tolerance))
+			{
+				number_of_mismatches++;
+				break;
+			}
+		}
+	}
+	return number_of_mismatches;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/**
+	 * @brief Build up -- a SPHSystem -- with a large domain
+	 */
+	SPHSystem sph_system(Vec2d(-BW, -BW), Vec2d(DS + BW, DS + BW), particle_spacing_ref);
+	/**
+	 * @brief Material property, partilces and body creation of fluid.
+	 */
+	WaterMaterial* water_material = new WaterMaterial();
+	WaterBlock* water_block = new WaterBlock(sph_system, "WaterBody", 0);
+	FluidParticles 	fluid_particles(water_block, water_material);
+	/** The same water block, but with the sparse cell linked list.
+	  * Here, the cell linked list is replaced after creating the particles. */
+	WaterBlock* sparse_water_block = new WaterBlock(sph_system, "SparseWaterBody", 0);
+	FluidParticles 	sparse_fluid_particles(sparse_water_block, water_material);
+	sparse_water_block->useSparseMeshCellLinkedList();
+	Probe* probe = new Probe(sph_system, "Probe", 0);
+	FluidParticles 	probe_particles(probe, water_material);
+	/** topology */
+	SPHBodyInnerRelation* water_block_inner_relation = new SPHBodyInnerRelation(water_block);
+	SPHBodyInnerRelation* sparse_water_block_inner_relation = new SPHBodyInnerRelation(sparse_water_block);
+	SPHBodyContactRelation* probe_contact_relation = new SPHBodyContactRelation(probe, { water_block });
+	SPHBodyContactRelation* sparse_probe_contact_relation = new SPHBodyContactRelation(probe, { sparse_water_block });
+	/** Build the cell linked lists and the configurations. */
+	sph_system.initializeSystemCellLinkedLists();
+	sph_system.initializeSystemConfigurations();
+	if (sparse_water_block->number_of_particles_ != water_block->number_of_particles_)
+	{
+		std::cout << "\n Error: the two water blocks have different numbers of particles!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+	/**
+	 * @brief 	Move the particles, and compare the neighbors after each update.
+	 */
+	Real dW_tolerance = 1.0e-6 * water_block->kernel_->dW(Vec2d(0.5 * particle_spacing_ref, 0.0));
+	size_t number_of_steps = 5;
+	for (size_t step = 0; step != number_of_steps; ++step)
+	{
+		StdVec<std::map<size_t, Real>> neighbors = NeighborsByParticleId(water_block_inner_relation);
+		StdVec<std::map<size_t, Real>> sparse_neighbors = NeighborsByParticleId(sparse_water_block_inner_relation);
+		size_t number_of_mismatches = NumberOfMismatches(neighbors, sparse_neighbors, dW_tolerance);
+		if (number_of_mismatches != 0)
+		{
+			std::cout << "\n Error: the inner neighbors of " << number_of_mismatches << " particles differ "
+				<< "with the sparse cell linked list at step " << step << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+		StdVec<std::map<size_t, Real>> contact_neighbors = ContactNeighborsByParticleId(probe_contact_relation);
+		StdVec<std::map<size_t, Real>> sparse_contact_neighbors = ContactNeighborsByParticleId(sparse_probe_contact_relation);
+		number_of_mismatches = NumberOfMismatches(contact_neighbors, sparse_contact_neighbors, dW_tolerance);
+		if (number_of_mismatches != 0)
+		{
+			std::cout << "\n Error: the contact neighbors of " << number_of_mismatches << " probe particles differ "
+				<< "with the sparse cell linked list at step " << step << "!" << std::endl;
+			std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+			return 1;
+		}
+
+		MoveParticles(water_block, step);
+		MoveParticles(sparse_water_block, step);
+		water_block->updateCellLinkedList();
+		sparse_water_block->updateCellLinkedList();
+		water_block_inner_relation->updateConfiguration();
+		sparse_water_block_inner_relation->updateConfiguration();
+		probe_contact_relation->updateConfiguration();
+		sparse_probe_contact_relation->updateConfiguration();
+	}
+	cout << "The neighbors of all " << water_block->number_of_particles_ << " particles are the same "
+		<< "with the dense and the sparse cell linked lists in " << number_of_steps << " steps." << endl;
+
+	return 0;
+}
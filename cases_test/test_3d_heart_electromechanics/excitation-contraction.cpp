@@ -605,6 +605,52 @@ int main(int ac, char* av[])
 	Real Observer_time 			= 0.01 * Ouput_T;	
 	Real dt 					= 0.0; 				/**< Default acoustic time step sizes for physiology. */
 	Real dt_s 					= 0.0;				/**< Default acoustic time step sizes for mechanics. */
+	/**
+	 * Multi-rate time stepping, in which the mechanics is sub-cycled
+	 * within each time step of the electrophysiology.
+	 */
+	MultiRateIntegrator electromechanics_integrator;
+	TimeSteppingLevel& physiology_level = electromechanics_integrator.addALevel("PhysiologyBody",
+		get_physiology_time_step, [&](Real dt) {
+			/** Apply stimulus excitation. */
+			if( 0 <= GlobalStaticVariables::physical_time_
+				&&  GlobalStaticVariables::physical_time_ <= 0.5)
+			{
+				apply_stimulus_s1.parallel_exec(dt);
+			}
+			/** Single spiral wave. */
+			// if( 60 <= GlobalStaticVariables::physical_time_
+			// 	&&  GlobalStaticVariables::physical_time_ <= 65)
+			// {
+			// 	apply_stimulus_s2.parallel_exec(dt);
+			// }
+			/**Strang splitting method. */
+			//forward reaction
+			int ite_forward = 0;
+			while (ite_forward < reaction_step )
+			{
+				reaction_relaxation_forward.parallel_exec(0.5 * dt / Real(reaction_step));
+				ite_forward ++;
+			}
+			/** 2nd Runge-Kutta scheme for diffusion. */
+			diffusion_relaxation.parallel_exec(dt);
+
+			//backward reaction
+			int ite_backward = 0;
+			while (ite_backward < reaction_step)
+			{
+				reaction_relaxation_backward.parallel_exec(0.5 * dt / Real(reaction_step));
+				ite_backward ++;
+			}
+		});
+	TimeSteppingLevel& mechanics_level = electromechanics_integrator.addALevel("MechanicsBody",
+		get_mechanics_time_step, [&](Real dt_s) {
+			stress_relaxation_first_half.parallel_exec(dt_s);
+			constrain_holder.parallel_exec(dt_s);
+			stress_relaxation_second_half.parallel_exec(dt_s);
+		}, &physiology_level);
+	physiology_level.setSynchronization([&](Real dt) { active_stress_interpolation.parallel_exec(); },
+		nullptr);
 	/** Statistics for computing time. */
 	tick_count t1 = tick_count::now();
 	tick_count::interval_t interval;
@@ -625,52 +671,9 @@ int main(int ac, char* av[])
 						<< "	dt = " << dt 
 						<< "	dt_s = " << dt_s << "\n";
 				}
-				/** Apply stimulus excitation. */
-				if( 0 <= GlobalStaticVariables::physical_time_ 
-					&&  GlobalStaticVariables::physical_time_ <= 0.5)
-				{
-					apply_stimulus_s1.parallel_exec(dt);
-				}
-				/** Single spiral wave. */
-				// if( 60 <= GlobalStaticVariables::physical_time_ 
-				// 	&&  GlobalStaticVariables::physical_time_ <= 65)	
-				// {
-				// 	apply_stimulus_s2.parallel_exec(dt);
-				// }
-				/**Strang splitting method. */
-				//forward reaction 
-				int ite_forward = 0;
-				while (ite_forward < reaction_step )
-				{
-					reaction_relaxation_forward.parallel_exec(0.5 * dt / Real(reaction_step));
-					ite_forward ++;
-				}
-				/** 2nd Runge-Kutta scheme for diffusion. */
-				diffusion_relaxation.parallel_exec(dt);
-
-				//backward reaction
-				int ite_backward = 0;
-				while (ite_backward < reaction_step)
-				{
-					reaction_relaxation_backward.parallel_exec(0.5 * dt / Real(reaction_step));
-					ite_backward ++;
-				}
-
-				active_stress_interpolation.parallel_exec();
-
-				Real dt_s_sum = 0.0;
-				while (dt_s_sum < dt) 
-				{
-					dt_s = get_mechanics_time_step.parallel_exec();
-					if (dt - dt_s_sum < dt_s) dt_s = dt - dt_s_sum;
-					stress_relaxation_first_half.parallel_exec(dt_s);
-					constrain_holder.parallel_exec(dt_s);
-					stress_relaxation_second_half.parallel_exec(dt_s);
-					dt_s_sum += dt_s;
-				}
-
+				dt = electromechanics_integrator.advanceAStep();
+				dt_s = mechanics_level.TimeStepSize();
 				ite++;
-				dt = get_physiology_time_step.parallel_exec();
 
 				relaxation_time += dt;
 				integration_time += dt;
@@ -690,6 +693,7 @@ int main(int ac, char* av[])
 	tick_count::interval_t tt;
 	tt = t4 - t1 - interval;
 	cout << "Total wall time for computation: " << tt.seconds() << " seconds." << endl;
+	electromechanics_integrator.printReport();
 
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file 	TriangleMeshQueries.cpp
+ * @brief 	3D test of the closest point and the inside/outside queries of triangle mesh shapes.
+ * @details The queries by the bounding volume hierarchy are compared with those of SimTK
+ * 			on a brick and a sphere mesh. The points are on a lattice aligned with the vertices of the brick,
+ * 			so that many rays of the inside/outside query go through the shared edges and vertices.
+ * @author 	Chi Zhang and Xiangyu Hu
+ * @version 0.1
+ */
+ /**
+  * @brief 	SPHinXsys Library.
+  */
+#include "sphinxsys.h"
+  /**
+ * @brief Namespace cite here.
+ */
+using namespace SPH;
+/**
+ * @brief 	Compare the queries of a triangle mesh shape with those of SimTK on the points of a lattice.
+ * The closest points are compared by their distances, as there may be several closest points.
+ * The inside/outside queries are compared only for the points not on the surface.
+ */
+bool isConsistentWithSimTK(TriangleMeshShape& triangle_mesh_shape, string shape_name,
+	Vec3d lower_bound, int number_of_lattice_points, Real lattice_spacing)
+{
+	SimTK::ContactGeometry::TriangleMesh* triangle_mesh = triangle_mesh_shape.getTriangleMesh();
+	size_t number_of_closest_point_mismatches = 0;
+	size_t number_of_containment_mismatches = 0;
+	for (int i = 0; i != number_of_lattice_points; ++i)
+		for (int j = 0; j != number_of_lattice_points; ++j)
+			for (int k = 0; k != number_of_lattice_points; ++k)
+			{
+				Vec3d pnt = lower_bound + Vec3d(Real(i), Real(j), Real(k)) * lattice_spacing;
+				bool inside = false;
+				int face_id;
+				SimTK::Vec2 uv_coordinate;
+				Vec3d closest_pnt = triangle_mesh->findNearestPoint(pnt, inside, face_id, uv_coordinate);
+				Real distance = (closest_pnt - pnt).norm();
+
+				Real bvh_distance = (triangle_mesh_shape.findClosestPoint(pnt) - pnt).norm();
+				if (ABS(bvh_distance - distance) > 1.0e-8 * lattice_spacing)
+					number_of_closest_point_mismatches++;
+
+				if (distance > 1.0e-3 * lattice_spacing && triangle_mesh_shape.checkContain(pnt) != inside)
+					number_of_containment_mismatches++;
+			}
+
+	cout << "The " << shape_name << " has " << number_of_closest_point_mismatches
+		<< " closest point mismatches and " << number_of_containment_mismatches
+		<< " inside/outside mismatches with SimTK." << endl;
+	return number_of_closest_point_mismatches == 0 && number_of_containment_mismatches == 0;
+}
+/**
+ * @brief 	Main program starts here.
+ */
+int main()
+{
+	/** The brick with its faces, edges and vertices on the lattice. */
+	TriangleMeshShape brick(Vec3d(0.5, 0.5, 0.5), 2, Vec3d(0));
+	/** The sphere with vertices not aligned to the lattice. */
+	TriangleMeshShape sphere(0.5, 3, Vec3d(0));
+
+	bool is_consistent = isConsistentWithSimTK(brick, "brick", Vec3d(-0.75), 13, 0.125);
+	is_consistent = isConsistentWithSimTK(sphere, "sphere", Vec3d(-0.75), 13, 0.125) && is_consistent;
+	if (!is_consistent)
+	{
+		std::cout << "\n Error: the triangle mesh queries differ from those of SimTK!" << std::endl;
+		std::cout << __FILE__ << ':' << __LINE__ << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
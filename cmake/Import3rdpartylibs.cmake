@@ -41,4 +41,20 @@ IF(Boost_FOUND)
      MESSAGE("${Boost_LIBRARIES}")
 ELSE(Boost_FOUND)
      MESSAGE(FATAL_ERROR "Boost library not found")
-ENDIF(Boost_FOUND)
\ No newline at end of file
+ENDIF(Boost_FOUND)
+FIND_PACKAGE(ZLIB)
+IF(ZLIB_FOUND)
+    INCLUDE_DIRECTORIES("${ZLIB_INCLUDE_DIRS}")
+    ADD_DEFINITIONS(-DSPHINXSYS_USE_ZLIB)
+    MESSAGE("${ZLIB_LIBRARIES}")
+ELSE(ZLIB_FOUND)
+    MESSAGE("zlib not found, compressed VTU output is disabled")
+ENDIF(ZLIB_FOUND)
+
+IF(ACTIVATE_MPI)
+    FIND_PACKAGE(MPI REQUIRED COMPONENTS CXX)
+    INCLUDE_DIRECTORIES("${MPI_CXX_INCLUDE_DIRS}")
+    ADD_DEFINITIONS(-DSPHINXSYS_USE_MPI)
+ENDIF(ACTIVATE_MPI)
+
+FIND_PACKAGE(Threads REQUIRED)